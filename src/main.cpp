@@ -7,6 +7,7 @@
 # include "mriConstants.h"
 # include "mriOptions.h"
 # include "mriCommunicator.h"
+# include "mriParallel.h"
 
 # include "mpi.h"
 
@@ -44,10 +45,20 @@ void readAndDistribute(mriCommunicator* comm, mriOptions* opts, mriSequence* seq
     // READ FROM FILE
     seq->readFromASCIISequence(kInputPLT,opts->sequenceFileList,opts->sequenceFileTimes); 
 
+  }else if (opts->inputFormatType == itFILESEQUENCE){
+
+    // READ ALL SCANS FROM ONE SEQUENCE FILE
+    seq->readFromSequenceFile(opts->inputFileName,opts->inputPhases,opts->inputBox);
+
   }
   
   // Compute the topology for all sequences
-  seq->createTopology();  
+  seq->createTopology(opts->topologyOrdering);
+
+  // Velocities from the expansion coefficients need faces and edges
+  if(opts->inputFormatType == itEXPANSION){
+    seq->rebuildFromExpansions();
+  }
 }
 
 // ============
@@ -57,12 +68,18 @@ void writeOutput(mriCommunicator* comm, mriOptions* opts, mriSequence* seq){
 
   // EXPORT FILE FROM ALL PROECESSORS IN ORDER
   if(comm->currProc == 0){
-    if(opts->outputFormatType == otFILEVTK){
+    if((opts->outputFormatType == otFILEVTK)||(opts->outputFormatType == otFILEVTKBINARY)){
       // READ FROM FILE      
-      seq->exportToVTK(opts->outputFileName,opts->thresholdCriteria);
+      seq->exportToVTK(opts->outputFileName,opts->thresholdCriteria,opts->outputFormatType == otFILEVTKBINARY);
+    }else if(opts->outputFormatType == otFILEVTKXML){
+      seq->exportToVTKXML(opts->outputFileName,opts->thresholdCriteria,opts->vtkXMLCompression);
     }else if (opts->outputFormatType == otFILEPLT){
       // READ FROM FILE
       seq->exportToTECPLOT(opts->outputFileName);
+    }else if (opts->outputFormatType == otFILEPLTBINARY){
+      seq->exportToTECPLOTBinary(opts->outputFileName);
+    }else if (opts->outputFormatType == otFILESEQUENCE){
+      seq->exportToSequenceFile(opts->outputFileName,opts->sequenceCompression);
     }else{
       throw mriException("ERROR: Invalid output file format.\n");
     }
@@ -77,6 +94,9 @@ void runApplication(mriOptions* opts, mriCommunicator* comm){
   // CREATE NEW SEQUENCE
   mriSequence* seq;
 
+  // SET WORKER THREADS
+  mriParallel::setThreadCount(opts->threadCount);
+
   // INIT SEQUENCE
   seq = new mriSequence(true/*Cyclic Sequence*/);
 
@@ -107,13 +127,17 @@ int main(int argc, char **argv){
   // Init mri Communicator
   mriCommunicator* comm = new mriCommunicator();
 
-  // Initialize MPI
-  MPI_Init(NULL,NULL);
+  // Initialize MPI, only the main thread makes MPI calls
+  int threadSupport = 0;
+  MPI_Init_thread(NULL,NULL,MPI_THREAD_FUNNELED,&threadSupport);
   int rank; int nproc;
   comm->mpiComm = MPI_COMM_WORLD;
   MPI_Comm_rank(comm->mpiComm, &comm->currProc);
   MPI_Comm_size(comm->mpiComm, &comm->totProc);
 
+  // Default worker threads from the cores per rank
+  mriParallel::initDefaultThreadCount(comm->mpiComm);
+
   //  Declare
   int val = 0;
   mriOptions* options;
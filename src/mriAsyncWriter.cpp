@@ -0,0 +1,138 @@
+#include <stdarg.h>
+#include <memory>
+#include "mriAsyncWriter.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriAsyncWriter::mriAsyncWriter(int queueDepth):pool(1,kAsyncWriterLoopThreads){
+  if(queueDepth < 1){
+    throw mriException("ERROR: Invalid queue depth in mriAsyncWriter.\n");
+  }
+  this->queueDepth = queueDepth;
+}
+
+// ===========
+// SUBMIT TASK
+// ===========
+void mriAsyncWriter::submit(const std::function<void()>& task){
+  pool.waitForSlots(queueDepth - 1);
+  pool.submit(task);
+}
+
+// ===================
+// WAIT FOR ALL WRITES
+// ===================
+void mriAsyncWriter::wait(){
+  pool.wait();
+}
+
+// ==============
+// RUN WRITE TASK
+// ==============
+void runWriteTask(mriAsyncWriter* asyncWriter, const std::function<void()>& task){
+  if(asyncWriter != NULL){
+    asyncWriter->submit(task);
+  }else{
+    task();
+  }
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriAsyncTextFile::mriAsyncTextFile(string fileName, mriAsyncWriter* asyncWriter){
+  this->asyncWriter = asyncWriter;
+  outFile = fopen(fileName.c_str(),"w");
+  if(outFile == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+  chunk.reserve(kAsyncTextChunkSize);
+}
+
+// ==========
+// DESTRUCTOR
+// ==========
+mriAsyncTextFile::~mriAsyncTextFile(){
+  if(outFile != NULL){
+    // Queued chunks still use the file
+    if(asyncWriter != NULL){
+      try{
+        asyncWriter->wait();
+      }catch(...){}
+    }
+    fclose(outFile);
+  }
+}
+
+// ==========
+// PRINT TEXT
+// ==========
+void mriAsyncTextFile::print(const char* format, ...){
+  char line[512];
+  va_list args;
+  va_start(args,format);
+  int length = vsnprintf(line,sizeof(line),format,args);
+  va_end(args);
+  if(length < 0){
+    throw mriException("ERROR: Invalid format in mriAsyncTextFile.\n");
+  }
+  if((size_t)length < sizeof(line)){
+    chunk.append(line,length);
+  }else{
+    // Long line, format again straight into the chunk
+    size_t chunkSize = chunk.size();
+    chunk.resize(chunkSize + length + 1);
+    va_start(args,format);
+    vsnprintf(&chunk[chunkSize],length + 1,format,args);
+    va_end(args);
+    chunk.resize(chunkSize + length);
+  }
+  if(chunk.size() >= kAsyncTextChunkSize){
+    writeChunk();
+  }
+}
+
+// ==========
+// WRITE TEXT
+// ==========
+void mriAsyncTextFile::write(std::shared_ptr<const string> text){
+  // Keep the order of the lines already printed
+  writeChunk();
+  FILE* file = outFile;
+  runWriteTask(asyncWriter,[file,text](){
+    if(fwrite(text->data(),1,text->size(),file) != text->size()){
+      throw mriException("ERROR: Cannot write to text file in mriAsyncTextFile.\n");
+    }
+  });
+}
+
+// ===========
+// WRITE CHUNK
+// ===========
+void mriAsyncTextFile::writeChunk(){
+  std::shared_ptr<string> text(new string());
+  text->swap(chunk);
+  chunk.reserve(kAsyncTextChunkSize);
+  FILE* file = outFile;
+  runWriteTask(asyncWriter,[file,text](){
+    if(fwrite(text->data(),1,text->size(),file) != text->size()){
+      throw mriException("ERROR: Cannot write to text file in mriAsyncTextFile.\n");
+    }
+  });
+}
+
+// ==========
+// CLOSE FILE
+// ==========
+void mriAsyncTextFile::close(){
+  if(outFile == NULL){
+    return;
+  }
+  writeChunk();
+  FILE* file = outFile;
+  outFile = NULL;
+  runWriteTask(asyncWriter,[file](){
+    fclose(file);
+  });
+}
@@ -0,0 +1,74 @@
+#ifndef MRIASYNCWRITER_H
+#define MRIASYNCWRITER_H
+
+# include <stdio.h>
+# include <string>
+# include <functional>
+# include <memory>
+
+# include "mriParallel.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Write tasks queued or running at the same time, double buffering
+const int kAsyncWriterQueueDepth = 2;
+// Threads of the loops inside write tasks, the compute threads stay busy
+const int kAsyncWriterLoopThreads = 1;
+// Text collected before it is handed to the writer thread
+const size_t kAsyncTextChunkSize = 1 << 22;
+
+// ========================
+// BACKGROUND EXPORT WRITER
+// ========================
+// Write tasks own an immutable snapshot of what they write and run in
+// submission order on one background thread, so files appended by
+// consecutive tasks keep their order. submit() blocks while the queue is
+// full, which bounds the memory held by the snapshots.
+class mriAsyncWriter{
+  public:
+    // CONSTRUCTOR
+    mriAsyncWriter(int queueDepth = kAsyncWriterQueueDepth);
+
+    // MEMBER FUNCTIONS
+    void submit(const std::function<void()>& task);
+    // Wait for all writes, forwards the first error
+    void wait();
+
+  private:
+    mriTaskPool pool;
+    int queueDepth;
+};
+
+// Run the task on the writer or, without a writer, right away
+void runWriteTask(mriAsyncWriter* asyncWriter, const std::function<void()>& task);
+
+// ===========================
+// TEXT FILE WRITTEN IN CHUNKS
+// ===========================
+// Lines are formatted by the caller into a chunk, full chunks are written
+// by the writer thread while the caller goes on. Without a writer the
+// chunks are written right away.
+class mriAsyncTextFile{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    mriAsyncTextFile(string fileName, mriAsyncWriter* asyncWriter);
+    ~mriAsyncTextFile();
+
+    // MEMBER FUNCTIONS
+    void print(const char* format, ...) __attribute__((format(printf,2,3)));
+    // Text shared with other files, written without a copy
+    void write(std::shared_ptr<const string> text);
+    void close();
+
+  private:
+    FILE* outFile;
+    mriAsyncWriter* asyncWriter;
+    string chunk;
+    void writeChunk();
+    // Not copyable
+    mriAsyncTextFile(const mriAsyncTextFile&);
+    mriAsyncTextFile& operator=(const mriAsyncTextFile&);
+};
+
+#endif // MRIASYNCWRITER_H
@@ -0,0 +1,50 @@
+#ifndef MRIBYTEORDER_H
+#define MRIBYTEORDER_H
+
+# include <stddef.h>
+# include <stdint.h>
+# include <string.h>
+
+// Legacy VTK binary data is big-endian
+const bool kHostIsBigEndian = (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__);
+
+// Unsigned integer with the same size as the type being swapped
+template<size_t N> struct mriUIntOfSize{};
+template<> struct mriUIntOfSize<1>{typedef uint8_t type;};
+template<> struct mriUIntOfSize<2>{typedef uint16_t type;};
+template<> struct mriUIntOfSize<4>{typedef uint32_t type;};
+template<> struct mriUIntOfSize<8>{typedef uint64_t type;};
+
+inline uint8_t  swapBytes(uint8_t value){return value;}
+inline uint16_t swapBytes(uint16_t value){return __builtin_bswap16(value);}
+inline uint32_t swapBytes(uint32_t value){return __builtin_bswap32(value);}
+inline uint64_t swapBytes(uint64_t value){return __builtin_bswap64(value);}
+
+// Load a big-endian value from a possibly unaligned address
+template<typename T> inline T loadBigEndian(const char* ptr){
+  typename mriUIntOfSize<sizeof(T)>::type bits;
+  memcpy(&bits,ptr,sizeof(T));
+  if(!kHostIsBigEndian){
+    bits = swapBytes(bits);
+  }
+  T value;
+  memcpy(&value,&bits,sizeof(T));
+  return value;
+}
+
+// Convert an array between host and big-endian order in place, the loop
+// has no dependencies between iterations and is vectorized by the compiler
+template<typename T> inline void swapToBigEndian(T* values, size_t count){
+  if(kHostIsBigEndian){
+    return;
+  }
+  typedef typename mriUIntOfSize<sizeof(T)>::type bitsType;
+  for(size_t loopA=0;loopA<count;loopA++){
+    bitsType bits;
+    memcpy(&bits,&values[loopA],sizeof(T));
+    bits = swapBytes(bits);
+    memcpy(&values[loopA],&bits,sizeof(T));
+  }
+}
+
+#endif // MRIBYTEORDER_H
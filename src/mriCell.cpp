@@ -3,61 +3,118 @@
 #include "mriConstants.h"
 #include "mriException.h"
 
-mriCell::mriCell(){
-  // Initialize Cell
-  concentration = 0.0;
-  velocity.resize(3,0.0);
-  auxVector.resize(3,0.0);
+std::atomic<unsigned long> mriCellData::versionCounter(0);
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriCellData::mriCellData(int totCells){
+  resize(totCells);
+}
+
+// ===================
+// RESIZE CELL STORAGE
+// ===================
+void mriCellData::resize(int totCells){
+  conc.resize(totCells,0.0);
+  vx.resize(totCells,0.0);
+  vy.resize(totCells,0.0);
+  vz.resize(totCells,0.0);
+  auxX.resize(totCells,0.0);
+  auxY.resize(totCells,0.0);
+  auxZ.resize(totCells,0.0);
+  markModified();
 }
 
-mriCell::~mriCell(){
+// ==================
+// CLEAR CELL STORAGE
+// ==================
+void mriCellData::clear(){
+  conc.clear();
+  vx.clear();
+  vy.clear();
+  vz.clear();
+  auxX.clear();
+  auxY.clear();
+  auxZ.clear();
+  markModified();
 }
 
-// ============
-// GET QUANTITY
-// ============
-double mriCell::getQuantity(int qtyID){
+// =============================
+// GET COLUMN FOR QUANTITY INDEX
+// =============================
+double* mriCellData::quantity(int qtyID){
   switch(qtyID){
     case kQtyConcentration:
-      return concentration;
-      break;
+      return conc.data();
     case kQtyVelocityX:
-      return velocity[0];
-      break;
+      return vx.data();
     case kQtyVelocityY:
-      return velocity[1];
-      break;
+      return vy.data();
     case kQtyVelocityZ:
-      return velocity[2];
-      break;
+      return vz.data();
     default:
-      throw mriException("ERROR: Invalid quantity in mriCell::getQuantity.\n");
-      break;
+      throw mriException("ERROR: Invalid quantity in mriCellData::quantity.\n");
   }
 }
 
-// ============
-// SET QUANTITY
-// ============
-void mriCell::setQuantity(int qtyID, double value){
-  switch(qtyID){
-    case kQtyConcentration:
-      concentration = value;
-      break;
-    case kQtyVelocityX:
-      velocity[0] = value;
-      break;
-    case kQtyVelocityY:
-      velocity[1] = value;
-      break;
-    case kQtyVelocityZ:
-      velocity[2] = value;
-      break;
-    default:
-      throw mriException("ERROR: Invalid quantity.\n");
-      break;
+const double* mriCellData::quantity(int qtyID) const{
+  return const_cast<mriCellData*>(this)->quantity(qtyID);
+}
+
+// ============================
+// CHECK THE MODIFICATION STAMP
+// ============================
+void mriCellData::checkVersion() const{
+#ifdef MRI_DEBUG
+  if(evalColumnsHash() != columnsHash){
+    throw mriException("ERROR: Cell data written without a new version.\n");
   }
+#endif
 }
 
+#ifdef MRI_DEBUG
+// Hash of the bit patterns in the stamped columns
+unsigned long mriCellData::evalColumnsHash() const{
+  const mriAlignedDoubleVec* columns[4] = {&conc,&vx,&vy,&vz};
+  unsigned long hash = 14695981039346656037UL;
+  for(int loopA=0;loopA<4;loopA++){
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(columns[loopA]->data());
+    size_t totBytes = columns[loopA]->size()*sizeof(double);
+    for(size_t loopB=0;loopB<totBytes;loopB++){
+      hash = (hash ^ bytes[loopB])*1099511628211UL;
+    }
+    hash = (hash ^ columns[loopA]->size())*1099511628211UL;
+  }
+  return hash;
+}
+#endif
 
+// ================================
+// COPY AUXILIARY VECTOR TO VELOCITY
+// ================================
+void mriCellData::copyAuxToVelocity(){
+  vx.assign(auxX.begin(),auxX.end());
+  vy.assign(auxY.begin(),auxY.end());
+  vz.assign(auxZ.begin(),auxZ.end());
+  markModified();
+}
 
+// ===========================
+// GET MAXIMUM VELOCITY MODULE
+// ===========================
+double mriCellData::getMaxVelocityModule() const{
+  double maxSq = 0.0;
+  double currSq = 0.0;
+  size_t totCells = size();
+  const double* x = vx.data();
+  const double* y = vy.data();
+  const double* z = vz.data();
+  for(size_t loopA=0;loopA<totCells;loopA++){
+    currSq = x[loopA]*x[loopA] + y[loopA]*y[loopA] + z[loopA]*z[loopA];
+    if(currSq > maxSq){
+      maxSq = currSq;
+    }
+  }
+  return sqrt(maxSq);
+}
@@ -1,19 +1,141 @@
 #ifndef MRICELL_H
 #define MRICELL_H
 
+# include <stdlib.h>
+# include <math.h>
+# include <new>
+# include <atomic>
 # include "mriTypes.h"
+# include "mriConstants.h"
+# include "mriException.h"
 
-class mriCell{
+// Alignment in bytes of the cell field arrays
+const size_t kCellDataAlignment = 64;
+
+// ==================================
+// ALIGNED ALLOCATOR FOR FIELD ARRAYS
+// ==================================
+template <class T>
+class mriAlignedAllocator{
+  public:
+    typedef T value_type;
+    mriAlignedAllocator(){}
+    template <class U> mriAlignedAllocator(const mriAlignedAllocator<U>&){}
+    T* allocate(size_t n){
+      void* ptr = NULL;
+      if(n == 0){
+        return NULL;
+      }
+      if(posix_memalign(&ptr,kCellDataAlignment,n*sizeof(T)) != 0){
+        throw std::bad_alloc();
+      }
+      return static_cast<T*>(ptr);
+    }
+    void deallocate(T* ptr, size_t){
+      free(ptr);
+    }
+};
+template <class T, class U>
+bool operator==(const mriAlignedAllocator<T>&, const mriAlignedAllocator<U>&){return true;}
+template <class T, class U>
+bool operator!=(const mriAlignedAllocator<T>&, const mriAlignedAllocator<U>&){return false;}
+
+typedef vector<double,mriAlignedAllocator<double> > mriAlignedDoubleVec;
+
+// ===================================
+// STRUCTURE-OF-ARRAYS CELL FIELD DATA
+// ===================================
+// Writers of conc, vx, vy and vz must stamp a new version when they are
+// done, either with an mriCellWriteGuard or by calling markModified().
+// Caches keyed on the version (fluid mask, derivatives) are otherwise
+// stale. Builds with MRI_DEBUG check the invariant when a cache is reused.
+class mriCellData{
+  public:
+    // Concentration
+    mriAlignedDoubleVec conc;
+    // Velocity Components
+    mriAlignedDoubleVec vx;
+    mriAlignedDoubleVec vy;
+    mriAlignedDoubleVec vz;
+    // Auxiliary Vector Components (used by filters)
+    mriAlignedDoubleVec auxX;
+    mriAlignedDoubleVec auxY;
+    mriAlignedDoubleVec auxZ;
+
+    // Modification stamp, used to invalidate cached data (fluid mask)
+    // Stamps are unique across all instances so swapped storage is detected,
+    // scans are read on several threads so the counter is atomic
+    unsigned long version;
+    static std::atomic<unsigned long> versionCounter;
+
+    // Constructor
+    mriCellData(){markModified();}
+    mriCellData(int totCells);
+
+    // Size
+    size_t size() const{return conc.size();}
+    bool empty() const{return conc.empty();}
+    void resize(int totCells);
+    void clear();
+
+    // Component Access
+    double* velocity(int dim){
+      return (dim == 0) ? vx.data() : ((dim == 1) ? vy.data() : vz.data());
+    }
+    const double* velocity(int dim) const{
+      return (dim == 0) ? vx.data() : ((dim == 1) ? vy.data() : vz.data());
+    }
+    double* aux(int dim){
+      return (dim == 0) ? auxX.data() : ((dim == 1) ? auxY.data() : auxZ.data());
+    }
+    double* quantity(int qtyID);
+    const double* quantity(int qtyID) const;
+
+    // Per-cell Access
+    double getQuantity(int cell, int qtyID) const{
+      return quantity(qtyID)[cell];
+    }
+    void setQuantity(int cell, int qtyID, double value){
+      quantity(qtyID)[cell] = value;
+    }
+    double getVelocityModule(int cell) const{
+      return sqrt(vx[cell]*vx[cell] + vy[cell]*vy[cell] + vz[cell]*vz[cell]);
+    }
+
+    // Must be called after writing to conc, vx, vy or vz
+    void markModified(){
+      version = versionCounter.fetch_add(1) + 1;
+#ifdef MRI_DEBUG
+      columnsHash = evalColumnsHash();
+#endif
+    }
+    // Throws if the columns changed since the last stamp, MRI_DEBUG only
+    void checkVersion() const;
+
+    // Bulk Operations
+    void copyAuxToVelocity();
+    double getMaxVelocityModule() const;
+
+  private:
+#ifdef MRI_DEBUG
+    unsigned long columnsHash;
+    unsigned long evalColumnsHash() const;
+#endif
+};
+
+// ===============================
+// SCOPED WRITE TO THE CELL FIELDS
+// ===============================
+// Stamps a new version of the cells when it goes out of scope, also when
+// the writes are interrupted by an exception
+class mriCellWriteGuard{
   public:
-    double concentration;
-    mriDoubleVec velocity;
-    mriDoubleVec auxVector;
-    // Constructor and Destructor
-    mriCell();
-    virtual ~mriCell();
-    // Member Functions
-    double getQuantity(int qtyID);
-    void   setQuantity(int qtyID, double value);
+    explicit mriCellWriteGuard(mriCellData& cells):cells(cells){}
+    ~mriCellWriteGuard(){cells.markModified();}
+  private:
+    mriCellData& cells;
+    mriCellWriteGuard(const mriCellWriteGuard&);
+    mriCellWriteGuard& operator=(const mriCellWriteGuard&);
 };
 
 #endif // MRICELL_H
@@ -325,43 +325,36 @@ void mriCommunicator::passString(string& msg){
 // ==============
 // PASS CELL DATA
 // ==============
-void mriCommunicator::passCellData(int& totalCellPoints,vector<mriCell>& cellPoints){
-  mriDoubleMat storeMat;
-  mriDoubleVec temp;  
-  if(currProc == 0){
-    temp.resize(7);
-    // Create Matrices
-    for(size_t loopA=0;loopA<cellPoints.size();loopA++){
-      //printf("PASSING CELLS: %d\n",loopA);
-      temp[0] = cellPoints[loopA].concentration;
-      temp[1] = cellPoints[loopA].velocity[0];
-      temp[2] = cellPoints[loopA].velocity[1];
-      temp[3] = cellPoints[loopA].velocity[2];
-      //printf("BEFORE STORE_PUSH\n");
-      storeMat.push_back(temp);
-      //printf("AFTER STORE_PUSH\n");
-    }
-  }
-
-  // Pass Storage Matrix to other Processes
-  passStdDoubleMatrix(storeMat);
-
-  // Rebuild Cell Data in other processes
-  if(currProc != 0){
-    totalCellPoints = storeMat.size();
-    // Resize
-    cellPoints.resize(totalCellPoints);
-    // Create Matrices
-    for(int loopA=0;loopA<totalCellPoints;loopA++){
-      cellPoints[loopA].concentration = storeMat[loopA][0];
-      cellPoints[loopA].velocity[0] = storeMat[loopA][1];
-      cellPoints[loopA].velocity[1] = storeMat[loopA][2];
-      cellPoints[loopA].velocity[2] = storeMat[loopA][3];
+void mriCommunicator::passCellData(int& totalCellPoints,mriCellData& cellPoints){
+  int source = 0;
+  int tag = 0;
+  int mpiError = 0;
+  int colSize = 0;
+  MPI_Status status;
+  // Pass the field columns directly from the contiguous storage
+  for(int loopA=0;loopA<4;loopA++){
+    if(currProc == 0){
+      double* column = (loopA == 0) ? cellPoints.conc.data() : cellPoints.velocity(loopA-1);
+      colSize = cellPoints.size();
+      for(int loopDest=1;loopDest<totProc;loopDest++){
+        mpiError = MPI_Send(column,colSize,MPI_DOUBLE,loopDest,tag,mpiComm);
+        mriUtils::checkMpiError(mpiError);
+      }
+    }else{
+      // Probe Column Length
+      mpiError = MPI_Probe(source,tag,mpiComm,&status);
+      mriUtils::checkMpiError(mpiError);
+      mpiError = MPI_Get_count(&status,MPI_DOUBLE,&colSize);
+      mriUtils::checkMpiError(mpiError);
+      // Resize on first column
+      if(loopA == 0){
+        totalCellPoints = colSize;
+        cellPoints.clear();
+        cellPoints.resize(totalCellPoints);
+      }
+      double* column = (loopA == 0) ? cellPoints.conc.data() : cellPoints.velocity(loopA-1);
+      mpiError = MPI_Recv(column,colSize,MPI_DOUBLE,source,tag,mpiComm,&status);
+      mriUtils::checkMpiError(mpiError);
     }
   }
 }
-
-
-
-
-
@@ -26,7 +26,7 @@ public:
   virtual ~mriCommunicator();
 
   // PASS CELL DATA
-  void passCellData(int& totalCellPoints,vector<mriCell>& cellPoints);
+  void passCellData(int& totalCellPoints,mriCellData& cellPoints);
 
   // SEND AND RECEIVE STD MATRICES AND VECTORS
   // Int Mat
@@ -95,10 +95,19 @@
   const int kMeanFilter     = 1;
   const int kGaussianFilter = 2;
 
+  // Region Tagging
+  const int kRegionFluid      = 0;
+  const int kRegionBoundary   = 1;
+  const int kRegionVortexCore = 2;
+
   // Types of inputs
   const int kInputVTK = 0;
   const int kInputPLT = 1;
 
+  // Face and Edge Numbering
+  const int kOrderingFirstSeen = 0;
+  const int kOrderingMorton    = 1;
+
   // Aternative Typedefs
   typedef const int mriDirection;
   typedef const int mriTemplateType;
@@ -0,0 +1,390 @@
+#include <math.h>
+#include <algorithm>
+#include "mriDerivatives.h"
+#include "mriTopology.h"
+#include "mriScan.h"
+#include "mriParallel.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriVelocityDerivs::mriVelocityDerivs(){
+  isValid = false;
+  cellVersion = 0;
+  maskVersion = 0;
+  geometryVersion = 0;
+  derivTopology = NULL;
+}
+
+// ===============================================
+// CHECK IF CACHED DERIVATIVES ARE STILL APPLICABLE
+// ===============================================
+bool mriVelocityDerivs::isCurrent(const mriCellData& cells, mriTopology* topology, const mriFluidMask& mask) const{
+  // A stale stamp would silently reuse data of the old columns
+  if(isValid && (cellVersion == cells.version)){
+    cells.checkVersion();
+  }
+  return isValid &&
+         (cellVersion == cells.version) &&
+         (maskVersion == mask.version) &&
+         (derivTopology == topology) &&
+         (geometryVersion == topology->geometryVersion);
+}
+
+// ===============================================
+// DISTANCES BETWEEN CONSECUTIVE CELL CENTRES
+// ===============================================
+// dist[c] is the distance between the centres of cells c and c+1
+static void getCentreDistances(mriTopology* topology, int dim, mriDoubleVec& dist, bool& isUniform){
+  int totCells = topology->cellTotals[dim];
+  const mriDoubleVec& lengths = topology->cellLengths[dim];
+  dist.assign(totCells > 1 ? totCells - 1 : 0,0.0);
+  isUniform = true;
+  for(int loopA=0;loopA<(int)dist.size();loopA++){
+    dist[loopA] = 0.5*(lengths[loopA] + lengths[loopA+1]);
+    isUniform = isUniform && (dist[loopA] == dist[0]);
+  }
+}
+
+// ==================================================
+// SCALAR STENCIL FOR BOUNDARY AND MASKED CELLS
+// ==================================================
+// One-sided Euler formulas where a neighbour is missing, central otherwise
+template<int kDerivOrder>
+static void evalCellStencil(const double* v, double* d1, double* d2, int cell, int stride, int coord,
+                            const double* dist, bool hasMinus, bool hasPlus, bool hasMinusMinus, bool hasPlusPlus){
+  double deltaMinus      = hasMinus      ? dist[coord-1] : 0.0;
+  double deltaPlus       = hasPlus       ? dist[coord]   : 0.0;
+  double deltaMinusMinus = hasMinusMinus ? dist[coord-2] : 0.0;
+  double deltaPlusPlus   = hasPlusPlus   ? dist[coord+1] : 0.0;
+  double vC  = v[cell];
+  double vM  = hasMinus      ? v[cell - stride]   : 0.0;
+  double vP  = hasPlus       ? v[cell + stride]   : 0.0;
+  double vMM = hasMinusMinus ? v[cell - 2*stride] : 0.0;
+  double vPP = hasPlusPlus   ? v[cell + 2*stride] : 0.0;
+  if(!hasMinus){
+    // Simple Euler Formula
+    d1[cell] = (fabs(deltaPlus) > kMathZero) ? (vP - vC)/deltaPlus : 0.0;
+    if(kDerivOrder > 1){
+      d2[cell] = (hasPlus && hasPlusPlus) ? (vC - 2.0*vP + vPP)/(deltaPlus*deltaPlusPlus) : 0.0;
+    }
+  }else if(!hasPlus){
+    // Simple Euler Formula
+    d1[cell] = (fabs(deltaMinus) > kMathZero) ? (vC - vM)/deltaMinus : 0.0;
+    if(kDerivOrder > 1){
+      d2[cell] = hasMinusMinus ? (vMM - 2.0*vM + vC)/(deltaMinus*deltaMinusMinus) : 0.0;
+    }
+  }else{
+    // Central Difference Formula: CAREFULL: ONLY FIRST ORDER IF GRID SPACING VARIES SIGNIFICANTLY
+    d1[cell] = ((deltaPlus + deltaMinus) > kMathZero) ? (vP - vM)/(deltaPlus + deltaMinus) : 0.0;
+    if(kDerivOrder > 1){
+      d2[cell] = (vP - 2.0*vC + vM)/(deltaPlus*deltaMinus);
+    }
+  }
+}
+
+// ================================================
+// CENTRAL DIFFERENCES ON A RUN OF INTERIOR CELLS
+// ================================================
+// The run is contiguous in memory and every cell has both neighbours
+// along the current direction, so the loop has no branches on the mask
+// and is vectorized by the compiler. With uniform spacing the distances
+// are the same for every cell of the run, otherwise distMinus and
+// distPlus are indexed together with the cells.
+template<int kDerivOrder, bool kUniformSpacing>
+static void evalInteriorRun(const double* v, double* d1, double* d2, int runLength, int stride,
+                            const double* distMinus, const double* distPlus){
+  double deltaMinus = distMinus[0];
+  double deltaPlus  = distPlus[0];
+  double deltaSum   = deltaPlus + deltaMinus;
+  double deltaProd  = deltaPlus*deltaMinus;
+  if(kUniformSpacing && (deltaSum <= kMathZero)){
+    for(int loopA=0;loopA<runLength;loopA++){
+      d1[loopA] = 0.0;
+    }
+  }else if(kUniformSpacing){
+    for(int loopA=0;loopA<runLength;loopA++){
+      d1[loopA] = (v[loopA + stride] - v[loopA - stride])/deltaSum;
+    }
+  }else{
+    // Degenerate spacing is checked up front to keep the division loop branch-free
+    double minSum = deltaSum;
+    for(int loopA=0;loopA<runLength;loopA++){
+      minSum = fmin(minSum,distPlus[loopA] + distMinus[loopA]);
+    }
+    if(minSum > kMathZero){
+      for(int loopA=0;loopA<runLength;loopA++){
+        d1[loopA] = (v[loopA + stride] - v[loopA - stride])/(distPlus[loopA] + distMinus[loopA]);
+      }
+    }else{
+      for(int loopA=0;loopA<runLength;loopA++){
+        deltaSum = distPlus[loopA] + distMinus[loopA];
+        d1[loopA] = (deltaSum > kMathZero) ? (v[loopA + stride] - v[loopA - stride])/deltaSum : 0.0;
+      }
+    }
+  }
+  if(kDerivOrder > 1){
+    if(kUniformSpacing){
+      for(int loopA=0;loopA<runLength;loopA++){
+        d2[loopA] = (v[loopA + stride] - 2.0*v[loopA] + v[loopA - stride])/deltaProd;
+      }
+    }else{
+      for(int loopA=0;loopA<runLength;loopA++){
+        d2[loopA] = (v[loopA + stride] - 2.0*v[loopA] + v[loopA - stride])/(distPlus[loopA]*distMinus[loopA]);
+      }
+    }
+  }
+}
+
+// =================================================
+// EVAL DERIVATIVES FOR ALL CELLS OF THE SCAN
+// =================================================
+// Rows along x are split into runs of interior cells, with fluid
+// neighbours on all six faces, and peeled cells at the boundary of the
+// fluid region. Runs use the branch-free central kernel, peeled cells
+// use the one-sided scalar stencil. Derivatives outside the fluid are zero.
+template<int kDerivOrder>
+static void evalAllDerivs(const mriCellData& cells, mriTopology* topology, const mriFluidMask& mask,
+                          mriAlignedDoubleVec* first, mriAlignedDoubleVec* second){
+  int nx = topology->cellTotals[0];
+  int ny = topology->cellTotals[1];
+  int nz = topology->cellTotals[2];
+  int stride[3] = {1,nx,nx*ny};
+  const double* vel[3] = {cells.vx.data(),cells.vy.data(),cells.vz.data()};
+
+  // Centre distances along each axis
+  mriDoubleVec dist[3];
+  bool isUniform[3];
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    getCentreDistances(topology,loopA,dist[loopA],isUniform[loopA]);
+  }
+
+  // Cells with all six face neighbours in the fluid
+  unsigned short interiorBits = kMaskFluid;
+  for(int loopA=0;loopA<2*kNumberOfDimensions;loopA++){
+    interiorBits |= maskNeighbourBit(loopA);
+  }
+
+  // Rows along x are independent, each block of rows goes to one thread
+  int rowsPerBlock = std::max(1,kParallelBlockSize/nx);
+  mriParallel::parallelFor(ny*nz,rowsPerBlock,[&](int /*thread*/,int beginRow,int endRow){
+    int coords[3] = {0,0,0};
+    for(int loopRow=beginRow;loopRow<endRow;loopRow++){
+      coords[1] = loopRow % ny;
+      coords[2] = loopRow / ny;
+      int rowStart = coords[2]*stride[2] + coords[1]*stride[1];
+      coords[0] = 0;
+      while(coords[0] < nx){
+        int currCell = rowStart + coords[0];
+
+        // Interior run
+        int runLength = 0;
+        while((coords[0] + runLength < nx) && ((mask.bits[currCell + runLength] & interiorBits) == interiorBits)){
+          runLength++;
+        }
+        if(runLength > 0){
+          for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+            // Along x distances change with the cell, along y and z they are fixed for the row
+            int distIdx = (loopA == 0) ? coords[0] : coords[loopA];
+            const double* distMinus = dist[loopA].data() + distIdx - 1;
+            const double* distPlus  = dist[loopA].data() + distIdx;
+            bool runUniform = (loopA > 0) || isUniform[0];
+            for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+              const double* v = vel[loopB] + currCell;
+              double* d1 = first[loopA*3 + loopB].data() + currCell;
+              double* d2 = second[loopA*3 + loopB].data() + currCell;
+              if(runUniform){
+                evalInteriorRun<kDerivOrder,true>(v,d1,d2,runLength,stride[loopA],distMinus,distPlus);
+              }else{
+                evalInteriorRun<kDerivOrder,false>(v,d1,d2,runLength,stride[loopA],distMinus,distPlus);
+              }
+            }
+          }
+          coords[0] += runLength;
+          continue;
+        }
+
+        // Peeled cell
+        if(mask.isFluid(currCell)){
+          for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+            // Plus face is 2*loopA, minus face is 2*loopA+1
+            bool hasMinus      = mask.hasNeighbour(currCell,2*loopA+1);
+            bool hasPlus       = mask.hasNeighbour(currCell,2*loopA);
+            bool hasMinusMinus = mask.hasSecondNeighbour(currCell,2*loopA+1);
+            bool hasPlusPlus   = mask.hasSecondNeighbour(currCell,2*loopA);
+            for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+              evalCellStencil<kDerivOrder>(vel[loopB],first[loopA*3 + loopB].data(),second[loopA*3 + loopB].data(),
+                                           currCell,stride[loopA],coords[loopA],dist[loopA].data(),
+                                           hasMinus,hasPlus,hasMinusMinus,hasPlusPlus);
+            }
+          }
+        }
+        coords[0]++;
+      }
+    }
+  });
+}
+
+// =================================================
+// EVAL FIRST AND SECOND DERIVATIVES FOR ALL CELLS
+// =================================================
+void mriVelocityDerivs::build(const mriCellData& cells, mriTopology* topology, const mriFluidMask& mask){
+  int totCells = topology->totalCells;
+  for(int loopA=0;loopA<kTotDerivComponents;loopA++){
+    first[loopA].assign(totCells,0.0);
+    second[loopA].assign(totCells,0.0);
+  }
+
+  evalAllDerivs<2>(cells,topology,mask,first,second);
+
+  // Store Key
+  isValid = true;
+  cellVersion = cells.version;
+  maskVersion = mask.version;
+  derivTopology = topology;
+  geometryVersion = topology->geometryVersion;
+}
+
+// =====================================
+// COPY DERIVATIVES OF A CELL TO MATRICES
+// =====================================
+void mriVelocityDerivs::getDerivs(int cell, mriDoubleMat& firstDerivs, mriDoubleMat& secondDerivs) const{
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      firstDerivs[loopA][loopB] = first[loopA*3 + loopB][cell];
+      secondDerivs[loopA][loopB] = second[loopA*3 + loopB][cell];
+    }
+  }
+}
+
+// ==================================
+// TIME DIFFERENCE SCHEMES FOR A SCAN
+// ==================================
+const int kTimeSchemeNone          = 0;
+const int kTimeSchemeEuler         = 1;
+const int kTimeSchemeCentral       = 2;
+const int kTimeSchemeParabolaFirst = 3;
+const int kTimeSchemeParabolaLast  = 4;
+
+// Central difference from the previous and next scan, nonuniform steps
+static void evalCentralTimePass(const double* prev, const double* curr, const double* next,
+                                double deltaT1, double deltaT2, double* res, int begin, int end){
+  for(int loopA=begin;loopA<end;loopA++){
+    res[loopA] = (curr[loopA] - prev[loopA])/(2.0*deltaT1) + (next[loopA] - curr[loopA])/(2.0*deltaT2);
+  }
+}
+
+// Parabola through three consecutive scans, slope at the first or last one
+static void evalParabolaTimePass(const double* y1, const double* y2, const double* y3,
+                                 double h1, double h2, bool isFirstPoint, double* res, int begin, int end){
+  double ratio = h2/h1;
+  double bDen = (h2*h2)/(h1) + h2;
+  double aDen = h1*h1;
+  double bValue = 0.0;
+  double aValue = 0.0;
+  for(int loopA=begin;loopA<end;loopA++){
+    bValue = ((y3[loopA]-y2[loopA])-(y1[loopA]-y2[loopA])*ratio*ratio)/bDen;
+    aValue = (y1[loopA]-y2[loopA]+bValue*h1)/aDen;
+    res[loopA] = isFirstPoint ? (bValue - 2.0*aValue*h1) : (bValue + 2.0*aValue*h2);
+  }
+}
+
+// Simple difference between two scans
+static void evalEulerTimePass(const double* curr, const double* next, double deltaT, double* res, int begin, int end){
+  for(int loopA=begin;loopA<end;loopA++){
+    res[loopA] = (next[loopA] - curr[loopA])/(deltaT);
+  }
+}
+
+// ================================
+// EVAL TIME DERIVATIVES FOR A SCAN
+// ================================
+void mriTimeDerivs::eval(const vector<mriScan*>& sequence, int currentScan, bool isCyclic){
+  int totScans = sequence.size();
+  int totCells = sequence[currentScan]->topology->totalCells;
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    dvdt[loopA].resize(totCells);
+  }
+
+  // Choose the scheme and the window of scans
+  int scheme = kTimeSchemeNone;
+  int window[3] = {currentScan,currentScan,currentScan};
+  double deltaT1 = 0.0;
+  double deltaT2 = 0.0;
+  bool isFirstScan = (currentScan == 0);
+  bool isLastScan = (currentScan == (totScans-1));
+  if(totScans < 2){
+    scheme = kTimeSchemeNone;
+  }else if(isFirstScan && isCyclic){
+    // Wrap to the last scan, assume same time step
+    scheme = kTimeSchemeCentral;
+    window[0] = totScans-1; window[1] = currentScan; window[2] = currentScan+1;
+    deltaT2 = sequence[currentScan+1]->scanTime - sequence[currentScan]->scanTime;
+    deltaT1 = deltaT2;
+  }else if(isFirstScan && (totScans > 2)){
+    scheme = kTimeSchemeParabolaFirst;
+    window[0] = currentScan; window[1] = currentScan+1; window[2] = currentScan+2;
+    deltaT1 = sequence[currentScan+1]->scanTime - sequence[currentScan]->scanTime;
+    deltaT2 = sequence[currentScan+2]->scanTime - sequence[currentScan+1]->scanTime;
+  }else if(isFirstScan){
+    scheme = kTimeSchemeEuler;
+    window[0] = currentScan; window[1] = currentScan+1;
+    deltaT1 = sequence[currentScan+1]->scanTime - sequence[currentScan]->scanTime;
+  }else if(isLastScan && isCyclic){
+    // Wrap to the first scan, assume same time step
+    scheme = kTimeSchemeCentral;
+    window[0] = currentScan-1; window[1] = currentScan; window[2] = 0;
+    deltaT1 = sequence[currentScan]->scanTime - sequence[currentScan-1]->scanTime;
+    deltaT2 = deltaT1;
+  }else if(isLastScan && (totScans > 2)){
+    scheme = kTimeSchemeParabolaLast;
+    window[0] = currentScan-2; window[1] = currentScan-1; window[2] = currentScan;
+    deltaT2 = sequence[currentScan]->scanTime - sequence[currentScan-1]->scanTime;
+    deltaT1 = sequence[currentScan-1]->scanTime - sequence[currentScan-2]->scanTime;
+  }else if(isLastScan){
+    scheme = kTimeSchemeEuler;
+    window[0] = currentScan-1; window[1] = currentScan;
+    deltaT1 = sequence[currentScan]->scanTime - sequence[currentScan-1]->scanTime;
+  }else{
+    scheme = kTimeSchemeCentral;
+    window[0] = currentScan-1; window[1] = currentScan; window[2] = currentScan+1;
+    deltaT1 = sequence[currentScan]->scanTime - sequence[currentScan-1]->scanTime;
+    deltaT2 = sequence[currentScan+1]->scanTime - sequence[currentScan]->scanTime;
+  }
+
+  // Whole-scan passes, one velocity component at a time
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+      double* res = dvdt[loopA].data();
+      const double* v0 = sequence[window[0]]->cells.velocity(loopA);
+      const double* v1 = sequence[window[1]]->cells.velocity(loopA);
+      const double* v2 = sequence[window[2]]->cells.velocity(loopA);
+      switch(scheme){
+        case kTimeSchemeNone:
+          std::fill(res + begin,res + end,0.0);
+          break;
+        case kTimeSchemeEuler:
+          evalEulerTimePass(v0,v1,deltaT1,res,begin,end);
+          break;
+        case kTimeSchemeCentral:
+          evalCentralTimePass(v0,v1,v2,deltaT1,deltaT2,res,begin,end);
+          break;
+        case kTimeSchemeParabolaFirst:
+          evalParabolaTimePass(v0,v1,v2,deltaT1,deltaT2,true,res,begin,end);
+          break;
+        case kTimeSchemeParabolaLast:
+          evalParabolaTimePass(v0,v1,v2,deltaT1,deltaT2,false,res,begin,end);
+          break;
+      }
+    }
+  });
+}
+
+// ======================================
+// COPY TIME DERIVATIVES OF A CELL TO VECTOR
+// ======================================
+void mriTimeDerivs::getDerivs(int cell, mriDoubleVec& timeDeriv) const{
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    timeDeriv[loopA] = dvdt[loopA][cell];
+  }
+}
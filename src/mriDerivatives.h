@@ -0,0 +1,69 @@
+#ifndef MRIDERIVATIVES_H
+#define MRIDERIVATIVES_H
+
+# include "mriTypes.h"
+# include "mriCell.h"
+# include "mriConstants.h"
+# include "mriFluidMask.h"
+
+class mriTopology;
+class mriScan;
+
+using namespace std;
+
+// Total components of a 3x3 derivative tensor
+const int kTotDerivComponents = 9;
+
+// ==============================================
+// CACHED VELOCITY DERIVATIVES FOR ALL SCAN CELLS
+// ==============================================
+// Column (dim*3 + comp) holds d(v_comp)/d(x_dim), the same layout
+// as the firstDerivs/secondDerivs matrices of evalSpaceDerivs
+class mriVelocityDerivs{
+  public:
+    // DATA MEMBERS
+    mriAlignedDoubleVec first[kTotDerivComponents];
+    mriAlignedDoubleVec second[kTotDerivComponents];
+
+    // CONSTRUCTOR
+    mriVelocityDerivs();
+
+    // MEMBER FUNCTIONS
+    bool isCurrent(const mriCellData& cells, mriTopology* topology, const mriFluidMask& mask) const;
+    void build(const mriCellData& cells, mriTopology* topology, const mriFluidMask& mask);
+    void invalidate(){isValid = false;}
+
+    // QUERIES
+    double getFirst(int cell, int dim, int comp) const{return first[dim*3 + comp][cell];}
+    double getSecond(int cell, int dim, int comp) const{return second[dim*3 + comp][cell];}
+    void   getDerivs(int cell, mriDoubleMat& firstDerivs, mriDoubleMat& secondDerivs) const;
+
+  private:
+    // Key of the cached derivatives
+    bool isValid;
+    unsigned long cellVersion;
+    unsigned long maskVersion;
+    unsigned long geometryVersion;
+    mriTopology* derivTopology;
+};
+
+// ====================================
+// VELOCITY TIME DERIVATIVES FOR A SCAN
+// ====================================
+// Computed from a window of up to three scans around the current one,
+// wrapping around the ends of cyclic sequences. The buffers are reused
+// when the same object is evaluated for the next scan.
+class mriTimeDerivs{
+  public:
+    // DATA MEMBERS
+    mriAlignedDoubleVec dvdt[kNumberOfDimensions];
+
+    // MEMBER FUNCTIONS
+    void eval(const vector<mriScan*>& sequence, int currentScan, bool isCyclic);
+
+    // QUERIES
+    double get(int cell, int comp) const{return dvdt[comp][cell];}
+    void   getDerivs(int cell, mriDoubleVec& timeDeriv) const;
+};
+
+#endif // MRIDERIVATIVES_H
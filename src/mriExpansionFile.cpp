@@ -0,0 +1,322 @@
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include "mriExpansionFile.h"
+#include "mriTextFile.h"
+#include "mriConstants.h"
+
+// File header: magic, byte order mark and version
+static const char kExpansionFileMagic[8] = {'M','R','I','E','X','P','\0','\0'};
+static const uint32_t kExpansionByteOrderMark = 0x01020304;
+static const uint32_t kExpansionFileVersion = 1;
+
+// Append raw bytes to a file
+static void writeBytes(FILE* outFile, const string& fileName, const void* data, size_t size){
+  if((size > 0)&&(fwrite(data,1,size,outFile) != size)){
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+}
+
+// Copy bytes from the mapped file and move past them
+static void readBytes(const char*& ptr, const char* end, const string& fileName, void* data, size_t size){
+  if((size_t)(end - ptr) < size){
+    throw mriException(string("ERROR: Truncated expansion file " + fileName + ".\n").c_str());
+  }
+  memcpy(data,ptr,size);
+  ptr += size;
+}
+
+// Values in single or double precision
+static void writeValues(FILE* outFile, const string& fileName, const double* values, size_t totValues, bool isSinglePrecision){
+  if(isSinglePrecision){
+    vector<float> singleValues(values,values + totValues);
+    writeBytes(outFile,fileName,singleValues.data(),totValues*sizeof(float));
+  }else{
+    writeBytes(outFile,fileName,values,totValues*sizeof(double));
+  }
+}
+
+// Read values stored in single or double precision
+static void readValues(const char*& ptr, const char* end, const string& fileName, double* values, size_t totValues, bool isSinglePrecision){
+  if(isSinglePrecision){
+    vector<float> singleValues(totValues);
+    readBytes(ptr,end,fileName,singleValues.data(),totValues*sizeof(float));
+    std::copy(singleValues.begin(),singleValues.end(),values);
+  }else{
+    readBytes(ptr,end,fileName,values,totValues*sizeof(double));
+  }
+}
+
+// =======================
+// WRITE TEXT COEFFICIENTS
+// =======================
+static void writeTextExpansionFile(FILE* fid, const mriExpansionFileData& data){
+  // WRITE TOTAL CELLS
+  fprintf(fid,"%15d %15d %15d\n",data.cellTotals[0],data.cellTotals[1],data.cellTotals[2]);
+
+  // WRITE CELL LENGTHS X, Y AND Z
+  for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+    for(int loopA=0;loopA<data.cellTotals[loopB];loopA++){
+      fprintf(fid,"%15.6e\n",data.cellLengths[loopB][loopA]);
+    }
+  }
+
+  // MIN DOMAIN SIZE
+  fprintf(fid,"%15.6e %15.6e %15.6e\n",data.domainSizeMin[0],data.domainSizeMin[1],data.domainSizeMin[2]);
+  // MAX DOMAIN SIZE
+  fprintf(fid,"%15.6e %15.6e %15.6e\n",data.domainSizeMax[0],data.domainSizeMax[1],data.domainSizeMax[2]);
+
+  // WRITE EXPANSION COEFFICIENTS
+  // Write Constant Flux Components
+  for(int loopA=0;loopA<3;loopA++){
+    fprintf(fid,"%15.6e\n",data.constantFluxCoeff[loopA]);
+  }
+  // Write Vortex Component
+  for(size_t loopA=0;loopA<data.vortexCoeff.size();loopA++){
+    fprintf(fid,"%15.6e\n",data.vortexCoeff[loopA]);
+  }
+}
+
+// =========================
+// WRITE BINARY COEFFICIENTS
+// =========================
+// Header, layout, grid and constant flux coefficients, then the vortex
+// coefficients as one dense block or as (index,value) pairs
+static void writeBinaryExpansionFile(FILE* fid, const string& fileName, const mriExpansionFileData& data, const mriExpansionFileFormat& format){
+  writeBytes(fid,fileName,kExpansionFileMagic,sizeof(kExpansionFileMagic));
+  writeBytes(fid,fileName,&kExpansionByteOrderMark,sizeof(uint32_t));
+  writeBytes(fid,fileName,&kExpansionFileVersion,sizeof(uint32_t));
+  int32_t layout[3] = {format.layout,format.isSinglePrecision ? 1 : 0,format.isDeltaEncoded ? 1 : 0};
+  writeBytes(fid,fileName,layout,sizeof(layout));
+
+  // Grid
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    int32_t total = data.cellTotals[loopA];
+    writeBytes(fid,fileName,&total,sizeof(int32_t));
+  }
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    writeBytes(fid,fileName,data.cellLengths[loopA].data(),data.cellTotals[loopA]*sizeof(double));
+  }
+  writeBytes(fid,fileName,data.domainSizeMin.data(),3*sizeof(double));
+  writeBytes(fid,fileName,data.domainSizeMax.data(),3*sizeof(double));
+
+  // Coefficients
+  writeBytes(fid,fileName,data.constantFluxCoeff.data(),3*sizeof(double));
+  int64_t totVortices = data.vortexCoeff.size();
+  writeBytes(fid,fileName,&totVortices,sizeof(int64_t));
+  if(format.layout == kExpansionFileDense){
+    writeValues(fid,fileName,data.vortexCoeff.data(),totVortices,format.isSinglePrecision);
+    return;
+  }
+
+  // Sparse: stored values, then their indices and values
+  mriDoubleVec values;
+  vector<uint32_t> indices;
+  vector<unsigned char> deltas;
+  uint32_t prevIndex = 0;
+  for(int64_t loopA=0;loopA<totVortices;loopA++){
+    if(fabs(data.vortexCoeff[loopA]) <= format.tolerance){
+      continue;
+    }
+    values.push_back(data.vortexCoeff[loopA]);
+    if(format.isDeltaEncoded){
+      // Seven bits per byte, the high bit marks that more bytes follow
+      uint32_t delta = (uint32_t)loopA - prevIndex;
+      while(delta >= 0x80){
+        deltas.push_back((unsigned char)((delta & 0x7F) | 0x80));
+        delta >>= 7;
+      }
+      deltas.push_back((unsigned char)delta);
+      prevIndex = (uint32_t)loopA;
+    }else{
+      indices.push_back((uint32_t)loopA);
+    }
+  }
+  int64_t totStored = values.size();
+  writeBytes(fid,fileName,&totStored,sizeof(int64_t));
+  if(format.isDeltaEncoded){
+    int64_t totDeltaBytes = deltas.size();
+    writeBytes(fid,fileName,&totDeltaBytes,sizeof(int64_t));
+    writeBytes(fid,fileName,deltas.data(),deltas.size());
+  }else{
+    writeBytes(fid,fileName,indices.data(),indices.size()*sizeof(uint32_t));
+  }
+  writeValues(fid,fileName,values.data(),totStored,format.isSinglePrecision);
+}
+
+// ============================
+// WRITE EXPANSION COEFFICIENTS
+// ============================
+void writeExpansionCoeffFile(string fileName, const mriExpansionFileData& data, const mriExpansionFileFormat& format){
+  // Open Output File
+  FILE* fid = fopen(fileName.c_str(),(format.layout == kExpansionFileText) ? "w" : "wb");
+  if(fid == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+  try{
+    if(format.layout == kExpansionFileText){
+      writeTextExpansionFile(fid,data);
+    }else{
+      writeBinaryExpansionFile(fid,fileName,data,format);
+    }
+  }catch(...){
+    fclose(fid);
+    throw;
+  }
+  // Close Output file
+  if(fclose(fid) != 0){
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+}
+
+// ======================
+// READ TEXT COEFFICIENTS
+// ======================
+// All entries are numbers: totals, lengths, limits and coefficients
+static void readTextExpansionFile(const mriMappedFile& file, const string& fileName, mriExpansionFileData& data){
+  mriTextBlock text(file.begin(),file.end());
+  mriDoubleVec values(text.getTotalValues());
+  double* components[1] = {values.data()};
+  text.parse(1,values.size(),components);
+
+  size_t pos = 0;
+  size_t minValues = 3;
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    data.cellTotals[loopA] = (pos < values.size()) ? (int)values[pos] : 0;
+    pos++;
+  }
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    minValues += std::max(0,data.cellTotals[loopA]);
+  }
+  minValues += 9;
+  if(values.size() < minValues){
+    throw mriException(string("ERROR: Truncated expansion file " + fileName + ".\n").c_str());
+  }
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    data.cellLengths[loopA].assign(values.begin() + pos,values.begin() + pos + data.cellTotals[loopA]);
+    pos += data.cellTotals[loopA];
+  }
+  data.domainSizeMin.assign(values.begin() + pos,values.begin() + pos + 3);
+  data.domainSizeMax.assign(values.begin() + pos + 3,values.begin() + pos + 6);
+  data.constantFluxCoeff.assign(values.begin() + pos + 6,values.begin() + pos + 9);
+  data.vortexCoeff.assign(values.begin() + pos + 9,values.end());
+}
+
+// ========================
+// READ BINARY COEFFICIENTS
+// ========================
+static void readBinaryExpansionFile(const mriMappedFile& file, const string& fileName, mriExpansionFileData& data){
+  const char* ptr = file.begin() + sizeof(kExpansionFileMagic);
+  const char* end = file.end();
+  uint32_t byteOrderMark = 0;
+  uint32_t version = 0;
+  readBytes(ptr,end,fileName,&byteOrderMark,sizeof(uint32_t));
+  readBytes(ptr,end,fileName,&version,sizeof(uint32_t));
+  if(byteOrderMark != kExpansionByteOrderMark){
+    throw mriException(string("ERROR: Expansion file " + fileName + " was written with a different byte order.\n").c_str());
+  }
+  if(version != kExpansionFileVersion){
+    throw mriException(string("ERROR: Unsupported version of expansion file " + fileName + ".\n").c_str());
+  }
+  int32_t layout[3];
+  readBytes(ptr,end,fileName,layout,sizeof(layout));
+  bool isSinglePrecision = (layout[1] != 0);
+  bool isDeltaEncoded = (layout[2] != 0);
+  if((layout[0] != kExpansionFileDense)&&(layout[0] != kExpansionFileSparse)){
+    throw mriException(string("ERROR: Invalid layout of expansion file " + fileName + ".\n").c_str());
+  }
+
+  // Grid
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    int32_t total = 0;
+    readBytes(ptr,end,fileName,&total,sizeof(int32_t));
+    if(total < 0){
+      throw mriException(string("ERROR: Invalid grid in expansion file " + fileName + ".\n").c_str());
+    }
+    data.cellTotals[loopA] = total;
+  }
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    data.cellLengths[loopA].resize(data.cellTotals[loopA]);
+    readBytes(ptr,end,fileName,data.cellLengths[loopA].data(),data.cellTotals[loopA]*sizeof(double));
+  }
+  data.domainSizeMin.resize(3);
+  data.domainSizeMax.resize(3);
+  readBytes(ptr,end,fileName,data.domainSizeMin.data(),3*sizeof(double));
+  readBytes(ptr,end,fileName,data.domainSizeMax.data(),3*sizeof(double));
+
+  // Coefficients
+  data.constantFluxCoeff.resize(3);
+  readBytes(ptr,end,fileName,data.constantFluxCoeff.data(),3*sizeof(double));
+  int64_t totVortices = 0;
+  readBytes(ptr,end,fileName,&totVortices,sizeof(int64_t));
+  if((totVortices < 0)||(totVortices > (int64_t)UINT32_MAX)){
+    throw mriException(string("ERROR: Invalid number of coefficients in expansion file " + fileName + ".\n").c_str());
+  }
+  data.vortexCoeff.assign(totVortices,0.0);
+  if(layout[0] == kExpansionFileDense){
+    readValues(ptr,end,fileName,data.vortexCoeff.data(),totVortices,isSinglePrecision);
+    return;
+  }
+
+  // Sparse
+  int64_t totStored = 0;
+  readBytes(ptr,end,fileName,&totStored,sizeof(int64_t));
+  if((totStored < 0)||(totStored > totVortices)){
+    throw mriException(string("ERROR: Invalid number of coefficients in expansion file " + fileName + ".\n").c_str());
+  }
+  vector<uint32_t> indices(totStored);
+  if(isDeltaEncoded){
+    int64_t totDeltaBytes = 0;
+    readBytes(ptr,end,fileName,&totDeltaBytes,sizeof(int64_t));
+    if((totDeltaBytes < 0)||(totDeltaBytes > end - ptr)){
+      throw mriException(string("ERROR: Truncated expansion file " + fileName + ".\n").c_str());
+    }
+    const unsigned char* curr = (const unsigned char*)ptr;
+    const unsigned char* deltaEnd = curr + totDeltaBytes;
+    uint32_t index = 0;
+    for(int64_t loopA=0;loopA<totStored;loopA++){
+      uint32_t delta = 0;
+      int shift = 0;
+      while(true){
+        if((curr == deltaEnd)||(shift > 28)){
+          throw mriException(string("ERROR: Corrupt indices in expansion file " + fileName + ".\n").c_str());
+        }
+        unsigned char byte = *curr++;
+        delta |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+        if((byte & 0x80) == 0){
+          break;
+        }
+      }
+      index += delta;
+      indices[loopA] = index;
+    }
+    ptr += totDeltaBytes;
+  }else{
+    readBytes(ptr,end,fileName,indices.data(),totStored*sizeof(uint32_t));
+  }
+  mriDoubleVec values(totStored);
+  readValues(ptr,end,fileName,values.data(),totStored,isSinglePrecision);
+  for(int64_t loopA=0;loopA<totStored;loopA++){
+    if(indices[loopA] >= (uint64_t)totVortices){
+      throw mriException(string("ERROR: Corrupt indices in expansion file " + fileName + ".\n").c_str());
+    }
+    data.vortexCoeff[indices[loopA]] = values[loopA];
+  }
+}
+
+// ===========================
+// READ EXPANSION COEFFICIENTS
+// ===========================
+void readExpansionCoeffFile(string fileName, mriExpansionFileData& data){
+  mriMappedFile file(fileName);
+  data.cellTotals.assign(3,0);
+  data.cellLengths.assign(3,mriDoubleVec());
+  bool isBinary = (file.size() >= sizeof(kExpansionFileMagic))&&
+                  (memcmp(file.begin(),kExpansionFileMagic,sizeof(kExpansionFileMagic)) == 0);
+  if(isBinary){
+    readBinaryExpansionFile(file,fileName,data);
+  }else{
+    readTextExpansionFile(file,fileName,data);
+  }
+}
@@ -0,0 +1,50 @@
+#ifndef MRIEXPANSIONFILE_H
+#define MRIEXPANSIONFILE_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Layout of the expansion coefficient files
+const int kExpansionFileText   = 0;
+const int kExpansionFileDense  = 1;
+const int kExpansionFileSparse = 2;
+
+// ==============================
+// HOW EXPANSION FILES ARE STORED
+// ==============================
+struct mriExpansionFileFormat{
+  int layout;
+  // Binary values in single precision
+  bool isSinglePrecision;
+  // Sparse indices stored as variable-length differences
+  bool isDeltaEncoded;
+  // Sparse files skip the vortex coefficients with |value| <= tolerance
+  double tolerance;
+};
+
+// ==================================
+// EXPANSION COEFFICIENTS OF ONE SCAN
+// ==================================
+struct mriExpansionFileData{
+  mriIntVec cellTotals;
+  mriDoubleMat cellLengths;
+  mriDoubleVec domainSizeMin;
+  mriDoubleVec domainSizeMax;
+  mriDoubleVec constantFluxCoeff;
+  // Vortex coefficients in the canonical edge numbering
+  mriDoubleVec vortexCoeff;
+};
+
+// Write text, dense or sparse binary files
+void writeExpansionCoeffFile(string fileName, const mriExpansionFileData& data, const mriExpansionFileFormat& format);
+// Read any layout, binary files are recognized by their header
+void readExpansionCoeffFile(string fileName, mriExpansionFileData& data);
+
+#endif // MRIEXPANSIONFILE_H
@@ -0,0 +1,264 @@
+#include <stdarg.h>
+#include "mriFEMesh.h"
+#include "mriTopology.h"
+
+// File headers: magic, byte order mark and version
+static const char kFEMeshFileMagic[8] = {'M','R','I','F','E','M','\0','\0'};
+static const char kFEFieldFileMagic[8] = {'M','R','I','F','E','F','\0','\0'};
+static const uint32_t kFEByteOrderMark = 0x01020304;
+static const uint32_t kFEFileVersion = 1;
+// Nodes of the hexahedra and of their faces
+static const int kFEElementNodes = 8;
+static const int kFEFaceNodes = 4;
+
+// Append raw bytes to a file
+static void writeBytes(FILE* outFile, const string& fileName, const void* data, size_t size){
+  if((size > 0)&&(fwrite(data,1,size,outFile) != size)){
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+}
+
+// Append a formatted line to a string
+static void printToString(string& text, const char* format, ...){
+  char line[256];
+  va_list args;
+  va_start(args,format);
+  int length = vsnprintf(line,sizeof(line),format,args);
+  va_end(args);
+  if((length < 0)||((size_t)length >= sizeof(line))){
+    throw mriException("ERROR: Invalid format in mriFEMesh.\n");
+  }
+  text.append(line,length);
+}
+
+// Magic, byte order mark and version
+static void writeHeader(FILE* outFile, const string& fileName, const char* magic){
+  writeBytes(outFile,fileName,magic,8);
+  writeBytes(outFile,fileName,&kFEByteOrderMark,sizeof(uint32_t));
+  writeBytes(outFile,fileName,&kFEFileVersion,sizeof(uint32_t));
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriFEMesh::mriFEMesh(mriTopology* topology, const mriFluidMask& fluidMask){
+  this->topology = topology;
+  maskVersion = fluidMask.version;
+  int totAuxNodes = topology->getTotalAuxNodes();
+
+  // Store the fluid cells used to build the mesh
+  fluidCells.resize(topology->totalCells);
+  for(int loopA=0;loopA<topology->totalCells;loopA++){
+    fluidCells[loopA] = fluidMask.isFluid(loopA);
+  }
+
+  // Mark Used Nodes
+  nodeUsageMap.assign(totAuxNodes,-1);
+  for(int loopA=0;loopA<topology->totalCells;loopA++){
+    if(fluidCells[loopA]){
+      for(size_t loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
+        nodeUsageMap[topology->cellConnections[loopA][loopB]] = 1;
+      }
+    }
+  }
+
+  // Renumber Nodes in nodeUsageMap
+  totalNodes = 0;
+  for(int loopA=0;loopA<totAuxNodes;loopA++){
+    if(nodeUsageMap[loopA] > 0){
+      nodeUsageMap[loopA] = totalNodes;
+      totalNodes++;
+    }
+  }
+
+  // Build Element Mapping
+  elUsageMap.assign(topology->totalCells,-1);
+  totalElements = 0;
+  for(int loopA=0;loopA<topology->totalCells;loopA++){
+    if(fluidCells[loopA]){
+      elUsageMap[loopA] = totalElements;
+      totalElements++;
+    }
+  }
+
+  // Faces with a single fluid cell are on the walls
+  int totFaces = topology->faceConnections.size();
+  mriIntVec faceCount(totFaces,0);
+  for(int loopA=0;loopA<topology->totalCells;loopA++){
+    if(fluidCells[loopA]){
+      for(size_t loopB=0;loopB<topology->cellFaces[loopA].size();loopB++){
+        faceCount[topology->cellFaces[loopA][loopB]]++;
+      }
+    }
+  }
+  isFaceOnWalls.resize(totFaces);
+  for(int loopA=0;loopA<totFaces;loopA++){
+    isFaceOnWalls[loopA] = (faceCount[loopA] == 1);
+    if(isFaceOnWalls[loopA]){
+      wallFaces.push_back(loopA);
+      if((topology->faceCells[loopA].size() == 1)||(fluidCells[topology->faceCells[loopA][0]])){
+        wallFaceCells.push_back(topology->faceCells[loopA][0]);
+      }else{
+        wallFaceCells.push_back(topology->faceCells[loopA][1]);
+      }
+    }
+  }
+}
+
+// ===============================
+// CHECK IF THE MESH FITS THE MASK
+// ===============================
+bool mriFEMesh::isCurrent(mriTopology* topology, const mriFluidMask& fluidMask) const{
+  if((this->topology != topology)||(fluidCells.size() != (size_t)topology->totalCells)){
+    return false;
+  }
+  if(fluidMask.version == maskVersion){
+    return true;
+  }
+  // Masks of other scans often select the same cells
+  for(int loopA=0;loopA<topology->totalCells;loopA++){
+    if(fluidCells[loopA] != fluidMask.isFluid(loopA)){
+      return false;
+    }
+  }
+  return true;
+}
+
+// =============
+// GET MESH TEXT
+// =============
+std::shared_ptr<const string> mriFEMesh::getMeshText(){
+  if(meshText){
+    return meshText;
+  }
+  std::shared_ptr<string> text(new string());
+
+  // SAVE NODE COORDS ONLY FOR NODES NUMBERED IN USEDNODEMAP
+  if(topology->totalCells > 0){
+    for(size_t loopA=0;loopA<nodeUsageMap.size();loopA++){
+      if(nodeUsageMap[loopA] > -1){
+        printToString(*text,"NODE %d %19.12e %19.12e %19.12e\n",nodeUsageMap[loopA]+1,
+                      topology->auxNodesCoords[loopA][0],topology->auxNodesCoords[loopA][1],topology->auxNodesCoords[loopA][2]);
+      }
+    }
+
+    // SAVE ELEMENT CONNECTIONS
+    for(int loopA=0;loopA<topology->totalCells;loopA++){
+      if(fluidCells[loopA]){
+        printToString(*text,"ELEMENT HEXA8 %d 1 ",elUsageMap[loopA]+1);
+        for(size_t loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
+          printToString(*text,"%d ",nodeUsageMap[topology->cellConnections[loopA][loopB]] + 1);
+        }
+        printToString(*text,"\n");
+      }
+    }
+  }
+
+  // SAVE ELEMENT DIFFUSIVITY
+  for(int loopA=0;loopA<totalElements;loopA++){
+    printToString(*text,"ELDIFF %d %e %e %e \n",loopA+1,1.0,1.0,1.0);
+  }
+  meshText = text;
+  return meshText;
+}
+
+// =================
+// WRITE BINARY MESH
+// =================
+// Header, totals, node coordinates, element connections and the wall
+// faces as their element and nodes. All numbering starts from zero and the
+// element diffusivity is always one.
+void mriFEMesh::writeBinaryMesh(string fileName, mriAsyncWriter* asyncWriter){
+  std::shared_ptr<mriDoubleVec> coords(new mriDoubleVec(3*totalNodes));
+  for(size_t loopA=0;loopA<nodeUsageMap.size();loopA++){
+    if(nodeUsageMap[loopA] > -1){
+      for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+        (*coords)[3*nodeUsageMap[loopA] + loopB] = topology->auxNodesCoords[loopA][loopB];
+      }
+    }
+  }
+  std::shared_ptr<vector<int32_t> > elements(new vector<int32_t>(kFEElementNodes*totalElements));
+  for(int loopA=0;loopA<topology->totalCells;loopA++){
+    if(fluidCells[loopA]){
+      if(topology->cellConnections[loopA].size() != kFEElementNodes){
+        throw mriException("ERROR: Binary solver export supports only hexahedral cells.\n");
+      }
+      for(int loopB=0;loopB<kFEElementNodes;loopB++){
+        (*elements)[kFEElementNodes*elUsageMap[loopA] + loopB] = nodeUsageMap[topology->cellConnections[loopA][loopB]];
+      }
+    }
+  }
+  int totWallFaces = wallFaces.size();
+  std::shared_ptr<vector<int32_t> > wallElements(new vector<int32_t>(totWallFaces));
+  std::shared_ptr<vector<int32_t> > wallNodes(new vector<int32_t>(kFEFaceNodes*totWallFaces));
+  for(int loopA=0;loopA<totWallFaces;loopA++){
+    const mriIntVec& faceNodes = topology->faceConnections[wallFaces[loopA]];
+    if(faceNodes.size() != kFEFaceNodes){
+      throw mriException("ERROR: Binary solver export supports only quadrilateral faces.\n");
+    }
+    (*wallElements)[loopA] = elUsageMap[wallFaceCells[loopA]];
+    for(int loopB=0;loopB<kFEFaceNodes;loopB++){
+      (*wallNodes)[kFEFaceNodes*loopA + loopB] = nodeUsageMap[faceNodes[loopB]];
+    }
+  }
+  int32_t totals[3] = {totalNodes,totalElements,totWallFaces};
+  meshFileName = fileName;
+
+  runWriteTask(asyncWriter,[=](){
+    FILE* outFile = fopen(fileName.c_str(),"wb");
+    if(outFile == NULL){
+      throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+    }
+    try{
+      writeHeader(outFile,fileName,kFEMeshFileMagic);
+      writeBytes(outFile,fileName,totals,sizeof(totals));
+      writeBytes(outFile,fileName,coords->data(),coords->size()*sizeof(double));
+      writeBytes(outFile,fileName,elements->data(),elements->size()*sizeof(int32_t));
+      writeBytes(outFile,fileName,wallElements->data(),wallElements->size()*sizeof(int32_t));
+      writeBytes(outFile,fileName,wallNodes->data(),wallNodes->size()*sizeof(int32_t));
+    }catch(...){
+      fclose(outFile);
+      throw;
+    }
+    if(fclose(outFile) != 0){
+      throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+    }
+  });
+}
+
+// ===================
+// WRITE FE FIELD FILE
+// ===================
+// Header, problem, name of the mesh file relative to this file, then the
+// element values and the wall face values in the order of the mesh
+void writeFEFieldFile(string fileName, int problem, string meshFileName,
+                      const mriDoubleVec& elementValues, const mriDoubleVec& wallValues,
+                      mriAsyncWriter* asyncWriter){
+  size_t slashPos = meshFileName.find_last_of('/');
+  string meshName = (slashPos == string::npos) ? meshFileName : meshFileName.substr(slashPos + 1);
+  std::shared_ptr<mriDoubleVec> elValues(new mriDoubleVec(elementValues));
+  std::shared_ptr<mriDoubleVec> faceValues(new mriDoubleVec(wallValues));
+
+  runWriteTask(asyncWriter,[=](){
+    FILE* outFile = fopen(fileName.c_str(),"wb");
+    if(outFile == NULL){
+      throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+    }
+    try{
+      writeHeader(outFile,fileName,kFEFieldFileMagic);
+      int32_t info[2] = {problem,(int32_t)meshName.size()};
+      writeBytes(outFile,fileName,info,sizeof(info));
+      writeBytes(outFile,fileName,meshName.data(),meshName.size());
+      int32_t totals[2] = {(int32_t)elValues->size(),(int32_t)faceValues->size()};
+      writeBytes(outFile,fileName,totals,sizeof(totals));
+      writeBytes(outFile,fileName,elValues->data(),elValues->size()*sizeof(double));
+      writeBytes(outFile,fileName,faceValues->data(),faceValues->size()*sizeof(double));
+    }catch(...){
+      fclose(outFile);
+      throw;
+    }
+    if(fclose(outFile) != 0){
+      throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+    }
+  });
+}
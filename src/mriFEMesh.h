@@ -0,0 +1,73 @@
+#ifndef MRIFEMESH_H
+#define MRIFEMESH_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <string>
+# include <vector>
+# include <memory>
+
+# include "mriTypes.h"
+# include "mriException.h"
+# include "mriAsyncWriter.h"
+# include "mriFluidMask.h"
+
+class mriTopology;
+
+using namespace std;
+
+// Format of the finite element solver exports
+const int kFEExportText   = 0;
+const int kFEExportBinary = 1;
+
+// Problems of the binary field files
+const int kFEProblemPPE      = 0;
+const int kFEProblemDistance = 1;
+
+// ==================================
+// MASKED MESH FOR THE SOLVER EXPORTS
+// ==================================
+// Nodes and hexahedra of the fluid cells renumbered from zero, with the
+// faces between the fluid and the rest of the grid. It depends only on the
+// topology and on the fluid cells, so a sequence builds it once and reuses
+// it for all scans sharing the same mask.
+class mriFEMesh{
+  public:
+    // DATA MEMBERS
+    // Mesh node of every aux node and element of every cell, -1 if unused
+    mriIntVec nodeUsageMap;
+    mriIntVec elUsageMap;
+    int totalNodes;
+    int totalElements;
+    // Wall faces in face order and the fluid cell they belong to
+    mriBoolVec isFaceOnWalls;
+    mriIntVec wallFaces;
+    mriIntVec wallFaceCells;
+    // Binary mesh file of this mesh and the export it was written for,
+    // empty until written
+    string meshFileName;
+    string meshFilePrefix;
+
+    // CONSTRUCTOR
+    mriFEMesh(mriTopology* topology, const mriFluidMask& fluidMask);
+
+    // MEMBER FUNCTIONS
+    bool isCurrent(mriTopology* topology, const mriFluidMask& fluidMask) const;
+    // NODE, ELEMENT and ELDIFF lines of the text exports, formatted once
+    std::shared_ptr<const string> getMeshText();
+    void writeBinaryMesh(string fileName, mriAsyncWriter* asyncWriter);
+
+  private:
+    mriTopology* topology;
+    unsigned long maskVersion;
+    vector<bool> fluidCells;
+    std::shared_ptr<const string> meshText;
+};
+
+// Element values and wall face values of one scan, the mesh is stored
+// once in meshFileName
+void writeFEFieldFile(string fileName, int problem, string meshFileName,
+                      const mriDoubleVec& elementValues, const mriDoubleVec& wallValues,
+                      mriAsyncWriter* asyncWriter);
+
+#endif // MRIFEMESH_H
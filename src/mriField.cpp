@@ -0,0 +1,177 @@
+#include "mriField.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriField::mriField(string locName, mriFieldType locType, int totCells){
+  name = locName;
+  type = locType;
+  totComponents = (int)locType;
+  columns.resize(totComponents);
+  for(int loopA=0;loopA<totComponents;loopA++){
+    columns[loopA].assign(totCells,0.0);
+  }
+}
+
+// ===================================
+// EXPAND SYMMETRIC TENSOR TO 3x3 FULL
+// ===================================
+void mriField::getTensor(int cell, double tensor[3][3]) const{
+  if(type != ftSymTensor){
+    throw mriException(string("ERROR: Field " + name + " is not a symmetric tensor in getTensor.\n").c_str());
+  }
+  tensor[0][0] = columns[kSymTensorXX][cell];
+  tensor[0][1] = columns[kSymTensorXY][cell];
+  tensor[0][2] = columns[kSymTensorXZ][cell];
+  tensor[1][0] = columns[kSymTensorXY][cell];
+  tensor[1][1] = columns[kSymTensorYY][cell];
+  tensor[1][2] = columns[kSymTensorYZ][cell];
+  tensor[2][0] = columns[kSymTensorXZ][cell];
+  tensor[2][1] = columns[kSymTensorYZ][cell];
+  tensor[2][2] = columns[kSymTensorZZ][cell];
+}
+
+// ========================================
+// GET COMPONENT NAME FOR TABULAR EXPORTERS
+// ========================================
+string mriField::getComponentName(int c) const{
+  const char* vecSuffix[3] = {"x","y","z"};
+  const char* tensorSuffix[6] = {"xx","xy","xz","yy","yz","zz"};
+  switch(type){
+    case ftScalar:
+      return name;
+    case ftVector:
+      return name + vecSuffix[c];
+    case ftSymTensor:
+      return name + tensorSuffix[c];
+  }
+  return name;
+}
+
+// ===========================
+// COPY CONSTRUCT AND ASSIGN
+// ===========================
+mriFieldRegistry::mriFieldRegistry(const mriFieldRegistry& other){
+  *this = other;
+}
+
+mriFieldRegistry& mriFieldRegistry::operator=(const mriFieldRegistry& other){
+  if(this != &other){
+    clear();
+    for(size_t loopA=0;loopA<other.fields.size();loopA++){
+      fields.push_back(new mriField(*other.fields[loopA]));
+    }
+    fieldIndex = other.fieldIndex;
+  }
+  return *this;
+}
+
+mriFieldRegistry::~mriFieldRegistry(){
+  clear();
+}
+
+// ==============
+// REGISTER FIELD
+// ==============
+mriField& mriFieldRegistry::addField(string name, mriFieldType type, int totCells){
+  map<string,size_t>::iterator it = fieldIndex.find(name);
+  if(it != fieldIndex.end()){
+    // Field already registered: reuse storage if compatible
+    mriField* field = fields[it->second];
+    if((field->type == type)&&(field->size() == totCells)){
+      for(int loopA=0;loopA<field->totComponents;loopA++){
+        std::fill(field->columns[loopA].begin(),field->columns[loopA].end(),0.0);
+      }
+      return *field;
+    }
+    delete field;
+    fields[it->second] = new mriField(name,type,totCells);
+    return *fields[it->second];
+  }
+  fieldIndex[name] = fields.size();
+  fields.push_back(new mriField(name,type,totCells));
+  return *fields.back();
+}
+
+// ============
+// REMOVE FIELD
+// ============
+void mriFieldRegistry::removeField(string name){
+  map<string,size_t>::iterator it = fieldIndex.find(name);
+  if(it == fieldIndex.end()){
+    return;
+  }
+  size_t idx = it->second;
+  delete fields[idx];
+  fields.erase(fields.begin() + idx);
+  // Rebuild Index
+  fieldIndex.clear();
+  for(size_t loopA=0;loopA<fields.size();loopA++){
+    fieldIndex[fields[loopA]->name] = loopA;
+  }
+}
+
+// ==================
+// CLEAR ALL FIELDS
+// ==================
+void mriFieldRegistry::clear(){
+  for(size_t loopA=0;loopA<fields.size();loopA++){
+    delete fields[loopA];
+  }
+  fields.clear();
+  fieldIndex.clear();
+}
+
+// ======
+// LOOKUP
+// ======
+bool mriFieldRegistry::hasField(string name) const{
+  return (fieldIndex.find(name) != fieldIndex.end());
+}
+
+mriField& mriFieldRegistry::getField(string name){
+  map<string,size_t>::iterator it = fieldIndex.find(name);
+  if(it == fieldIndex.end()){
+    throw mriException(string("ERROR: Field " + name + " not found in registry.\n").c_str());
+  }
+  return *fields[it->second];
+}
+
+// ============
+// TYPED VIEWS
+// ============
+template <int N>
+mriFieldView<N> mriFieldRegistry::getView(mriField& field){
+  if(field.totComponents != N){
+    throw mriException(string("ERROR: Invalid type for field " + field.name + ".\n").c_str());
+  }
+  mriFieldView<N> view;
+  for(int loopA=0;loopA<N;loopA++){
+    view.comp[loopA] = field.component(loopA);
+  }
+  return view;
+}
+
+mriScalarView mriFieldRegistry::addScalar(string name, int totCells){
+  return getView<ftScalar>(addField(name,ftScalar,totCells));
+}
+
+mriVectorView mriFieldRegistry::addVector(string name, int totCells){
+  return getView<ftVector>(addField(name,ftVector,totCells));
+}
+
+mriSymTensorView mriFieldRegistry::addSymTensor(string name, int totCells){
+  return getView<ftSymTensor>(addField(name,ftSymTensor,totCells));
+}
+
+mriScalarView mriFieldRegistry::getScalar(string name){
+  return getView<ftScalar>(getField(name));
+}
+
+mriVectorView mriFieldRegistry::getVector(string name){
+  return getView<ftVector>(getField(name));
+}
+
+mriSymTensorView mriFieldRegistry::getSymTensor(string name){
+  return getView<ftSymTensor>(getField(name));
+}
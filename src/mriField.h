@@ -0,0 +1,108 @@
+#ifndef MRIFIELD_H
+#define MRIFIELD_H
+
+# include <map>
+# include <algorithm>
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriCell.h"
+# include "mriException.h"
+
+using namespace std;
+
+// FIELD TYPES (VALUE IS THE NUMBER OF STORED COMPONENTS)
+enum mriFieldType{ftScalar = 1, ftVector = 3, ftSymTensor = 6};
+
+// Symmetric tensor component ordering: xx xy xz yy yz zz
+const int kSymTensorXX = 0;
+const int kSymTensorXY = 1;
+const int kSymTensorXZ = 2;
+const int kSymTensorYY = 3;
+const int kSymTensorYZ = 4;
+const int kSymTensorZZ = 5;
+
+// ===================================
+// TYPED VIEW ON THE COLUMNS OF A FIELD
+// ===================================
+template <int N>
+class mriFieldView{
+  public:
+    double* comp[N];
+    // Component resolved at compile time
+    template <int C>
+    double& at(int cell) const{
+      return comp[C][cell];
+    }
+    // Component resolved at run time
+    double& operator()(int cell, int c) const{
+      return comp[c][cell];
+    }
+};
+typedef mriFieldView<ftScalar>    mriScalarView;
+typedef mriFieldView<ftVector>    mriVectorView;
+typedef mriFieldView<ftSymTensor> mriSymTensorView;
+
+// ==========================
+// NAMED FIELD ON SCAN CELLS
+// ==========================
+class mriField{
+  public:
+    // DATA MEMBERS
+    string name;
+    mriFieldType type;
+    int totComponents;
+    // One aligned column per component
+    vector<mriAlignedDoubleVec> columns;
+
+    // CONSTRUCTOR
+    mriField(string locName, mriFieldType locType, int totCells);
+
+    // MEMBER FUNCTIONS
+    int size() const{return columns[0].size();}
+    double* component(int c){return columns[c].data();}
+    const double* component(int c) const{return columns[c].data();}
+    double getValue(int cell, int c) const{return columns[c][cell];}
+    void getTensor(int cell, double tensor[3][3]) const;
+    string getComponentName(int c) const;
+};
+
+// ==================================
+// REGISTRY OF DERIVED FIELDS ON SCAN
+// ==================================
+class mriFieldRegistry{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    mriFieldRegistry(){}
+    mriFieldRegistry(const mriFieldRegistry& other);
+    mriFieldRegistry& operator=(const mriFieldRegistry& other);
+    ~mriFieldRegistry();
+
+    // REGISTRATION
+    mriField& addField(string name, mriFieldType type, int totCells);
+    void removeField(string name);
+    void clear();
+
+    // LOOKUP
+    size_t size() const{return fields.size();}
+    bool hasField(string name) const;
+    mriField& operator[](size_t idx){return *fields[idx];}
+    const mriField& operator[](size_t idx) const{return *fields[idx];}
+    mriField& getField(string name);
+
+    // TYPED ACCESSORS FOR HOT LOOPS
+    mriScalarView    addScalar(string name, int totCells);
+    mriVectorView    addVector(string name, int totCells);
+    mriSymTensorView addSymTensor(string name, int totCells);
+    mriScalarView    getScalar(string name);
+    mriVectorView    getVector(string name);
+    mriSymTensorView getSymTensor(string name);
+
+  private:
+    vector<mriField*> fields;
+    map<string,size_t> fieldIndex;
+    template <int N> mriFieldView<N> getView(mriField& field);
+};
+
+#endif // MRIFIELD_H
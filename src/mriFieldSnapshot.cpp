@@ -0,0 +1,57 @@
+#include "mriFieldSnapshot.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriFieldSnapshot::mriFieldSnapshot(){
+  totPoints = 0;
+}
+
+// ================
+// WRITE POINT DATA
+// ================
+void mriFieldSnapshot::writePointData(int totPoints){
+  this->totPoints = totPoints;
+}
+
+// =========
+// ADD FIELD
+// =========
+mriFieldSnapshot::snapshotField& mriFieldSnapshot::addField(const string& name, int totComponents){
+  fields.push_back(snapshotField());
+  snapshotField& field = fields.back();
+  field.name = name;
+  field.totComponents = totComponents;
+  field.values.resize(totComponents);
+  for(int loopA=0;loopA<totComponents;loopA++){
+    field.values[loopA].resize(totPoints);
+  }
+  return field;
+}
+
+// =============
+// WRITE SCALARS
+// =============
+void mriFieldSnapshot::writeScalars(const string& name, const double* values){
+  snapshotField& field = addField(name,1);
+  field.values[0].assign(values,values + totPoints);
+}
+
+// =====================
+// WRITE INTEGER SCALARS
+// =====================
+void mriFieldSnapshot::writeScalars(const string& name, const int* values){
+  snapshotField& field = addField(name,1);
+  field.values[0].clear();
+  field.intValues.assign(values,values + totPoints);
+}
+
+// =============
+// WRITE VECTORS
+// =============
+void mriFieldSnapshot::writeVectors(const string& name, const double* x, const double* y, const double* z){
+  snapshotField& field = addField(name,3);
+  field.values[0].assign(x,x + totPoints);
+  field.values[1].assign(y,y + totPoints);
+  field.values[2].assign(z,z + totPoints);
+}
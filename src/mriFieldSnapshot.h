@@ -0,0 +1,88 @@
+#ifndef MRIFIELDSNAPSHOT_H
+#define MRIFIELDSNAPSHOT_H
+
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+
+using namespace std;
+
+// ==================================
+// COPY OF THE POINT FIELDS OF A SCAN
+// ==================================
+// Has the interface of the VTK writers and keeps a copy of every field,
+// tensors are evaluated when they are added. replay() writes the copies
+// later, possibly on the writer thread while the scan is reused.
+class mriFieldSnapshot{
+  public:
+    // CONSTRUCTOR
+    mriFieldSnapshot();
+
+    // MEMBER FUNCTIONS
+    void writePointData(int totPoints);
+    void writeScalars(const string& name, const double* values);
+    void writeScalars(const string& name, const int* values);
+    void writeVectors(const string& name, const double* x, const double* y, const double* z);
+    // getTensor(point,tensor) fills the 3x3 tensor of a point
+    template<typename F> void writeTensors(const string& name, F getTensor);
+    void close(){}
+    // Pass the fields to a writer in the order they were added
+    template<typename W> void replay(W& writer) const;
+
+  private:
+    struct snapshotField{
+      string name;
+      int totComponents;
+      mriDoubleMat values;
+      mriIntVec intValues;
+    };
+    int totPoints;
+    vector<snapshotField> fields;
+    snapshotField& addField(const string& name, int totComponents);
+};
+
+// =============
+// WRITE TENSORS
+// =============
+template<typename F> void mriFieldSnapshot::writeTensors(const string& name, F getTensor){
+  snapshotField& field = addField(name,9);
+  double tensor[3][3];
+  for(int loopA=0;loopA<totPoints;loopA++){
+    getTensor(loopA,tensor);
+    for(int loopB=0;loopB<3;loopB++){
+      for(int loopC=0;loopC<3;loopC++){
+        field.values[loopB*3 + loopC][loopA] = tensor[loopB][loopC];
+      }
+    }
+  }
+}
+
+// =============
+// REPLAY FIELDS
+// =============
+template<typename W> void mriFieldSnapshot::replay(W& writer) const{
+  writer.writePointData(totPoints);
+  for(size_t loopA=0;loopA<fields.size();loopA++){
+    const snapshotField& field = fields[loopA];
+    if(field.totComponents == 9){
+      const mriDoubleMat* values = &field.values;
+      writer.writeTensors(field.name,[values](int point,double tensor[3][3]){
+        for(int loopB=0;loopB<3;loopB++){
+          for(int loopC=0;loopC<3;loopC++){
+            tensor[loopB][loopC] = (*values)[loopB*3 + loopC][point];
+          }
+        }
+      });
+    }else if(field.totComponents == 3){
+      writer.writeVectors(field.name,field.values[0].data(),field.values[1].data(),field.values[2].data());
+    }else if(field.intValues.size() > 0){
+      writer.writeScalars(field.name,field.intValues.data());
+    }else{
+      writer.writeScalars(field.name,field.values[0].data());
+    }
+  }
+  writer.close();
+}
+
+#endif // MRIFIELDSNAPSHOT_H
@@ -0,0 +1,107 @@
+#include "mriFluidMask.h"
+#include "mriTopology.h"
+
+std::atomic<unsigned long> mriFluidMask::versionCounter(0);
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriFluidMask::mriFluidMask(){
+  totalFluidCells = 0;
+  version = 0;
+  isValid = false;
+  cellVersion = 0;
+  maskTopology = NULL;
+  maskQty = kNoQuantity;
+  maskType = 0;
+  maskValue = 0.0;
+}
+
+// ========================================
+// CHECK IF CACHED MASK IS STILL APPLICABLE
+// ========================================
+bool mriFluidMask::isCurrent(const mriCellData& cells, mriTopology* topology, mriThresholdCriteria* threshold) const{
+  // A stale stamp would silently reuse data of the old columns
+  if(isValid && (cellVersion == cells.version)){
+    cells.checkVersion();
+  }
+  return isValid &&
+         (cellVersion == cells.version) &&
+         (maskTopology == topology) &&
+         (bits.size() == (size_t)topology->totalCells) &&
+         (maskQty == threshold->thresholdQty) &&
+         (maskType == threshold->thresholdType) &&
+         (maskValue == threshold->thresholdValue);
+}
+
+// ===============
+// BUILD FLUID MASK
+// ===============
+void mriFluidMask::build(const mriCellData& cells, mriTopology* topology, mriThresholdCriteria* threshold){
+  int totCells = topology->totalCells;
+  int nx = topology->cellTotals[0];
+  int ny = topology->cellTotals[1];
+  int nz = topology->cellTotals[2];
+  bits.assign(totCells,0);
+  totalFluidCells = 0;
+
+  // Evaluate the threshold once per cell
+  double currValue = 0.0;
+  for(int loopA=0;loopA<totCells;loopA++){
+    switch(threshold->thresholdQty){
+      case kNoQuantity:
+        currValue = 0.0;
+        break;
+      case kQtyPositionX:
+      case kQtyPositionY:
+      case kQtyPositionZ:
+        currValue = topology->cellLocations[loopA][threshold->thresholdQty];
+        break;
+      case kQtyVelModule:
+        currValue = cells.getVelocityModule(loopA);
+        break;
+      default:
+        currValue = cells.getQuantity(loopA,threshold->thresholdQty);
+        break;
+    }
+    if(!threshold->meetsCriteria(currValue)){
+      bits[loopA] = kMaskFluid;
+      totalFluidCells++;
+    }
+  }
+
+  // Precompute neighbour validity bits
+  int stride[3] = {1,nx,nx*ny};
+  int totals[3] = {nx,ny,nz};
+  int coords[3] = {0,0,0};
+  for(int loopA=0;loopA<totCells;loopA++){
+    coords[0] = loopA % nx;
+    coords[1] = (loopA / nx) % ny;
+    coords[2] = loopA / (nx*ny);
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      // Plus Direction
+      if((coords[loopB]+1 < totals[loopB])&&(bits[loopA+stride[loopB]] & kMaskFluid)){
+        bits[loopA] |= maskNeighbourBit(2*loopB);
+      }
+      if((coords[loopB]+2 < totals[loopB])&&(bits[loopA+2*stride[loopB]] & kMaskFluid)){
+        bits[loopA] |= maskSecondNeighbourBit(2*loopB);
+      }
+      // Minus Direction
+      if((coords[loopB]-1 >= 0)&&(bits[loopA-stride[loopB]] & kMaskFluid)){
+        bits[loopA] |= maskNeighbourBit(2*loopB+1);
+      }
+      if((coords[loopB]-2 >= 0)&&(bits[loopA-2*stride[loopB]] & kMaskFluid)){
+        bits[loopA] |= maskSecondNeighbourBit(2*loopB+1);
+      }
+    }
+  }
+
+  // Store Key
+  version = versionCounter.fetch_add(1) + 1;
+  isValid = true;
+  cellVersion = cells.version;
+  maskTopology = topology;
+  maskQty = threshold->thresholdQty;
+  maskType = threshold->thresholdType;
+  maskValue = threshold->thresholdValue;
+}
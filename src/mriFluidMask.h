@@ -0,0 +1,60 @@
+#ifndef MRIFLUIDMASK_H
+#define MRIFLUIDMASK_H
+
+# include <vector>
+# include <atomic>
+
+# include "mriTypes.h"
+# include "mriCell.h"
+# include "mriConstants.h"
+# include "mriException.h"
+# include "mriThresholdCriteria.h"
+
+class mriTopology;
+
+using namespace std;
+
+// MASK BITS
+// Bit 0: cell is fluid (does not meet the threshold criterion)
+// Bits 1-6: face neighbour (kfacePlusX..kfaceMinusZ) exists and is fluid
+// Bits 7-12: second neighbour along the same direction exists and is fluid
+const unsigned short kMaskFluid = 1;
+inline unsigned short maskNeighbourBit(int face){return (unsigned short)(1 << (1 + face));}
+inline unsigned short maskSecondNeighbourBit(int face){return (unsigned short)(1 << (7 + face));}
+
+// ================================
+// CACHED FLUID MASK FOR A THRESHOLD
+// ================================
+class mriFluidMask{
+  public:
+    // DATA MEMBERS
+    vector<unsigned short> bits;
+    int totalFluidCells;
+    // Unique stamp for every build
+    unsigned long version;
+    static std::atomic<unsigned long> versionCounter;
+
+    // CONSTRUCTOR
+    mriFluidMask();
+
+    // MEMBER FUNCTIONS
+    bool isCurrent(const mriCellData& cells, mriTopology* topology, mriThresholdCriteria* threshold) const;
+    void build(const mriCellData& cells, mriTopology* topology, mriThresholdCriteria* threshold);
+    void invalidate(){isValid = false;}
+
+    // QUERIES
+    bool isFluid(int cell) const{return (bits[cell] & kMaskFluid) != 0;}
+    bool hasNeighbour(int cell, int face) const{return (bits[cell] & maskNeighbourBit(face)) != 0;}
+    bool hasSecondNeighbour(int cell, int face) const{return (bits[cell] & maskSecondNeighbourBit(face)) != 0;}
+
+  private:
+    // Key of the cached mask
+    bool isValid;
+    unsigned long cellVersion;
+    mriTopology* maskTopology;
+    int maskQty;
+    int maskType;
+    double maskValue;
+};
+
+#endif // MRIFLUIDMASK_H
@@ -0,0 +1,158 @@
+#include <math.h>
+#include <limits>
+#include <algorithm>
+#include "mriHistogram.h"
+#include "mriTopology.h"
+#include "mriParallel.h"
+#include "mriCommunicator.h"
+#include "mriUtils.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriHistogram::mriHistogram(const mriCellData* first, const mriCellData* second, int qtyID, int numberOfBins, double minAbsValue){
+  if(numberOfBins < 1){
+    throw mriException("ERROR: Invalid number of bins in mriHistogram.\n");
+  }
+  this->first = first;
+  this->second = second;
+  this->qtyID = qtyID;
+  this->numberOfBins = numberOfBins;
+  this->minAbsValue = minAbsValue;
+  minRange = 0.0;
+  maxRange = 0.0;
+  binWidth = 0.0;
+  binCenters.assign(numberOfBins,0.0);
+  binValues.assign(numberOfBins,0.0);
+}
+
+// ==============
+// SET BIN LIMITS
+// ==============
+void mriHistogram::setRange(double minValue, double maxValue){
+  // If minRange and maxRange are the same than add something
+  if(fabs(maxValue - minValue) < kMathZero){
+    minValue = minValue - 1.0;
+    maxValue = maxValue + 1.0;
+  }
+  minRange = minValue;
+  maxRange = maxValue;
+  binWidth = (maxRange - minRange)/(double)numberOfBins;
+  for(int loopA=0;loopA<numberOfBins;loopA++){
+    binCenters[loopA] = minRange + (loopA + 0.5)*binWidth;
+  }
+}
+
+// ==================
+// NORMALIZE TO A PDF
+// ==================
+void mriHistogram::normalize(){
+  mriUtils::normalizeBinArray(binValues,binWidth);
+}
+
+// =============
+// ADD HISTOGRAM
+// =============
+int mriHistogramSet::addHistogram(const mriCellData* first, const mriCellData* second, int qtyID, int numberOfBins, double minAbsValue){
+  histograms.push_back(mriHistogram(first,second,qtyID,numberOfBins,minAbsValue));
+  return (int)histograms.size() - 1;
+}
+
+// =======================
+// EVALUATE ALL HISTOGRAMS
+// =======================
+void mriHistogramSet::evaluate(mriTopology* topology, const mriDoubleVec* limitBox, mriCommunicator* comm){
+  int totHisto = (int)histograms.size();
+  if(totHisto == 0){
+    return;
+  }
+  // Cells handled by this process
+  int firstCell = 0;
+  int lastCell = topology->totalCells;
+  if(comm != NULL){
+    firstCell = (int)(((long long)topology->totalCells*comm->currProc)/comm->totProc);
+    lastCell = (int)(((long long)topology->totalCells*(comm->currProc + 1))/comm->totProc);
+  }
+  int totCells = lastCell - firstCell;
+  int totThreads = mriParallel::getThreadCount();
+
+  // Shared pass: cells inside the box and limits of every quantity
+  vector<unsigned char> isInside(totCells,1);
+  mriDoubleMat threadMin(totThreads,mriDoubleVec(totHisto,std::numeric_limits<double>::max()));
+  mriDoubleMat threadMax(totThreads,mriDoubleVec(totHisto,-std::numeric_limits<double>::max()));
+  mriParallel::parallelFor(totCells,[&](int thread,int begin,int end){
+    double* currMin = threadMin[thread].data();
+    double* currMax = threadMax[thread].data();
+    for(int loopA=begin;loopA<end;loopA++){
+      int currCell = firstCell + loopA;
+      if(limitBox != NULL){
+        isInside[loopA] = mriUtils::isPointInsideBox(topology->cellLocations[currCell][0],
+                                                     topology->cellLocations[currCell][1],
+                                                     topology->cellLocations[currCell][2],*limitBox);
+      }
+      if(!isInside[loopA]){
+        continue;
+      }
+      for(int loopB=0;loopB<totHisto;loopB++){
+        double currValue = histograms[loopB].getValue(currCell);
+        currMin[loopB] = std::min(currMin[loopB],currValue);
+        currMax[loopB] = std::max(currMax[loopB],currValue);
+      }
+    }
+  });
+  mriDoubleVec minValues(totHisto,std::numeric_limits<double>::max());
+  mriDoubleVec maxValues(totHisto,-std::numeric_limits<double>::max());
+  for(int loopA=0;loopA<totThreads;loopA++){
+    for(int loopB=0;loopB<totHisto;loopB++){
+      minValues[loopB] = std::min(minValues[loopB],threadMin[loopA][loopB]);
+      maxValues[loopB] = std::max(maxValues[loopB],threadMax[loopA][loopB]);
+    }
+  }
+  if((comm != NULL)&&(comm->totProc > 1)){
+    MPI_Allreduce(MPI_IN_PLACE,minValues.data(),totHisto,MPI_DOUBLE,MPI_MIN,comm->mpiComm);
+    MPI_Allreduce(MPI_IN_PLACE,maxValues.data(),totHisto,MPI_DOUBLE,MPI_MAX,comm->mpiComm);
+  }
+  int totBins = 0;
+  mriIntVec binOffset(totHisto,0);
+  for(int loopA=0;loopA<totHisto;loopA++){
+    // No cells in the box
+    if(minValues[loopA] > maxValues[loopA]){
+      minValues[loopA] = 0.0;
+      maxValues[loopA] = 0.0;
+    }
+    histograms[loopA].setRange(minValues[loopA],maxValues[loopA]);
+    binOffset[loopA] = totBins;
+    totBins += histograms[loopA].numberOfBins;
+  }
+
+  // Binning pass, counts are integers so the order of the sums does not matter
+  mriDoubleMat threadCounts(totThreads,mriDoubleVec(totBins,0.0));
+  mriParallel::parallelFor(totCells,[&](int thread,int begin,int end){
+    double* counts = threadCounts[thread].data();
+    for(int loopA=begin;loopA<end;loopA++){
+      if(!isInside[loopA]){
+        continue;
+      }
+      for(int loopB=0;loopB<totHisto;loopB++){
+        const mriHistogram& histo = histograms[loopB];
+        double currValue = histo.getValue(firstCell + loopA);
+        if(fabs(currValue) > histo.minAbsValue){
+          counts[binOffset[loopB] + histo.getBin(currValue)] += 1.0;
+        }
+      }
+    }
+  });
+  mriDoubleVec counts(totBins,0.0);
+  for(int loopA=0;loopA<totThreads;loopA++){
+    for(int loopB=0;loopB<totBins;loopB++){
+      counts[loopB] += threadCounts[loopA][loopB];
+    }
+  }
+  if((comm != NULL)&&(comm->totProc > 1)){
+    MPI_Allreduce(MPI_IN_PLACE,counts.data(),totBins,MPI_DOUBLE,MPI_SUM,comm->mpiComm);
+  }
+  for(int loopA=0;loopA<totHisto;loopA++){
+    mriHistogram& histo = histograms[loopA];
+    std::copy(counts.begin() + binOffset[loopA],counts.begin() + binOffset[loopA] + histo.numberOfBins,histo.binValues.begin());
+  }
+}
@@ -0,0 +1,84 @@
+#ifndef MRIHISTOGRAM_H
+#define MRIHISTOGRAM_H
+
+# include <math.h>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriCell.h"
+# include "mriConstants.h"
+# include "mriException.h"
+
+class mriTopology;
+class mriCommunicator;
+
+using namespace std;
+
+// Single scan PDFs skip the cells with a smaller magnitude
+const double kPDFMinAbsValue = 1.2e-2;
+
+// ==============================
+// HISTOGRAM OF ONE CELL QUANTITY
+// ==============================
+// The binned value is the quantity on first, minus the quantity
+// on second when a second scan is given.
+class mriHistogram{
+  public:
+    // DATA MEMBERS
+    const mriCellData* first;
+    const mriCellData* second;
+    int qtyID;
+    // Values not above it in magnitude are not binned but still set the limits
+    double minAbsValue;
+    // Bins of equal width between minRange and maxRange
+    int numberOfBins;
+    double minRange;
+    double maxRange;
+    double binWidth;
+    mriDoubleVec binCenters;
+    // Cell counts, probability density after normalize
+    mriDoubleVec binValues;
+
+    // CONSTRUCTOR
+    mriHistogram(const mriCellData* first, const mriCellData* second, int qtyID, int numberOfBins, double minAbsValue);
+
+    // MEMBER FUNCTIONS
+    double getValue(int cell) const{
+      double value = getCellValue(*first,cell);
+      if(second != NULL){
+        value -= getCellValue(*second,cell);
+      }
+      return value;
+    }
+    // Bins are closed on the right, the first also on the left
+    int getBin(double value) const{
+      int bin = (int)ceil((value - minRange)/binWidth) - 1;
+      return (bin < 0) ? 0 : ((bin >= numberOfBins) ? numberOfBins - 1 : bin);
+    }
+    void setRange(double minValue, double maxValue);
+    void normalize();
+
+  private:
+    double getCellValue(const mriCellData& cells, int cell) const{
+      return (qtyID == kQtyVelModule) ? cells.getVelocityModule(cell) : cells.getQuantity(cell,qtyID);
+    }
+};
+
+// ============================================
+// HISTOGRAMS OF SEVERAL QUANTITIES IN ONE PASS
+// ============================================
+class mriHistogramSet{
+  public:
+    // DATA MEMBERS
+    vector<mriHistogram> histograms;
+
+    // MEMBER FUNCTIONS
+    // Returns the index of the new histogram
+    int addHistogram(const mriCellData* first, const mriCellData* second, int qtyID, int numberOfBins, double minAbsValue);
+    // Bin the cells inside limitBox (all cells if NULL). The limits of all
+    // histograms come from one shared min/max pass. With a communicator the
+    // cells are split among the processes and the results are reduced.
+    void evaluate(mriTopology* topology, const mriDoubleVec* limitBox, mriCommunicator* comm);
+};
+
+#endif // MRIHISTOGRAM_H
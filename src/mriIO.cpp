@@ -2,6 +2,18 @@
 
 using namespace std;
 
+// ======================
+// INITIALIZE PLT OPTIONS
+// ======================
+void resetPLTOptions(pltOptionRecord& pltOptions){
+  pltOptions.i = 0;
+  pltOptions.j = 0;
+  pltOptions.k = 0;
+  pltOptions.N = 0;
+  pltOptions.E = 0;
+  pltOptions.type = pltUNIFORM;
+}
+
 // ====================================
 // READS HEADER AND ASSIGNS PLT OPTIONS
 // ====================================
@@ -40,9 +52,16 @@ void assignVTKOptions(int lineNum, const mriStringVec& tokens, vtkStructuredPoin
     if(boost::to_upper_copy(tokens[loopA]) == "ASCII"){
       vtkOptions.isASCII = true;
       vtkOptions.isDefined[0] = true;
+    }else if(boost::to_upper_copy(tokens[loopA]) == "BINARY"){
+      vtkOptions.isASCII = false;
+      vtkOptions.isDefined[0] = true;
     }else if(boost::to_upper_copy(tokens[loopA]).find("STRUCTURED") != string::npos){
       vtkOptions.isValidDataset = true;
       vtkOptions.isDefined[1] = true;
+    }else if(boost::to_upper_copy(tokens[loopA]) == "RECTILINEAR_GRID"){
+      vtkOptions.isValidDataset = true;
+      vtkOptions.isRectilinear = true;
+      vtkOptions.isDefined[1] = true;
     }else if(boost::to_upper_copy(tokens[loopA]) == "DIMENSIONS"){
       vtkOptions.dimensions[0] = atoi(tokens[loopA+1].c_str());
       vtkOptions.dimensions[1] = atoi(tokens[loopA+2].c_str());
@@ -88,6 +107,7 @@ void assignVTKOptions(int lineNum, const mriStringVec& tokens, vtkStructuredPoin
 void initVTKStructuredPointsOptions(vtkStructuredPointsOptionRecord &opts){
   opts.isASCII = false;
   opts.isValidDataset = false;
+  opts.isRectilinear = false;
   opts.numDefined = 5;
   // Size
   opts.dimensions[0] = 0;
@@ -107,105 +127,3 @@ void initVTKStructuredPointsOptions(vtkStructuredPointsOptionRecord &opts){
   }
 }
 
-// ===================
-// READ EXPANSION FILE
-// ===================
-void readExpansionFile(string fileName,
-                       mriIntVec& tot,
-                       mriDoubleVec& lengthX,
-                       mriDoubleVec& lengthY,
-                       mriDoubleVec& lengthZ,
-                       mriDoubleVec& minlimits,
-                       mriDoubleVec& maxlimits,
-                       mriExpansion* exp){
-
-  // ASSIGN FILE
-  int lineCount = 0;
-  std::vector<std::string> ResultArray;
-  std::string Buffer;
-  std::ifstream inFile;
-  inFile.open(fileName.c_str());
-
-  // GET TOTAL CELLS
-  lineCount++;
-  std::getline(inFile,Buffer);
-  ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-  tot[0] = atoi(ResultArray[0].c_str());
-  tot[1] = atoi(ResultArray[1].c_str());
-  tot[2] = atoi(ResultArray[2].c_str());
-
-  printf("TOTALS %d %d %d\n",tot[0],tot[1],tot[2]);
-
-  // GET CELL X LENGTHS
-  int lengthCount = 0;
-  while(lengthCount<tot[0]){
-    std::getline(inFile,Buffer);
-    boost::trim(Buffer);
-    ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-    for(size_t loopA=0;loopA<ResultArray.size();loopA++){
-      // Assign Length
-      lengthX.push_back(atof(ResultArray[loopA].c_str()));
-      // Update Counter
-      lengthCount++;
-    }
-  }
-
-  // GET CELL Y LENGTHS
-  lengthCount = 0;
-  while(lengthCount<tot[1]){
-    std::getline(inFile,Buffer);
-    boost::trim(Buffer);
-    ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-    for(size_t loopA=0;loopA<ResultArray.size();loopA++){
-      // Assign Length
-      lengthY.push_back(atof(ResultArray[loopA].c_str()));
-      // Update Counter
-      lengthCount++;
-    }
-  }
-
-  // GET CELL Z LENGTHS
-  lengthCount = 0;
-  while(lengthCount<tot[2]){
-    std::getline(inFile,Buffer);
-    boost::trim(Buffer);
-    ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-    for(size_t loopA=0;loopA<ResultArray.size();loopA++){
-      // Assign Length
-      lengthZ.push_back(atof(ResultArray[loopA].c_str()));
-      // Update Counter
-      lengthCount++;
-    }
-  }
-
-  // GET MIN LIMITS
-  lineCount++;
-  std::getline(inFile,Buffer);
-  ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-  minlimits[0] = atof(ResultArray[0].c_str());
-  minlimits[1] = atof(ResultArray[1].c_str());
-  minlimits[2] = atof(ResultArray[2].c_str());
-
-  // GET MAX LIMITS
-  lineCount++;
-  std::getline(inFile,Buffer);
-  ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-  maxlimits[0] = atof(ResultArray[0].c_str());
-  maxlimits[1] = atof(ResultArray[1].c_str());
-  maxlimits[2] = atof(ResultArray[2].c_str());
-
-  // GET EXPANSION COEFFICIENTS
-  std::vector<double> tempExpansion;
-  while(std::getline(inFile,Buffer)){
-    ResultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-    tempExpansion.push_back(atof(ResultArray[0].c_str()));
-  }
-
-  // CREATE EXPANSION
-  exp = new mriExpansion((int)tempExpansion.size()-3);
-  exp->fillFromVector(tempExpansion);
-
-  // CLOSE FILE
-  inFile.close();
-}
-
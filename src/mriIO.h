@@ -9,21 +9,12 @@
 class mriScan;
 class mriTopology;
 
-void readPLTData(string PltFileName, mriTopology* topo, mriScan* scan);
-
-void readExpansionFile(string fileName,
-                       mriIntVec& tot,
-                       mriDoubleVec& lengthX,
-                       mriDoubleVec& lengthY,
-                       mriDoubleVec& lengthZ,
-                       mriDoubleVec& minlimits,
-                       mriDoubleVec& maxlimits,
-                       mriExpansion* exp);
-
 void initVTKStructuredPointsOptions(vtkStructuredPointsOptionRecord &opts);
 
 void assignVTKOptions(int lineNum, const mriStringVec& tokens, vtkStructuredPointsOptionRecord &vtkOptions);
 
+void resetPLTOptions(pltOptionRecord& pltOptions);
+
 void assignPLTOptions(const mriStringVec& tokens, pltOptionRecord& pltOptions);
 
 
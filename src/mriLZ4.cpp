@@ -0,0 +1,162 @@
+#include <string.h>
+#include <stdint.h>
+#include "mriLZ4.h"
+#include "mriException.h"
+
+// Shortest match, the last match starts at least kLZ4MatchLimit bytes
+// before the end and the last kLZ4LastLiterals bytes are always literals
+static const int kLZ4MinMatch = 4;
+static const int kLZ4MatchLimit = 12;
+static const int kLZ4LastLiterals = 5;
+static const int kLZ4MaxOffset = 65535;
+
+static inline uint32_t readWord(const char* ptr){
+  uint32_t value;
+  memcpy(&value,ptr,sizeof(value));
+  return value;
+}
+
+static inline int hashWord(uint32_t value){
+  return (int)((value*2654435761U) >> (32 - kLZ4HashLog));
+}
+
+// Extra bytes of a literal or match length of 15 or more
+static inline void writeLength(char*& out, int length){
+  while(length >= 255){
+    *out++ = (char)255;
+    length -= 255;
+  }
+  *out++ = (char)length;
+}
+
+// Append one sequence: literals, then an optional match
+static inline void writeSequence(char*& out, const char* literals, int totLiterals, int offset, int matchLength){
+  char* token = out++;
+  int literalCode = (totLiterals < 15) ? totLiterals : 15;
+  int matchCode = 0;
+  if(totLiterals >= 15){
+    writeLength(out,totLiterals - 15);
+  }
+  memcpy(out,literals,totLiterals);
+  out += totLiterals;
+  if(matchLength > 0){
+    *out++ = (char)(offset & 0xff);
+    *out++ = (char)((offset >> 8) & 0xff);
+    int length = matchLength - kLZ4MinMatch;
+    matchCode = (length < 15) ? length : 15;
+    if(length >= 15){
+      writeLength(out,length - 15);
+    }
+  }
+  *token = (char)((literalCode << 4) | matchCode);
+}
+
+// ===========================
+// GET MAXIMUM COMPRESSED SIZE
+// ===========================
+int mriLZ4::getMaxCompressedSize(int srcSize){
+  return srcSize + srcSize/255 + 16;
+}
+
+// ==================
+// COMPRESS LZ4 BLOCK
+// ==================
+void mriLZ4::compressBlock(const char* src, int srcSize, vector<char>& dst){
+  dst.resize(getMaxCompressedSize(srcSize));
+  char* out = dst.data();
+  int anchor = 0;
+  if(srcSize > kLZ4MatchLimit){
+    vector<int> table(1 << kLZ4HashLog,-1);
+    int matchStartLimit = srcSize - kLZ4MatchLimit;
+    int matchEndLimit = srcSize - kLZ4LastLiterals;
+    int pos = 0;
+    while(pos < matchStartLimit){
+      uint32_t word = readWord(src + pos);
+      int hash = hashWord(word);
+      int ref = table[hash];
+      table[hash] = pos;
+      if((ref < 0)||(pos - ref > kLZ4MaxOffset)||(readWord(src + ref) != word)){
+        pos++;
+        continue;
+      }
+      int matchLength = kLZ4MinMatch;
+      while((pos + matchLength < matchEndLimit)&&(src[ref + matchLength] == src[pos + matchLength])){
+        matchLength++;
+      }
+      writeSequence(out,src + anchor,pos - anchor,pos - ref,matchLength);
+      pos += matchLength;
+      anchor = pos;
+    }
+  }
+  // Last literals
+  writeSequence(out,src + anchor,srcSize - anchor,0,0);
+  dst.resize(out - dst.data());
+}
+
+// Length of 15 or more continues in the next bytes
+static inline bool readLength(const char*& in, const char* inEnd, int& length){
+  unsigned char value = 255;
+  while(value == 255){
+    if(in >= inEnd){
+      return false;
+    }
+    value = (unsigned char)*in++;
+    length += value;
+  }
+  return true;
+}
+
+// ====================
+// DECOMPRESS LZ4 BLOCK
+// ====================
+void mriLZ4::decompressBlock(const char* src, int srcSize, char* dst, int dstSize){
+  const char* in = src;
+  const char* inEnd = src + srcSize;
+  char* out = dst;
+  char* outEnd = dst + dstSize;
+  bool isValid = true;
+  while(isValid && (in < inEnd)){
+    unsigned char token = (unsigned char)*in++;
+    // Literals
+    int totLiterals = token >> 4;
+    if(totLiterals == 15){
+      isValid = readLength(in,inEnd,totLiterals);
+    }
+    if((!isValid)||(totLiterals > inEnd - in)||(totLiterals > outEnd - out)){
+      isValid = false;
+      break;
+    }
+    memcpy(out,in,totLiterals);
+    in += totLiterals;
+    out += totLiterals;
+    // The last sequence has no match
+    if(in == inEnd){
+      break;
+    }
+    // Match
+    if(inEnd - in < 2){
+      isValid = false;
+      break;
+    }
+    int offset = (unsigned char)in[0] | ((unsigned char)in[1] << 8);
+    in += 2;
+    int matchLength = token & 15;
+    if(matchLength == 15){
+      isValid = readLength(in,inEnd,matchLength);
+    }
+    matchLength += kLZ4MinMatch;
+    if((!isValid)||(offset == 0)||(offset > out - dst)||(matchLength > outEnd - out)){
+      isValid = false;
+      break;
+    }
+    // Byte by byte, the match may overlap the output
+    const char* ref = out - offset;
+    for(int loopA=0;loopA<matchLength;loopA++){
+      out[loopA] = ref[loopA];
+    }
+    out += matchLength;
+  }
+  if((!isValid)||(out != outEnd)){
+    throw mriException("ERROR: Corrupt LZ4 block.\n");
+  }
+}
@@ -0,0 +1,28 @@
+#ifndef MRILZ4_H
+#define MRILZ4_H
+
+# include <vector>
+
+using namespace std;
+
+// Entries of the match finder hash table (power of two)
+const int kLZ4HashLog = 14;
+
+// LZ4 BLOCK FORMAT COMPRESSION
+namespace mriLZ4{
+
+  // Largest compressed size of a block of srcSize bytes
+  int getMaxCompressedSize(int srcSize);
+
+  // Compress one block with a greedy single-probe match finder. The output
+  // is a raw LZ4 block that any LZ4 decoder (e.g. vtkLZ4DataCompressor)
+  // reads back with the original size.
+  void compressBlock(const char* src, int srcSize, vector<char>& dst);
+
+  // Decompress a raw LZ4 block of exactly dstSize bytes, throws if the
+  // block is corrupt or does not fit
+  void decompressBlock(const char* src, int srcSize, char* dst, int dstSize);
+
+}
+
+#endif // MRILZ4_H
@@ -0,0 +1,185 @@
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include "mriLabeling.h"
+#include "mriParallel.h"
+
+// Union-find forest on the grid cells. Every link points to a smaller cell
+// index, so the root of a region is its first cell whatever the order in
+// which the links were created.
+typedef std::atomic<int> mriLabelLink;
+
+// ===============================
+// FIND THE ROOT WITH PATH HALVING
+// ===============================
+// Links are only shortened to another ancestor, so this is safe while
+// other threads unite regions
+int findRoot(mriLabelLink* parent, int cell){
+  while(true){
+    int next = parent[cell].load(std::memory_order_relaxed);
+    if(next == cell){
+      return cell;
+    }
+    int grand = parent[next].load(std::memory_order_relaxed);
+    if(grand != next){
+      parent[cell].store(grand,std::memory_order_relaxed);
+    }
+    cell = grand;
+  }
+}
+
+// =================
+// UNITE TWO REGIONS
+// =================
+void uniteRegions(mriLabelLink* parent, int first, int second){
+  while(true){
+    int rootA = findRoot(parent,first);
+    int rootB = findRoot(parent,second);
+    if(rootA == rootB){
+      return;
+    }
+    if(rootA < rootB){
+      std::swap(rootA,rootB);
+    }
+    // Link the larger root to the smaller one, retry if
+    // another thread linked it in the meantime
+    int expected = rootA;
+    if(parent[rootA].compare_exchange_strong(expected,rootB)){
+      return;
+    }
+    first = rootA;
+    second = rootB;
+  }
+}
+
+// ===========================
+// LABEL THE CONNECTED REGIONS
+// ===========================
+int mriLabeling::labelRegions(const int* totals, const unsigned char* isTaggable, mriIntVec& labels){
+  int nx = totals[0];
+  int ny = totals[1];
+  int nz = totals[2];
+  int planeSize = nx*ny;
+  int totCells = planeSize*nz;
+  labels.resize(totCells);
+  if(totCells == 0){
+    return 0;
+  }
+  // Left uninitialized, only the links of taggable cells are used
+  std::unique_ptr<mriLabelLink[]> links(new mriLabelLink[totCells]);
+  mriLabelLink* parent = links.get();
+
+  // Unite the cells inside slabs of planes, each slab on one thread.
+  // A link to the minus neighbour is skipped when the cell before and
+  // the cell before its neighbour already connect the two.
+  int planesPerBlock = std::max(1,kParallelBlockSize/planeSize);
+  planesPerBlock = std::max(planesPerBlock,(nz + kLabelingMaxSlabs - 1)/kLabelingMaxSlabs);
+  mriParallel::parallelFor(nz,planesPerBlock,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      for(int loopB=0;loopB<ny;loopB++){
+        int rowStart = (loopA*ny + loopB)*nx;
+        for(int loopC=0;loopC<nx;loopC++){
+          int currCell = rowStart + loopC;
+          if(!isTaggable[currCell]){
+            continue;
+          }
+          // A new cell joins the region of the cell before directly
+          bool hasPrev = (loopC > 0)&&(isTaggable[currCell-1]);
+          if(hasPrev){
+            parent[currCell].store(parent[currCell-1].load(std::memory_order_relaxed),std::memory_order_relaxed);
+          }else{
+            parent[currCell].store(currCell,std::memory_order_relaxed);
+          }
+          if((loopB > 0)&&(isTaggable[currCell-nx])){
+            if(!(hasPrev && isTaggable[currCell-1-nx])){
+              uniteRegions(parent,currCell,currCell-nx);
+            }
+          }
+          if((loopA > begin)&&(isTaggable[currCell-planeSize])){
+            if(!(hasPrev && isTaggable[currCell-1-planeSize])){
+              uniteRegions(parent,currCell,currCell-planeSize);
+            }
+          }
+        }
+      }
+    }
+  });
+
+  // Merge the slabs across their first plane, rows of all
+  // border planes are shared among the threads
+  int totSlabs = (nz + planesPerBlock - 1)/planesPerBlock;
+  int rowsPerBlock = std::max(1,kParallelBlockSize/nx);
+  mriParallel::parallelFor((totSlabs-1)*ny,rowsPerBlock,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      int currZ = (loopA/ny + 1)*planesPerBlock;
+      int rowStart = (currZ*ny + loopA % ny)*nx;
+      for(int loopB=0;loopB<nx;loopB++){
+        int currCell = rowStart + loopB;
+        if((!isTaggable[currCell])||(!isTaggable[currCell-planeSize])){
+          continue;
+        }
+        if((loopB > 0)&&(isTaggable[currCell-1])&&(isTaggable[currCell-1-planeSize])){
+          continue;
+        }
+        uniteRegions(parent,currCell,currCell-planeSize);
+      }
+    }
+  });
+
+  // Store the roots and count them per block
+  int totBlocks = mriParallel::getBlockCount(totCells);
+  mriIntVec blockRoots(totBlocks,0);
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    int count = 0;
+    for(int loopA=begin;loopA<end;loopA++){
+      if(isTaggable[loopA]){
+        labels[loopA] = findRoot(parent,loopA);
+        if(labels[loopA] == loopA){
+          count++;
+        }
+      }else{
+        labels[loopA] = -1;
+      }
+    }
+    blockRoots[mriParallel::getBlockIndex(begin)] = count;
+  });
+
+  // Number the roots in cell order
+  mriIntVec blockOffset(totBlocks,0);
+  int totRegions = 0;
+  for(int loopA=0;loopA<totBlocks;loopA++){
+    blockOffset[loopA] = totRegions;
+    totRegions += blockRoots[loopA];
+  }
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    int currRegion = blockOffset[mriParallel::getBlockIndex(begin)];
+    for(int loopA=begin;loopA<end;loopA++){
+      if(labels[loopA] == loopA){
+        parent[loopA].store(currRegion,std::memory_order_relaxed);
+        currRegion++;
+      }
+    }
+  });
+
+  // Every cell takes the number of its root
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      if(labels[loopA] >= 0){
+        labels[loopA] = parent[labels[loopA]].load(std::memory_order_relaxed);
+      }
+    }
+  });
+  return totRegions;
+}
+
+// ================
+// GET REGION SIZES
+// ================
+void mriLabeling::getRegionSizes(const mriIntVec& labels, int totRegions, mriIntVec& regionSizes){
+  regionSizes.assign(totRegions,0);
+  for(size_t loopA=0;loopA<labels.size();loopA++){
+    if(labels[loopA] >= 0){
+      regionSizes[labels[loopA]]++;
+    }
+  }
+}
@@ -0,0 +1,29 @@
+#ifndef MRILABELING_H
+#define MRILABELING_H
+
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Largest number of plane slabs labeled independently, links
+// across the slab borders are merged afterwards
+const int kLabelingMaxSlabs = 64;
+
+// CONNECTED COMPONENT LABELING ON STRUCTURED GRIDS
+namespace mriLabeling{
+
+  // Label the face-connected regions of the cells with isTaggable set on a
+  // grid with totals[0]*totals[1]*totals[2] cells (x fastest). Regions are
+  // numbered from zero in the order of their first cell, other cells get -1.
+  // Returns the number of regions.
+  int labelRegions(const int* totals, const unsigned char* isTaggable, mriIntVec& labels);
+
+  // Number of cells in every region
+  void getRegionSizes(const mriIntVec& labels, int totRegions, mriIntVec& regionSizes);
+
+}
+
+#endif // MRILABELING_H
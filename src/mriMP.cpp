@@ -328,9 +328,9 @@ void mriScan::recoverCellVelocitiesRT0(bool useBCFilter, mriDoubleVec& filteredV
       secondAvVelocity = (filteredVec[secondFaceID]* topology->faceNormal[secondFaceID][loopB]/topology->faceArea[secondFaceID]);
       // Set Correction
       if(useBCFilter){
-        cells[loopA].auxVector[loopB] = cells[loopA].velocity[loopB]-0.5*(firstAvVelocity + secondAvVelocity);
+        cells.aux(loopB)[loopA] = cells.velocity(loopB)[loopA]-0.5*(firstAvVelocity + secondAvVelocity);
       }else{
-        cells[loopA].auxVector[loopB] = 0.5*(firstAvVelocity + secondAvVelocity);
+        cells.aux(loopB)[loopA] = 0.5*(firstAvVelocity + secondAvVelocity);
       }
     }
   }
@@ -558,8 +558,9 @@ std::string getFaceLocationString(int faceLocation){
 // Assemble Face Flux Vectors
 void mriScan::assembleResidualVector(bool useBCFilter, mriThresholdCriteria* thresholdCriteria,
                                      int& totalFaces, mriDoubleVec& resVec, mriDoubleVec& filteredVec, double& resNorm){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(thresholdCriteria);
   bool   continueToProcess = false;
-  double currentValue = 0.0;
   double faceComponent = 0.0;
   int    currentFace = 0;
   double currFaceArea = 0.0;
@@ -584,8 +585,7 @@ void mriScan::assembleResidualVector(bool useBCFilter, mriThresholdCriteria* thr
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Check for BC
     if(useBCFilter){
-      currentValue = cells[loopA].getQuantity(thresholdCriteria->thresholdQty);
-      continueToProcess = thresholdCriteria->meetsCriteria(currentValue);
+      continueToProcess = !fluidMask.isFluid(loopA);
     }else{
       continueToProcess = true;
     }
@@ -599,7 +599,7 @@ void mriScan::assembleResidualVector(bool useBCFilter, mriThresholdCriteria* thr
         // Get Normal Veclocity
         faceComponent = 0.0;
         for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
-          faceComponent += cells[loopA].velocity[loopC] * topology->faceNormal[currentFace][loopC];
+          faceComponent += cells.velocity(loopC)[loopA] * topology->faceNormal[currentFace][loopC];
         }
         // Assemble
         resVec[currentFace] = resVec[currentFace] + currFaceArea * faceComponent;
@@ -1166,7 +1166,7 @@ void mriScan::rebuildFromExpansion(mriExpansion* expansion, bool useConstantFlux
     for(int loopE=0;loopE<totalStarFaces;loopE++){
       currFaceID = facesID[loopE];
       currFaceCoeff = facesCoeffs[loopE];
-      faceFluxVec[currFaceID] += currFaceCoeff*expansion->vortexCoeff[componentCount];
+      faceFluxVec[currFaceID] += currFaceCoeff*expansion->vortexCoeff[topology->getCanonicalEdge(componentCount)];
     }
   }
 
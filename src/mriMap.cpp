@@ -94,8 +94,8 @@ void mriSequence::getUnitVector(int CurrentCell, const mriDoubleVec& GlobalFaceC
 void mriSequence::getGlobalCoords(int DimNumber, int SliceNumber, double FaceCoord1, double FaceCoord2, mriDoubleVec& globalCoords){
   // Sum up the slices
   double sliceValue = 0.0;
-  for(int loopA=1;loopA<SliceNumber;loopA++){
-    sliceValue += 0.5*(topology->cellLengths[DimNumber][loopA-1] + topology->cellLengths[DimNumber][loopA]);
+  if(SliceNumber > 0){
+    sliceValue = topology->cellCenterOffsets[DimNumber][SliceNumber-1];
   }
   switch(DimNumber){
     case 0:
@@ -122,9 +122,9 @@ void mriSequence::getGlobalCoords(int DimNumber, int SliceNumber, double FaceCoo
 // Map Cell Number
 int mriSequence::getCellNumber(const mriDoubleVec& coords){
   // Check Indexes
-  int i = mriUtils::findHowMany(coords[0] - topology->domainSizeMin[0],topology->cellLengths[0]);
-  int j = mriUtils::findHowMany(coords[1] - topology->domainSizeMin[1],topology->cellLengths[1]);
-  int k = mriUtils::findHowMany(coords[2] - topology->domainSizeMin[2],topology->cellLengths[2]);
+  int i = topology->locateOnAxis(0,coords[0] - topology->domainSizeMin[0]);
+  int j = topology->locateOnAxis(1,coords[1] - topology->domainSizeMin[1]);
+  int k = topology->locateOnAxis(2,coords[2] - topology->domainSizeMin[2]);
   // If OutSide Project To Max Index
   if(i>(topology->cellTotals[0]-1)){
     i = (topology->cellTotals[0]-1);
@@ -154,9 +154,9 @@ int mriSequence::getCellNumber(const mriDoubleVec& coords){
 double mriSequence::getVelocityNormAtCell(int cell){
   double norm = 0.0;
   for(int loopA=0;loopA<sequence.size();loopA++){
-    norm += sequence[loopA]->cells[loopA].velocity[0] * sequence[loopA]->cells[loopA].velocity[0];
-    norm += sequence[loopA]->cells[loopA].velocity[1] * sequence[loopA]->cells[loopA].velocity[1];
-    norm += sequence[loopA]->cells[loopA].velocity[2] * sequence[loopA]->cells[loopA].velocity[2];
+    norm += sequence[loopA]->cells.vx[loopA] * sequence[loopA]->cells.vx[loopA];
+    norm += sequence[loopA]->cells.vy[loopA] * sequence[loopA]->cells.vy[loopA];
+    norm += sequence[loopA]->cells.vz[loopA] * sequence[loopA]->cells.vz[loopA];
   }
   return sqrt(norm);
 }
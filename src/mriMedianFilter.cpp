@@ -0,0 +1,269 @@
+#include <algorithm>
+#include "mriMedianFilter.h"
+#include "mriTopology.h"
+#include "mriParallel.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriMedianNetwork::mriMedianNetwork(){
+  totValues = 0;
+}
+
+// ====================
+// BUILD MEDIAN NETWORK
+// ====================
+void mriMedianNetwork::build(int totValues){
+  this->totValues = totValues;
+  first.clear();
+  second.clear();
+  if(totValues < 2){
+    return;
+  }
+  // Batcher network on the next power of two, entries past
+  // totValues behave as +inf so their comparators are dropped
+  int totPow2 = 1;
+  while(totPow2 < totValues){
+    totPow2 *= 2;
+  }
+  mriIntVec allFirst;
+  mriIntVec allSecond;
+  for(int p=1;p<totPow2;p*=2){
+    for(int k=p;k>=1;k/=2){
+      for(int j=k%p;j<totPow2-k;j+=2*k){
+        for(int i=0;i<std::min(k,totPow2-j-k);i++){
+          if(((i+j)/(2*p) == (i+j+k)/(2*p))&&(i+j+k < totValues)){
+            allFirst.push_back(i+j);
+            allSecond.push_back(i+j+k);
+          }
+        }
+      }
+    }
+  }
+  // Keep the comparators the median depends on, walking backwards
+  vector<bool> isNeeded(totValues,false);
+  isNeeded[totValues/2] = true;
+  for(int loopA=(int)allFirst.size()-1;loopA>=0;loopA--){
+    if(isNeeded[allFirst[loopA]]||isNeeded[allSecond[loopA]]){
+      isNeeded[allFirst[loopA]] = true;
+      isNeeded[allSecond[loopA]] = true;
+      first.push_back(allFirst[loopA]);
+      second.push_back(allSecond[loopA]);
+    }
+  }
+  std::reverse(first.begin(),first.end());
+  std::reverse(second.begin(),second.end());
+}
+
+// =================
+// SELECT THE MEDIAN
+// =================
+double mriMedianNetwork::select(double* values) const{
+  double valA = 0.0;
+  double valB = 0.0;
+  for(size_t loopA=0;loopA<first.size();loopA++){
+    valA = values[first[loopA]];
+    valB = values[second[loopA]];
+    values[first[loopA]] = std::min(valA,valB);
+    values[second[loopA]] = std::max(valA,valB);
+  }
+  return values[totValues/2];
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriMedianFilter::mriMedianFilter(int order){
+  if(order < 0){
+    throw mriException("ERROR: Invalid order in mriMedianFilter.\n");
+  }
+  this->order = order;
+  if(order <= kMedianGatherMaxOrder){
+    int width = 2*order+1;
+    network.build(width*width*width);
+  }
+}
+
+// ===================================
+// MERGE A COLUMN INTO A SORTED WINDOW
+// ===================================
+// Remove the values in leaving and insert the values in entering,
+// all three sequences are sorted with medianLess and leaving is part of
+// window. Leaving values are matched by equivalence so NaN is removed too.
+void mergeSortedWindow(const mriDoubleVec& window, const mriDoubleVec& leaving, const mriDoubleVec& entering, mriDoubleVec& result){
+  if(leaving.size() > window.size()){
+    throw mriException("ERROR: Leaving values not in window in mergeSortedWindow.\n");
+  }
+  result.resize(window.size() - leaving.size() + entering.size());
+  const double* windowPtr = window.data();
+  const double* windowEnd = windowPtr + window.size();
+  const double* leavingPtr = leaving.data();
+  const double* leavingEnd = leavingPtr + leaving.size();
+  const double* enteringPtr = entering.data();
+  const double* enteringEnd = enteringPtr + entering.size();
+  double* resultPtr = result.data();
+  double* resultEnd = resultPtr + result.size();
+  while(windowPtr < windowEnd){
+    if((leavingPtr < leavingEnd)&&(!medianLess(*leavingPtr,*windowPtr))&&(!medianLess(*windowPtr,*leavingPtr))){
+      leavingPtr++;
+      windowPtr++;
+      continue;
+    }
+    while((enteringPtr < enteringEnd)&&(medianLess(*enteringPtr,*windowPtr))&&(resultPtr < resultEnd)){
+      *resultPtr++ = *enteringPtr++;
+    }
+    if(resultPtr == resultEnd){
+      break;
+    }
+    *resultPtr++ = *windowPtr++;
+  }
+  while((enteringPtr < enteringEnd)&&(resultPtr < resultEnd)){
+    *resultPtr++ = *enteringPtr++;
+  }
+  if((leavingPtr != leavingEnd)||(windowPtr != windowEnd)||(enteringPtr != enteringEnd)){
+    throw mriException("ERROR: Leaving values not in window in mergeSortedWindow.\n");
+  }
+}
+
+// ==================================
+// FILTER ROWS GATHERING THE FULL BOX
+// ==================================
+void mriMedianFilter::filterRowsGather(const int* totals, const mriFluidMask& fluidMask, double** inVel, double** outVel, int firstRow, int lastRow) const{
+  int nx = totals[0];
+  int ny = totals[1];
+  int nz = totals[2];
+  int width = 2*order+1;
+  int boxSize = width*width*width;
+  // Fluid values in the box, one segment per component
+  mriDoubleVec values(kNumberOfDimensions*boxSize);
+  for(int loopA=firstRow;loopA<lastRow;loopA++){
+    int currY = loopA % ny;
+    int currZ = loopA / ny;
+    int minY = std::max(0,currY-order);
+    int maxY = std::min(ny-1,currY+order);
+    int minZ = std::max(0,currZ-order);
+    int maxZ = std::min(nz-1,currZ+order);
+    for(int loopB=0;loopB<nx;loopB++){
+      int currCell = loopA*nx + loopB;
+      if(!fluidMask.isFluid(currCell)){
+        for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+          outVel[loopC][currCell] = inVel[loopC][currCell];
+        }
+        continue;
+      }
+      // Gather the fluid cells in the box
+      int minX = std::max(0,loopB-order);
+      int maxX = std::min(nx-1,loopB+order);
+      int count = 0;
+      bool hasNaN = false;
+      for(int loopZ=minZ;loopZ<=maxZ;loopZ++){
+        for(int loopY=minY;loopY<=maxY;loopY++){
+          int rowStart = (loopZ*ny + loopY)*nx;
+          for(int loopX=minX;loopX<=maxX;loopX++){
+            if(fluidMask.isFluid(rowStart+loopX)){
+              for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+                values[loopC*boxSize+count] = inVel[loopC][rowStart+loopX];
+                hasNaN = hasNaN||(values[loopC*boxSize+count] != values[loopC*boxSize+count]);
+              }
+              count++;
+            }
+          }
+        }
+      }
+      // Median of each component
+      for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+        double* compValues = &values[loopC*boxSize];
+        if((count == network.getSize())&&(!hasNaN)){
+          outVel[loopC][currCell] = network.select(compValues);
+        }else{
+          std::nth_element(compValues,compValues+count/2,compValues+count,medianLess);
+          outVel[loopC][currCell] = compValues[count/2];
+        }
+      }
+    }
+  }
+}
+
+// ========================================
+// FILTER ROWS WITH A SLIDING SORTED WINDOW
+// ========================================
+void mriMedianFilter::filterRowsWindow(const int* totals, const mriFluidMask& fluidMask, double** inVel, double** outVel, int firstRow, int lastRow) const{
+  int nx = totals[0];
+  int ny = totals[1];
+  int nz = totals[2];
+  int width = 2*order+1;
+  // Sorted values of the x-columns in the window, stored in a ring
+  vector<mriDoubleVec> columns(kNumberOfDimensions*width);
+  mriDoubleVec window[kNumberOfDimensions];
+  mriDoubleVec entering[kNumberOfDimensions];
+  mriDoubleVec merged;
+  mriDoubleVec noValues;
+  for(int loopA=firstRow;loopA<lastRow;loopA++){
+    int currY = loopA % ny;
+    int currZ = loopA / ny;
+    int minY = std::max(0,currY-order);
+    int maxY = std::min(ny-1,currY+order);
+    int minZ = std::max(0,currZ-order);
+    int maxZ = std::min(nz-1,currZ+order);
+    for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+      window[loopC].clear();
+    }
+    // Column entering at x = loopB + order, leaving at x = loopB - order - 1
+    for(int loopB=-order;loopB<nx;loopB++){
+      int enterX = loopB + order;
+      int leaveX = loopB - order - 1;
+      for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+        entering[loopC].clear();
+      }
+      if(enterX < nx){
+        for(int loopZ=minZ;loopZ<=maxZ;loopZ++){
+          for(int loopY=minY;loopY<=maxY;loopY++){
+            int currCell = (loopZ*ny + loopY)*nx + enterX;
+            if(fluidMask.isFluid(currCell)){
+              for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+                entering[loopC].push_back(inVel[loopC][currCell]);
+              }
+            }
+          }
+        }
+      }
+      // Entering and leaving columns share the same ring slot
+      int slot = (enterX % width);
+      for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+        std::sort(entering[loopC].begin(),entering[loopC].end(),medianLess);
+        const mriDoubleVec& leaving = (leaveX >= 0) ? columns[loopC*width+slot] : noValues;
+        mergeSortedWindow(window[loopC],leaving,entering[loopC],merged);
+        window[loopC].swap(merged);
+        columns[loopC*width+slot].swap(entering[loopC]);
+      }
+      if(loopB < 0){
+        continue;
+      }
+      // Median in the centre cell
+      int currCell = loopA*nx + loopB;
+      for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+        if(fluidMask.isFluid(currCell)){
+          outVel[loopC][currCell] = window[loopC][window[loopC].size()/2];
+        }else{
+          outVel[loopC][currCell] = inVel[loopC][currCell];
+        }
+      }
+    }
+  }
+}
+
+// ===================
+// APPLY MEDIAN FILTER
+// ===================
+void mriMedianFilter::apply(mriTopology* topology, const mriFluidMask& fluidMask, double** inVel, double** outVel) const{
+  int totals[3] = {topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]};
+  // Slabs of contiguous x-rows on the worker threads
+  int rowsPerBlock = std::max(1,kParallelBlockSize/totals[0]);
+  mriParallel::parallelFor(totals[1]*totals[2],rowsPerBlock,[&](int /*thread*/,int begin,int end){
+    if(order <= kMedianGatherMaxOrder){
+      filterRowsGather(totals,fluidMask,inVel,outVel,begin,end);
+    }else{
+      filterRowsWindow(totals,fluidMask,inVel,outVel,begin,end);
+    }
+  });
+}
@@ -0,0 +1,74 @@
+#ifndef MRIMEDIANFILTER_H
+#define MRIMEDIANFILTER_H
+
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriConstants.h"
+# include "mriException.h"
+# include "mriFluidMask.h"
+
+class mriTopology;
+
+using namespace std;
+
+// Largest order filtered by gathering the full box around every cell,
+// higher orders update a sorted window while moving along the x-rows
+const int kMedianGatherMaxOrder = 2;
+
+// Order of the values in a median, NaN sorts after all numbers so a
+// window holding NaN stays sorted and its values can be removed
+inline bool medianLess(double first, double second){
+  return (first < second)||((second != second)&&(first == first));
+}
+
+// Merge step of the sliding window filter
+void mergeSortedWindow(const mriDoubleVec& window, const mriDoubleVec& leaving, const mriDoubleVec& entering, mriDoubleVec& result);
+
+// =====================================
+// COMPARATOR NETWORK SELECTING A MEDIAN
+// =====================================
+// Batcher odd-even merge sort reduced to the comparators that
+// the middle output depends on. Branch-free for a fixed count.
+class mriMedianNetwork{
+  public:
+    // CONSTRUCTOR
+    mriMedianNetwork();
+
+    // MEMBER FUNCTIONS
+    void build(int totValues);
+    int getSize() const{return totValues;}
+    // Value with index totValues/2 in sorted order, values are reordered
+    double select(double* values) const;
+
+  private:
+    int totValues;
+    mriIntVec first;
+    mriIntVec second;
+};
+
+// ==============================================
+// MEDIAN FILTER ON THE THREE VELOCITY COMPONENTS
+// ==============================================
+// Every fluid cell gets the median of the fluid cells in the
+// (2*order+1)^3 box around it, non-fluid cells keep their value.
+// NaN values count as larger than all numbers.
+class mriMedianFilter{
+  public:
+    // CONSTRUCTOR
+    mriMedianFilter(int order);
+
+    // Filter the components in inVel into outVel
+    void apply(mriTopology* topology, const mriFluidMask& fluidMask, double** inVel, double** outVel) const;
+
+  private:
+    int order;
+    // Network for a box with all cells fluid
+    mriMedianNetwork network;
+
+    // Work on the x-rows [firstRow,lastRow)
+    void filterRowsGather(const int* totals, const mriFluidMask& fluidMask, double** inVel, double** outVel, int firstRow, int lastRow) const;
+    void filterRowsWindow(const int* totals, const mriFluidMask& fluidMask, double** inVel, double** outVel, int firstRow, int lastRow) const;
+};
+
+#endif // MRIMEDIANFILTER_H
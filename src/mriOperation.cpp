@@ -20,7 +20,8 @@ mriOpExportForPoissonSolver::mriOpExportForPoissonSolver(string fileName,
                                                          bool PPE_IncludeReynoldsTerm,
                                                          bool readMuTFromFile,
                                                          string muTFile,
-                                                         double smagorinskyCoeff){
+                                                         double smagorinskyCoeff,
+                                                         int exportFormat){
   this->fileName = fileName;
   this->density = density;
   this->viscosity = viscosity;
@@ -31,6 +32,13 @@ mriOpExportForPoissonSolver::mriOpExportForPoissonSolver(string fileName,
   this->readMuTFromFile = readMuTFromFile;
   this->muTFile = muTFile;
   this->smagorinskyCoeff = smagorinskyCoeff;
+  this->exportFormat = exportFormat;
+}
+
+// CONSTRUCTOR FOR DISTANCE EXPORT
+mriOpExportForDistanceSolver::mriOpExportForDistanceSolver(string distanceFileName, int exportFormat){
+  this->distanceFileName = distanceFileName;
+  this->exportFormat = exportFormat;
 }
 
 // DATA MEMBER
@@ -40,12 +48,38 @@ mriOpApplySmoothing::mriOpApplySmoothing(int filterNumIterations, int filterType
   this->filterOrder = filterOrder;
 }
 
+// CONSTRUCTOR FOR PRESSURE SOLVER OPERATION
+mriOpSolvePressurePoisson::mriOpSolvePressurePoisson(double density, double viscosity, int maxIt, double tolerance){
+  this->density = density;
+  this->viscosity = viscosity;
+  this->maxIt = maxIt;
+  this->tolerance = tolerance;
+}
+
+// CONSTRUCTOR FOR DIVERGENCE SMOOTHING OPERATION
+mriOpApplyDivergenceSmoothing::mriOpApplyDivergenceSmoothing(int maxIt, double tolerance, string historyFileName){
+  this->maxIt = maxIt;
+  this->tolerance = tolerance;
+  this->historyFileName = historyFileName;
+}
+
+// CONSTRUCTOR FOR REGION TAGGING
+mriOpTagRegions::mriOpTagRegions(int regionType){
+  this->regionType = regionType;
+}
+
 // INITIALIZE APPLY NOISE OPERATION
 mriOpApplyNoise::mriOpApplyNoise(double noiseIntensity, double seed){
   this->noiseIntensity = noiseIntensity;
   this->seed = seed;
 }
 
+// CONSTRUCTOR FOR EXPANSION COEFFICIENT EXPORT
+mriOpWriteExpansionCoefficients::mriOpWriteExpansionCoefficients(string outputFileName, const mriExpansionFileFormat& format){
+  this->outputFileName = outputFileName;
+  this->format = format;
+}
+
 // CONSTRUCTOR FOR SOLENOIDAL FILTER OPERATION
 mriOpApplySolenoidalFilter::mriOpApplySolenoidalFilter(bool applyBCFilter,bool useConstantPatterns,double itTol,int maxIt){
   this->applyBCFilter = applyBCFilter;
@@ -77,9 +111,22 @@ void mriOpApplyNoise::processSequence(mriCommunicator* comm, mriThresholdCriteri
 
 // APPLY SMOOTHING FILTER
 void mriOpApplySmoothing::processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq){
-  seq->applyMedianFilter(kQtyVelocityX,numIterations,filterOrder,filterType,thresholdCriteria);
-  seq->applyMedianFilter(kQtyVelocityY,numIterations,filterOrder,filterType,thresholdCriteria);
-  seq->applyMedianFilter(kQtyVelocityZ,numIterations,filterOrder,filterType,thresholdCriteria);
+  seq->applyVelocityFilter(numIterations,filterOrder,filterType,thresholdCriteria);
+}
+
+// SOLVE PRESSURE POISSON EQUATION
+void mriOpSolvePressurePoisson::processSequence(mriCommunicator* /*comm*/, mriThresholdCriteria* thresholdCriteria, mriSequence* seq){
+  seq->solvePressurePoisson(thresholdCriteria,density,viscosity,maxIt,tolerance);
+}
+
+// APPLY LAVISION DIVERGENCE SMOOTHING
+void mriOpApplyDivergenceSmoothing::processSequence(mriCommunicator* /*comm*/, mriThresholdCriteria* /*thresholdCriteria*/, mriSequence* seq){
+  seq->applyDivergenceSmoothing(maxIt,tolerance,historyFileName);
+}
+
+// TAG CONNECTED REGIONS
+void mriOpTagRegions::processSequence(mriCommunicator* /*comm*/, mriThresholdCriteria* thresholdCriteria, mriSequence* seq){
+  seq->tagRegions(thresholdCriteria,regionType);
 }
 
 // CLEAN NORMAL COMPONENT ON BOUNDARY
@@ -132,7 +179,7 @@ void mriOpComputeSMPVortexCriteria::processSequence(mriCommunicator* comm, mriTh
 
 // WRITE EXPANSION COEFFICIENTS
 void mriOpWriteExpansionCoefficients::processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq){
-  seq->writeExpansionFile(string(outputFileName + "_expCoeff"));
+  seq->writeExpansionFile(string(outputFileName + "_expCoeff"),format);
 }
 
 // EXPORT FOR FINITE ELEMENT POISSON SOLVER
@@ -144,12 +191,13 @@ void mriOpExportForPoissonSolver::processSequence(mriCommunicator* comm, mriThre
                         PPE_IncludeReynoldsTerm,
                         readMuTFromFile,
                         muTFile,
-                        smagorinskyCoeff);
+                        smagorinskyCoeff,
+                        exportFormat);
 }
 
 // EXPORT FOR DISTANCE COMPUTATION
 void mriOpExportForDistanceSolver::processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq){
-  seq->exportForDistancing(distanceFileName,thresholdCriteria);
+  seq->exportForDistancing(distanceFileName,thresholdCriteria,exportFormat);
 }
 
 // DATA MEMBER
@@ -160,21 +208,21 @@ void mriOpEvalStatistics::processSequence(mriCommunicator* comm, mriThresholdCri
   double zFactor = 1.0;
   mriUtils::applyLimitBoxFactors(xFactor,yFactor,zFactor,limitBox);
   
-  // Allocate Bin Arrays
-  mriDoubleVec binCenters(numberOfBins);
-  mriDoubleVec binValues(numberOfBins);
-  // Eval Single PDFs
-  // FIRST
-  seq->getScan(0)->evalScanPDF(kQtyVelModule,numberOfBins,useBox,limitBox,binCenters,binValues);
-  mriUtils::printBinArrayToFile(statFileNameFirst,numberOfBins,binCenters,binValues);
-
-  // SECOND
-  seq->getScan(0)->evalScanPDF(kQtyVelModule,numberOfBins,useBox,limitBox,binCenters,binValues);
-  mriUtils::printBinArrayToFile(statFileNameSecond,numberOfBins,binCenters,binValues);
-
-  // DIFFERENCE
-  seq->evalScanDifferencePDF(1,0,kQtyVelModule,numberOfBins,useBox,limitBox,binCenters,binValues);
-  mriUtils::printBinArrayToFile(statFileNameDiff,numberOfBins,binCenters,binValues);
+  // PDFs of the first scan, the second scan and their difference in one pass
+  mriHistogramSet histoSet;
+  histoSet.addHistogram(&seq->getScan(0)->cells,NULL,kQtyVelModule,numberOfBins,kPDFMinAbsValue);
+  histoSet.addHistogram(&seq->getScan(1)->cells,NULL,kQtyVelModule,numberOfBins,kPDFMinAbsValue);
+  histoSet.addHistogram(&seq->getScan(1)->cells,&seq->getScan(0)->cells,kQtyVelModule,numberOfBins,0.0);
+  // Cells are shared among the processes
+  histoSet.evaluate(seq->topology,useBox ? &limitBox : NULL,comm);
+  for(size_t loopA=0;loopA<histoSet.histograms.size();loopA++){
+    histoSet.histograms[loopA].normalize();
+  }
+  if(comm->currProc == 0){
+    mriUtils::printBinArrayToFile(statFileNameFirst,numberOfBins,histoSet.histograms[0].binCenters,histoSet.histograms[0].binValues);
+    mriUtils::printBinArrayToFile(statFileNameSecond,numberOfBins,histoSet.histograms[1].binCenters,histoSet.histograms[1].binValues);
+    mriUtils::printBinArrayToFile(statFileNameDiff,numberOfBins,histoSet.histograms[2].binCenters,histoSet.histograms[2].binValues);
+  }
 }
 
 // COMPUTE SCAN MATRICES
@@ -67,6 +67,31 @@ class mriOpApplySmoothing: public mriOperation{
     virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
 };
 
+// APPLY LAVISION DIVERGENCE SMOOTHING
+class mriOpApplyDivergenceSmoothing: public mriOperation{
+  public:
+    int maxIt;
+    double tolerance;
+    // Residual history, not written if empty
+    string historyFileName;
+
+    // CONSTRUCTOR
+    mriOpApplyDivergenceSmoothing(int maxIt, double tolerance, string historyFileName);
+    // DATA MEMBER
+    virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
+};
+
+// TAG CONNECTED REGIONS
+class mriOpTagRegions: public mriOperation{
+  public:
+    int regionType;
+
+    // CONSTRUCTOR
+    mriOpTagRegions(int regionType);
+    // DATA MEMBER
+    virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
+};
+
 // CLEAN NORMAL COMPONENT ON BOUNDARY
 class mriOpCleanNormalComponentOnBoundary: public mriOperation{
   public:
@@ -123,6 +148,9 @@ class mriOpComputeSMPVortexCriteria: public mriOperation{
 class mriOpWriteExpansionCoefficients: public mriOperation{
   public:
     string outputFileName;
+    mriExpansionFileFormat format;
+    // CONSTRUCTOR
+    mriOpWriteExpansionCoefficients(string outputFileName, const mriExpansionFileFormat& format);
     // DATA MEMBER
     virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
 };
@@ -144,6 +172,8 @@ class mriOpExportForPoissonSolver: public mriOperation{
     bool readMuTFromFile;
     string muTFile;
     double smagorinskyCoeff;
+    // Text or binary solver files
+    int exportFormat;
 
     // CONSTRUCTOR
     mriOpExportForPoissonSolver(string fileName,
@@ -155,16 +185,34 @@ class mriOpExportForPoissonSolver: public mriOperation{
                                 bool PPE_IncludeReynoldsTerm,
                                 bool readMuTFromFile,
                                 string muTFile,
-                                double smagorinskyCoeff);
+                                double smagorinskyCoeff,
+                                int exportFormat);
 
     // DATA MEMBER
     virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
 };
 
+// SOLVE PRESSURE POISSON EQUATION
+class mriOpSolvePressurePoisson: public mriOperation{
+  public:
+    double density;
+    double viscosity;
+    int maxIt;
+    double tolerance;
+
+    // CONSTRUCTOR
+    mriOpSolvePressurePoisson(double density, double viscosity, int maxIt, double tolerance);
+    // DATA MEMBER
+    virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
+};
+
 // EXPORT FOR DISTANCE COMPUTATION
 class mriOpExportForDistanceSolver: public mriOperation{
   public:
     string distanceFileName;
+    int exportFormat;
+    // CONSTRUCTOR
+    mriOpExportForDistanceSolver(string distanceFileName, int exportFormat);
     // DATA MEMBER
     virtual void processSequence(mriCommunicator* comm, mriThresholdCriteria* thresholdCriteria, mriSequence* seq);
 };
@@ -34,6 +34,21 @@ mriOptions::mriOptions(){
   readMuTFromFile = false;
   muTFile = "";
   smagorinskyCoeff = 0.15;
+  // Face and Edge Numbering
+  topologyOrdering = kOrderingFirstSeen;
+  // Worker threads, zero uses the cores per MPI rank
+  threadCount = 0;
+  // Compressed VTK XML output
+  vtkXMLCompression = kVTKCompressZLib;
+  // Sequence files favour speed over size
+  sequenceCompression = kSequenceCompressLZ4;
+  // Expansion coefficients as text, binary files drop exact zeros when sparse
+  expansionFormat.layout = kExpansionFileText;
+  expansionFormat.isSinglePrecision = false;
+  expansionFormat.isDeltaEncoded = true;
+  expansionFormat.tolerance = 0.0;
+  // Solver exports as text
+  feExportFormat = kFEExportText;
 }
 
 mriOptions::~mriOptions(){
@@ -161,7 +176,7 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
   int maxIt;
 
   bool saveInitialVel;
-  bool saveExpansionCoeffs;
+  bool saveExpansionCoeffs = false;
 
   bool applySMPFilter;
   bool applyBCFilter;
@@ -173,7 +188,7 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
   bool evalSMPVortexCriterion;
   bool evalPressure;
   bool exportToPoisson;
-  bool exportToDistance;
+  bool exportToDistance = false;
   string distanceFileName;
   string poissonFileName;
   bool applyNoise;
@@ -266,6 +281,41 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
         }catch(...){
           throw mriException("ERROR: Invalid Median Filter Entry.\n");
         }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("APPLYDIVERGENCESMOOTHING")){
+      int smoothMaxIt = 0;
+      double smoothTolerance = 0.0;
+      string historyFileName("");
+      try{
+        smoothMaxIt = atoi(tokenizedString.at(1).c_str());
+        smoothTolerance = atof(tokenizedString.at(2).c_str());
+      }catch(...){
+        throw mriException("ERROR: Invalid Divergence Smoothing Entry.\n");
+      }
+      if(smoothMaxIt < 1){
+        throw mriException("ERROR: Invalid Divergence Smoothing Iterations.\n");
+      }
+      if(tokenizedString.size() > 3){
+        historyFileName = tokenizedString.at(3);
+      }
+      // Create New Operation
+      mriOperation* op = new mriOpApplyDivergenceSmoothing(smoothMaxIt,smoothTolerance,historyFileName);
+      // Add to the operation list
+      operationList.push_back(op);
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("TAGREGIONS")){
+      int regionType = kRegionFluid;
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("FLUID")){
+        regionType = kRegionFluid;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("BOUNDARY")){
+        regionType = kRegionBoundary;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("VORTEXCORES")){
+        regionType = kRegionVortexCore;
+      }else{
+        throw mriException("ERROR: Invalid region type.\n");
+      }
+      // Create New Operation
+      mriOperation* op = new mriOpTagRegions(regionType);
+      // Add to the operation list
+      operationList.push_back(op);
     }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("SMPITERATIONTOLERANCE")){
       try{
         itTol = atof(tokenizedString.at(1).c_str());
@@ -343,14 +393,24 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
         inputFormatType = itTEMPLATE;
       }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("EXPANSION")){
         inputFormatType = itEXPANSION;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("SEQUENCE")){
+        inputFormatType = itFILESEQUENCE;
       }else{
         throw mriException("ERROR: Invalid input file type.\n");
       }
     }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("OUTPUTTYPE")){
       if(boost::to_upper_copy(tokenizedString.at(1)) == string("VTK")){
         outputFormatType = otFILEVTK;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("VTKBINARY")){
+        outputFormatType = otFILEVTKBINARY;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("VTKXML")){
+        outputFormatType = otFILEVTKXML;
       }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("PLT")){
         outputFormatType = otFILEPLT;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("PLTBINARY")){
+        outputFormatType = otFILEPLTBINARY;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("SEQUENCE")){
+        outputFormatType = otFILESEQUENCE;
       }else{
         throw mriException("ERROR: Invalid output file type.\n");
       }
@@ -455,7 +515,24 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
                                                          PPE_IncludeReynoldsTerm,
                                                          readMuTFromFile,
                                                          muTFile,
-                                                         smagorinskyCoeff);
+                                                         smagorinskyCoeff,
+                                                         feExportFormat);
+      // Add to the operation list
+      operationList.push_back(op);
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("SOLVEPRESSURE")){
+      int solverMaxIt = 0;
+      double solverTolerance = 0.0;
+      try{
+        solverMaxIt = atoi(tokenizedString.at(1).c_str());
+        solverTolerance = atof(tokenizedString.at(2).c_str());
+      }catch(...){
+        throw mriException("ERROR: Invalid Pressure Solver Entry.\n");
+      }
+      if(solverMaxIt < 1){
+        throw mriException("ERROR: Invalid Pressure Solver Iterations.\n");
+      }
+      // Create Operation For the Native Pressure Solver
+      mriOperation* op = new mriOpSolvePressurePoisson(density,viscosity,solverMaxIt,solverTolerance);
       // Add to the operation list
       operationList.push_back(op);
     }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("EXPORTTODISTANCE")){
@@ -464,7 +541,9 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
       }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("FALSE")){
         exportToDistance = false;
       }else{
-        throw mriException("ERROR: Invalid logical value for exportToDistance.\n");
+        // File name given with the token
+        exportToDistance = true;
+        distanceFileName = tokenizedString.at(1);
       }
     }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("DISTANCEFILE")){
       distanceFileName = tokenizedString.at(1);
@@ -542,6 +621,95 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
       }catch(...){
         throw mriException("ERROR: Invalid Smagorinsky Constant.\n");
       }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("TOPOLOGYORDERING")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("DEFAULT")){
+        topologyOrdering = kOrderingFirstSeen;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("MORTON")){
+        topologyOrdering = kOrderingMorton;
+      }else{
+        throw mriException("ERROR: Invalid value for TOPOLOGYORDERING.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("THREADS")){
+      threadCount = atoi(tokenizedString.at(1).c_str());
+      if(threadCount < 0){
+        throw mriException("ERROR: Invalid number of THREADS.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("VTKXMLCOMPRESSION")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("NONE")){
+        vtkXMLCompression = kVTKCompressNone;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("ZLIB")){
+        vtkXMLCompression = kVTKCompressZLib;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("LZ4")){
+        vtkXMLCompression = kVTKCompressLZ4;
+      }else{
+        throw mriException("ERROR: Invalid value for VTKXMLCOMPRESSION.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("SEQUENCECOMPRESSION")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("NONE")){
+        sequenceCompression = kSequenceCompressNone;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("ZLIB")){
+        sequenceCompression = kSequenceCompressZLib;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("LZ4")){
+        sequenceCompression = kSequenceCompressLZ4;
+      }else{
+        throw mriException("ERROR: Invalid value for SEQUENCECOMPRESSION.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("EXPANSIONFORMAT")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("TEXT")){
+        expansionFormat.layout = kExpansionFileText;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("DENSE")){
+        expansionFormat.layout = kExpansionFileDense;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("SPARSE")){
+        expansionFormat.layout = kExpansionFileSparse;
+      }else{
+        throw mriException("ERROR: Invalid value for EXPANSIONFORMAT.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("EXPANSIONPRECISION")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("DOUBLE")){
+        expansionFormat.isSinglePrecision = false;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("SINGLE")){
+        expansionFormat.isSinglePrecision = true;
+      }else{
+        throw mriException("ERROR: Invalid value for EXPANSIONPRECISION.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("EXPANSIONDELTAINDICES")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("TRUE")){
+        expansionFormat.isDeltaEncoded = true;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("FALSE")){
+        expansionFormat.isDeltaEncoded = false;
+      }else{
+        throw mriException("ERROR: Invalid logical value for EXPANSIONDELTAINDICES.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("EXPANSIONTOLERANCE")){
+      try{
+        expansionFormat.tolerance = atof(tokenizedString.at(1).c_str());
+      }catch(...){
+        throw mriException("ERROR: Invalid value for EXPANSIONTOLERANCE.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("FEEXPORTFORMAT")){
+      if(boost::to_upper_copy(tokenizedString.at(1)) == string("TEXT")){
+        feExportFormat = kFEExportText;
+      }else if(boost::to_upper_copy(tokenizedString.at(1)) == string("BINARY")){
+        feExportFormat = kFEExportBinary;
+      }else{
+        throw mriException("ERROR: Invalid value for FEEXPORTFORMAT.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("INPUTPHASES")){
+      inputPhases.clear();
+      for(size_t loopA=1;loopA<tokenizedString.size();loopA++){
+        inputPhases.push_back(atoi(tokenizedString[loopA].c_str()));
+      }
+      if((inputPhases.size() != 2)||(inputPhases[0] < 0)||(inputPhases[0] > inputPhases[1])){
+        throw mriException("ERROR: Invalid INPUTPHASES, expected first,last.\n");
+      }
+    }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("INPUTBOX")){
+      inputBox.clear();
+      for(size_t loopA=1;loopA<tokenizedString.size();loopA++){
+        inputBox.push_back(atoi(tokenizedString[loopA].c_str()));
+      }
+      if(inputBox.size() != 6){
+        throw mriException("ERROR: Invalid INPUTBOX, expected iMin,iMax,jMin,jMax,kMin,kMax.\n");
+      }
     }else if(boost::to_upper_copy(tokenizedString.at(0)) == string("SCALEVELOCITY")){
         try{
           scaleVelocities = true;
@@ -602,6 +770,19 @@ int mriOptions::getOptionsFromCommandFile(string commandFile){
   }
   // Close File
   infile.close();
+  // Distance export after the operations on the velocities
+  if(exportToDistance){
+    if(distanceFileName.empty()){
+      throw mriException("ERROR: Missing DISTANCEFILE for EXPORTTODISTANCE.\n");
+    }
+    mriOperation* op = new mriOpExportForDistanceSolver(distanceFileName,feExportFormat);
+    operationList.push_back(op);
+  }
+  // Coefficients are saved after all other operations
+  if(saveExpansionCoeffs){
+    mriOperation* op = new mriOpWriteExpansionCoefficients(outputFileName,expansionFormat);
+    operationList.push_back(op);
+  }
   // Return
   return 0;
 }
@@ -14,6 +14,10 @@
 # include "mriConstants.h"
 # include "mriUtils.h"
 # include "mriException.h"
+# include "mriVTKXMLWriter.h"
+# include "mriSequenceFile.h"
+# include "mriExpansionFile.h"
+# include "mriFEMesh.h"
 
 using namespace std;
 
@@ -44,10 +48,15 @@ using namespace std;
   const int itFILEPLT                       = 1;
   const int itTEMPLATE                      = 2;
   const int itEXPANSION                     = 3;
+  const int itFILESEQUENCE                  = 4;
 
   // OUTPUT TYPES
   const int otFILEVTK                       = 0;
   const int otFILEPLT                       = 1;
+  const int otFILEVTKBINARY                 = 2;
+  const int otFILEVTKXML                    = 3;
+  const int otFILESEQUENCE                  = 4;
+  const int otFILEPLTBINARY                 = 5;
 
 class mriOperation;
 
@@ -74,6 +83,17 @@ public:
   // Export File Format
   int inputFormatType;
   int outputFormatType;
+  // Block compression of VTK XML files
+  int vtkXMLCompression;
+  // Brick compression of sequence files
+  int sequenceCompression;
+  // Layout of the expansion coefficient files
+  mriExpansionFileFormat expansionFormat;
+  // Text or binary finite element solver exports
+  int feExportFormat;
+  // Phases and cell box read from a sequence file, empty reads all
+  mriIntVec inputPhases;
+  mriIntVec inputBox;
   // Material Properties
   double density;
   double viscosity;
@@ -90,6 +110,10 @@ public:
   bool readMuTFromFile;
   string muTFile;
   double smagorinskyCoeff;
+  // Face and Edge Numbering
+  int topologyOrdering;
+  // Worker threads per MPI rank
+  int threadCount;
   // List of operations
   vector<mriOperation*> operationList;
 
@@ -1,7 +0,0 @@
-#include "mriOutput.h"
-
-// CONSTRUCTOR
-mriOutput::mriOutput(string locName, int comp){
-  name = locName;
-  totComponents = comp;
-}
@@ -0,0 +1,58 @@
+#include <string.h>
+#include "mriPLTReader.h"
+#include "mriIO.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriPLTReader::mriPLTReader(string fileName, bool headerOnly){
+  this->fileName = fileName;
+  resetPLTOptions(options);
+  options.headerCount = 0;
+  totPoints = 0;
+
+  // Header lines up to the first line of numbers
+  mriMappedFile file(fileName);
+  mriStringVec tokenizedString;
+  const char* dataStart = NULL;
+  const char* lineStart = file.begin();
+  const char* fileEnd = file.end();
+  while(lineStart < fileEnd){
+    const char* lineEnd = (const char*)memchr(lineStart,'\n',fileEnd - lineStart);
+    if(lineEnd == NULL){
+      lineEnd = fileEnd;
+    }
+    string buffer(lineStart,lineEnd);
+    boost::trim(buffer);
+    boost::split(tokenizedString, buffer, boost::is_any_of("= ,"), boost::token_compress_on);
+    assignPLTOptions(tokenizedString, options);
+    bool areAllFloats = true;
+    for(size_t loopA=0;loopA<tokenizedString.size();loopA++){
+      areAllFloats = (areAllFloats && (mriUtils::isFloat(tokenizedString[loopA])));
+    }
+    options.headerCount++;
+    if(areAllFloats){
+      dataStart = lineStart;
+      break;
+    }
+    lineStart = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+  }
+  if(headerOnly){
+    return;
+  }
+
+  // Point data, one value per variable and point
+  mriTextBlock text((dataStart == NULL) ? fileEnd : dataStart,fileEnd);
+  size_t totValues = (size_t)options.i*(size_t)options.j*(size_t)options.k*kPLTTotalColumns;
+  if(text.getTotalValues() != totValues){
+    throw mriException("ERROR: cell number mismatch while reading PLT file");
+  }
+  totPoints = options.i*options.j*options.k;
+  columns.resize(kPLTTotalColumns);
+  double* values[kPLTTotalColumns];
+  for(int loopA=0;loopA<kPLTTotalColumns;loopA++){
+    columns[loopA].resize(totPoints);
+    values[loopA] = columns[loopA].data();
+  }
+  text.parse(kPLTTotalColumns,totPoints,values);
+}
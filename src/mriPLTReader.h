@@ -0,0 +1,41 @@
+#ifndef MRIPLTREADER_H
+#define MRIPLTREADER_H
+
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriTextFile.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Values on every point of an ordered zone: X, Y, Z, concentration, Vx, Vy, Vz
+const int kPLTTotalColumns = 7;
+
+// ====================================
+// ASCII TECPLOT FILE WITH ORDERED ZONE
+// ====================================
+// The file is memory-mapped, the header lines are read up to the first
+// line of numbers and the point data is then parsed once in parallel, one
+// column per variable. Topology and scan are both built from the same
+// reader. A header only reader knows the zone sizes but has no columns.
+class mriPLTReader{
+  public:
+    // CONSTRUCTOR
+    mriPLTReader(string fileName, bool headerOnly = false);
+
+    // MEMBER FUNCTIONS
+    string getFileName() const{return fileName;}
+    const pltOptionRecord& getOptions() const{return options;}
+    int getTotalPoints() const{return totPoints;}
+    const mriDoubleVec& getColumn(int column) const{return columns[column];}
+
+  private:
+    string fileName;
+    pltOptionRecord options;
+    int totPoints;
+    mriDoubleMat columns;
+};
+
+#endif // MRIPLTREADER_H
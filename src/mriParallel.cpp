@@ -0,0 +1,370 @@
+#include <thread>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+#include "mriParallel.h"
+
+namespace{
+  // Threads requested from the command file, zero uses the default
+  int requestedThreads = 0;
+  // Cores per MPI rank on the current node
+  int defaultThreads = 1;
+  // Threads of the loops run by a task pool worker, zero outside pools
+  thread_local int workerThreads = 0;
+
+  // Sets the loop threads of the current thread while in scope
+  class mriScopedLoopThreads{
+    public:
+      mriScopedLoopThreads(int threads){
+        savedThreads = workerThreads;
+        workerThreads = threads;
+      }
+      ~mriScopedLoopThreads(){
+        workerThreads = savedThreads;
+      }
+    private:
+      int savedThreads;
+  };
+
+  // =================================
+  // ONE LOOP SHARED BY POOLED THREADS
+  // =================================
+  struct mriLoopJob{
+    const mriLoopBody& body;
+    int totItems;
+    int blockSize;
+    int totBlocks;
+    int totThreads;
+    // Blocks are handed out dynamically, each block is processed exactly once
+    std::atomic<int> nextBlock;
+    std::vector<std::exception_ptr> errors;
+    // Pool threads working on the loop, guarded by the pool mutex
+    int activeHelpers;
+
+    mriLoopJob(const mriLoopBody& body, int totItems, int blockSize, int totBlocks, int totThreads):
+      body(body),totItems(totItems),blockSize(blockSize),totBlocks(totBlocks),totThreads(totThreads),
+      nextBlock(0),errors(totThreads),activeHelpers(0){}
+
+    void runBlocks(int thread){
+      try{
+        int currBlock = nextBlock++;
+        while(currBlock < totBlocks){
+          body(thread,currBlock*blockSize,std::min(totItems,(currBlock+1)*blockSize));
+          currBlock = nextBlock++;
+        }
+      }catch(...){
+        errors[thread] = std::current_exception();
+        // Stop handing out blocks
+        nextBlock = totBlocks;
+      }
+    }
+  };
+
+  // ====================================
+  // PERSISTENT THREADS OF PARALLEL LOOPS
+  // ====================================
+  // Every loop queues one ticket per helper thread it wants and works as
+  // thread zero. When its blocks are done it drops the tickets no helper
+  // has taken yet, so a loop never waits for busy threads to start. Threads
+  // are started on first use and nested loops run serially on them.
+  class mriLoopPool{
+    public:
+      mriLoopPool(){
+        busyHelpers = 0;
+        isStopping = false;
+      }
+      ~mriLoopPool(){
+        {
+          std::lock_guard<std::mutex> lock(poolMutex);
+          isStopping = true;
+        }
+        ticketReady.notify_all();
+        for(size_t loopA=0;loopA<helpers.size();loopA++){
+          helpers[loopA].join();
+        }
+      }
+
+      void run(mriLoopJob& job){
+        {
+          std::lock_guard<std::mutex> lock(poolMutex);
+          for(int loopA=1;loopA<job.totThreads;loopA++){
+            tickets.push_back(std::make_pair(&job,loopA));
+          }
+          // Start threads for all loops waiting at the same time
+          while(helpers.size() < tickets.size() + busyHelpers){
+            helpers.push_back(std::thread(&mriLoopPool::runHelper,this));
+          }
+        }
+        ticketReady.notify_all();
+        {
+          mriScopedLoopThreads serialNested(1);
+          job.runBlocks(0);
+        }
+        std::unique_lock<std::mutex> lock(poolMutex);
+        for(std::deque<mriLoopTicket>::iterator it=tickets.begin();it!=tickets.end();){
+          if(it->first == &job){
+            it = tickets.erase(it);
+          }else{
+            ++it;
+          }
+        }
+        helperDone.wait(lock,[&job]{return job.activeHelpers == 0;});
+      }
+
+    private:
+      typedef std::pair<mriLoopJob*,int> mriLoopTicket;
+      std::vector<std::thread> helpers;
+      std::deque<mriLoopTicket> tickets;
+      std::mutex poolMutex;
+      std::condition_variable ticketReady;
+      std::condition_variable helperDone;
+      size_t busyHelpers;
+      bool isStopping;
+
+      void runHelper(){
+        workerThreads = 1;
+        while(true){
+          mriLoopTicket ticket;
+          {
+            std::unique_lock<std::mutex> lock(poolMutex);
+            ticketReady.wait(lock,[this]{return isStopping || (!tickets.empty());});
+            if(tickets.empty()){
+              return;
+            }
+            ticket = tickets.front();
+            tickets.pop_front();
+            ticket.first->activeHelpers++;
+            busyHelpers++;
+          }
+          ticket.first->runBlocks(ticket.second);
+          {
+            std::lock_guard<std::mutex> lock(poolMutex);
+            // The job may be gone once the lock is released
+            ticket.first->activeHelpers--;
+            busyHelpers--;
+          }
+          helperDone.notify_all();
+        }
+      }
+  };
+
+  // Started on the first parallel loop, joined at exit
+  mriLoopPool& getLoopPool(){
+    static mriLoopPool loopPool;
+    return loopPool;
+  }
+}
+
+// =============================================
+// DEFAULT THREADS FROM CORES PER RANK ON NODE
+// =============================================
+void mriParallel::initDefaultThreadCount(MPI_Comm comm){
+  int totCores = (int)std::thread::hardware_concurrency();
+  if(totCores < 1){
+    totCores = 1;
+  }
+  // Count the ranks sharing this node
+  int nodeRanks = 1;
+  MPI_Comm nodeComm;
+  if(MPI_Comm_split_type(comm,MPI_COMM_TYPE_SHARED,0,MPI_INFO_NULL,&nodeComm) == MPI_SUCCESS){
+    MPI_Comm_size(nodeComm,&nodeRanks);
+    MPI_Comm_free(&nodeComm);
+  }
+  defaultThreads = totCores/nodeRanks;
+  if(defaultThreads < 1){
+    defaultThreads = 1;
+  }
+}
+
+// ======================
+// SET NUMBER OF THREADS
+// ======================
+void mriParallel::setThreadCount(int threads){
+  if(threads < 0){
+    throw mriException("ERROR: Invalid number of threads.\n");
+  }
+  requestedThreads = threads;
+}
+
+// ======================
+// GET NUMBER OF THREADS
+// ======================
+int mriParallel::getThreadCount(){
+  if(workerThreads > 0){
+    return workerThreads;
+  }
+  if(requestedThreads > 0){
+    return requestedThreads;
+  }
+  return defaultThreads;
+}
+
+// ================
+// GET BLOCK COUNT
+// ================
+int mriParallel::getBlockCount(int totItems){
+  return (totItems + kParallelBlockSize - 1)/kParallelBlockSize;
+}
+
+// =======================
+// RUN LOOP ON ALL THREADS
+// =======================
+void mriParallel::parallelFor(int totItems, const mriLoopBody& body){
+  parallelFor(totItems,kParallelBlockSize,body);
+}
+
+void mriParallel::parallelFor(int totItems, int blockSize, const mriLoopBody& body){
+  if(blockSize < 1){
+    throw mriException("ERROR: Invalid block size in parallelFor.\n");
+  }
+  int totBlocks = (totItems + blockSize - 1)/blockSize;
+  int totThreads = getThreadCount();
+  if(totThreads > totBlocks){
+    totThreads = totBlocks;
+  }
+  // Run on the calling thread when there is nothing to share
+  if(totThreads <= 1){
+    for(int loopA=0;loopA<totBlocks;loopA++){
+      body(0,loopA*blockSize,std::min(totItems,(loopA+1)*blockSize));
+    }
+    return;
+  }
+
+  mriLoopJob job(body,totItems,blockSize,totBlocks,totThreads);
+  getLoopPool().run(job);
+
+  // Forward the first error to the caller
+  for(int loopA=0;loopA<totThreads;loopA++){
+    if(job.errors[loopA]){
+      std::rethrow_exception(job.errors[loopA]);
+    }
+  }
+}
+
+// ==========================
+// SUM BLOCK PARTIAL RESULTS
+// ==========================
+double mriParallel::sumBlocks(const mriDoubleVec& blockValues){
+  double result = 0.0;
+  for(size_t loopA=0;loopA<blockValues.size();loopA++){
+    result += blockValues[loopA];
+  }
+  return result;
+}
+
+// =================================
+// MAX OF NON-NEGATIVE BLOCK RESULTS
+// =================================
+double mriParallel::maxBlocks(const mriDoubleVec& blockValues){
+  double result = 0.0;
+  for(size_t loopA=0;loopA<blockValues.size();loopA++){
+    if(blockValues[loopA] > result){
+      result = blockValues[loopA];
+    }
+  }
+  return result;
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriTaskPool::mriTaskPool(int totThreads, int loopThreads){
+  if((totThreads < 1)||(loopThreads < 0)){
+    throw mriException("ERROR: Invalid number of threads in mriTaskPool.\n");
+  }
+  totPending = 0;
+  isStopping = false;
+  // Loops inside the tasks share the threads among the workers
+  if(loopThreads > 0){
+    threadsPerWorker = loopThreads;
+  }else{
+    threadsPerWorker = std::max(1,mriParallel::getThreadCount()/totThreads);
+  }
+  for(int loopA=0;loopA<totThreads;loopA++){
+    workers.push_back(std::thread(&mriTaskPool::runWorker,this));
+  }
+}
+
+// ==========
+// DESTRUCTOR
+// ==========
+mriTaskPool::~mriTaskPool(){
+  {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    taskDone.wait(lock,[this]{return totPending == 0;});
+    isStopping = true;
+  }
+  taskReady.notify_all();
+  for(size_t loopA=0;loopA<workers.size();loopA++){
+    workers[loopA].join();
+  }
+}
+
+// ===========
+// SUBMIT TASK
+// ===========
+void mriTaskPool::submit(const std::function<void()>& task){
+  {
+    std::lock_guard<std::mutex> lock(poolMutex);
+    tasks.push_back(task);
+    totPending++;
+  }
+  taskReady.notify_one();
+}
+
+// ============================
+// WAIT FOR FEWER PENDING TASKS
+// ============================
+void mriTaskPool::waitForSlots(int maxPending){
+  std::unique_lock<std::mutex> lock(poolMutex);
+  taskDone.wait(lock,[this,maxPending]{return totPending <= maxPending;});
+}
+
+// =======================
+// WAIT FOR ALL TASKS DONE
+// =======================
+void mriTaskPool::wait(){
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(poolMutex);
+    taskDone.wait(lock,[this]{return totPending == 0;});
+    error = firstError;
+    firstError = nullptr;
+  }
+  if(error){
+    std::rethrow_exception(error);
+  }
+}
+
+// =======================
+// WORKER THREAD MAIN LOOP
+// =======================
+void mriTaskPool::runWorker(){
+  workerThreads = threadsPerWorker;
+  while(true){
+    std::function<void()> task;
+    {
+      std::unique_lock<std::mutex> lock(poolMutex);
+      taskReady.wait(lock,[this]{return isStopping || (!tasks.empty());});
+      if(tasks.empty()){
+        return;
+      }
+      task = tasks.front();
+      tasks.pop_front();
+    }
+    std::exception_ptr error;
+    try{
+      task();
+    }catch(...){
+      error = std::current_exception();
+    }
+    {
+      std::lock_guard<std::mutex> lock(poolMutex);
+      if(error && (!firstError)){
+        firstError = error;
+      }
+      totPending--;
+    }
+    taskDone.notify_all();
+  }
+}
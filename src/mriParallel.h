@@ -0,0 +1,89 @@
+#ifndef MRIPARALLEL_H
+#define MRIPARALLEL_H
+
+# include <functional>
+# include <vector>
+# include <deque>
+# include <thread>
+# include <mutex>
+# include <condition_variable>
+# include <exception>
+# include "mpi.h"
+
+# include "mriTypes.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Items in one work block of a parallel loop. Blocks do not depend on the
+// number of threads, so reductions combined per block in block order give
+// the same result for any thread count
+const int kParallelBlockSize = 4096;
+
+// Loop body: worker thread index and half-open range of items [begin,end)
+typedef std::function<void(int thread,int begin,int end)> mriLoopBody;
+
+// SHARED MEMORY PARALLEL LOOPS
+namespace mriParallel{
+
+  // Default to the cores available per MPI rank on the current node
+  void initDefaultThreadCount(MPI_Comm comm);
+  // Set the number of worker threads, zero restores the default
+  void setThreadCount(int threads);
+  // Inside a mriTaskPool task, the share of threads of that worker
+  int  getThreadCount();
+
+  // Blocks covering totItems items
+  int getBlockCount(int totItems);
+  inline int getBlockIndex(int begin){return begin/kParallelBlockSize;}
+
+  // Run the body on all blocks of [0,totItems) using the persistent loop threads
+  void parallelFor(int totItems, const mriLoopBody& body);
+  // Same with a custom block size, for loops over rows or planes
+  void parallelFor(int totItems, int blockSize, const mriLoopBody& body);
+
+  // Sum per-block partial results in block order
+  double sumBlocks(const mriDoubleVec& blockValues);
+  // Maximum of non-negative per-block partial results
+  double maxBlocks(const mriDoubleVec& blockValues);
+
+}
+
+// ===============================
+// POOL OF BACKGROUND TASK THREADS
+// ===============================
+// Tasks are started in submission order on a fixed set of threads while
+// the caller keeps working. wait() returns when all tasks are done and
+// forwards the first error. Parallel loops run by a task use an even
+// share of the threads, so nested loops do not oversubscribe the cores.
+class mriTaskPool{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    // loopThreads sets the threads of the loops inside a task, zero shares
+    // the threads of the caller among the workers
+    mriTaskPool(int totThreads, int loopThreads = 0);
+    ~mriTaskPool();
+
+    // MEMBER FUNCTIONS
+    void submit(const std::function<void()>& task);
+    // Block until at most maxPending tasks are queued or running
+    void waitForSlots(int maxPending);
+    void wait();
+
+  private:
+    std::vector<std::thread> workers;
+    std::deque<std::function<void()> > tasks;
+    std::mutex poolMutex;
+    std::condition_variable taskReady;
+    std::condition_variable taskDone;
+    int totPending;
+    int threadsPerWorker;
+    bool isStopping;
+    std::exception_ptr firstError;
+    void runWorker();
+    // Not copyable
+    mriTaskPool(const mriTaskPool&);
+    mriTaskPool& operator=(const mriTaskPool&);
+};
+
+#endif // MRIPARALLEL_H
@@ -0,0 +1,417 @@
+#include <math.h>
+#include <algorithm>
+#include "mriPoisson.h"
+#include "mriTopology.h"
+#include "mriParallel.h"
+
+// ================================
+// RUN A LOOP ON ALL ROWS OF A GRID
+// ================================
+// The body gets the row index, its y and z coordinates and its first cell
+template <class Body>
+void forAllRows(const int* totals, Body body){
+  int nx = totals[0];
+  int ny = totals[1];
+  int rowsPerBlock = std::max(1,kParallelBlockSize/nx);
+  mriParallel::parallelFor(ny*totals[2],rowsPerBlock,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      body(loopA % ny,loopA / ny,loopA*nx);
+    }
+  });
+}
+
+// =========================
+// DOT PRODUCT OF TWO FIELDS
+// =========================
+double poissonDot(const double* first, const double* second, int totCells){
+  mriDoubleVec blockSum(mriParallel::getBlockCount(totCells),0.0);
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    double sum = 0.0;
+    for(int loopA=begin;loopA<end;loopA++){
+      sum += first[loopA]*second[loopA];
+    }
+    blockSum[mriParallel::getBlockIndex(begin)] = sum;
+  });
+  return mriParallel::sumBlocks(blockSum);
+}
+
+// ===============================
+// REMOVE THE MEAN ON ACTIVE CELLS
+// ===============================
+// Cells without open faces are not coupled and are set to zero
+void removeActiveMean(const mriPoissonLevel& level, double* values){
+  int totCells = level.totCells;
+  const double* diag = level.diag.data();
+  int totBlocks = mriParallel::getBlockCount(totCells);
+  mriDoubleVec blockSum(totBlocks,0.0);
+  mriDoubleVec blockCount(totBlocks,0.0);
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    double sum = 0.0;
+    double count = 0.0;
+    for(int loopA=begin;loopA<end;loopA++){
+      if(diag[loopA] > 0.0){
+        sum += values[loopA];
+        count += 1.0;
+      }
+    }
+    blockSum[mriParallel::getBlockIndex(begin)] = sum;
+    blockCount[mriParallel::getBlockIndex(begin)] = count;
+  });
+  double totActive = mriParallel::sumBlocks(blockCount);
+  double mean = (totActive > 0.0) ? mriParallel::sumBlocks(blockSum)/totActive : 0.0;
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      values[loopA] = (diag[loopA] > 0.0) ? values[loopA] - mean : 0.0;
+    }
+  });
+}
+
+// ============
+// RESIZE LEVEL
+// ============
+void mriPoissonLevel::resize(int nx, int ny, int nz){
+  totals[0] = nx;
+  totals[1] = ny;
+  totals[2] = nz;
+  totCells = nx*ny*nz;
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    faceCoeff[loopA].assign(totCells,0.0);
+  }
+  diag.assign(totCells,0.0);
+}
+
+// =================
+// EVAL THE DIAGONAL
+// =================
+void mriPoissonLevel::evalDiagonal(){
+  int stride[3] = {1,totals[0],totals[0]*totals[1]};
+  int coords[3] = {0,0,0};
+  for(int loopA=0;loopA<totCells;loopA++){
+    coords[0] = loopA % totals[0];
+    coords[1] = (loopA / totals[0]) % totals[1];
+    coords[2] = loopA / stride[2];
+    double sum = 0.0;
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      sum += faceCoeff[loopB][loopA];
+      if(coords[loopB] > 0){
+        sum += faceCoeff[loopB][loopA-stride[loopB]];
+      }
+    }
+    diag[loopA] = sum;
+  }
+}
+
+// ==================
+// APPLY THE OPERATOR
+// ==================
+void mriPoissonLevel::apply(const double* values, double* result) const{
+  int nx = totals[0];
+  int ny = totals[1];
+  int nz = totals[2];
+  int strideZ = nx*ny;
+  const double* coeffX = faceCoeff[0].data();
+  const double* coeffY = faceCoeff[1].data();
+  const double* coeffZ = faceCoeff[2].data();
+  const double* diagPtr = diag.data();
+  forAllRows(totals,[&](int currY,int currZ,int rowStart){
+    const double* val = values + rowStart;
+    double* res = result + rowStart;
+    const double* cx = coeffX + rowStart;
+    for(int loopA=0;loopA<nx;loopA++){
+      res[loopA] = diagPtr[rowStart+loopA]*val[loopA];
+    }
+    // Faces along x inside the row
+    for(int loopA=0;loopA<nx-1;loopA++){
+      res[loopA] -= cx[loopA]*val[loopA+1];
+      res[loopA+1] -= cx[loopA]*val[loopA];
+    }
+    // Faces along y and z shared with the neighbour rows
+    if(currY > 0){
+      const double* cy = coeffY + rowStart - nx;
+      for(int loopA=0;loopA<nx;loopA++){
+        res[loopA] -= cy[loopA]*val[loopA-nx];
+      }
+    }
+    if(currY < ny-1){
+      const double* cy = coeffY + rowStart;
+      for(int loopA=0;loopA<nx;loopA++){
+        res[loopA] -= cy[loopA]*val[loopA+nx];
+      }
+    }
+    if(currZ > 0){
+      const double* cz = coeffZ + rowStart - strideZ;
+      for(int loopA=0;loopA<nx;loopA++){
+        res[loopA] -= cz[loopA]*val[loopA-strideZ];
+      }
+    }
+    if(currZ < nz-1){
+      const double* cz = coeffZ + rowStart;
+      for(int loopA=0;loopA<nx;loopA++){
+        res[loopA] -= cz[loopA]*val[loopA+strideZ];
+      }
+    }
+  });
+}
+
+// ====================
+// DAMPED JACOBI SWEEPS
+// ====================
+void mriPoissonLevel::smooth(const double* rhs, double* values, double* scratch, int sweeps) const{
+  const double* diagPtr = diag.data();
+  for(int loopA=0;loopA<sweeps;loopA++){
+    apply(values,scratch);
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      for(int loopB=begin;loopB<end;loopB++){
+        if(diagPtr[loopB] > 0.0){
+          values[loopB] += kPoissonJacobiWeight*(rhs[loopB] - scratch[loopB])/diagPtr[loopB];
+        }
+      }
+    });
+  }
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriPoissonSolver::mriPoissonSolver(){
+  topology = NULL;
+}
+
+// =====================
+// BUILD LEVEL HIERARCHY
+// =====================
+void mriPoissonSolver::build(mriTopology* topology, const mriFluidMask& fluidMask){
+  this->topology = topology;
+  levels.clear();
+  levels.push_back(mriPoissonLevel());
+  mriPoissonLevel& fine = levels[0];
+  fine.resize(topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]);
+
+  // Face area over centre distance for faces between fluid cells
+  int coords[3] = {0,0,0};
+  for(int loopA=0;loopA<fine.totCells;loopA++){
+    coords[0] = loopA % fine.totals[0];
+    coords[1] = (loopA / fine.totals[0]) % fine.totals[1];
+    coords[2] = loopA / (fine.totals[0]*fine.totals[1]);
+    if(!fluidMask.isFluid(loopA)){
+      continue;
+    }
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      if(fluidMask.hasNeighbour(loopA,2*loopB)){
+        const mriDoubleVec& lengths = topology->cellLengths[loopB];
+        double area = topology->cellLengths[(loopB+1)%3][coords[(loopB+1)%3]]*
+                      topology->cellLengths[(loopB+2)%3][coords[(loopB+2)%3]];
+        double dist = 0.5*(lengths[coords[loopB]] + lengths[coords[loopB]+1]);
+        fine.faceCoeff[loopB][loopA] = area/dist;
+      }
+    }
+  }
+  fine.evalDiagonal();
+
+  // Coarsen by aggregating 2x2x2 cells
+  while(((int)levels.size() < kPoissonMaxLevels)&&(levels.back().totCells > kPoissonCoarsestCells)){
+    mriPoissonLevel coarse;
+    coarsen(levels.back(),coarse);
+    if(coarse.totCells == levels.back().totCells){
+      break;
+    }
+    levels.push_back(coarse);
+  }
+}
+
+// ===============
+// COARSEN A LEVEL
+// ===============
+// Faces between two aggregates keep the sum of the fine face coefficients,
+// halved so the coarse operator matches a rediscretization on a uniform grid
+void mriPoissonSolver::coarsen(const mriPoissonLevel& fine, mriPoissonLevel& coarse) const{
+  coarse.resize((fine.totals[0]+1)/2,(fine.totals[1]+1)/2,(fine.totals[2]+1)/2);
+  int coords[3] = {0,0,0};
+  for(int loopA=0;loopA<fine.totCells;loopA++){
+    coords[0] = loopA % fine.totals[0];
+    coords[1] = (loopA / fine.totals[0]) % fine.totals[1];
+    coords[2] = loopA / (fine.totals[0]*fine.totals[1]);
+    int coarseCell = ((coords[2]/2)*coarse.totals[1] + coords[1]/2)*coarse.totals[0] + coords[0]/2;
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      // Only faces on the high side of an aggregate connect two aggregates
+      if((coords[loopB] % 2) == 1){
+        coarse.faceCoeff[loopB][coarseCell] += 0.5*fine.faceCoeff[loopB][loopA];
+      }
+    }
+  }
+  coarse.evalDiagonal();
+}
+
+// =================
+// RESTRICT RESIDUAL
+// =================
+void mriPoissonSolver::restrictResidual(int level, const double* fineValues, double* coarseValues) const{
+  const mriPoissonLevel& fine = levels[level];
+  const mriPoissonLevel& coarse = levels[level+1];
+  int fnx = fine.totals[0];
+  int fny = fine.totals[1];
+  int fnz = fine.totals[2];
+  forAllRows(coarse.totals,[&](int currY,int currZ,int rowStart){
+    for(int loopA=0;loopA<coarse.totals[0];loopA++){
+      double sum = 0.0;
+      for(int loopZ=2*currZ;loopZ<std::min(2*currZ+2,fnz);loopZ++){
+        for(int loopY=2*currY;loopY<std::min(2*currY+2,fny);loopY++){
+          int fineRow = (loopZ*fny + loopY)*fnx;
+          for(int loopX=2*loopA;loopX<std::min(2*loopA+2,fnx);loopX++){
+            sum += fineValues[fineRow+loopX];
+          }
+        }
+      }
+      coarseValues[rowStart+loopA] = sum;
+    }
+  });
+}
+
+// ==================
+// PROLONG CORRECTION
+// ==================
+void mriPoissonSolver::prolongCorrection(int level, const double* coarseValues, double* fineValues) const{
+  const mriPoissonLevel& fine = levels[level];
+  const mriPoissonLevel& coarse = levels[level+1];
+  forAllRows(fine.totals,[&](int currY,int currZ,int rowStart){
+    const double* coarseRow = coarseValues + ((currZ/2)*coarse.totals[1] + currY/2)*coarse.totals[0];
+    for(int loopA=0;loopA<fine.totals[0];loopA++){
+      fineValues[rowStart+loopA] += coarseRow[loopA/2];
+    }
+  });
+}
+
+// =======
+// V-CYCLE
+// =======
+// Work vectors per level: smoother scratch, residual, rhs and solution
+void mriPoissonSolver::vCycle(int level, const double* rhs, double* values, vector<mriAlignedDoubleVec>& work) const{
+  const mriPoissonLevel& currLevel = levels[level];
+  double* scratch = work[4*level].data();
+  std::fill(values,values+currLevel.totCells,0.0);
+  if(level == (int)levels.size()-1){
+    currLevel.smooth(rhs,values,scratch,kPoissonCoarsestSweeps);
+    return;
+  }
+  currLevel.smooth(rhs,values,scratch,kPoissonSmoothingSweeps);
+  // Residual
+  double* residual = work[4*level+1].data();
+  currLevel.apply(values,residual);
+  mriParallel::parallelFor(currLevel.totCells,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      residual[loopA] = rhs[loopA] - residual[loopA];
+    }
+  });
+  // Coarse grid correction
+  double* coarseRhs = work[4*(level+1)+2].data();
+  double* coarseValues = work[4*(level+1)+3].data();
+  restrictResidual(level,residual,coarseRhs);
+  vCycle(level+1,coarseRhs,coarseValues,work);
+  prolongCorrection(level,coarseValues,values);
+  currLevel.smooth(rhs,values,scratch,kPoissonSmoothingSweeps);
+}
+
+// ==================================
+// EVAL SOURCE FROM PRESSURE GRADIENT
+// ==================================
+// The flux through a face between two fluid cells is the face area times
+// the average normal gradient. Walls and domain boundaries carry the
+// Neumann condition dp/dn = g.n: its flux area*g.n enters both the
+// operator row and the divergence of g and cancels, so those faces add
+// nothing here and the source sums to zero over the fluid cells.
+void mriPoissonSolver::evalSource(const double* const* pressGrad, double* rhs) const{
+  if(levels.empty()){
+    throw mriException("ERROR: Poisson solver used before build.\n");
+  }
+  const mriPoissonLevel& fine = levels[0];
+  int stride[3] = {1,fine.totals[0],fine.totals[0]*fine.totals[1]};
+  std::fill(rhs,rhs+fine.totCells,0.0);
+  int coords[3] = {0,0,0};
+  for(int loopA=0;loopA<fine.totCells;loopA++){
+    coords[0] = loopA % fine.totals[0];
+    coords[1] = (loopA / fine.totals[0]) % fine.totals[1];
+    coords[2] = loopA / stride[2];
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      if(fine.faceCoeff[loopB][loopA] > 0.0){
+        int other = loopA + stride[loopB];
+        double area = topology->cellLengths[(loopB+1)%3][coords[(loopB+1)%3]]*
+                      topology->cellLengths[(loopB+2)%3][coords[(loopB+2)%3]];
+        double flux = area*0.5*(pressGrad[loopB][loopA] + pressGrad[loopB][other]);
+        // A = -div(grad)
+        rhs[loopA] -= flux;
+        rhs[other] += flux;
+      }
+    }
+  }
+}
+
+// ==============
+// SOLVE WITH PCG
+// ==============
+int mriPoissonSolver::solve(const double* rhs, double* pressure, int maxIt, double tolerance, mriDoubleVec& residuals) const{
+  if(levels.empty()){
+    throw mriException("ERROR: Poisson solver used before build.\n");
+  }
+  const mriPoissonLevel& fine = levels[0];
+  int totCells = fine.totCells;
+  residuals.clear();
+
+  // Multigrid work vectors
+  vector<mriAlignedDoubleVec> work(4*levels.size());
+  for(size_t loopA=0;loopA<levels.size();loopA++){
+    for(int loopB=0;loopB<4;loopB++){
+      work[4*loopA+loopB].assign(levels[loopA].totCells,0.0);
+    }
+  }
+
+  // CG vectors, the rhs is made compatible with the Neumann problem
+  mriAlignedDoubleVec res(rhs,rhs+totCells);
+  mriAlignedDoubleVec prec(totCells,0.0);
+  mriAlignedDoubleVec dir(totCells,0.0);
+  mriAlignedDoubleVec dirA(totCells,0.0);
+  removeActiveMean(fine,res.data());
+  std::fill(pressure,pressure+totCells,0.0);
+
+  double rhsNorm = sqrt(poissonDot(res.data(),res.data(),totCells));
+  if(rhsNorm == 0.0){
+    return 0;
+  }
+
+  vCycle(0,res.data(),prec.data(),work);
+  dir = prec;
+  double resPrec = poissonDot(res.data(),prec.data(),totCells);
+  int itCount = 0;
+  while(itCount < maxIt){
+    itCount++;
+    fine.apply(dir.data(),dirA.data());
+    double curv = poissonDot(dir.data(),dirA.data(),totCells);
+    if(curv <= 0.0){
+      break;
+    }
+    double alpha = resPrec/curv;
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      for(int loopA=begin;loopA<end;loopA++){
+        pressure[loopA] += alpha*dir[loopA];
+        res[loopA] -= alpha*dirA[loopA];
+      }
+    });
+    double relRes = sqrt(poissonDot(res.data(),res.data(),totCells))/rhsNorm;
+    residuals.push_back(relRes);
+    if(relRes < tolerance){
+      break;
+    }
+    vCycle(0,res.data(),prec.data(),work);
+    double newResPrec = poissonDot(res.data(),prec.data(),totCells);
+    double beta = newResPrec/resPrec;
+    resPrec = newResPrec;
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      for(int loopA=begin;loopA<end;loopA++){
+        dir[loopA] = prec[loopA] + beta*dir[loopA];
+      }
+    });
+  }
+
+  // Relative pressure with zero mean
+  removeActiveMean(fine,pressure);
+  return itCount;
+}
@@ -0,0 +1,79 @@
+#ifndef MRIPOISSON_H
+#define MRIPOISSON_H
+
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriCell.h"
+# include "mriConstants.h"
+# include "mriException.h"
+# include "mriFluidMask.h"
+
+class mriTopology;
+
+using namespace std;
+
+// Damping of the Jacobi smoother
+const double kPoissonJacobiWeight = 0.8;
+// Jacobi sweeps before and after the coarse grid correction
+const int kPoissonSmoothingSweeps = 2;
+// Jacobi sweeps on the coarsest level
+const int kPoissonCoarsestSweeps = 50;
+// Stop coarsening below this number of cells
+const int kPoissonCoarsestCells = 64;
+const int kPoissonMaxLevels = 12;
+
+// ========================================
+// FINITE VOLUME LAPLACIAN ON A MASKED GRID
+// ========================================
+// Stores the operator A = -div(grad) on the active cells. Face coefficients
+// are zero for faces touching a non-active cell or the domain boundary, so
+// these faces drop out of A. The Neumann data of these faces cancels with
+// the source, see mriPoissonSolver::evalSource.
+class mriPoissonLevel{
+  public:
+    // DATA MEMBERS
+    int totals[3];
+    int totCells;
+    // Coefficient of the face between cell c and c + stride[dim]
+    mriAlignedDoubleVec faceCoeff[3];
+    // Sum of the face coefficients of each cell
+    mriAlignedDoubleVec diag;
+
+    // MEMBER FUNCTIONS
+    void resize(int nx, int ny, int nz);
+    void evalDiagonal();
+    // result = A*values
+    void apply(const double* values, double* result) const;
+    // Damped Jacobi sweeps on A*values = rhs, scratch holds totCells entries
+    void smooth(const double* rhs, double* values, double* scratch, int sweeps) const;
+};
+
+// ================================================
+// MULTIGRID PRECONDITIONED CG FOR THE PRESSURE PPE
+// ================================================
+class mriPoissonSolver{
+  public:
+    // CONSTRUCTOR
+    mriPoissonSolver();
+
+    // MEMBER FUNCTIONS
+    // Build the level hierarchy for the fluid cells
+    void build(mriTopology* topology, const mriFluidMask& fluidMask);
+    // Right hand side of A*p = rhs for the cell-centred pressure gradient
+    void evalSource(const double* const* pressGrad, double* rhs) const;
+    // Solve with zero mean pressure, returns the number of iterations
+    int solve(const double* rhs, double* pressure, int maxIt, double tolerance, mriDoubleVec& residuals) const;
+
+  private:
+    vector<mriPoissonLevel> levels;
+    mriTopology* topology;
+
+    void coarsen(const mriPoissonLevel& fine, mriPoissonLevel& coarse) const;
+    void restrictResidual(int level, const double* fineValues, double* coarseValues) const;
+    void prolongCorrection(int level, const double* coarseValues, double* fineValues) const;
+    // One V-cycle on level, approximating A^-1 rhs
+    void vCycle(int level, const double* rhs, double* values, vector<mriAlignedDoubleVec>& work) const;
+};
+
+#endif // MRIPOISSON_H
@@ -1,8 +1,10 @@
 #include <math.h>
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include "mriScan.h"
 #include "mriThresholdCriteria.h"
 #include "mriUtils.h"
+#include "mriMedianFilter.h"
 
 using namespace std;
 
@@ -33,13 +35,15 @@ double convoluteWithGaussianKernel(mriIntVec cellNeighbors,mriDoubleVec neighVal
 void mriScan::getStructuredNeighbourCells(int centreCell,int order,mriThresholdCriteria* threshold,mriIntVec& cellNeighbors){
  mriIntVec centreCellCoords(3);
  int nextCell = 0;
- double cellQty = 0.0;
  cellNeighbors.clear();
  if (order == 0){
    cellNeighbors.push_back(centreCell);
    return;
  }else{
 
+   // Cached fluid mask
+   const mriFluidMask& fluidMask = getFluidMask(threshold);
+
    // Get Coords in current cell
    topology->mapIndexToCoords(centreCell,centreCellCoords);
    for(int i=-order;i<=order;i++){
@@ -53,8 +57,7 @@ void mriScan::getStructuredNeighbourCells(int centreCell,int order,mriThresholdC
            nextCell = -1;
          }
          if(nextCell>-1){
-           cellQty = cells[nextCell].getQuantity(threshold->thresholdQty);
-           if(!threshold->meetsCriteria(cellQty)){
+           if(fluidMask.isFluid(nextCell)){
              cellNeighbors.push_back(nextCell);
            }else{
              cellNeighbors.push_back(-1);
@@ -107,75 +110,259 @@ void mriScan::applyMedianFilter(int qtyID,int maxIt,int order,int filterType,mri
     throw mriException("Error in ApplyMedianFilter: Invalid Filter Type.\n");
   }
   mriDoubleVec tempVec(topology->totalCells);
-  double currValue = 0.0;
-  double currMedian = 0.0;
-  double currError = 0.0;
-  double centerCellValue = 0.0;
-  int currCell = 0;
-  double cellQty = 0.0;
-  mriIntVec neighbours;
-  mriDoubleVec neighValues;
+  // Largest change in each block of cells
+  mriDoubleVec blockError(mriParallel::getBlockCount(topology->totalCells),0.0);
+  // Field columns
+  double* qtyValues = cells.quantity(qtyID);
   // PERFORM ITERATIONS
   for(int loop0=0;loop0<maxIt;loop0++){
+    const mriFluidMask& fluidMask = getFluidMask(threshold);
     // LOOP ON ALL CELLS
-    double maxError = 0.0;
-    for(int loopA=0;loopA<topology->totalCells;loopA++){
+    mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+      double currValue = 0.0;
+      double currMedian = 0.0;
+      double currError = 0.0;
+      double centerCellValue = 0.0;
+      double maxError = 0.0;
+      int currCell = 0;
+      mriIntVec neighbours;
+      mriDoubleVec neighValues;
+      for(int loopA=begin;loopA<end;loopA++){
 
-      // Get Value in Current Cell
-      centerCellValue = cells[loopA].getQuantity(qtyID);
+        // Get Value in Current Cell
+        centerCellValue = qtyValues[loopA];
 
-      // GET NEIGHBOURS
-      getStructuredNeighbourCells(loopA,order,threshold,neighbours);      
+        // GET NEIGHBOURS
+        getStructuredNeighbourCells(loopA,order,threshold,neighbours);      
 
-      // CHECK IF THE CURRENT CELL IS TO BE PROCESSED
-      cellQty = cells[loopA].getQuantity(threshold->thresholdQty);
-      if(!threshold->meetsCriteria(cellQty)){
+        // CHECK IF THE CURRENT CELL IS TO BE PROCESSED
+        if(fluidMask.isFluid(loopA)){
 
-        // GET THE VALUES ON NEIGHBOR CELLS
-        neighValues.clear();
-        for(size_t loopB=0;loopB<neighbours.size();loopB++){
-          currCell = neighbours[loopB];
-          if(currCell>-1){
-            // Get Quantity for Neighbor Cell
-            currValue = cells[currCell].getQuantity(qtyID);
-            // Store value
-            neighValues.push_back(currValue);
+          // GET THE VALUES ON NEIGHBOR CELLS
+          neighValues.clear();
+          for(size_t loopB=0;loopB<neighbours.size();loopB++){
+            currCell = neighbours[loopB];
+            if(currCell>-1){
+              // Get Quantity for Neighbor Cell
+              currValue = qtyValues[currCell];
+              // Store value
+              neighValues.push_back(currValue);
+            }else if(filterType == kGaussianFilter){
+              neighValues.push_back(0.0);
+            }
+          }
+
+          // FIND MEDIAN VALUE
+          if(filterType == kMedianFilter){
+            if(neighValues.size() > 0){
+              currMedian = mriUtils::getMedian(neighValues);
+            }else{
+              currMedian = centerCellValue;
+            }
+          }else if(filterType == kMeanFilter){
+            if(neighValues.size() > 0){
+              currMedian = mriUtils::getMean(neighValues);
+            }else{
+              currMedian = centerCellValue;
+            }
           }else if(filterType == kGaussianFilter){
-            neighValues.push_back(0.0);
+            currMedian = convoluteWithGaussianKernel(neighbours,neighValues,gaussKernelVector);
           }
+        }else{
+          currMedian = centerCellValue;
+        }
+        // EVAL CHANGE
+        currError = fabs(((currMedian-centerCellValue)/(double)maxVelModule)*100.0);
+        if(currError>maxError){
+          maxError = currError;
         }
+        // ASSIGN MEDIAN
+        tempVec[loopA] = currMedian;
+      }
+      blockError[mriParallel::getBlockIndex(begin)] = maxError;
+    });
+    double maxError = mriParallel::maxBlocks(blockError);
+    // ASSIGN VALUES
+    std::copy(tempVec.begin(),tempVec.end(),qtyValues);
+    cells.markModified();
+    // END OF ITERATION PRINT MAX ERROR
+    writeSchMessage(string("Iteration "+mriUtils::intToStr(loop0+1)+"; Max Error: "+mriUtils::floatToStr(maxError)+"\n"));
+  }
+}
 
-        // FIND MEDIAN VALUE
-        if(filterType == kMedianFilter){
-          if(neighValues.size() > 0){
-            currMedian = mriUtils::getMedian(neighValues);
-          }else{
-            currMedian = centerCellValue;
+// =============================
+// CREATE ONE-DIMENSIONAL KERNEL
+// =============================
+void createSeparableKernel(int order,int filterType,mriDoubleVec& kernel){
+  kernel.resize(2*order+1);
+  double sigma = order;
+  for(int i=-order;i<=order;i++){
+    if((filterType == kGaussianFilter)&&(i != 0)){
+      kernel[i+order] = exp(-(i*i)/(2*sigma*sigma));
+    }else{
+      kernel[i+order] = 1.0;
+    }
+  }
+}
+
+// ============================================
+// CONVOLVE FILTER CHANNELS ALONG ONE GRID AXIS
+// ============================================
+void convolveFilterAxis(int axis,const int* totals,const mriDoubleVec& kernel,int totChannels,double** input,double** output){
+  int nx = totals[0];
+  int ny = totals[1];
+  int order = ((int)kernel.size()-1)/2;
+  int stride = (axis == 0) ? 1 : ((axis == 1) ? nx : nx*ny);
+  // Work on blocks of contiguous x-rows
+  int rowsPerBlock = std::max(1,kParallelBlockSize/nx);
+  mriParallel::parallelFor(ny*totals[2],rowsPerBlock,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      int rowStart = loopA*nx;
+      // Row position along the filter axis
+      int axisCoord = 0;
+      if(axis == 1){
+        axisCoord = loopA % ny;
+      }else if(axis == 2){
+        axisCoord = loopA / ny;
+      }
+      for(int loopB=0;loopB<totChannels;loopB++){
+        const double* in = input[loopB];
+        double* out = output[loopB] + rowStart;
+        for(int loopC=0;loopC<nx;loopC++){
+          out[loopC] = 0.0;
+        }
+        for(int loopC=-order;loopC<=order;loopC++){
+          // Cells outside the domain do not contribute
+          int first = 0;
+          int last = nx;
+          if(axis == 0){
+            first = std::max(0,-loopC);
+            last = std::min(nx,nx-loopC);
+          }else if((axisCoord+loopC < 0)||(axisCoord+loopC >= totals[axis])){
+            continue;
           }
-        }else if(filterType == kMeanFilter){
-          if(neighValues.size() > 0){
-            currMedian = mriUtils::getMean(neighValues);
-          }else{
-            currMedian = centerCellValue;
+          double weight = kernel[loopC+order];
+          int offset = rowStart + loopC*stride;
+          for(int loopD=first;loopD<last;loopD++){
+            out[loopD] += weight*in[offset+loopD];
           }
-        }else if(filterType == kGaussianFilter){
-          currMedian = convoluteWithGaussianKernel(neighbours,neighValues,gaussKernelVector);
         }
-      }else{
-        currMedian = centerCellValue;
-      }
-      // EVAL CHANGE
-      currError = fabs(((currMedian-centerCellValue)/(double)maxVelModule)*100.0);
-      if(currError>maxError){
-        maxError = currError;
       }
-      // ASSIGN MEDIAN
-      tempVec[loopA] = currMedian;
-    }
-    // ASSIGN VALUES
-    for(int loopA=0;loopA<topology->totalCells;loopA++){
-      cells[loopA].setQuantity(qtyID,tempVec[loopA]);
     }
+  });
+}
+
+// ============================================
+// APPLY MEAN OR GAUSSIAN FILTER WITH 1D PASSES
+// ============================================
+void mriScan::applySeparableFilter(int maxIt,int order,int filterType,mriThresholdCriteria* threshold){
+  if(filterType == kMeanFilter){
+    writeSchMessage(std::string("Applying Mean Filter...\n"));
+  }else if(filterType == kGaussianFilter){
+    writeSchMessage(std::string("Applying Gaussian Filter...\n"));
+  }else{
+    throw mriException("Error in applySeparableFilter: Invalid Filter Type.\n");
+  }
+  int totCells = topology->totalCells;
+  int totals[3] = {topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]};
+  mriDoubleVec kernel;
+  createSeparableKernel(order,filterType,kernel);
+
+  // Channels: the three velocity components on fluid cells and the fluid mask.
+  // The filtered velocity is the ratio of the filtered channels, which gives
+  // the kernel-weighted average over the fluid cells in the (2*order+1)^3 box
+  const int totChannels = 4;
+  vector<mriAlignedDoubleVec> bufferA(totChannels,mriAlignedDoubleVec(totCells));
+  vector<mriAlignedDoubleVec> bufferB(totChannels,mriAlignedDoubleVec(totCells));
+  double* chanA[totChannels];
+  double* chanB[totChannels];
+  for(int loopA=0;loopA<totChannels;loopA++){
+    chanA[loopA] = bufferA[loopA].data();
+    chanB[loopA] = bufferB[loopA].data();
+  }
+  double* vel[3] = {cells.velocity(0),cells.velocity(1),cells.velocity(2)};
+  // Largest change in each block of cells
+  mriDoubleVec blockError(mriParallel::getBlockCount(totCells),0.0);
+
+  // PERFORM ITERATIONS
+  for(int loop0=0;loop0<maxIt;loop0++){
+    const mriFluidMask& fluidMask = getFluidMask(threshold);
+
+    // FILL CHANNELS
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      for(int loopA=begin;loopA<end;loopA++){
+        bool isFluid = fluidMask.isFluid(loopA);
+        for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+          chanA[loopB][loopA] = isFluid ? vel[loopB][loopA] : 0.0;
+        }
+        chanA[3][loopA] = isFluid ? 1.0 : 0.0;
+      }
+    });
+
+    // ONE PASS PER AXIS
+    convolveFilterAxis(0,totals,kernel,totChannels,chanA,chanB);
+    convolveFilterAxis(1,totals,kernel,totChannels,chanB,chanA);
+    convolveFilterAxis(2,totals,kernel,totChannels,chanA,chanB);
+
+    // NORMALIZE ON FLUID CELLS AND EVAL CHANGE
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      double currValue = 0.0;
+      double currError = 0.0;
+      double maxError = 0.0;
+      for(int loopA=begin;loopA<end;loopA++){
+        if(fluidMask.isFluid(loopA)){
+          for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+            currValue = chanB[loopB][loopA]/chanB[3][loopA];
+            currError = fabs(((currValue-vel[loopB][loopA])/(double)maxVelModule)*100.0);
+            if(currError>maxError){
+              maxError = currError;
+            }
+            vel[loopB][loopA] = currValue;
+          }
+        }
+      }
+      blockError[mriParallel::getBlockIndex(begin)] = maxError;
+    });
+    double maxError = mriParallel::maxBlocks(blockError);
+    cells.markModified();
+    // END OF ITERATION PRINT MAX ERROR
+    writeSchMessage(string("Iteration "+mriUtils::intToStr(loop0+1)+"; Max Error: "+mriUtils::floatToStr(maxError)+"\n"));
+  }
+}
+
+// =====================================
+// APPLY MEDIAN FILTER TO ALL COMPONENTS
+// =====================================
+void mriScan::applyVelocityMedianFilter(int maxIt,int order,mriThresholdCriteria* threshold){
+  writeSchMessage(std::string("Applying Median Filter...\n"));
+  int totCells = topology->totalCells;
+  mriMedianFilter filter(order);
+  vector<mriAlignedDoubleVec> filtered(kNumberOfDimensions,mriAlignedDoubleVec(totCells));
+  double* vel[3] = {cells.velocity(0),cells.velocity(1),cells.velocity(2)};
+  double* filteredVel[3] = {filtered[0].data(),filtered[1].data(),filtered[2].data()};
+  // Largest change in each block of cells
+  mriDoubleVec blockError(mriParallel::getBlockCount(totCells),0.0);
+  // PERFORM ITERATIONS
+  for(int loop0=0;loop0<maxIt;loop0++){
+    const mriFluidMask& fluidMask = getFluidMask(threshold);
+    filter.apply(topology,fluidMask,vel,filteredVel);
+    // EVAL CHANGE AND ASSIGN VALUES
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      double currError = 0.0;
+      double maxError = 0.0;
+      for(int loopA=begin;loopA<end;loopA++){
+        for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+          currError = fabs(((filteredVel[loopB][loopA]-vel[loopB][loopA])/(double)maxVelModule)*100.0);
+          if(currError>maxError){
+            maxError = currError;
+          }
+          vel[loopB][loopA] = filteredVel[loopB][loopA];
+        }
+      }
+      blockError[mriParallel::getBlockIndex(begin)] = maxError;
+    });
+    double maxError = mriParallel::maxBlocks(blockError);
+    cells.markModified();
     // END OF ITERATION PRINT MAX ERROR
     writeSchMessage(string("Iteration "+mriUtils::intToStr(loop0+1)+"; Max Error: "+mriUtils::floatToStr(maxError)+"\n"));
   }
@@ -189,9 +376,7 @@ double mriScan::evalAverageVelocityMod(){
   double avVel = 0.0;
   double currentMod = 0.0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    currentMod = sqrt((cells[loopA].velocity[0])*(cells[loopA].velocity[0])+
-                      (cells[loopA].velocity[1])*(cells[loopA].velocity[1])+
-                      (cells[loopA].velocity[2])*(cells[loopA].velocity[2]));
+    currentMod = cells.getVelocityModule(loopA);
     avVel += currentMod;
   }
   return ((double)currentMod/(double)topology->totalCells);
@@ -203,37 +388,28 @@ double mriScan::evalAverageVelocityMod(){
 void mriScan::applyThresholding(mriThresholdCriteria* thresholdCriteria){
   writeSchMessage(std::string("\n"));
   writeSchMessage(std::string("Applying Thresholding...\n"));
-  // Init Number Of Filtered
-  int numberOfFiltered = 0;
-  // Apply Threshold
-  double currentValue = 0.0;
   // If No Quantity then return
   if(thresholdCriteria->thresholdQty == kNoQuantity){
     return;
   }
+  mriCellWriteGuard cellWrite(cells);
+  // Number of filtered cells in each block
+  mriDoubleVec blockFiltered(mriParallel::getBlockCount(topology->totalCells),0.0);
   // Loop through the cells
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    switch(thresholdCriteria->thresholdQty){
-      case kQtyConcentration:
-        currentValue = cells[loopA].concentration;
-        break;
-      case kQtyVelocityX:
-        currentValue = cells[loopA].velocity[0];
-        break;
-      case kQtyVelocityY:
-        currentValue = cells[loopA].velocity[1];
-        break;
-      case kQtyVelocityZ:
-        currentValue = cells[loopA].velocity[2];
-        break;
-    }
-    if(thresholdCriteria->meetsCriteria(currentValue)){
-      numberOfFiltered++;
-      cells[loopA].velocity[0] = 0.0;
-      cells[loopA].velocity[1] = 0.0;
-      cells[loopA].velocity[2] = 0.0;
+  const double* thresholdQty = cells.quantity(thresholdCriteria->thresholdQty);
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    int numberOfFiltered = 0;
+    for(int loopA=begin;loopA<end;loopA++){
+      if(thresholdCriteria->meetsCriteria(thresholdQty[loopA])){
+        numberOfFiltered++;
+        cells.vx[loopA] = 0.0;
+        cells.vy[loopA] = 0.0;
+        cells.vz[loopA] = 0.0;
+      }
     }
-  }
+    blockFiltered[mriParallel::getBlockIndex(begin)] = numberOfFiltered;
+  });
+  int numberOfFiltered = (int)mriParallel::sumBlocks(blockFiltered);
   writeSchMessage(string("Cells Modified: "+mriUtils::intToStr(numberOfFiltered)+"\n"));
   writeSchMessage(string("------------------------------------------------------------------\n"));
 }
@@ -242,6 +418,7 @@ void mriScan::applyThresholding(mriThresholdCriteria* thresholdCriteria){
 // APPLY LAVISION FILTER
 // =====================
 void mriScan::applySmoothingFilter(){
+  mriCellWriteGuard cellWrite(cells);
   bool converged = false;
   int itCount = 0;
   double maxDivergence = 0.0;
@@ -255,6 +432,9 @@ void mriScan::applySmoothingFilter(){
   // Local Divergence 
   double localDivergence = 0.0;
   mriIntVec otherCells;
+  double* vx = cells.vx.data();
+  double* vy = cells.vy.data();
+  double* vz = cells.vz.data();
   // LOOP UNTIL CONVERGED
   while(!converged){
     // Increment Iteration Count
@@ -266,23 +446,23 @@ void mriScan::applySmoothingFilter(){
         // Eval Neighbours
         getCartesianNeighbourCells(loopA,otherCells,false);
         // Get Velocities from Neighbors
-        velXPlus =  cells[otherCells[0]].velocity[0];
-        velXMinus = cells[otherCells[1]].velocity[0];
-        velYPlus =  cells[otherCells[2]].velocity[1];
-        velYMinus = cells[otherCells[3]].velocity[1];
-        velZPlus =  cells[otherCells[4]].velocity[2];
-        velZMinus = cells[otherCells[5]].velocity[2];
+        velXPlus =  vx[otherCells[0]];
+        velXMinus = vx[otherCells[1]];
+        velYPlus =  vy[otherCells[2]];
+        velYMinus = vy[otherCells[3]];
+        velZPlus =  vz[otherCells[4]];
+        velZMinus = vz[otherCells[5]];
         // Compute Local Divergence
         localDivergence = (velXPlus - velXMinus) + (velYPlus - velYMinus) + (velZPlus - velZMinus);
         // Store Max Value
         if(fabs(localDivergence)>maxDivergence) maxDivergence = fabs(localDivergence);
         // Spread The Value Of Divergence
-        cells[otherCells[0]].velocity[0] -= (1.0/6.0) * localDivergence;
-        cells[otherCells[1]].velocity[0] += (1.0/6.0) * localDivergence;
-        cells[otherCells[2]].velocity[1] -= (1.0/6.0) * localDivergence;
-        cells[otherCells[3]].velocity[1] += (1.0/6.0) * localDivergence;
-        cells[otherCells[4]].velocity[2] -= (1.0/6.0) * localDivergence;
-        cells[otherCells[5]].velocity[2] += (1.0/6.0) * localDivergence;
+        vx[otherCells[0]] -= (1.0/6.0) * localDivergence;
+        vx[otherCells[1]] += (1.0/6.0) * localDivergence;
+        vy[otherCells[2]] -= (1.0/6.0) * localDivergence;
+        vy[otherCells[3]] += (1.0/6.0) * localDivergence;
+        vz[otherCells[4]] -= (1.0/6.0) * localDivergence;
+        vz[otherCells[5]] += (1.0/6.0) * localDivergence;
       }
     }
     writeSchMessage("It: "+mriUtils::intToStr(itCount)+";Max Div: "+mriUtils::floatToStr(maxDivergence)+"\n");
@@ -291,18 +471,95 @@ void mriScan::applySmoothingFilter(){
   }
 }
 
+// ===========================================
+// APPLY LAVISION FILTER WITH RED-BLACK SWEEPS
+// ===========================================
+// An inner cell moves the velocities of its six neighbours. Cells two apart
+// along one axis share those entries, so cells are coloured with the parity
+// of (x/2 + y/2 + z/2) and each colour is swept in parallel without conflicts.
+void mriScan::applyRedBlackSmoothingFilter(int maxIt,double tolerance,mriDoubleVec& residuals){
+  mriCellWriteGuard cellWrite(cells);
+  int nx = topology->cellTotals[0];
+  int ny = topology->cellTotals[1];
+  int nz = topology->cellTotals[2];
+  int strideY = nx;
+  int strideZ = nx*ny;
+  int totRows = ny*nz;
+  int rowsPerBlock = std::max(1,kParallelBlockSize/nx);
+  int totBlocks = (totRows + rowsPerBlock - 1)/rowsPerBlock;
+  // Largest divergence in each block of rows and colour
+  mriDoubleVec blockDivergence(2*totBlocks,0.0);
+  double* vx = cells.vx.data();
+  double* vy = cells.vy.data();
+  double* vz = cells.vz.data();
+  bool converged = false;
+  int itCount = 0;
+  double maxDivergence = 0.0;
+  residuals.clear();
+  // LOOP UNTIL CONVERGED OR MAX ITERATIONS
+  while((!converged)&&(itCount < maxIt)){
+    // Increment Iteration Count
+    itCount++;
+    for(int loopA=0;loopA<2;loopA++){
+      mriParallel::parallelFor(totRows,rowsPerBlock,[&](int /*thread*/,int begin,int end){
+        double localDivergence = 0.0;
+        double maxBlockDiv = 0.0;
+        for(int loopB=begin;loopB<end;loopB++){
+          int currY = loopB % ny;
+          int currZ = loopB / ny;
+          // Inner cells only
+          if((currY < 1)||(currY > ny-2)||(currZ < 1)||(currZ > nz-2)){
+            continue;
+          }
+          int rowColour = currY/2 + currZ/2;
+          for(int loopC=1;loopC<nx-1;loopC++){
+            if(((loopC/2 + rowColour) % 2) != loopA){
+              continue;
+            }
+            int currCell = loopB*nx + loopC;
+            // Compute Local Divergence, same sign convention as applySmoothingFilter
+            localDivergence = (vx[currCell-1] - vx[currCell+1]) +
+                              (vy[currCell-strideY] - vy[currCell+strideY]) +
+                              (vz[currCell-strideZ] - vz[currCell+strideZ]);
+            // Store Max Value
+            if(fabs(localDivergence)>maxBlockDiv) maxBlockDiv = fabs(localDivergence);
+            // Spread The Value Of Divergence
+            vx[currCell-1] -= (1.0/6.0) * localDivergence;
+            vx[currCell+1] += (1.0/6.0) * localDivergence;
+            vy[currCell-strideY] -= (1.0/6.0) * localDivergence;
+            vy[currCell+strideY] += (1.0/6.0) * localDivergence;
+            vz[currCell-strideZ] -= (1.0/6.0) * localDivergence;
+            vz[currCell+strideZ] += (1.0/6.0) * localDivergence;
+          }
+        }
+        blockDivergence[loopA*totBlocks + begin/rowsPerBlock] = maxBlockDiv;
+      });
+    }
+    maxDivergence = mriParallel::maxBlocks(blockDivergence);
+    residuals.push_back(maxDivergence);
+    writeSchMessage("It: "+mriUtils::intToStr(itCount)+";Max Div: "+mriUtils::floatToStr(maxDivergence)+"\n");
+    // Check Convergence
+    converged = (maxDivergence<tolerance);
+  }
+  if(!converged){
+    writeSchMessage(string("Divergence smoothing not converged after "+mriUtils::intToStr(itCount)+" iterations.\n"));
+  }
+}
+
 // ====================
 // APPLY GAUSSIAN NOISE
 // ====================
 void mriScan::applyGaussianNoise(double stDev, double seed){
+  mriCellWriteGuard cellWrite(cells);
   // Multiply by the velocity module
   stDev = stDev * maxVelModule / 100.0;
   mriUtils::SetSeed(seed);
   // Apply Gaussian Noise
   for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
     // Loop On Cells
+    double* vel = cells.velocity(loopA);
     for(int loopB=0;loopB<topology->totalCells;loopB++){
-      cells[loopB].velocity[loopA] = cells[loopB].velocity[loopA] + mriUtils::generateStandardGaussian(stDev);
+      vel[loopB] = vel[loopB] + mriUtils::generateStandardGaussian(stDev);
     }
   }
 }
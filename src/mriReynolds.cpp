@@ -15,31 +15,28 @@ void mriScan::evalEddyViscosity_simple(mriDoubleVec& nuT){
 }
 // EVAL TURBULENT KINETIC ENERGY
 void mriScan::evalTurbulentKineticEnergy(mriThresholdCriteria* threshold, mriDoubleVec& turbK){
-  // First and Second Cell Derivatives
-
-  mriDoubleMat firstDerivs;
-  mriDoubleMat secondDerivs;
-  firstDerivs.resize(3);
-  secondDerivs.resize(3);
-  for(int loopA=0;loopA<3;loopA++){
-    firstDerivs[loopA].resize(3);
-    secondDerivs[loopA].resize(3);
-  }
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
   // Loop through all cells
-  double tensorProduct = 0.0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Eval First and Derivative Tensor
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
-    // Eval Tensor Product
-    tensorProduct = 0.0;
-    for(int loopB=0;loopB<3;loopB++){
-      for(int loopC=0;loopC<3;loopC++){
-        tensorProduct += firstDerivs[loopB][loopC]*firstDerivs[loopB][loopC];
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    // First and Second Cell Derivatives
+    mriDoubleMat firstDerivs(3,mriDoubleVec(3));
+    mriDoubleMat secondDerivs(3,mriDoubleVec(3));
+    double tensorProduct = 0.0;
+    for(int loopA=begin;loopA<end;loopA++){
+      // Eval First and Derivative Tensor
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
+      // Eval Tensor Product
+      tensorProduct = 0.0;
+      for(int loopB=0;loopB<3;loopB++){
+        for(int loopC=0;loopC<3;loopC++){
+          tensorProduct += firstDerivs[loopB][loopC]*firstDerivs[loopB][loopC];
+        }
       }
+      // Careful SI Units
+      turbK[loopA] = 2.0*tensorProduct*0.001;
     }
-    // Careful SI Units
-    turbK[loopA] = 2.0*tensorProduct*0.001;
-  }
+  });
 }
 
 // ==============================================
@@ -104,21 +101,6 @@ void mriScan::evalReynoldsStress(mriThresholdCriteria* threshold){
   // Allocate
   mriDoubleVec turbNu(topology->totalCells,0.0);
   mriDoubleVec turbK(topology->totalCells,0.0);
-  // First and Second Cell Derivatives
-  mriDoubleMat firstDerivs;
-  mriDoubleMat secondDerivs;
-
-  firstDerivs.resize(3);
-  secondDerivs.resize(3);
-
-  for(int loopA=0;loopA<3;loopA++){
-    firstDerivs[loopA].resize(3);
-    secondDerivs[loopA].resize(3);
-    for(int loopB=0;loopB<3;loopB++){
-      firstDerivs[loopA][loopB] = 0.0;
-      secondDerivs[loopA][loopB] = 0.0;
-    }
-  }
 
   // CHOOSE WHICH REAYNOLDS TO USE
   int ReynoldsCriterion = 0;
@@ -134,63 +116,68 @@ void mriScan::evalReynoldsStress(mriThresholdCriteria* threshold){
   // Eval Turbulent Kinetic Energy in current Scan
   evalTurbulentKineticEnergy(threshold,turbK);
 
-  // Allocate Reynolds Stress matrix
-  reynoldsStress.resize(topology->totalCells);
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    reynoldsStress[loopA].resize(6);
-  }
+  // Allocate Reynolds Stress field
+  mriSymTensorView reynoldsStress = outputs.addSymTensor("ReynoldsStress",topology->totalCells);
+
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
 
   // Cycle through all cells
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    // First and Second Cell Derivatives
+    mriDoubleMat firstDerivs(3,mriDoubleVec(3,0.0));
+    mriDoubleMat secondDerivs(3,mriDoubleVec(3,0.0));
+    for(int loopA=begin;loopA<end;loopA++){
 
-    // Eval First Derivative Tensor
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
+      // Eval First Derivative Tensor
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
 
-    if(ReynoldsCriterion == 0){
-      // COMPLETE STRESSES
-      // RXXs
-      reynoldsStress[loopA][0] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][0]+firstDerivs[0][0]))-((2.0)/(3.0))*turbK[loopA];
-      //cellPoints[loopA].ReStress[0] = turbK[loopA];
-      // RXY
-      reynoldsStress[loopA][1] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][1]+firstDerivs[1][0]));
-      // RXZ
-      reynoldsStress[loopA][2] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][2]+firstDerivs[2][0]));
-      // RYY
-      reynoldsStress[loopA][3] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][1]+firstDerivs[1][1]))-((2.0)/(3.0))*turbK[loopA];
-      // RYZ
-      reynoldsStress[loopA][4] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][2]+firstDerivs[2][1]));
-      // RZZ
-      reynoldsStress[loopA][5] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[2][2]+firstDerivs[2][2]))-((2.0)/(3.0))*turbK[loopA];
-    }else if(ReynoldsCriterion == 1){
-      // ONLY VELOCITY GRADIENTS
-      // RXXs
-      reynoldsStress[loopA][0] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][0]+firstDerivs[0][0]));
-      // RXY
-      reynoldsStress[loopA][1] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][1]+firstDerivs[1][0]));
-      // RXZ
-      reynoldsStress[loopA][2] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][2]+firstDerivs[2][0]));
-      // RYY
-      reynoldsStress[loopA][3] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][1]+firstDerivs[1][1]));
-      // RYZ
-      reynoldsStress[loopA][4] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][2]+firstDerivs[2][1]));
-      // RZZ
-      reynoldsStress[loopA][5] = 2.0*turbNu[loopA]*(0.5*(firstDerivs[2][2]+firstDerivs[2][2]));
-    }else if(ReynoldsCriterion == 2){
-      // ONLY HYDROSTATIC PART
-      // RXXs
-      reynoldsStress[loopA][0] = -((2.0)/(3.0))*turbK[loopA];
-      // RXY
-      reynoldsStress[loopA][1] = 0.0;
-      // RXZ
-      reynoldsStress[loopA][2] = 0.0;
-      // RYY
-      reynoldsStress[loopA][3] = -((2.0)/(3.0))*turbK[loopA];
-      // RYZ
-      reynoldsStress[loopA][4] = 0.0;
-      // RZZ
-      reynoldsStress[loopA][5] = -((2.0)/(3.0))*turbK[loopA];
+      if(ReynoldsCriterion == 0){
+        // COMPLETE STRESSES
+        // RXXs
+        reynoldsStress.at<kSymTensorXX>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][0]+firstDerivs[0][0]))-((2.0)/(3.0))*turbK[loopA];
+        //cellPoints[loopA].ReStress[0] = turbK[loopA];
+        // RXY
+        reynoldsStress.at<kSymTensorXY>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][1]+firstDerivs[1][0]));
+        // RXZ
+        reynoldsStress.at<kSymTensorXZ>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][2]+firstDerivs[2][0]));
+        // RYY
+        reynoldsStress.at<kSymTensorYY>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][1]+firstDerivs[1][1]))-((2.0)/(3.0))*turbK[loopA];
+        // RYZ
+        reynoldsStress.at<kSymTensorYZ>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][2]+firstDerivs[2][1]));
+        // RZZ
+        reynoldsStress.at<kSymTensorZZ>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[2][2]+firstDerivs[2][2]))-((2.0)/(3.0))*turbK[loopA];
+      }else if(ReynoldsCriterion == 1){
+        // ONLY VELOCITY GRADIENTS
+        // RXXs
+        reynoldsStress.at<kSymTensorXX>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][0]+firstDerivs[0][0]));
+        // RXY
+        reynoldsStress.at<kSymTensorXY>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][1]+firstDerivs[1][0]));
+        // RXZ
+        reynoldsStress.at<kSymTensorXZ>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[0][2]+firstDerivs[2][0]));
+        // RYY
+        reynoldsStress.at<kSymTensorYY>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][1]+firstDerivs[1][1]));
+        // RYZ
+        reynoldsStress.at<kSymTensorYZ>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[1][2]+firstDerivs[2][1]));
+        // RZZ
+        reynoldsStress.at<kSymTensorZZ>(loopA) = 2.0*turbNu[loopA]*(0.5*(firstDerivs[2][2]+firstDerivs[2][2]));
+      }else if(ReynoldsCriterion == 2){
+        // ONLY HYDROSTATIC PART
+        // RXXs
+        reynoldsStress.at<kSymTensorXX>(loopA) = -((2.0)/(3.0))*turbK[loopA];
+        // RXY
+        reynoldsStress.at<kSymTensorXY>(loopA) = 0.0;
+        // RXZ
+        reynoldsStress.at<kSymTensorXZ>(loopA) = 0.0;
+        // RYY
+        reynoldsStress.at<kSymTensorYY>(loopA) = -((2.0)/(3.0))*turbK[loopA];
+        // RYZ
+        reynoldsStress.at<kSymTensorYZ>(loopA) = 0.0;
+        // RZZ
+        reynoldsStress.at<kSymTensorZZ>(loopA) = -((2.0)/(3.0))*turbK[loopA];
+      }
     }
-  }
+  });
 
   // DONE
   writeSchMessage("Done.\n");
@@ -200,40 +187,35 @@ void mriScan::evalReynoldsStress(mriThresholdCriteria* threshold){
 // EVAL SMAGORINSKY LILLY TURBULENT VISCOSITY MODEL
 // ================================================
 void mriScan::evalSmagorinskyLillyTurbViscosity(double density, double smagorinskyCoeff, mriThresholdCriteria* threshold, mriDoubleMat& turbViscosity){
-  double modS = 0.0;
-  double currCharDist = 0.0;
-  double sTerm = 0.0;
-  mriDoubleVec tmp;
-  // First and Second Derivatives
-  mriDoubleMat firstDerivs;
-  mriDoubleMat secondDerivs;
-  firstDerivs.resize(kNumberOfDimensions);
-  secondDerivs.resize(kNumberOfDimensions);
-  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
-    firstDerivs[loopA].resize(kNumberOfDimensions);
-    secondDerivs[loopA].resize(kNumberOfDimensions);
-  }
-
-  turbViscosity.clear();
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Eva Spatial Derivatives
-    evalSpaceDerivs(loopA, threshold, firstDerivs, secondDerivs);
-    // Evaluate the Module of the strain rate tensor
-    sTerm = 0.0;
-    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
-      for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
-        // Pradtl
-        sTerm += (0.5 * (firstDerivs[loopB][loopC] + firstDerivs[loopC][loopB])) * (0.5 * (firstDerivs[loopB][loopC] + firstDerivs[loopC][loopB]));
-        // Baldwin and Lomax
-        //sTerm += (0.5 * (firstDerivs[loopB][loopC] - firstDerivs[loopC][loopB])) * (0.5 * (firstDerivs[loopB][loopC] - firstDerivs[loopC][loopB]));
+  // One value per cell, preallocated to be filled in parallel
+  turbViscosity.assign(topology->totalCells,mriDoubleVec(1,0.0));
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    double modS = 0.0;
+    double currCharDist = 0.0;
+    double sTerm = 0.0;
+    // First and Second Derivatives
+    mriDoubleMat firstDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat secondDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    for(int loopA=begin;loopA<end;loopA++){
+      // Eva Spatial Derivatives
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
+      // Evaluate the Module of the strain rate tensor
+      sTerm = 0.0;
+      for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+        for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
+          // Pradtl
+          sTerm += (0.5 * (firstDerivs[loopB][loopC] + firstDerivs[loopC][loopB])) * (0.5 * (firstDerivs[loopB][loopC] + firstDerivs[loopC][loopB]));
+          // Baldwin and Lomax
+          //sTerm += (0.5 * (firstDerivs[loopB][loopC] - firstDerivs[loopC][loopB])) * (0.5 * (firstDerivs[loopB][loopC] - firstDerivs[loopC][loopB]));
+        }
       }
+      currCharDist = pow(evalCellVolume(loopA),1.0/3.0);
+      modS = sqrt(2.0 * sTerm);
+      turbViscosity[loopA][0] = density * (smagorinskyCoeff * currCharDist) * (smagorinskyCoeff * currCharDist) * modS;
     }
-    currCharDist = pow(evalCellVolume(loopA),1.0/3.0);
-    modS = sqrt(2.0 * sTerm);
-    tmp.clear();
-    tmp.push_back(density * (smagorinskyCoeff * currCharDist) * (smagorinskyCoeff * currCharDist) * modS);
-    turbViscosity.push_back(tmp);
-  }
+  });
 }
 
 // ==============================
@@ -248,6 +230,8 @@ void mriScan::evalReynoldsStressGradient(int currentCell, mriDoubleMat& Reynolds
   mriIntVec currentCellCoords(kNumberOfDimensions);
   topology->mapIndexToCoords(currentCell,currentCellCoords);
   int firstCell,secondCell;
+  // Reynolds Stress field
+  const mriField& rsField = outputs.getField("ReynoldsStress");
   // Assemble Terms
   for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
     switch(loopA){
@@ -312,20 +296,21 @@ void mriScan::evalReynoldsStressGradient(int currentCell, mriDoubleMat& Reynolds
     double currentVComponent = 0.0;
     for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
       int ReStressIndex = getReynoldsStressIndex(loopA,loopB);
+      const double* reynoldsStress = rsField.component(ReStressIndex);
       // First Component
       if(firstCell>-1){
-        firstVComponent = reynoldsStress[firstCell][ReStressIndex];
+        firstVComponent = reynoldsStress[firstCell];
       }else{
         firstVComponent = 0.0;
       }
       // Second Component
       if(secondCell>-1){
-        secondVComponent = reynoldsStress[secondCell][ReStressIndex];
+        secondVComponent = reynoldsStress[secondCell];
       }else{
         secondVComponent = 0.0;
       }
       // Current Component
-      currentVComponent = reynoldsStress[currentCell][ReStressIndex];
+      currentVComponent = reynoldsStress[currentCell];
 
       // FIRST DERIVS
       if(firstCell<0){
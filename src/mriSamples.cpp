@@ -63,9 +63,9 @@ void mriScan::sampleVelocities(mriSamplingOptions SamplingOptions, mriIntVec& bi
       currentZCoord = topology->cellLocations[currentCell][2];
 
       // Eval Cell Velocity Module
-      currentModule = sqrt((cells[currentCell].velocity[0]*cells[currentCell].velocity[0])+
-                           (cells[currentCell].velocity[1]*cells[currentCell].velocity[1])+
-                           (cells[currentCell].velocity[2]*cells[currentCell].velocity[2]));
+      currentModule = sqrt((cells.vx[currentCell]*cells.vx[currentCell])+
+                           (cells.vy[currentCell]*cells.vy[currentCell])+
+                           (cells.vz[currentCell]*cells.vz[currentCell]));
 
       // Increment Counter
       if((SamplingOptions.useBox)&&(mriUtils::isPointInsideBox(currentXCoord,currentYCoord,currentZCoord,SamplingOptions.limitBox))){
@@ -4,6 +4,7 @@ using namespace std;
 
 mriScan::mriScan(double currentTime){
   topology = NULL;
+  expansion = NULL;
   scanTime = currentTime;
 }
 
@@ -36,28 +37,10 @@ void mriScan::fillPLTHeader(std::vector<std::string> &pltHeader, bool isFirstFil
   pltHeader.clear();
   if (isFirstFile){
     pltHeader.push_back("TITLE = \"smpFilterOutput\"");
-    pltHeader.push_back("VARIABLES = \"X/D\"");
-    pltHeader.push_back("\"Y/D\"");
-    pltHeader.push_back("\"Z/D\"");
-    pltHeader.push_back("\"Conc%\"");
-    pltHeader.push_back("\"Vx/Ubulk\"");
-    pltHeader.push_back("\"Vy/Ubulk\"");
-    pltHeader.push_back("\"Vz/Ubulk\"");
-    // Print all outputs
-    for(size_t loopA=0;loopA<outputs.size();loopA++){
-      // Add output Name
-      if(outputs[loopA].totComponents == 1){
-        pltHeader.push_back("\"" + outputs[loopA].name + "\"");
-      }else if(outputs[loopA].totComponents == 2){
-        pltHeader.push_back("\"" + outputs[loopA].name + "x\"");
-        pltHeader.push_back("\"" + outputs[loopA].name + "y\"");
-      }else if(outputs[loopA].totComponents == 3){
-        pltHeader.push_back("\"" + outputs[loopA].name + "x\"");
-        pltHeader.push_back("\"" + outputs[loopA].name + "y\"");
-        pltHeader.push_back("\"" + outputs[loopA].name + "z\"");
-      }else{
-        throw mriException("Too many components for TECPLOT result.\n");
-      }
+    mriStringVec varNames;
+    getPLTVariableNames(varNames);
+    for(size_t loopA=0;loopA<varNames.size();loopA++){
+      pltHeader.push_back(((loopA == 0) ? "VARIABLES = \"" : "\"") + varNames[loopA] + "\"");
     }
   }
   pltHeader.push_back("ZONE T=\"SubZone\"");
@@ -74,6 +57,26 @@ void mriScan::fillPLTHeader(std::vector<std::string> &pltHeader, bool isFirstFil
   pltHeader.push_back(singleString);
 }
 
+// ======================
+// TECPLOT VARIABLE NAMES
+// ======================
+// Coordinates, concentration, velocity and every component of the outputs
+void mriScan::getPLTVariableNames(mriStringVec& varNames){
+  varNames.clear();
+  varNames.push_back("X/D");
+  varNames.push_back("Y/D");
+  varNames.push_back("Z/D");
+  varNames.push_back("Conc%");
+  varNames.push_back("Vx/Ubulk");
+  varNames.push_back("Vy/Ubulk");
+  varNames.push_back("Vz/Ubulk");
+  for(size_t loopA=0;loopA<outputs.size();loopA++){
+    for(int loopB=0;loopB<outputs[loopA].totComponents;loopB++){
+      varNames.push_back(outputs[loopA].getComponentName(loopB));
+    }
+  }
+}
+
 // returns file size in bytes or -1 if not found.
 std::ifstream::pos_type GetFileSize(const char* filename){
     std::ifstream in(filename, std::ifstream::in | std::ifstream::binary);
@@ -95,75 +98,30 @@ void WriteIOLog(std::string LogFileName, std::string MsgsString){
 // =======================
 // READ SCAN FROM PLT FILE
 // =======================
-void mriScan::readFromPLT_ASCII(string pltFileName, const pltOptionRecord& pltOptions){
+void mriScan::readFromPLT(const mriPLTReader& reader){
 
   // Write Progress
-  writeSchMessage(std::string("Reading Scan Data from PLT: ") + pltFileName + std::string("\n"));
-
-  // Open PLT File
-  ifstream pltFile;
-  pltFile.open(pltFileName.c_str());
-
-  // Skip File header  
-  string buffer;
-  for(size_t loopA=0;loopA<pltOptions.headerCount-1;loopA++){
-    getline(pltFile,buffer);
-    // printf("Skipping: %s\n",buffer.c_str());
-  }
-
-  // Read Scan Data 
-  mriDoubleMat dataTable; 
-  mriDoubleVec dataVec;
-  mriStringVec tokenizedString;
-  while (getline(pltFile,buffer)){
-    boost::trim(buffer);
-    boost::split(tokenizedString, buffer, boost::is_any_of("= ,"), boost::token_compress_on);
-    if(tokenizedString.size() != 7){
-      throw mriException("ERROR: invalid cell data size while reading PLT file");
-    }
-    dataVec.clear();
-    for(size_t loopA=0;loopA<tokenizedString.size();loopA++){
-      try{
-        dataVec.push_back(atof(tokenizedString[loopA].c_str()));  
-      }catch(...){
-        throw mriException("ERROR: invalid cell numerical entry while reading PLT file");
-      }
-    }
-    dataTable.push_back(dataVec);
-  }
-
-  // Verify dataset size
-  if(dataTable.size() != pltOptions.i*pltOptions.j*pltOptions.k){
-    throw mriException("ERROR: cell number mismatch while reading PLT file");
-  }
+  writeSchMessage(std::string("Reading Scan Data from PLT: ") + reader.getFileName() + std::string("\n"));
 
-  // Get Total Cells
-  int totCells = dataTable.size();
   // Transfer Scalars and Vectors to Cells
+  mriCellWriteGuard cellWrite(cells);
+  int totCells = reader.getTotalPoints();
   cells.clear();
-  mriCell cell;
-  for(int loopA=0;loopA<totCells;loopA++){
-    cell.concentration = dataTable[loopA][3];
-    cells.push_back(cell);
-  }
+  cells.resize(totCells);
+  const mriDoubleVec& conc = reader.getColumn(3);
+  const mriDoubleVec& vx = reader.getColumn(4);
+  const mriDoubleVec& vy = reader.getColumn(5);
+  const mriDoubleVec& vz = reader.getColumn(6);
+  std::copy(conc.begin(),conc.end(),cells.conc.begin());
+  std::copy(vx.begin(),vx.end(),cells.vx.begin());
+  std::copy(vy.begin(),vy.end(),cells.vy.begin());
+  std::copy(vz.begin(),vz.end(),cells.vz.begin());
 
   // Vectors
   maxVelModule = 0.0;
-  double currModulus = 0.0;
   for(int loopA=0;loopA<totCells;loopA++){
-      cells[loopA].velocity[0] = dataTable[loopA][4];
-      cells[loopA].velocity[1] = dataTable[loopA][5];
-      cells[loopA].velocity[2] = dataTable[loopA][6];
-      currModulus = sqrt((cells[loopA].velocity[0] * cells[loopA].velocity[0]) +
-                         (cells[loopA].velocity[1] * cells[loopA].velocity[1]) +
-                         (cells[loopA].velocity[2] * cells[loopA].velocity[2]));
-      if(currModulus > maxVelModule){
-        maxVelModule = currModulus;
-      }
+    maxVelModule = std::max(maxVelModule,cells.getVelocityModule(loopA));
   }
-
-  // Close File
-  pltFile.close();
 }
 
 // ================
@@ -183,22 +141,22 @@ void mriScan::exportToLSDYNA(std::string LSFileName, double scale){
   int TotalNodes = 0;
 	double CurrentModule;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    CurrentModule = sqrt((cells[loopA].velocity[0]*cells[loopA].velocity[0])+
-                         (cells[loopA].velocity[1]*cells[loopA].velocity[1])+
-                         (cells[loopA].velocity[2]*cells[loopA].velocity[2]));
+    CurrentModule = sqrt((cells.vx[loopA]*cells.vx[loopA])+
+                         (cells.vy[loopA]*cells.vy[loopA])+
+                         (cells.vz[loopA]*cells.vz[loopA]));
     // Export Nodes Based On Original Velocity
     if (CurrentModule>kMathZero){
       // Node 1
       TotalNodes++;
-      CurrentXCoord = topology->cellLocations[loopA][0] - cells[loopA].velocity[0]*scale;
-      CurrentYCoord = topology->cellLocations[loopA][1] - cells[loopA].velocity[1]*scale;
-      CurrentZCoord = topology->cellLocations[loopA][2] - cells[loopA].velocity[2]*scale;
+      CurrentXCoord = topology->cellLocations[loopA][0] - cells.vx[loopA]*scale;
+      CurrentYCoord = topology->cellLocations[loopA][1] - cells.vy[loopA]*scale;
+      CurrentZCoord = topology->cellLocations[loopA][2] - cells.vz[loopA]*scale;
       fprintf(LSFile,"%d,%e,%e,%e,0,0\n",TotalNodes,CurrentXCoord,CurrentYCoord,CurrentZCoord);
       // Node 2
       TotalNodes++;
-      CurrentXCoord = topology->cellLocations[loopA][0] + cells[loopA].velocity[0]*scale;
-      CurrentYCoord = topology->cellLocations[loopA][1] + cells[loopA].velocity[1]*scale;
-      CurrentZCoord = topology->cellLocations[loopA][2] + cells[loopA].velocity[2]*scale;
+      CurrentXCoord = topology->cellLocations[loopA][0] + cells.vx[loopA]*scale;
+      CurrentYCoord = topology->cellLocations[loopA][1] + cells.vy[loopA]*scale;
+      CurrentZCoord = topology->cellLocations[loopA][2] + cells.vz[loopA]*scale;
       fprintf(LSFile,"%d,%e,%e,%e,0,0\n",TotalNodes,CurrentXCoord,CurrentYCoord,CurrentZCoord);
     }
   }
@@ -207,9 +165,9 @@ void mriScan::exportToLSDYNA(std::string LSFileName, double scale){
   int Count = 0;
 	int Node1,Node2;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    CurrentModule = sqrt((cells[loopA].velocity[0]*cells[loopA].velocity[0])+
-                         (cells[loopA].velocity[1]*cells[loopA].velocity[1])+
-                         (cells[loopA].velocity[2]*cells[loopA].velocity[2]));
+    CurrentModule = sqrt((cells.vx[loopA]*cells.vx[loopA])+
+                         (cells.vy[loopA]*cells.vy[loopA])+
+                         (cells.vz[loopA]*cells.vz[loopA]));
     if (CurrentModule>kMathZero){
       Count++;
       Node1 = (Count-1)*2+1;
@@ -234,10 +192,10 @@ void mriScan::exportToCSV(std::string FileName){
     OutFile << topology->cellLocations[loopA][0] << 
                topology->cellLocations[loopA][1] << 
                topology->cellLocations[loopA][2] <<
-               cells[loopA].concentration <<
-			         cells[loopA].velocity[0] << 
-               cells[loopA].velocity[1] << 
-               cells[loopA].velocity[2];
+               cells.conc[loopA] <<
+			         cells.vx[loopA] << 
+               cells.vy[loopA] << 
+               cells.vz[loopA];
   }
   OutFile.close();
   printf("Done\n");
@@ -246,65 +204,128 @@ void mriScan::exportToCSV(std::string FileName){
 // ============================
 // EXPORT TO TECPLOT ASCII FILE
 // ============================
-void mriScan::exportToTECPLOT(std::string FileName, bool isFirstFile){
+void mriScan::exportToTECPLOT(std::string FileName, bool isFirstFile, mriAsyncWriter* asyncWriter){
   // Write Progress Message 
 	writeSchMessage(std::string("Exporting to TECPLOT..."));
-  
-  // Open Output File
-	FILE* outFile;
-  if (isFirstFile){
-	  outFile = fopen(FileName.c_str(),"w");
-  }else{
-    outFile = fopen(FileName.c_str(),"a");
-  }
 
   // Fill Header
   std::vector<std::string> PltFileHeader;
   fillPLTHeader(PltFileHeader,isFirstFile);
 
-  // Write Header
-  std::string LineString;
-  std::string compString = "I";
-  for(unsigned int loopA=0;loopA<PltFileHeader.size();loopA++){
-    boost::trim(PltFileHeader[loopA]);
-    LineString = PltFileHeader[loopA];
-    if (LineString.substr(0,1) != compString){
-      fprintf(outFile,"%s\n",PltFileHeader[loopA].c_str());
+  // Copy the cell values and results, positions are read from the topology
+  std::shared_ptr<mriDoubleMat> cellValues(new mriDoubleMat(4));
+  (*cellValues)[0].assign(cells.conc.begin(),cells.conc.end());
+  (*cellValues)[1].assign(cells.vx.begin(),cells.vx.end());
+  (*cellValues)[2].assign(cells.vy.begin(),cells.vy.end());
+  (*cellValues)[3].assign(cells.vz.begin(),cells.vz.end());
+  std::shared_ptr<mriFieldRegistry> results(new mriFieldRegistry(outputs));
+  const mriTopology* topo = topology;
+
+  runWriteTask(asyncWriter,[=](){
+    // Open Output File
+    FILE* outFile;
+    if (isFirstFile){
+      outFile = fopen(FileName.c_str(),"w");
     }else{
-      fprintf(outFile," I=%d, J=%d, K=%d, ZONETYPE=Ordered\n",topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]);
+      outFile = fopen(FileName.c_str(),"a");
+    }
+    if(outFile == NULL){
+      throw mriException(string("ERROR: Cannot open file " + FileName + " for writing.\n").c_str());
     }
-  }
-  // Loop On Cells
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
 
-    // Write position, concentration and velocity
-    fprintf(outFile,"%-15.6e %-15.6e %-15.6e %-15.6e %-15.6e %-15.6e %-15.6e ",
-                      topology->cellLocations[loopA][0],
-                      topology->cellLocations[loopA][1],
-                      topology->cellLocations[loopA][2],
-                      cells[loopA].concentration,
-                      cells[loopA].velocity[0],
-                      cells[loopA].velocity[1],
-                      cells[loopA].velocity[2]);
-
-    // Add result quantities
-    for(size_t loopB=0;loopB<outputs.size();loopB++){
-      for(int loopC=0;loopC<outputs[loopB].totComponents;loopC++){
-        fprintf(outFile,"%-15.6e ",outputs[loopB].values[loopA*outputs[loopB].totComponents + loopC]);
+    // Write Header
+    std::string LineString;
+    std::string compString = "I";
+    for(unsigned int loopA=0;loopA<PltFileHeader.size();loopA++){
+      LineString = boost::trim_copy(PltFileHeader[loopA]);
+      if (LineString.substr(0,1) != compString){
+        fprintf(outFile,"%s\n",LineString.c_str());
+      }else{
+        fprintf(outFile," I=%d, J=%d, K=%d, ZONETYPE=Ordered\n",topo->cellTotals[0],topo->cellTotals[1],topo->cellTotals[2]);
       }
     }
+    // Loop On Cells
+    const mriDoubleMat& values = *cellValues;
+    for(int loopA=0;loopA<topo->totalCells;loopA++){
+
+      // Write position, concentration and velocity
+      fprintf(outFile,"%-15.6e %-15.6e %-15.6e %-15.6e %-15.6e %-15.6e %-15.6e ",
+                        topo->cellLocations[loopA][0],
+                        topo->cellLocations[loopA][1],
+                        topo->cellLocations[loopA][2],
+                        values[0][loopA],
+                        values[1][loopA],
+                        values[2][loopA],
+                        values[3][loopA]);
+
+      // Add result quantities
+      for(size_t loopB=0;loopB<results->size();loopB++){
+        const mriField& field = (*results)[loopB];
+        for(int loopC=0;loopC<field.totComponents;loopC++){
+          fprintf(outFile,"%-15.6e ",field.getValue(loopA,loopC));
+        }
+      }
 
-    // New Line
-    fprintf(outFile,"\n");
-  }
+      // New Line
+      fprintf(outFile,"\n");
+    }
 
-  // Close Output file
-  fclose(outFile);
+    // Close Output file
+    fclose(outFile);
+  });
   
   // Write Done Message
   writeSchMessage(std::string("Done\n"));
 };
 
+// =============================
+// EXPORT TO TECPLOT BINARY FILE
+// =============================
+void mriScan::exportToTECPLOTBinary(mriTecplotWriter* writer, bool isFirstZone, mriAsyncWriter* asyncWriter){
+  // Write Progress Message
+  writeSchMessage(std::string("Exporting to binary TECPLOT..."));
+
+  // Single precision copy of every variable, coordinates for the first zone only
+  int totCells = topology->totalCells;
+  vector<const double*> columns;
+  columns.push_back(cells.conc.data());
+  columns.push_back(cells.vx.data());
+  columns.push_back(cells.vy.data());
+  columns.push_back(cells.vz.data());
+  for(size_t loopA=0;loopA<outputs.size();loopA++){
+    for(int loopB=0;loopB<outputs[loopA].totComponents;loopB++){
+      columns.push_back(outputs[loopA].component(loopB));
+    }
+  }
+  int totCoords = isFirstZone ? kNumberOfDimensions : 0;
+  std::shared_ptr<vector<vector<float> > > values(new vector<vector<float> >(totCoords + columns.size()));
+  for(size_t loopA=0;loopA<values->size();loopA++){
+    (*values)[loopA].resize(totCells);
+  }
+  mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      for(int loopB=0;loopB<totCoords;loopB++){
+        (*values)[loopB][loopA] = (float)topology->cellLocations[loopA][loopB];
+      }
+      for(size_t loopB=0;loopB<columns.size();loopB++){
+        (*values)[totCoords + loopB][loopA] = (float)columns[loopB][loopA];
+      }
+    }
+  });
+
+  runWriteTask(asyncWriter,[=](){
+    // Shared coordinates are not read after the first zone
+    vector<const float*> zoneValues(kNumberOfDimensions - totCoords,NULL);
+    for(size_t loopA=0;loopA<values->size();loopA++){
+      zoneValues.push_back((*values)[loopA].data());
+    }
+    writer->writeZone(zoneValues);
+  });
+
+  // Write Done Message
+  writeSchMessage(std::string("Done\n"));
+}
+
 // ========================
 // Get Local Adjacent Plane
 // ========================
@@ -337,8 +358,8 @@ void mriScan::flushToFile(std::string FileName){
             topology->cellLocations[loopA][0],
             topology->cellLocations[loopA][1],
             topology->cellLocations[loopA][2],
-            cells[loopA].concentration,
-            cells[loopA].velocity[0],cells[loopA].velocity[1],cells[loopA].velocity[2]);
+            cells.conc[loopA],
+            cells.vx[loopA],cells.vy[loopA],cells.vz[loopA]);
   }
 	// Close Output file
 	fclose(outFile);
@@ -541,16 +562,17 @@ void mriScan::assembleDecodingMatrix(int &totalRows, int &totalColumns, mriDoubl
 
 // Assign Random Component
 void mriScan::assignRandomComponent(const int direction,stdRndGenerator &generator){
+  mriCellWriteGuard cellWrite(cells);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     switch (direction){
       case kdirX:
-        cells[loopA].velocity[0] = generator();
+        cells.vx[loopA] = generator();
         break;
       case kdirY:
-        cells[loopA].velocity[1] = generator();
+        cells.vy[loopA] = generator();
         break;
       case kdirZ:
-        cells[loopA].velocity[2] = generator();
+        cells.vz[loopA] = generator();
         break;
     }
   }
@@ -571,7 +593,7 @@ void mriScan::exportVelocitiesToFile(std::string fileName, bool append){
   // Write Header
   for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
     for(int loopB=0;loopB<topology->totalCells;loopB++){
-      fprintf(outFile,"%e ",cells[loopB].velocity[loopA]);  
+      fprintf(outFile,"%e ",cells.velocity(loopA)[loopB]);  
     }
   }
   fprintf(outFile,"\n");  
@@ -592,8 +614,7 @@ void mriScan::crop(const mriDoubleVec& limitBox, const mriBoolVec& indexesToCrop
     }
   }
   // Allocate New Cellpoints
-  std::vector<mriCell> tempCellPoints;
-  tempCellPoints.resize(remainingCells);
+  mriCellData tempCellPoints(remainingCells);
   maxVelModule = 0.0;
   double currVelModule = 0.0;
   // Fill Temporary Cells
@@ -603,15 +624,13 @@ void mriScan::crop(const mriDoubleVec& limitBox, const mriBoolVec& indexesToCrop
                                    topology->cellLocations[loopA][1],
                                    topology->cellLocations[loopA][2],limitBox)){
       // Concentration
-      tempCellPoints[tempCount].concentration = cells[loopA].concentration;
+      tempCellPoints.conc[tempCount] = cells.conc[loopA];
       // Velocity
-      tempCellPoints[tempCount].velocity[0] = cells[loopA].velocity[0];
-      tempCellPoints[tempCount].velocity[1] = cells[loopA].velocity[1];
-      tempCellPoints[tempCount].velocity[2] = cells[loopA].velocity[2];
+      tempCellPoints.vx[tempCount] = cells.vx[loopA];
+      tempCellPoints.vy[tempCount] = cells.vy[loopA];
+      tempCellPoints.vz[tempCount] = cells.vz[loopA];
       // Get Velocity Module
-      currVelModule = sqrt(tempCellPoints[tempCount].velocity[0]*tempCellPoints[tempCount].velocity[0]+
-                           tempCellPoints[tempCount].velocity[1]*tempCellPoints[tempCount].velocity[1]+
-                           tempCellPoints[tempCount].velocity[2]*tempCellPoints[tempCount].velocity[2]);
+      currVelModule = tempCellPoints.getVelocityModule(tempCount);
       // Store Maximum Velocity Module
       if (currVelModule > maxVelModule){
         maxVelModule = currVelModule;
@@ -620,28 +639,18 @@ void mriScan::crop(const mriDoubleVec& limitBox, const mriBoolVec& indexesToCrop
       tempCount++;
     }
   }
-  cells.resize(remainingCells);
-  // Copy Back
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Concentration
-    cells[loopA].concentration = tempCellPoints[loopA].concentration;
-    // Velocity
-    cells[loopA].velocity[0] = tempCellPoints[loopA].velocity[0];
-    cells[loopA].velocity[1] = tempCellPoints[loopA].velocity[1];
-    cells[loopA].velocity[2] = tempCellPoints[loopA].velocity[2];
-    // Filtered Velocities
-    cells[loopA].auxVector[0] = 0.0;
-    cells[loopA].auxVector[1] = 0.0;
-    cells[loopA].auxVector[2] = 0.0;
-  }
+  // Swap in the cropped storage (filtered velocities are zero)
+  std::swap(cells,tempCellPoints);
+  cells.markModified();
 }
 
 // SCALE VELOCITIES
 void mriScan::scaleVelocities(double factor){
+  mriCellWriteGuard cellWrite(cells);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    cells[loopA].velocity[0] *= factor;
-    cells[loopA].velocity[1] *= factor;
-    cells[loopA].velocity[2] *= factor;
+    cells.vx[loopA] *= factor;
+    cells.vy[loopA] *= factor;
+    cells.vz[loopA] *= factor;
   }
   maxVelModule *= factor;
 }
@@ -650,81 +659,103 @@ void mriScan::scaleVelocities(double factor){
 // CHECK IF SPACING IS UNIFORM
 // ===========================
 bool mriScan::hasUniformSpacing(){
-  double lengthX = topology->cellLengths[0][0];
-  double lengthY = topology->cellLengths[1][0];
-  double lengthZ = topology->cellLengths[2][0];
-  int count = 1;
-  bool result = true;
-  while(result && ((size_t)count<topology->cellLengths.size())){
-    result = result && (fabs(topology->cellLengths[0][count] - lengthX) < kMathZero) &&
-                       (fabs(topology->cellLengths[1][count] - lengthY) < kMathZero) &&
-                       (fabs(topology->cellLengths[2][count] - lengthZ) < kMathZero);
-    count++;
-  }
-  return result;
+  return topology->uniformAxis[0] && topology->uniformAxis[1] && topology->uniformAxis[2];
 }
 
 // =================
 // Write to VTK File
 // =================
-void mriScan::exportToVTK(string fileName, mriThresholdCriteria* threshold){
-
-  // Declare
-  bool printAux = true;
-  double currXCoord = 0.0;
-  double currYCoord = 0.0;
-  double currZCoord = 0.0;
-
-  // Open Output File
-  FILE* outFile;
-  outFile = fopen(fileName.c_str(),"w");
-  // Write Header
-  fprintf(outFile,"# vtk DataFile Version 3.0\n");
-  fprintf(outFile,"Grid Point Model\n");
-  fprintf(outFile,"ASCII\n");
-
-  if(hasUniformSpacing()){
-      printf("Dataset type STRUCTURED_POINTS.\n");
-      // Write Data Set
-      fprintf(outFile,"DATASET STRUCTURED_POINTS\n");
-      fprintf(outFile,"DIMENSIONS %d %d %d\n",topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]);
-      fprintf(outFile,"SPACING %e %e %e\n",topology->cellLengths[0][0],topology->cellLengths[1][0],topology->cellLengths[2][0]);
-      fprintf(outFile,"ORIGIN %e %e %e\n",topology->domainSizeMin[0],topology->domainSizeMin[1],topology->domainSizeMin[2]);
+void mriScan::exportToVTK(string fileName, mriThresholdCriteria* threshold, bool isBinary, mriAsyncWriter* asyncWriter){
+
+  // Grid of the data set
+  bool isUniform = hasUniformSpacing();
+  mriIntVec totals = topology->cellTotals;
+  double spacing[3] = {0.0};
+  double origin[3] = {0.0};
+  mriDoubleMat axisCoords;
+  if(isUniform){
+    printf("Dataset type STRUCTURED_POINTS.\n");
+    for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+      spacing[loopA] = topology->cellLengths[loopA][0];
+      origin[loopA] = topology->domainSizeMin[loopA];
+    }
   }else{
     printf("Dataset type: RECTILINEAR_GRID.\n");
-    // Write Data Set
-    fprintf(outFile,"DATASET RECTILINEAR_GRID\n");
-    fprintf(outFile,"DIMENSIONS %d %d %d\n",topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]);
-    // Export X Coordinates
-    fprintf(outFile,"X_COORDINATES %d double\n",(int)topology->cellLengths[0].size());
-    currXCoord = topology->domainSizeMin[0];
-    for(size_t loopA=1;loopA<topology->cellLengths[0].size();loopA++){
-      fprintf(outFile,"%e ",currXCoord);
-      currXCoord += 0.5*(topology->cellLengths[0][loopA-1] + topology->cellLengths[0][loopA]);
+    getVTKAxisCoords(axisCoords);
+  }
+
+  // Copy the fields, the file is written from the copy
+  std::shared_ptr<mriFieldSnapshot> fields(new mriFieldSnapshot());
+  writeVTKFields(*fields,threshold);
+
+  runWriteTask(asyncWriter,[=](){
+    // Open Output File and Write Header
+    mriVTKWriter writer(fileName,isBinary);
+    writer.writeHeader("Grid Point Model");
+    if(isUniform){
+      writer.writeStructuredPoints(totals,spacing,origin);
+    }else{
+      writer.writeRectilinearGrid(totals,axisCoords);
     }
-    fprintf(outFile,"%e\n",currXCoord);
+    fields->replay(writer);
+  });
+}
 
-    // Export Y Coordinates
-    fprintf(outFile,"Y_COORDINATES %d double\n",(int)topology->cellLengths[1].size());
-    currYCoord = topology->domainSizeMin[1];
-    for(size_t loopA=1;loopA<topology->cellLengths[1].size();loopA++){
-      fprintf(outFile,"%e ",currYCoord);
-      currYCoord += 0.5*(topology->cellLengths[1][loopA-1] + topology->cellLengths[1][loopA]);
+// ======================
+// EXPORT TO VTK XML FILE
+// ======================
+void mriScan::exportToVTKXML(string fileName, mriThresholdCriteria* threshold, int compression, mriAsyncWriter* asyncWriter){
+  bool isUniform = hasUniformSpacing();
+  mriIntVec totals = topology->cellTotals;
+  double spacing[3] = {0.0};
+  double origin[3] = {0.0};
+  mriDoubleMat axisCoords;
+  if(isUniform){
+    for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+      spacing[loopA] = topology->cellLengths[loopA][0];
+      origin[loopA] = topology->domainSizeMin[loopA];
     }
-    fprintf(outFile,"%e\n",currYCoord);
+  }else{
+    getVTKAxisCoords(axisCoords);
+  }
+  std::shared_ptr<mriFieldSnapshot> fields(new mriFieldSnapshot());
+  writeVTKFields(*fields,threshold);
 
-    // Export Z Coordinates
-    fprintf(outFile,"Z_COORDINATES %d double\n",(int)topology->cellLengths[2].size());
-    currZCoord = topology->domainSizeMin[2];
-    for(size_t loopA=1;loopA<topology->cellLengths[2].size();loopA++){
-      fprintf(outFile,"%e ",currZCoord);
-      currZCoord += 0.5*(topology->cellLengths[2][loopA-1] + topology->cellLengths[2][loopA]);
+  runWriteTask(asyncWriter,[=](){
+    mriVTKXMLWriter writer(fileName,compression);
+    if(isUniform){
+      writer.setImageData(totals,spacing,origin);
+    }else{
+      writer.setRectilinearGrid(totals,axisCoords);
+    }
+    fields->replay(writer);
+  });
+}
+
+// ========================
+// GET VTK AXIS COORDINATES
+// ========================
+// Cell center coordinates along each axis of a rectilinear grid
+void mriScan::getVTKAxisCoords(mriDoubleMat& axisCoords){
+  axisCoords.resize(kNumberOfDimensions);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    axisCoords[loopA].resize(topology->cellCenterOffsets[loopA].size());
+    for(size_t loopB=0;loopB<axisCoords[loopA].size();loopB++){
+      axisCoords[loopA][loopB] = topology->domainSizeMin[loopA] + topology->cellCenterOffsets[loopA][loopB];
     }
-    fprintf(outFile,"%e\n",currZCoord);
   }
+}
+
+// ======================
+// WRITE VTK POINT FIELDS
+// ======================
+// Shared by the legacy and XML writers and by mriFieldSnapshot. The XML
+// writer reads the arrays when it is closed, so all of them must live
+// until writer.close().
+template<typename W> void mriScan::writeVTKFields(W& writer, mriThresholdCriteria* threshold){
 
   // Export Point quantities
-  fprintf(outFile,"POINT_DATA %d\n",topology->totalCells);
+  writer.writePointData(topology->totalCells);
 
   // Export Normal sign
   mriDoubleVec normSignX(topology->totalCells);
@@ -756,27 +787,13 @@ void mriScan::exportToVTK(string fileName, mriThresholdCriteria* threshold){
       normSignZ[loopA] /= (double)counterVec[loopA];
     }
   }
-  fprintf(outFile,"VECTORS faceNormals double\n");
-  // Print velocity components
-  for (int loopA=0;loopA<topology->totalCells;loopA++){
-    fprintf(outFile,"%e %e %e\n",normSignX[loopA],normSignY[loopA],normSignZ[loopA]);
-  }
+  writer.writeVectors("faceNormals",normSignX.data(),normSignY.data(),normSignZ.data());
 
   // Print Scalar Concentration
-  fprintf(outFile,"SCALARS concentration double\n");
-  fprintf(outFile,"LOOKUP_TABLE default\n");
-  // Print Concentrations
-  for (int loopA=0;loopA<topology->totalCells;loopA++){
-    fprintf(outFile,"%e\n",cells[loopA].concentration);
-  }
+  writer.writeScalars("concentration",cells.conc.data());
 
   //Print velocity
-  fprintf(outFile,"VECTORS velocity double\n");
-  // Print velocity components
-  for (int loopA=0;loopA<topology->totalCells;loopA++){
-    fprintf(outFile,"%e %e %e\n",cells[loopA].velocity[0],cells[loopA].velocity[1],cells[loopA].velocity[2]);
-    //fprintf(outFile,"%e %e %e\n",cellPoints[loopA].filteredVel[0],cellPoints[loopA].filteredVel[1],cellPoints[loopA].filteredVel[2]);
-  }
+  writer.writeVectors("velocity",cells.vx.data(),cells.vy.data(),cells.vz.data());
 
   // ==================
   // EXPORT DERIVATIVES
@@ -792,63 +809,49 @@ void mriScan::exportToVTK(string fileName, mriThresholdCriteria* threshold){
     secondDerivs[loopA].resize(kNumberOfDimensions);
   }  
 
-  // Print the Velocity Gradient
-  fprintf(outFile,"TENSORS VelocityGradient double\n");
-  // Print Reynolds Stress Tensor
-  for (int loopA=0;loopA<topology->totalCells;loopA++){
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
-    fprintf(outFile,"%e %e %e\n",firstDerivs[0][0],firstDerivs[0][1],firstDerivs[0][2]);
-    fprintf(outFile,"%e %e %e\n",firstDerivs[1][0],firstDerivs[1][1],firstDerivs[1][2]);
-    fprintf(outFile,"%e %e %e\n",firstDerivs[2][0],firstDerivs[2][1],firstDerivs[2][2]);
-    fprintf(outFile,"\n");
-  }
-
-  
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
 
   // Print the Velocity Gradient
-  fprintf(outFile,"TENSORS VelocityCurvature double\n");
-  // Print Reynolds Stress Tensor
-  for (int loopA=0;loopA<topology->totalCells;loopA++){
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
-    fprintf(outFile,"%e %e %e\n",secondDerivs[0][0],secondDerivs[0][1],secondDerivs[0][2]);
-    fprintf(outFile,"%e %e %e\n",secondDerivs[1][0],secondDerivs[1][1],secondDerivs[1][2]);
-    fprintf(outFile,"%e %e %e\n",secondDerivs[2][0],secondDerivs[2][1],secondDerivs[2][2]);
-    fprintf(outFile,"\n");
-  }
+  writer.writeTensors("VelocityGradient",[&](int cell,double tensor[3][3]){
+    derivs.getDerivs(cell,firstDerivs,secondDerivs);
+    for(int loopA=0;loopA<3;loopA++){
+      for(int loopB=0;loopB<3;loopB++){
+        tensor[loopA][loopB] = firstDerivs[loopA][loopB];
+      }
+    }
+  });
+
+  // Print the Velocity Curvature
+  writer.writeTensors("VelocityCurvature",[&](int cell,double tensor[3][3]){
+    derivs.getDerivs(cell,firstDerivs,secondDerivs);
+    for(int loopA=0;loopA<3;loopA++){
+      for(int loopB=0;loopB<3;loopB++){
+        tensor[loopA][loopB] = secondDerivs[loopA][loopB];
+      }
+    }
+  });
 
   // EXPORT OUTPUTS
   for(size_t loopA=0;loopA<outputs.size();loopA++){
-    // Print Header
-    if(outputs[loopA].totComponents == 1){
-      fprintf(outFile,"%s\n",string("SCALARS " + outputs[loopA].name + " double").c_str());
-      fprintf(outFile,"LOOKUP_TABLE default\n");
-      for (int loopB=0;loopB<topology->totalCells;loopB++){
-        fprintf(outFile,"%e\n",outputs[loopA].values[loopB]);
-      }
-    }else{
-      int count = 0;
-      fprintf(outFile,"%s\n",string("VECTORS " + outputs[loopA].name + " double").c_str());
-      for (int loopB=0;loopB<topology->totalCells;loopB++){
-        for(int loopC=0;loopC<outputs[loopA].totComponents;loopC++){
-          fprintf(outFile,"%e ",outputs[loopA].values[count]);
-          count++;
-        }
-        fprintf(outFile,"\n");
-      }
+    const mriField& field = outputs[loopA];
+    if(field.type == ftScalar){
+      writer.writeScalars(field.name,field.component(0));
+    }else if(field.type == ftVector){
+      writer.writeVectors(field.name,field.component(0),field.component(1),field.component(2));
+    }else if(field.type == ftSymTensor){
+      const mriField* tensorField = &field;
+      writer.writeTensors(field.name,[tensorField](int cell,double tensor[3][3]){
+        tensorField->getTensor(cell,tensor);
+      });
     }
   }
 
   // Print Tagging
   if(cellTags.size() > 0){
-    fprintf(outFile,"SCALARS Tags double\n");
-    fprintf(outFile,"LOOKUP_TABLE default\n");
-    for (int loopA=0;loopA<topology->totalCells;loopA++){
-      fprintf(outFile,"%d\n",cellTags[loopA]);
-    }
+    writer.writeScalars("Tags",cellTags.data());
   }
-
-  // Close File
-  fclose(outFile);
+  writer.close();
 }
 
 // Eval total Number of Vortices
@@ -902,22 +905,18 @@ void mriScan::readRAWFileSequence(std::string fileListName){
       topology->cellLengths[loopA][loopB] = 1.0;
     }
   }
+  topology->buildCoordinateTables();
 
   // Set total Points
   topology->totalCells = topology->cellTotals[0] * topology->cellTotals[1] * topology->cellTotals[2];
 
   // Intialize Cells
-  mriCell myCellPoint;
-  myCellPoint.concentration = 0.0;
-  myCellPoint.velocity[0] = 0.0;
-  myCellPoint.velocity[1] = 0.0;
-  myCellPoint.velocity[2] = 0.0;
-  // Resize: CHECK!!!
-  cells.resize(topology->totalCells,myCellPoint);
+  cells.clear();
+  cells.resize(topology->totalCells);
 
   // Fill Concentration with First Image Data
   for(int loopA=0;loopA<data.sizeX*data.sizeY;loopA++){
-    cells[loopA].concentration = data.rawData[loopA];
+    cells.conc[loopA] = data.rawData[loopA];
   }
 
   // Intialize how many cells read so far
@@ -933,7 +932,7 @@ void mriScan::readRAWFileSequence(std::string fileListName){
     }
     // Fill Concentration with First Image Data
     for(int loopB=readSoFar;loopB<readSoFar + data.sizeX*data.sizeY;loopB++){
-      cells[loopB].concentration = data.rawData[loopB];
+      cells.conc[loopB] = data.rawData[loopB];
     }
     // Increment readSoFar
     readSoFar += data.sizeX*data.sizeY;
@@ -1012,46 +1011,25 @@ int mriScan::readRawImage(std::string FileName, mriImageData &data){
 // ====================
 // WRITE EXPANSION FILE
 // ====================
-void mriScan::writeExpansionFile(std::string fileName){
-  // Open Output File
-  FILE* fid;
-  fid = fopen(fileName.c_str(),"w");
-
-  // WRITE TOTAL CELLS
-  fprintf(fid,"%15d %15d %15d\n",topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]);
-
-
-  // WRITE CELL LENGTHS X
-  for(int loopA=0;loopA<topology->cellTotals[0];loopA++){
-    fprintf(fid,"%15.6e\n",topology->cellLengths[0][loopA]);
-  }
-
-  // WRITE CELL LENGTHS Y
-  for(int loopA=0;loopA<topology->cellTotals[1];loopA++){
-    fprintf(fid,"%15.6e\n",topology->cellLengths[1][loopA]);
-  }
-
-  // WRITE CELL LENGTHS Z
-  for(int loopA=0;loopA<topology->cellTotals[2];loopA++){
-    fprintf(fid,"%15.6e\n",topology->cellLengths[2][loopA]);
-  }
-
-  // MIN DOMAIN SIZE
-  fprintf(fid,"%15.6e %15.6e %15.6e\n",topology->domainSizeMin[0],topology->domainSizeMin[1],topology->domainSizeMin[2]);
-  // MAX DOMAIN SIZE
-  fprintf(fid,"%15.6e %15.6e %15.6e\n",topology->domainSizeMax[0],topology->domainSizeMax[1],topology->domainSizeMax[2]);
-
-  // WRITE EXPANSION COEFFICIENTS
-  // Write Constant Flux Components
-  for(int loopA=0;loopA<3;loopA++){
-    fprintf(fid,"%15.6e\n",expansion->constantFluxCoeff[loopA]);
-  }
-  // Write Vortex Component
+void mriScan::writeExpansionFile(std::string fileName, const mriExpansionFileFormat& format, mriAsyncWriter* asyncWriter){
+  if(expansion == NULL){
+    throw mriException("ERROR: No expansion coefficients to write, the SMP filter was not applied.\n");
+  }
+  // Grid and coefficients, stored in the first-seen edge numbering
+  std::shared_ptr<mriExpansionFileData> data(new mriExpansionFileData());
+  data->cellTotals = topology->cellTotals;
+  data->cellLengths = topology->cellLengths;
+  data->domainSizeMin = topology->domainSizeMin;
+  data->domainSizeMax = topology->domainSizeMax;
+  data->constantFluxCoeff.assign(expansion->constantFluxCoeff,expansion->constantFluxCoeff + 3);
+  data->vortexCoeff.resize(expansion->totalVortices);
   for(int loopA=0;loopA<expansion->totalVortices;loopA++){
-    fprintf(fid,"%15.6e\n",expansion->vortexCoeff[loopA]);
+    data->vortexCoeff[topology->getCanonicalEdge(loopA)] = expansion->vortexCoeff[loopA];
   }
-  // Close Output file
-  fclose(fid);
+
+  runWriteTask(asyncWriter,[=](){
+    writeExpansionCoeffFile(fileName,*data,format);
+  });
 }
 
 // ==================
@@ -1061,13 +1039,14 @@ void mriScan::thresholdQuantity(int qtyID,double threshold){
   // DECLARE
   writeSchMessage(std::string("Applying threshold...\n"));
   double centerCellValue = 0.0;
+  mriCellWriteGuard cellWrite(cells);
   // LOOP ON ALL CELLS
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Get Value in Current Cell
-    centerCellValue = cells[loopA].getQuantity(qtyID);
+    centerCellValue = cells.getQuantity(loopA,qtyID);
     // Apply Threshold
     if (centerCellValue<threshold){
-      cells[loopA].setQuantity(qtyID,0.0);
+      cells.setQuantity(loopA,qtyID,0.0);
     }
   }
 }
@@ -1078,7 +1057,7 @@ void mriScan::thresholdQuantity(int qtyID,double threshold){
 void mriScan::evalSMPVortexCriteria(mriExpansion* exp){
   // LOOP ON CELLS
   mriIntVec idx;
-  mriOutput out1("SMPVortexCriterion",3);
+  mriVectorView out1 = outputs.addVector("SMPVortexCriterion",topology->totalCells);
   double avVortexIndex = 0.0;
   double totalIntensity = 0.0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
@@ -1097,11 +1076,9 @@ void mriScan::evalSMPVortexCriteria(mriExpansion* exp){
                          exp->vortexCoeff[idx[2]]*exp->vortexCoeff[idx[2]] +
                          exp->vortexCoeff[idx[3]]*exp->vortexCoeff[idx[3]]);
       // Assign To cell
-      out1.values.push_back(avVortexIndex);
+      out1(loopA,loopB) = avVortexIndex;
     }
   }
-  // Add output quantities
-  outputs.push_back(out1);
   // Printout
   printf("Total SMP Intensities: %e\n",totalIntensity);
 }
@@ -1147,15 +1124,15 @@ void mriScan::recoverGlobalErrorEstimates(double& AvNormError, double& AvAngleEr
   // Loop
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Eval Velocity Difference
-    diffVel[0] = cells[loopA].velocity[0] - cells[loopA].auxVector[0];
-    diffVel[1] = cells[loopA].velocity[1] - cells[loopA].auxVector[1];
-    diffVel[2] = cells[loopA].velocity[2] - cells[loopA].auxVector[2];
+    diffVel[0] = cells.vx[loopA] - cells.auxX[loopA];
+    diffVel[1] = cells.vy[loopA] - cells.auxY[loopA];
+    diffVel[2] = cells.vz[loopA] - cells.auxZ[loopA];
     diffNorm = mriUtils::do3DEucNorm(diffVel);
     AvNormError = AvNormError + diffNorm;
     // Eval Velocity Angle
     for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
-      normVel[loopB] = cells[loopA].velocity[loopB];
-      normFilterVel[loopB] = cells[loopA].auxVector[loopB];
+      normVel[loopB] = cells.velocity(loopB)[loopA];
+      normFilterVel[loopB] = cells.aux(loopB)[loopA];
     }
     // Normalize
     mriUtils::normalize3DVector(normVel);
@@ -1235,155 +1212,42 @@ void printVTKOptions(vtkStructuredPointsOptionRecord opts){
   printf("\n");
 }
 
-// Read Scalars From VTK Legacy
-void readVTKScalar(ifstream& vtkFile, int& lineCount,int linesToRead,mriDoubleVec& vtkScalar){
-  vtkScalar.clear();
-  string buffer;
-  double value;
-  mriStringVec tokenizedString;
-  // Skip first two lines
-  getline(vtkFile,buffer);
-  //printf("Skipping; %s\n",buffer.c_str());
-  lineCount++;
-  getline(vtkFile,buffer);
-  //printf("Skipping; %s\n",buffer.c_str());
-  lineCount++;
-  for(int loopA=0;loopA<linesToRead;loopA++){
-    getline(vtkFile,buffer);
-    //printf("Reading: %s\n",buffer.c_str());
-    boost::trim(buffer);
-    lineCount++;
-    if(!buffer.empty()){
-      boost::split(tokenizedString, buffer, boost::is_any_of(" ,"), boost::token_compress_on);
-      for(size_t loopB=0;loopB<tokenizedString.size();loopB++){
-        try{
-          value = atof(tokenizedString[loopB].c_str());
-          vtkScalar.push_back(value);
-        }catch(...){
-          return;
-        }
-      }
-    }else{
-      break;
-    }
-  }
-}
-
-// Read Vectors From VTK Legacy
-void readVTKVector(ifstream& vtkFile, int& lineCount, int linesToRead, mriDoubleMat& vtkVector){
-  vtkVector.clear();
-  mriDoubleVec temp;
-  mriDoubleVec store;
-  string buffer;
-  double value;
-  mriStringVec tokenizedString;
-  // Skip first line
-  getline(vtkFile,buffer);
-  lineCount++;
-  for(int loopA=0;loopA<linesToRead;loopA++){
-    std::getline(vtkFile,buffer);
-    boost::trim(buffer);
-    lineCount++;
-    if(!buffer.empty()){
-      boost::split(tokenizedString, buffer, boost::is_any_of(" ,"), boost::token_compress_on);
-      for(size_t loopB=0;loopB<tokenizedString.size();loopB++){
-        try{
-          value = atof(tokenizedString[loopB].c_str());
-          temp.push_back(value);
-        }catch(...){
-          //printf("Exiting with: %s\n",buffer.c_str());
-          break;
-        }
-      }
-    }else{
-      //printf("Exiting with: %s\n",buffer.c_str());
-      break;
-    }
-  }
-  // Fill Matrix
-  for(int loopA=0;loopA<temp.size()/3;loopA++){
-    store.clear();
-    for(int loopB=0;loopB<3;loopB++){
-      store.push_back(temp[loopA*3 + loopB]);
-    }
-    vtkVector.push_back(store);
-  }
-}
-
-// ==========================
-// READ VTK STRUCTURED POINTS
-// ==========================
-void mriScan::readFromVTK_ASCII(string vtkFileName, const vtkStructuredPointsOptionRecord& vtkOptions){
+// ===============================
+// READ VTK ASCII OR BINARY VALUES
+// ===============================
+void mriScan::readFromVTK(const mriVTKReader& reader){
 
   // Print Progress
-  printf("Reading Scan Data From: %s\n",vtkFileName.c_str());
-
-  // Reset File
-  ifstream vtkFile;
-  vtkFile.open(vtkFileName.c_str());
-
-  // Read Concentration and Velocities
-  mriDoubleVec vtkScalar;
-  mriDoubleMat vtkVector;
-  string Buffer;
-  int linesToRead = 0;
-  int totalLinesInFile = 0;
-  for(int loopA=0;loopA<vtkOptions.dataBlockStart.size();loopA++){
-    if(vtkOptions.dataBlockRead[loopA]){
-      // Go to next block start
-      while(totalLinesInFile<vtkOptions.dataBlockStart[loopA]){
-        std::getline(vtkFile,Buffer);
-        totalLinesInFile++;
-      }
-      // Read Scalars Or Vectors
-      if(vtkOptions.dataBlockType[loopA] == 0){
-        // Read Scalars
-        writeSchMessage(string("Reading Scalars...\n"));        
-        vtkScalar.clear();
-        linesToRead = vtkOptions.dataBlockStart[loopA + 1] - vtkOptions.dataBlockStart[loopA] - 2;
-        readVTKScalar(vtkFile,totalLinesInFile,linesToRead,vtkScalar);
-      }else{
-        // Read Vectors
-        writeSchMessage(std::string("Reading Vectors...\n"));
-        vtkVector.clear();
-        linesToRead = vtkOptions.dataBlockStart[loopA + 1] - vtkOptions.dataBlockStart[loopA];
-        readVTKVector(vtkFile,totalLinesInFile,linesToRead,vtkVector);
-      }
-    }
+  printf("Reading Scan Data From: %s\n",reader.getFileName().c_str());
+
+  // Locate Concentration and Velocities
+  const mriVTKDataBlock* scalarBlock = reader.findBlock(kVTKBlockScalars,"CONCENTRATION");
+  const mriVTKDataBlock* vectorBlock = reader.findBlock(kVTKBlockVectors,"VELOCITY");
+  if((scalarBlock == NULL)||(vectorBlock == NULL)){
+    throw mriException("ERROR: Incompatible Scalar and Vector in readFromVTK.\n");
   }
+  writeSchMessage(string("Reading Scalars...\n"));
+  mriVTKBlockValues scalarValues(*scalarBlock);
+  writeSchMessage(std::string("Reading Vectors...\n"));
+  mriVTKBlockValues vectorValues(*vectorBlock);
 
   // Check Consistence between scalar and vector
-  if(vtkScalar.size() != vtkVector.size()){
-    throw mriException("ERROR: Incompatible Scalar and Vector in readFromVTK_ASCII.\n");
+  if(vectorValues.getTotalValues() != 3*scalarValues.getTotalValues()){
+    throw mriException("ERROR: Incompatible Scalar and Vector in readFromVTK.\n");
   }
 
-  // Get Total Cells
-  int totCells = vtkScalar.size();
-  // Transfer Scalars and Vectors to Cells
+  // Parse Scalars and Vectors straight into the Cells
+  int totCells = scalarValues.getTotalValues();
   cells.clear();
-  mriCell cell;
-  for(int loopA=0;loopA<totCells;loopA++){
-    cell.concentration = vtkScalar[loopA];
-    cells.push_back(cell);
-  }
-
-  // Vectors
-  maxVelModule = 0.0;
-  double currModulus = 0.0;
-  for(int loopA=0;loopA<totCells;loopA++){
-      cells[loopA].velocity[0] = vtkVector[loopA][0];
-      cells[loopA].velocity[1] = vtkVector[loopA][1];
-      cells[loopA].velocity[2] = vtkVector[loopA][2];
-      currModulus = sqrt((cells[loopA].velocity[0] * cells[loopA].velocity[0]) +
-                         (cells[loopA].velocity[1] * cells[loopA].velocity[1]) +
-                         (cells[loopA].velocity[2] * cells[loopA].velocity[2]));
-      if(currModulus > maxVelModule){
-        maxVelModule = currModulus;
-      }
-  }
-
-  // Close File
-  vtkFile.close();
+  cells.resize(totCells);
+  double* scalarComps[1] = {cells.conc.data()};
+  scalarValues.decode(1,totCells,scalarComps);
+  double* vectorComps[3] = {cells.vx.data(),cells.vy.data(),cells.vz.data()};
+  vectorValues.decode(3,totCells,vectorComps);
+  cells.markModified();
+
+  // Max Velocity Module
+  maxVelModule = cells.getMaxVelocityModule();
 }
 
 // ============================
@@ -1422,9 +1286,10 @@ void mriScan::setWallFluxesToZero(bool* isFaceOnWalls, mriDoubleVec& poissonSour
 // COMPUTE TURBULENT VISCOSITY USING PANDTL MIXED LENGTH MODEL
 // ===========================================================
 void mriScan::evalPradtlTurbViscosity(mriDoubleMat cellDistance, mriThresholdCriteria* threshold, double density, mriDoubleMat& turbViscosity){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(threshold);
   int cellCount = 0;
   double sTerm  = 0.0;
-  double qty    = 0.0;
   double currDist = 0.0;
   mriDoubleVec tmp;
   
@@ -1439,14 +1304,15 @@ void mriScan::evalPradtlTurbViscosity(mriDoubleMat cellDistance, mriThresholdCri
   }
   
   turbViscosity.clear();
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Only Cells with significant Concentration
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
+    if(fluidMask.isFluid(loopA)){
       // Get Current Distance
       currDist = cellDistance[cellCount][0];
       // Eva Spatial Derivatives
-      evalSpaceDerivs(loopA, threshold, firstDerivs, secondDerivs);
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
       // Evaluate the Module of the strain rate tensor
       sTerm = 0.0;
       for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
@@ -1476,9 +1342,12 @@ void mriScan::evalPradtlTurbViscosity(mriDoubleMat cellDistance, mriThresholdCri
 // ==================================================================
 void mriScan::exportForPoisson(string inputFileName,double density,double viscosity,
                                          mriThresholdCriteria* threshold,
-                                         const mriDoubleMat& timeDerivs,
+                                         const mriTimeDerivs& timeDerivs,
                                          bool PPE_IncludeAccelerationTerm,bool PPE_IncludeAdvectionTerm,bool PPE_IncludeDiffusionTerm,bool PPE_IncludeReynoldsTerm,
-                                         bool readMuTFromFile, string muTFile, double smagorinskyCoeff){
+                                         bool readMuTFromFile, string muTFile, double smagorinskyCoeff,
+                                         mriFEMesh* mesh, int exportFormat, mriAsyncWriter* asyncWriter){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(threshold);
 
   printf("\n");
   printf("Acceleration Term included: %s\n",PPE_IncludeAccelerationTerm ? "TRUE":"FALSE");
@@ -1486,60 +1355,24 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
   printf("Viscous Term included:      %s\n",PPE_IncludeDiffusionTerm ? "TRUE":"FALSE");
   printf("Reynolds Term included:     %s\n",PPE_IncludeReynoldsTerm ? "TRUE":"FALSE");
 
-  // Declare
-  FILE* outFile;
-  outFile = fopen(inputFileName.c_str(),"w");
+  // Mesh renumbering shared by the scans with the same fluid cells
+  const mriIntVec& elUsageMap = mesh->elUsageMap;
   int totAuxNodes = topology->getTotalAuxNodes();
+  int elCount = mesh->totalElements;
 
-  double qty = 0.0;
-
-  // WRITE THE TOTAL NUMBER OF DOFs FOR THIS PROBLEM
-  fprintf(outFile,"NODEDOF %d\n",1);
-  fprintf(outFile,"PROBLEM PPE\n");
-
-  // Get the mappings for nodes that need to be used
-  mriIntVec nodeUsageMap;
-  mriIntVec elUsageMap;
-  for(int loopA=0;loopA<totAuxNodes;loopA++){
-    nodeUsageMap.push_back(-1);
-  }
-
-  // Mark Used Nodes
-  int currAuxNode = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      for(int loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
-        currAuxNode = topology->cellConnections[loopA][loopB];
-        nodeUsageMap[currAuxNode] = 1;
-      }
-    }
-  }
-
-  // Renumber Nodes in nodeUsageMap
-  int usedNodeCount = 0;
-  for(int loopA=0;loopA<totAuxNodes;loopA++){
-    if(nodeUsageMap[loopA] > 0){
-      nodeUsageMap[loopA] = usedNodeCount;
-      usedNodeCount++;
-    }
-  }
+  // Check if no fluid element is exported
+  if(elCount == 0){
 
-  // Build Element Mapping
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    elUsageMap.push_back(-1);
-  }
-  int elCount = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      elUsageMap[loopA] = elCount;
-      elCount++;
+    // Binary files keep the empty mesh
+    if(exportFormat == kFEExportBinary){
+      writeFEFieldFile(inputFileName,kFEProblemPPE,mesh->meshFileName,mriDoubleVec(),mriDoubleVec(),asyncWriter);
+      return;
     }
-  }
 
-  // Check if no fluid element is exported
-  if(elCount == 0){
+    // Lines are written by the writer thread in chunks
+    mriAsyncTextFile outFile(inputFileName,asyncWriter);
+    outFile.print("NODEDOF %d\n",1);
+    outFile.print("PROBLEM PPE\n");
 
     // SAVE NODE COORDS ONLY FOR NODES NUMBERED IN USEDNODEMAP
     if(topology->totalCells > 0){
@@ -1548,7 +1381,7 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
         pos[0] = topology->auxNodesCoords[loopA][0];
         pos[1] = topology->auxNodesCoords[loopA][1];
         pos[2] = topology->auxNodesCoords[loopA][2];
-        fprintf(outFile,"NODE %d %19.12e %19.12e %19.12e\n",loopA+1,pos[0],pos[1],pos[2]);
+        outFile.print("NODE %d %19.12e %19.12e %19.12e\n",loopA+1,pos[0],pos[1],pos[2]);
       }
 
       // ========================
@@ -1556,12 +1389,12 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
       // ========================
       elCount = 0;
       for(int loopA=0;loopA<topology->totalCells;loopA++){
-        fprintf(outFile,"ELEMENT HEXA8 %d 1 ",elCount+1);
+        outFile.print("ELEMENT HEXA8 %d 1 ",elCount+1);
         elCount++;
         for(int loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
-          fprintf(outFile,"%d ",topology->cellConnections[loopA][loopB] + 1);
+          outFile.print("%d ",topology->cellConnections[loopA][loopB] + 1);
         }
-        fprintf(outFile,"\n");
+        outFile.print("\n");
       }
     }
 
@@ -1570,67 +1403,20 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
     // ========================
     elCount = 0;
     for(int loopA=0;loopA<topology->totalCells;loopA++){
-      fprintf(outFile,"ELDIFF %d ",elCount+1);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"\n");
+      outFile.print("ELDIFF %d ",elCount+1);
+      outFile.print("%e ",1.0);
+      outFile.print("%e ",1.0);
+      outFile.print("%e ",1.0);
+      outFile.print("\n");
       elCount++;
     }  
 
     // Return mesh with no source or Neumann boundary conditions
+    outFile.close();
     return;    
 
   }
 
-  // ==================
-  // SAVE MESH TOPOLOGY
-  // ==================
-  // SAVE NODE COORDS ONLY FOR NODES NUMBERED IN USEDNODEMAP
-  if(topology->totalCells > 0){
-    double pos[3];
-    for(int loopA=0;loopA<totAuxNodes;loopA++){
-      if(nodeUsageMap[loopA] > -1){
-        pos[0] = topology->auxNodesCoords[loopA][0];
-        pos[1] = topology->auxNodesCoords[loopA][1];
-        pos[2] = topology->auxNodesCoords[loopA][2];
-        fprintf(outFile,"NODE %d %19.12e %19.12e %19.12e\n",nodeUsageMap[loopA]+1,pos[0],pos[1],pos[2]);
-      }
-    }
-
-    // ========================
-    // SAVE ELEMENT CONNECTIONS
-    // ========================
-    elCount = 0;
-    for(int loopA=0;loopA<topology->totalCells;loopA++){
-      qty = cells[loopA].getQuantity(threshold->thresholdQty);
-      if(!threshold->meetsCriteria(qty)){
-        fprintf(outFile,"ELEMENT HEXA8 %d 1 ",elCount+1);
-        elCount++;
-        for(int loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
-          fprintf(outFile,"%d ",nodeUsageMap[topology->cellConnections[loopA][loopB]] + 1);
-        }
-        fprintf(outFile,"\n");
-      }
-    }
-  }
-
-  // ========================
-  // SAVE ELEMENT DIFFUSIVITY
-  // ========================
-  elCount = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      fprintf(outFile,"ELDIFF %d ",elCount+1);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"\n");
-      elCount++;
-    }
-  }  
-
   // ========================================
   // TEMP: READ TURBULENT VISCOSITY FROM FILE
   // ========================================
@@ -1667,13 +1453,11 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
   // ==========================================
   // ADD THE TURBULENT VISCOSITY TO THE RESULTS
   // ==========================================
-  mriOutput outMuT("TurbulentViscosity",1);
+  mriScalarView outMuT = outputs.addScalar("TurbulentViscosity",topology->totalCells);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Assign To cell
-    outMuT.values.push_back(turbViscosity[loopA][0]);
+    outMuT.at<0>(loopA) = turbViscosity[loopA][0];
   }
-  // Add output quantities
-  outputs.push_back(outMuT);
 
   // ====================================
   // COMPUTE PRESSURE GRADIENT COMPONENTS
@@ -1701,11 +1485,13 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
   // ========================================
   // PRINT THE NORM OF THE STRAIN RATE TENSOR
   // ========================================
-  mriOutput outSS("strainRateNorm",1);
+  mriScalarView outSS = outputs.addScalar("strainRateNorm",topology->totalCells);
   double sTerm = 0.0;
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Eva Spatial Derivatives
-    evalSpaceDerivs(loopA, threshold, firstDerivs, secondDerivs);
+    derivs.getDerivs(loopA,firstDerivs,secondDerivs);
     // Evaluate the Module of the velocity Gradient
     sTerm = 0.0;
     for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
@@ -1716,20 +1502,17 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
         //sTerm += (0.5 * (firstDerivs[loopB][loopC] - firstDerivs[loopC][loopB])) * (0.5 * (firstDerivs[loopB][loopC] - firstDerivs[loopC][loopB]));
       }
     }
-    outSS.values.push_back(sqrt(2.0 * sTerm));
+    outSS.at<0>(loopA) = sqrt(2.0 * sTerm);
   }
-  // Add output quantities
-  outputs.push_back(outSS);
 
   // LOOP ON CELLS
   elCount = 0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Only Cells with significant Concentration
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
+    if(fluidMask.isFluid(loopA)){
 
       // Eva Spatial Derivatives
-      evalSpaceDerivs(loopA, threshold, firstDerivs, secondDerivs);
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
 
       // Eval the Convective term for the current Cell
       temp.clear();
@@ -1741,7 +1524,7 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
         currValueAdvection = 0.0;
         if(PPE_IncludeAdvectionTerm){
           for(int loopC=0;loopC<kNumberOfDimensions;loopC++){
-            currValueAdvection += cells[loopA].velocity[loopC] * firstDerivs[loopC][loopB];
+            currValueAdvection += cells.velocity(loopC)[loopA] * firstDerivs[loopC][loopB];
           }
         }
 
@@ -1755,7 +1538,7 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
 
         // Add Acceleration term if required
         if(PPE_IncludeAccelerationTerm){
-          currValueAccel = timeDerivs[loopA][loopB];
+          currValueAccel = timeDerivs.get(loopA,loopB);
         }else{
           currValueAccel = 0.0;
         }
@@ -1810,43 +1593,18 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
 
   // =====================
   // ADD THE RESULT VECTOR
-  // ======================
-  mriOutput outF("PressureGradient",3);
+  // =====================
+  mriVectorView outF = outputs.addVector("PressureGradient",topology->totalCells);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Loop on the dimensions
     for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
       // Assign To cell
-      outF.values.push_back(termSum[loopA][loopB]);
+      outF(loopA,loopB) = termSum[loopA][loopB];
     }
   }
-  // Add output quantities
-  outputs.push_back(outF);
 
-  // ===================
-  // FIND FACES ON WALLS
-  // ===================
-  mriIntVec faceCount(topology->faceConnections.size());
-  for(int loopA=0;loopA<topology->faceConnections.size();loopA++){
-    faceCount[loopA] = 0;
-  }
-  mriBoolVec isFaceOnWalls(topology->faceConnections.size());
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Only Cells with Reasonable Concentration
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      for(int loopB=0;loopB<topology->cellFaces[loopA].size();loopB++){
-        faceCount[topology->cellFaces[loopA][loopB]]++;
-      }
-    }
-  }
-  for(int loopA=0;loopA<topology->faceConnections.size();loopA++){
-    if(faceCount[loopA] == 1){
-      isFaceOnWalls[loopA] = true;
-    }else{
-      isFaceOnWalls[loopA] = false;
-    }
-  }
-  faceCount.clear();
+  // Faces on the walls of the fluid region
+  const mriBoolVec& isFaceOnWalls = mesh->isFaceOnWalls;
 
   // Convert Cell Vector to Face Vector
   mriDoubleVec poissonSourceFaceVec;
@@ -1871,8 +1629,7 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
     // Evaluate current cell volume
     currVol = evalCellVolume(loopA);    
     // Add Source Term
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
+    if(fluidMask.isFluid(loopA)){
       SourceSum += cellDivs[loopA];
       totalVolume += currVol;
       if(currVol > maxVolume){
@@ -1891,20 +1648,17 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
   printf("Total Fluid Volume: %f\n",totalVolume);
   printf("Source term summation: %f\n",SourceSum);
 
-  // SAVE ELEMENT SOURCES TO FILE
-  elCount = 0;
+  // ELEMENT SOURCES IN MESH ORDER
+  mriDoubleVec elementSources(elCount);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      fprintf(outFile,"ELSOURCE %d %19.12e\n",elCount+1,sourcesToApply[loopA]);
-      elCount++;
+    if(elUsageMap[loopA] > -1){
+      elementSources[elUsageMap[loopA]] = sourcesToApply[loopA];
     }
   }
 
   // ============================
   // CHECK THE DIVERGENCE THEOREM
   // ============================
-  int currCell = 0;
   double divSource = 0.0;
   double divNeu = 0.0;
   double sign = 0.0;
@@ -1912,17 +1666,15 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
     // Evaluate current cell volume
     currVol = evalCellVolume(loopA);
     // Sum Source Contribution
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
+    if(fluidMask.isFluid(loopA)){
       divSource += cellDivs[loopA];
     }
   }
   mriDoubleVec extNormal(3,0.0);
   int currFace = 0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      for(int loopB=0;loopB<topology->cellFaces[loopA].size();loopB++){
+    if(fluidMask.isFluid(loopA)){
+      for(size_t loopB=0;loopB<topology->cellFaces[loopA].size();loopB++){
         currFace = topology->cellFaces[loopA][loopB];
         if(isFaceOnWalls[currFace]){
           topology->getExternalFaceNormal(loopA,loopB,extNormal);
@@ -1944,46 +1696,34 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
   // =====================
   // SAVE NEUMANN BOUNDARY
   // =====================
-  // Loop on the free faces
-  for(int loopA=0;loopA<topology->faceCells.size();loopA++){    
-
-    // Check if the face is on the wall
-    //if(faceCells[loopA].size() == 1){
-    if(isFaceOnWalls[loopA]){
-
-      // Get Current element
-      if(topology->faceCells[loopA].size() == 1){
-        currCell = topology->faceCells[loopA][0];
-      }else{
-        qty = cells[topology->faceCells[loopA][0]].getQuantity(threshold->thresholdQty);
-        if(!threshold->meetsCriteria(qty)){
-          currCell = topology->faceCells[loopA][0];
-        }else{
-          currCell = topology->faceCells[loopA][1];
-        }
-      }
+  mriDoubleVec wallFluxes(mesh->wallFaces.size());
+  for(size_t loopA=0;loopA<mesh->wallFaces.size();loopA++){
+    wallFluxes[loopA] = - poissonSourceFaceVec[mesh->wallFaces[loopA]];
+  }
 
-      // Only Cells with significant concentration
-      qty = cells[currCell].getQuantity(threshold->thresholdQty);
-      if(!threshold->meetsCriteria(qty)){
-        // Print Neumann Condition
-        fprintf(outFile,"FACENEUMANN %d ",elUsageMap[currCell] + 1);
-        for(int loopB=0;loopB<topology->faceConnections[loopA].size();loopB++){
-          fprintf(outFile,"%d ",nodeUsageMap[topology->faceConnections[loopA][loopB]] + 1);
-        }
-        fprintf(outFile,"%19.12e\n", - poissonSourceFaceVec[loopA]);
-      }else{
-        printf("PROBLEM!\n");
+  if(exportFormat == kFEExportBinary){
+    writeFEFieldFile(inputFileName,kFEProblemPPE,mesh->meshFileName,elementSources,wallFluxes,asyncWriter);
+  }else{
+    // Lines are written by the writer thread in chunks
+    mriAsyncTextFile outFile(inputFileName,asyncWriter);
+    outFile.print("NODEDOF %d\n",1);
+    outFile.print("PROBLEM PPE\n");
+    outFile.write(mesh->getMeshText());
+    for(int loopA=0;loopA<elCount;loopA++){
+      outFile.print("ELSOURCE %d %19.12e\n",loopA+1,elementSources[loopA]);
+    }
+    for(size_t loopA=0;loopA<mesh->wallFaces.size();loopA++){
+      outFile.print("FACENEUMANN %d ",elUsageMap[mesh->wallFaceCells[loopA]] + 1);
+      const mriIntVec& faceNodes = topology->faceConnections[mesh->wallFaces[loopA]];
+      for(size_t loopB=0;loopB<faceNodes.size();loopB++){
+        outFile.print("%d ",mesh->nodeUsageMap[faceNodes[loopB]] + 1);
       }
+      outFile.print("%19.12e\n",wallFluxes[loopA]);
     }
+    // Close Output file
+    outFile.close();
   }
 
-  // Close Output file
-  fclose(outFile);
-
-  // Free Memory
-  isFaceOnWalls.clear();
-
   printf("Poisson Solver File Exported.\n");
   printf("\n");
 }
@@ -1993,8 +1733,9 @@ void mriScan::exportForPoisson(string inputFileName,double density,double viscos
 // ==========================
 void mriScan::cellToFace(bool deleteWalls, mriThresholdCriteria* thresholdCriteria,
                                    mriDoubleMat cellVec, mriDoubleVec &faceVec){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(thresholdCriteria);
   bool   continueToProcess = false;
-  double currentValue = 0.0;
   double faceComponent = 0.0;
   int    currentFace = 0;
   double currFaceArea = 0.0;
@@ -2017,8 +1758,7 @@ void mriScan::cellToFace(bool deleteWalls, mriThresholdCriteria* thresholdCriter
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Check for BC
     if(deleteWalls){
-      currentValue = cells[loopA].getQuantity(thresholdCriteria->thresholdQty);
-      continueToProcess = !(thresholdCriteria->meetsCriteria(currentValue));
+      continueToProcess = fluidMask.isFluid(loopA);
     }else{
       continueToProcess = true;
     }
@@ -2063,6 +1803,8 @@ void mriScan::cellToFace(bool deleteWalls, mriThresholdCriteria* thresholdCriter
 // ====================================================================
 void mriScan::cellToFacePartial(mriIntVec elUsageMap, mriThresholdCriteria* threshold,
                                           mriDoubleMat cellVec, mriDoubleVec &faceVec){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(threshold);
   double faceComponent = 0.0;
   int    currentFace = 0;
   double currFaceArea = 0.0;
@@ -2082,11 +1824,9 @@ void mriScan::cellToFacePartial(mriIntVec elUsageMap, mriThresholdCriteria* thre
   }
 
   // Loop To Assemble Residual Vector
-  double qty = 0.0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Check for BC
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
+    if(fluidMask.isFluid(loopA)){
       // Loop On Faces
       for(int loopB=0;loopB<k3DNeighbors;loopB++){
         // Get Current Face
@@ -2183,61 +1923,43 @@ void mriScan::distributeScanData(mriCommunicator* comm){
   comm->passStdIntMatrix(topology->edgeFaces);
 }
 
-// =========================================
-// CHECK IF THE CELL HAS UNTAGGED NEIGHBOURS
-// =========================================
-bool mriScan::hasUntaggedNeighbours(int cell,int* cellTags, bool* isTaggable){
-  bool result = false;
-  int currentFace = 0;
-  int nextCell = 0;
-  for(int loopA=0;loopA<topology->cellFaces[cell].size();loopA++){
-    currentFace = topology->cellFaces[cell][loopA];
-    for(int loopB=0;loopB<topology->faceCells[currentFace].size();loopB++){
-      nextCell = topology->faceCells[currentFace][loopB];
-      result = result || ((isTaggable[nextCell]) && (cellTags[nextCell] == -1));
-    }
-  }
-  // Return the check
-  return result;
-}
-
-// ==========================
-// TAG CELLS USING NEIGHBOURS
-// ==========================
-void mriScan::tagByNeighbour(int tag,int* cellTags, bool* isTaggable,int startingCell){
-  // Set Starting Cell
-  int currentCell = startingCell;
-  cellTags[currentCell] = tag;
-  mriIntVec cellList;
-  int currentFace = 0;
-  int nextCell = 0;
-
-  bool finished = false;
-  while(!finished){
-    // Explore Cell by Neighbourhood
-    for(int loopA=0;loopA<topology->cellFaces[currentCell].size();loopA++){
-      currentFace = topology->cellFaces[currentCell][loopA];
-      // Tag Faces
-      for(int loopB=0;loopB<topology->faceCells[currentFace].size();loopB++){
-        nextCell = topology->faceCells[currentFace][loopB];
-        if((isTaggable[nextCell]) && (nextCell != currentCell) && (cellTags[nextCell] == -1) ){
-          cellTags[nextCell] = tag;
-          if(hasUntaggedNeighbours(nextCell,cellTags,isTaggable)){
-            cellList.insert(cellList.begin(),nextCell);
+// ===================================
+// TAG THE CONNECTED REGIONS OF A SCAN
+// ===================================
+// Cells are tagged with the region number, -1 outside the selected cells:
+// kRegionFluid, all fluid cells
+// kRegionBoundary, fluid cells with a face not shared with another fluid cell
+// kRegionVortexCore, fluid cells with positive Q criterion
+int mriScan::tagRegions(mriThresholdCriteria* threshold, int regionType){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(threshold);
+  int totCells = topology->totalCells;
+  vector<unsigned char> isTaggable(totCells,0);
+  if(regionType == kRegionFluid){
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      for(int loopA=begin;loopA<end;loopA++){
+        isTaggable[loopA] = fluidMask.isFluid(loopA);
+      }
+    });
+  }else if(regionType == kRegionBoundary){
+    mriParallel::parallelFor(totCells,[&](int /*thread*/,int begin,int end){
+      for(int loopA=begin;loopA<end;loopA++){
+        if(fluidMask.isFluid(loopA)){
+          for(int loopB=0;loopB<k3DNeighbors;loopB++){
+            if(!fluidMask.hasNeighbour(loopA,loopB)){
+              isTaggable[loopA] = 1;
+            }
           }
         }
       }
-    }
-    // Update Current Cell
-    if(cellList.size() == 0){
-      finished = true;
-    }else{
-      // Get Cell From the tops
-      currentCell = cellList[0];
-      // Delete First Element
-      cellList.erase (cellList.begin());
-    }
+    });
+  }else if(regionType == kRegionVortexCore){
+    evalVortexCoreCells(threshold,isTaggable);
+  }else{
+    throw mriException("ERROR: Invalid region type in tagRegions.\n");
   }
+  int totals[3] = {topology->cellTotals[0],topology->cellTotals[1],topology->cellTotals[2]};
+  return mriLabeling::labelRegions(totals,isTaggable.data(),cellTags);
 }
 
 // ================================
@@ -2253,11 +1975,12 @@ void mriScan::interpolateBoundaryVelocities(mriThresholdCriteria* threshold){
 void mriScan::projectCellVelocity(int cell,double* normal){
   double normComponent = 0.0;
   for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
-    normComponent += normal[loopA] * cells[cell].velocity[loopA];
+    normComponent += normal[loopA] * cells.velocity(loopA)[cell];
   }
-  cells[cell].velocity[0] = normal[0] * normComponent;
-  cells[cell].velocity[1] = normal[1] * normComponent;
-  cells[cell].velocity[2] = normal[2] * normComponent;
+  cells.vx[cell] = normal[0] * normComponent;
+  cells.vy[cell] = normal[1] * normComponent;
+  cells.vz[cell] = normal[2] * normComponent;
+  cells.markModified();
 }
 
 // ==========================
@@ -2290,16 +2013,16 @@ int mriScan::getOppositeCell(int cell, double* normal){
 // CLEAN VELOCITY COMPONENTS ON BOUNDARY
 // =====================================
 void mriScan::cleanNormalComponentOnBoundary(mriThresholdCriteria* threshold){
+  // Cached fluid mask
+  const mriFluidMask& fluidMask = getFluidMask(threshold);
   double currFaceNormal[3] = {0.0};
   int currCell = 0;
   int otherCell = 0;
-  double qty = 0.0;
   for(int loopA=0;loopA<topology->faceConnections.size();loopA++){
     if(topology->faceCells[loopA].size() == 1){
       //
       currCell = topology->faceCells[loopA][0];
-      qty = cells[currCell].getQuantity(threshold->thresholdQty);
-      if(!threshold->meetsCriteria(qty)){
+      if(fluidMask.isFluid(currCell)){
         // Get Normal
         currFaceNormal[0] = topology->faceNormal[loopA][0];
         currFaceNormal[1] = topology->faceNormal[loopA][1];
@@ -2321,227 +2044,87 @@ void mriScan::cleanNormalComponentOnBoundary(mriThresholdCriteria* threshold){
 // ==================================================================
 // EXPORT TO POISSON SOLVER ONLY ELEMENTS WITH POSITIVE CONCENTRATION
 // ==================================================================
-void mriScan::exportForDistancing(string inputFileName,mriThresholdCriteria* threshold){
-
-  // Declare
-  FILE* outFile;
-  outFile = fopen(inputFileName.c_str(),"w");
-  int totAuxNodes = topology->getTotalAuxNodes();
-  double qty = 0.0;
-
-  // WRITE THE NUMBER OF DOFs FOR THIS PROBLEM
-  fprintf(outFile,"NODEDOF %d\n",1);
-  fprintf(outFile,"PROBLEM DISTANCE\n");
-
-  // Get the mappings for nodes that need to be used
-  mriIntVec nodeUsageMap;
-  mriIntVec elUsageMap;
-  for(int loopA=0;loopA<totAuxNodes;loopA++){
-    nodeUsageMap.push_back(-1);
-  }
-
-  // Mark Used Nodes
-  int currAuxNode = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      for(int loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
-        currAuxNode = topology->cellConnections[loopA][loopB];
-        nodeUsageMap[currAuxNode] = 1;
-      }
-    }
-  }
-
-  // Renumber Nodes in nodeUsageMap
-  int usedNodeCount = 0;
-  for(int loopA=0;loopA<totAuxNodes;loopA++){
-    if(nodeUsageMap[loopA] > 0){
-      nodeUsageMap[loopA] = usedNodeCount;
-      usedNodeCount++;
-    }
-  }
-
-  // Build Element Mapping
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    elUsageMap.push_back(-1);
-  }
-  int elCount = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      elUsageMap[loopA] = elCount;
-      elCount++;
-    }
-  }
-
-  // ==================
-  // SAVE MESH TOPOLOGY
-  // ==================
-  // SAVE NODE COORDS ONLY FOR NODES NUMBERED IN USEDNODEMAP
-  if(topology->totalCells > 0){
-    double pos[3];
-    for(int loopA=0;loopA<totAuxNodes;loopA++){
-      if(nodeUsageMap[loopA] > -1){
-        pos[0] = topology->auxNodesCoords[loopA][0];
-        pos[1] = topology->auxNodesCoords[loopA][1];
-        pos[2] = topology->auxNodesCoords[loopA][2];
-        fprintf(outFile,"NODE %d %19.12e %19.12e %19.12e\n",nodeUsageMap[loopA]+1,pos[0],pos[1],pos[2]);
-      }
-    }
+void mriScan::exportForDistancing(string inputFileName,mriThresholdCriteria* /*threshold*/, mriFEMesh* mesh, int exportFormat, mriAsyncWriter* asyncWriter){
+  // Mesh renumbering shared by the scans with the same fluid cells
+  const mriIntVec& elUsageMap = mesh->elUsageMap;
 
-    // ========================
-    // SAVE ELEMENT CONNECTIONS
-    // ========================
-    elCount = 0;
-    for(int loopA=0;loopA<topology->totalCells;loopA++){
-      qty = cells[loopA].getQuantity(threshold->thresholdQty);
-      if(!threshold->meetsCriteria(qty)){
-        fprintf(outFile,"ELEMENT HEXA8 %d 1 ",elCount+1);
-        elCount++;
-        for(int loopB=0;loopB<topology->cellConnections[loopA].size();loopB++){
-          fprintf(outFile,"%d ",nodeUsageMap[topology->cellConnections[loopA][loopB]] + 1);
-        }
-        fprintf(outFile,"\n");
-      }
-    }
-  }
-
-  // ===================
-  // FIND FACES ON WALLS
-  // ===================
-  int* faceCount = new int[topology->faceConnections.size()];
-  for(int loopA=0;loopA<topology->faceConnections.size();loopA++){
-    faceCount[loopA] = 0;
-  }
-  mriBoolVec isFaceOnWalls(topology->faceConnections.size());
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Only Cells with Reasonable Concentration
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      for(int loopB=0;loopB<topology->cellFaces[loopA].size();loopB++){
-        faceCount[topology->cellFaces[loopA][loopB]]++;
-      }
-    }
-  }
-  for(int loopA=0;loopA<topology->faceConnections.size();loopA++){
-    if(faceCount[loopA] == 1){
-      isFaceOnWalls[loopA] = true;
-    }else{
-      isFaceOnWalls[loopA] = false;
+  // ==========================================
+  // SAVE DIRICHELET CONDITIONS ON THE BOUNDARY
+  // ==========================================
+  // Nodes of the faces on the walls
+  mriIntVec diricheletNodes(mesh->totalNodes,0);
+  for(size_t loopA=0;loopA<mesh->wallFaces.size();loopA++){
+    const mriIntVec& faceNodes = topology->faceConnections[mesh->wallFaces[loopA]];
+    for(size_t loopB=0;loopB<faceNodes.size();loopB++){
+      diricheletNodes[mesh->nodeUsageMap[faceNodes[loopB]]]++;
     }
   }
-  delete [] faceCount;
 
-  // ========================
-  // SAVE ELEMENT DIFFUSIVITY
-  // ========================
-  elCount = 0;
+  // ELEMENT SOURCES IN MESH ORDER
+  mriDoubleVec elementSources(mesh->totalElements);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      fprintf(outFile,"ELDIFF %d ",elCount+1);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"%e ",1.0);
-      fprintf(outFile,"\n");
-      elCount++;
+    if(elUsageMap[loopA] > -1){
+      elementSources[elUsageMap[loopA]] = 1.0/evalCellVolume(loopA);
     }
   }
 
-  // ==========================================
-  // SAVE DIRICHELET CONDITIONS ON THE BOUNDARY
-  // ==========================================
-  mriIntVec diricheletNodes;
-  diricheletNodes.resize(topology->totalCells);
-  long int currCell = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    diricheletNodes[loopA] = 0;
-  }
-  for(int loopA=0;loopA<topology->faceCells.size();loopA++){
-
-    // Check if the face is on the wall
-    if(isFaceOnWalls[loopA]){
-
-      // Get Current element
-      if (topology->faceCells[loopA].size() == 1){
-        currCell = topology->faceCells[loopA][0];
-      }else{
-        qty = cells[topology->faceCells[loopA][0]].getQuantity(threshold->thresholdQty);
-        if(!threshold->meetsCriteria(qty)){
-          currCell = topology->faceCells[loopA][0];
-        }else{
-          currCell = topology->faceCells[loopA][1];
-        }
-      }
-
-      // Only Cells with significant concentration
-      qty = cells[currCell].getQuantity(threshold->thresholdQty);
-      if(!threshold->meetsCriteria(qty)){
-        // Loop through the Nodes
-        for(int loopB=0;loopB<topology->faceConnections[loopA].size();loopB++){
-          diricheletNodes[nodeUsageMap[topology->faceConnections[loopA][loopB]]]++;
-        }
-      }else{
-        printf("PROBLEM!\n");
+  if(exportFormat == kFEExportBinary){
+    // Dirichelet nodes are the nodes of the wall faces in the mesh file
+    writeFEFieldFile(inputFileName,kFEProblemDistance,mesh->meshFileName,elementSources,mriDoubleVec(),asyncWriter);
+  }else{
+    // Lines are written by the writer thread in chunks
+    mriAsyncTextFile outFile(inputFileName,asyncWriter);
+    // WRITE THE NUMBER OF DOFs FOR THIS PROBLEM
+    outFile.print("NODEDOF %d\n",1);
+    outFile.print("PROBLEM DISTANCE\n");
+    outFile.write(mesh->getMeshText());
+    // WRITE DIRICHELET BOUNDARY CONDITIONS
+    for(int loopA=0;loopA<mesh->totalNodes;loopA++){
+      if(diricheletNodes[loopA] > 0){
+        outFile.print("NODEDIRBC %d %19.12e\n",loopA+1,0.0e0);
       }
     }
-  }
-
-  // WRITE DIRICHELET BOUNDARY CONDITIONS
-  elCount = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    if(diricheletNodes[loopA] > 0){
-      fprintf(outFile,"NODEDIRBC %d %19.12e\n",loopA+1,0.0e0);
+    // SAVE ELEMENT SOURCES TO FILE
+    for(int loopA=0;loopA<mesh->totalElements;loopA++){
+      outFile.print("ELSOURCE %d %19.12e\n",loopA+1,elementSources[loopA]);
     }
+    // Close Output file
+    outFile.close();
   }
 
-  // COMPUTE SOURCE TERMS TO APPLY
-  mriDoubleVec sourcesToApply;
-  double currVol = 0.0;
+  printf("\n");
+  printf("Distancing Solver File Exported.\n");
+}
 
-  // APPLY SOURCES
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Evaluate current cell volume
-    currVol = evalCellVolume(loopA);
-    // Add Source Term
-    sourcesToApply.push_back(1.0/currVol);
+// ======================================
+// GET FLUID MASK, REBUILD WHEN OUT OF DATE
+// ======================================
+const mriFluidMask& mriScan::getFluidMask(mriThresholdCriteria* threshold){
+  if(!fluidMask.isCurrent(cells,topology,threshold)){
+    fluidMask.build(cells,topology,threshold);
   }
+  return fluidMask;
+}
 
-  // SAVE ELEMENT SOURCES TO FILE
-  elCount = 0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    qty = cells[loopA].getQuantity(threshold->thresholdQty);
-    if(!threshold->meetsCriteria(qty)){
-      fprintf(outFile,"ELSOURCE %d %19.12e\n",elCount+1,sourcesToApply[loopA]);
-      elCount++;
-    }
+// ========================================================
+// GET VELOCITY DERIVATIVES, REBUILD WHEN OUT OF DATE
+// ========================================================
+const mriVelocityDerivs& mriScan::getVelocityDerivs(mriThresholdCriteria* threshold){
+  const mriFluidMask& mask = getFluidMask(threshold);
+  if(!velocityDerivs.isCurrent(cells,topology,mask)){
+    velocityDerivs.build(cells,topology,mask);
   }
-  
-  // Close Output file
-  fclose(outFile);
-
-  printf("\n");
-  printf("Distancing Solver File Exported.\n");
+  return velocityDerivs;
 }
 
 // =================================
 // UPDATE VELOCITIES FROM AUX VECTOR
 // =================================
 void mriScan::updateVelocities(){
-  maxVelModule = 0.0;
-  double currentNorm = 0.0;
   // Update Velocities
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Assign Filtered Vectors
-    cells[loopA].velocity[0] = cells[loopA].auxVector[0];
-    cells[loopA].velocity[1] = cells[loopA].auxVector[1];
-    cells[loopA].velocity[2] = cells[loopA].auxVector[2];
-    // Get New Norm
-    currentNorm = mriUtils::do3DEucNorm(cells[loopA].auxVector);
-    if(currentNorm > maxVelModule){
-      maxVelModule = currentNorm;
-    }
-  }
+  cells.copyAuxToVelocity();
+  // Get New Norm
+  maxVelModule = cells.getMaxVelocityModule();
 }
 
 void mriScan::testScanAdjacency(string fileName){
@@ -2587,18 +2170,16 @@ void mriScan::testScanAdjacency(string fileName){
 // SAVE QUANTITIES TO OUTPUTS
 // ==========================
 void mriScan::saveVelocity(){
-  mriOutput out1("Original_Velocity",3);
+  mriVectorView out1 = outputs.addVector("Original_Velocity",topology->totalCells);
   double totalVel = 0.0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    out1.values.push_back(cells[loopA].velocity[0]);
-    out1.values.push_back(cells[loopA].velocity[1]);
-    out1.values.push_back(cells[loopA].velocity[2]);
-    totalVel += (cells[loopA].velocity[0]*cells[loopA].velocity[0] +
-                 cells[loopA].velocity[1]*cells[loopA].velocity[1] +
-                 cells[loopA].velocity[2]*cells[loopA].velocity[2]);
-  }
-  // Add output quantities
-  outputs.push_back(out1);
+    out1.at<0>(loopA) = cells.vx[loopA];
+    out1.at<1>(loopA) = cells.vy[loopA];
+    out1.at<2>(loopA) = cells.vz[loopA];
+    totalVel += (cells.vx[loopA]*cells.vx[loopA] +
+                 cells.vy[loopA]*cells.vy[loopA] +
+                 cells.vz[loopA]*cells.vz[loopA]);
+  }
   printf("Velocity Energy: %e\n",totalVel);
 }
 
@@ -2618,76 +2199,16 @@ void mriScan::evalCellAreas(int cellNumber, mriDoubleVec& Areas){
   Areas[2] = EdgeX * EdgeY;
 }
 
-// FORM BIN LIMITS FOR SINGLE SCAN
-void mriScan::formBinLimits(int pdfQuantity, double& currInterval, const mriDoubleVec& limitBox, int numberOfBins, mriDoubleVec& binMin, mriDoubleVec& binMax, mriDoubleVec& binCenter){
-    // Initialize Limits
-  double  minRange = std::numeric_limits<double>::max();
-  double  maxRange = -std::numeric_limits<double>::max();
-  mriDoubleVec cellCoord(3);
-  double  otherQuantity = 0.0;
-  double  refQuantity = 0.0;
-  double  currValue = 0.0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Get Cell Coords
-    cellCoord[0] = topology->cellLocations[loopA][0];
-    cellCoord[1] = topology->cellLocations[loopA][1];
-    cellCoord[2] = topology->cellLocations[loopA][2];
-    // Get quantity
-    currValue = cells[loopA].getQuantity(pdfQuantity);
-    // Check If Within the Bin 
-    if (mriUtils::isPointInsideBox(cellCoord[0],cellCoord[1],cellCoord[2],limitBox)){
-      // Assign Values
-      if(currValue>maxRange) maxRange = currValue;
-      if(currValue<minRange) minRange = currValue;
-    }
-  }
-  // If minRange and maxRange are the same than add something
-  if (fabs(maxRange - minRange)<kMathZero){
-    minRange = minRange - 1.0;
-    maxRange = maxRange + 1.0;
-  }
-  // Fill the bin arrays
-  double currPtr = minRange;
-  currInterval = ((maxRange - minRange)/(double)numberOfBins);
-  for(int loopA=0;loopA<numberOfBins;loopA++){
-    binMin[loopA] = currPtr;
-    binMax[loopA] = currPtr + currInterval;
-    binCenter[loopA] = 0.5*(binMin[loopA] + binMax[loopA]);
-    // Update
-    currPtr += currInterval;
-  }
-}
-
 // Eval The PDF of a Single Scan
 void mriScan::evalScanPDF(int pdfQuantity, int numberOfBins, bool useBox, mriDoubleVec& limitBox,mriDoubleVec& binCenter, mriDoubleVec& binArray){
-  // Allocate Quantities
-  mriDoubleVec binMin(numberOfBins);
-  mriDoubleVec binMax(numberOfBins);
-  // Form Bin 
-  double currInterval = 0.0;
-  formBinLimits(pdfQuantity,currInterval,limitBox,numberOfBins,binMin,binMax,binCenter);
-  // Initialize binArray
-  for(int loopA=0;loopA<numberOfBins;loopA++){
-    binArray[loopA] = 0.0;
-  }
-  // Loop through the points
-  mriDoubleVec cellCoord(3);
-  double currValue = 0.0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Get Cell Coords
-    cellCoord[0] = topology->cellLocations[loopA][0];
-    cellCoord[1] = topology->cellLocations[loopA][1];
-    cellCoord[2] = topology->cellLocations[loopA][2];
-    // Get quantity
-    currValue = cells[loopA].getQuantity(pdfQuantity);
-    // Assign Value to Bin
-    if (mriUtils::isPointInsideBox(cellCoord[0],cellCoord[1],cellCoord[2],limitBox)&&fabs(currValue)>1.2e-2){
-      // COMPLETE
-      mriUtils::assignToBin(currValue,numberOfBins,binMin,binMax,binArray);
-    }
-  }
+  mriHistogramSet histoSet;
+  histoSet.addHistogram(&cells,NULL,pdfQuantity,numberOfBins,kPDFMinAbsValue);
+  histoSet.evaluate(topology,useBox ? &limitBox : NULL,NULL);
   // Normalize
-  mriUtils::normalizeBinArray(binArray,currInterval);
+  mriHistogram& histo = histoSet.histograms[0];
+  histo.normalize();
+  binCenter = histo.binCenters;
+  binArray = histo.binValues;
 }
 
 // =========================
@@ -2695,8 +2216,11 @@ void mriScan::evalScanPDF(int pdfQuantity, int numberOfBins, bool useBox, mriDou
 // =========================
 void mriScan::computeQuantityGradient(int qtyID){
   mriDoubleVec gradient(3);
+  mriVectorView qtyGradient = outputs.addVector("QuantityGradient",topology->totalCells);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     evalSpaceGradient(loopA,qtyID,gradient);
-    qtyGradient.push_back(gradient);
+    qtyGradient.at<0>(loopA) = gradient[0];
+    qtyGradient.at<1>(loopA) = gradient[1];
+    qtyGradient.at<2>(loopA) = gradient[2];
   }
 }
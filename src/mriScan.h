@@ -14,12 +14,26 @@
 # include "mriCell.h"
 # include "mriTypes.h"
 # include "mriExpansion.h"
+# include "mriExpansionFile.h"
+# include "mriFEMesh.h"
 # include "mriThresholdCriteria.h"
 # include "mriImagedata.h"
 # include "mriConstants.h"
 # include "mriException.h"
 # include "mriSamplingOptions.h"
-# include "mriOutput.h"
+# include "mriField.h"
+# include "mriFluidMask.h"
+# include "mriDerivatives.h"
+# include "mriParallel.h"
+# include "mriLabeling.h"
+# include "mriHistogram.h"
+# include "mriVTKReader.h"
+# include "mriPLTReader.h"
+# include "mriVTKWriter.h"
+# include "mriVTKXMLWriter.h"
+# include "mriTecplotWriter.h"
+# include "mriFieldSnapshot.h"
+# include "mriAsyncWriter.h"
 # include "mriTopology.h"
 # include "mriIO.h"
 
@@ -39,15 +53,19 @@ class mriScan{
     // ============
 
     // Cell Data
-    vector<mriCell> cells;
+    mriCellData cells;
     mriIntVec       cellTags;
     
-    // Output Quantities
-    vector<mriOutput> outputs;
+    // Cached Fluid Mask (use getFluidMask)
+    mriFluidMask fluidMask;
+
+    // Cached Velocity Derivatives (use getVelocityDerivs)
+    mriVelocityDerivs velocityDerivs;
+
+    // Output Quantities (derived fields, including ReynoldsStress and QuantityGradient)
+    mriFieldRegistry outputs;
     
     // Utility Functions
-    mriDoubleMat reynoldsStress;
-    mriDoubleMat qtyGradient;
     double scanTime;
     double maxVelModule;
     
@@ -77,8 +95,8 @@ class mriScan{
     // ==============
     // READ FUNCTIONS
     // ==============
-    void readFromVTK_ASCII(string vtkFileName, const vtkStructuredPointsOptionRecord& vtkOptions);
-    void readFromPLT_ASCII(std::string PltFileName, const pltOptionRecord& pltOptions);
+    void readFromVTK(const mriVTKReader& reader);
+    void readFromPLT(const mriPLTReader& reader);
     void readFromExpansionFile(std::string fileName,bool applyThreshold,int thresholdType,double thresholdValue);
 
     // ==================
@@ -91,6 +109,7 @@ class mriScan{
     // WRITE FUNCTIONS
     // ===============
     void fillPLTHeader(std::vector<std::string> &pltHeader, bool isFirstFile);
+    void getPLTVariableNames(mriStringVec& varNames);
     void exportToLSDYNA(std::string LSFileName, double scale);
     void exportToCSV(std::string FileName);
     void exportNodesToFile(std::string FileName);
@@ -98,14 +117,23 @@ class mriScan{
     void exportVelocitiesToFile(std::string fileName, bool append);
     // VIRTUAL
     void exportToVOL(std::string FileName);
-    void exportToTECPLOT(std::string FileName, bool isFirstFile);
-    void exportToVTK(std::string fileName, mriThresholdCriteria* threshold);
-    void writeExpansionFile(std::string fileName);
+    // Exports copy what they write and leave the writing to asyncWriter,
+    // or write right away when asyncWriter is NULL
+    void exportToTECPLOT(std::string FileName, bool isFirstFile, mriAsyncWriter* asyncWriter);
+    // Coordinates are written with the first zone only
+    void exportToTECPLOTBinary(mriTecplotWriter* writer, bool isFirstZone, mriAsyncWriter* asyncWriter);
+    void exportToVTK(std::string fileName, mriThresholdCriteria* threshold, bool isBinary, mriAsyncWriter* asyncWriter);
+    void exportToVTKXML(std::string fileName, mriThresholdCriteria* threshold, int compression, mriAsyncWriter* asyncWriter);
+    // Point fields of the VTK exports, W is mriVTKWriter or mriVTKXMLWriter
+    template<typename W> void writeVTKFields(W& writer, mriThresholdCriteria* threshold);
+    void getVTKAxisCoords(mriDoubleMat& axisCoords);
+    void writeExpansionFile(std::string fileName, const mriExpansionFileFormat& format, mriAsyncWriter* asyncWriter);
     // Export to Poisson Solver Only element with significant concentration
-    void exportForDistancing(string inputFileName, mriThresholdCriteria* threshold);
-    void exportForPoisson(string inputFileName,double density,double viscosity,mriThresholdCriteria* threshold, const mriDoubleMat& timeDerivs,
+    void exportForDistancing(string inputFileName, mriThresholdCriteria* threshold, mriFEMesh* mesh, int exportFormat, mriAsyncWriter* asyncWriter);
+    void exportForPoisson(string inputFileName,double density,double viscosity,mriThresholdCriteria* threshold, const mriTimeDerivs& timeDerivs,
                           bool PPE_IncludeAccelerationTerm,bool PPE_IncludeAdvectionTerm,bool PPE_IncludeDiffusionTerm,bool PPE_IncludeReynoldsTerm,
-                          bool readMuTFromFile, string muTFile, double smagorinskyCoeff);
+                          bool readMuTFromFile, string muTFile, double smagorinskyCoeff,
+                          mriFEMesh* mesh, int exportFormat, mriAsyncWriter* asyncWriter);
 
     // ========
     // TOPOLOGY
@@ -228,6 +256,8 @@ class mriScan{
     int  getNextStartingCell(int currentCell, bool* visitedCell, bool* isBoundaryCell, bool &finished, int &bookmark);
     int  evalCentralCell();
     void updateVelocities();
+    const mriFluidMask& getFluidMask(mriThresholdCriteria* threshold);
+    const mriVelocityDerivs& getVelocityDerivs(mriThresholdCriteria* threshold);
 
     // REYNOLDS STRESS COMPUTATION    
     void evalReynoldsStress(mriThresholdCriteria* threshold);
@@ -239,7 +269,13 @@ class mriScan{
     
     // APPLY SMOOTHING FILTER - LAVISION
     void applySmoothingFilter();
+    // Red-black parallel variant with an iteration cap, stores the max divergence of each iteration
+    void applyRedBlackSmoothingFilter(int maxIt,double tolerance,mriDoubleVec& residuals);
     void applyMedianFilter(int qtyID,int maxIt,int order,int filterType,mriThresholdCriteria* threshold);
+    // Mean or Gaussian filter on all velocity components with separable passes
+    void applySeparableFilter(int maxIt,int order,int filterType,mriThresholdCriteria* threshold);
+    // Median filter on all velocity components
+    void applyVelocityMedianFilter(int maxIt,int order,mriThresholdCriteria* threshold);
 
     // THRESHOLD
     void thresholdQuantity(int qtyID,double threshold);
@@ -272,6 +308,7 @@ class mriScan{
     void   evalVorticity(mriThresholdCriteria* threshold);
     void   evalEnstrophy(mriThresholdCriteria* threshold);
     void   evalSMPVortexCriteria(mriExpansion* exp);
+    void   evalVortexCoreCells(mriThresholdCriteria* threshold, vector<unsigned char>& isCore);
 
     // SPATIAL REPRESENTATION OF VORTEX COEFFICIENTS
     double evalVortexCriteria(mriExpansion* exp);
@@ -303,13 +340,13 @@ class mriScan{
    void interpolateBoundaryVelocities(mriThresholdCriteria* threshold);
    void projectCellVelocity(int cell,double* normal);
    int  getOppositeCell(int cell, double* normal);
-   void tagByNeighbour(int tag,int* cellTags, bool* isTaggable,int startingCell);
-   bool hasUntaggedNeighbours(int cell,int* cellTags, bool* isTaggable);
    void setWallFluxesToZero(bool* isFaceOnWalls, mriDoubleVec& poissonSourceFaceVec);
 
+   // REGION TAGGING
+   int tagRegions(mriThresholdCriteria* threshold, int regionType);
+
    // STATISTICS
    void evalScanPDF(int pdfQuantity, int numberOfBins, bool useBox, mriDoubleVec& limitBox,mriDoubleVec& binCenter, mriDoubleVec& binArray);
-   void formBinLimits(int pdfQuantity, double& currInterval, const mriDoubleVec& limitBox, int numberOfBins, mriDoubleVec& binMin, mriDoubleVec& binMax, mriDoubleVec& binCenter);
 
    // PRESSURE
    void evalCellPressureGradients(int currentCell,
@@ -318,6 +355,8 @@ class mriScan{
                                   const mriDoubleMat& secondDerivs,
                                   const mriDoubleMat& ReynoldsStressGrad,
                                   mriDoubleVec& pressureGrad);
+   // Relative pressure from the QuantityGradient field with the native PPE solver
+   void solvePressurePoisson(mriThresholdCriteria* threshold, int maxIt, double tolerance);
 };
 
 #endif // mriSTRUCTUREDSCAN_H
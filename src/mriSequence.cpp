@@ -1,55 +1,8 @@
+# include <memory>
+# include <algorithm>
+# include <sys/stat.h>
 # include "mriSequence.h"
 
-// FORM BIN LIMITS
-void mriSequence::formDifferenceBinLimits(int otherScan, int refScan, 
-                                          int pdfQuantity, double& currInterval,
-                                          const mriDoubleVec& limitBox, 
-                                          int numberOfBins, 
-                                          mriDoubleVec& binMin, 
-                                          mriDoubleVec& binMax, 
-                                          mriDoubleVec& binCenter){
-  // Get The Scans out of the sequence
-  mriScan* scanOther = getScan(otherScan);
-  mriScan* scanRef = getScan(refScan);
-  // Initialize Limits
-  double minRange = std::numeric_limits<double>::max();
-  double maxRange = -std::numeric_limits<double>::max();
-  double* cellCoord = NULL;
-  double otherQuantity = 0.0;
-  double refQuantity = 0.0;
-  double currValue = 0.0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Get quantity
-    otherQuantity = scanOther->cells[loopA].getQuantity(pdfQuantity);
-    refQuantity = scanRef->cells[loopA].getQuantity(pdfQuantity);
-    // Get Value
-    currValue = (otherQuantity - refQuantity);
-    // Check If Within the Bin 
-    if (mriUtils::isPointInsideBox(topology->cellLocations[loopA][0],
-                                   topology->cellLocations[loopA][1],
-                                   topology->cellLocations[loopA][2],limitBox)){
-      // Assign Values
-      if(currValue>maxRange) maxRange = currValue;
-      if(currValue<minRange) minRange = currValue;
-    }
-  }
-  // If minRange and maxRange are the same than add something
-  if (fabs(maxRange - minRange)<kMathZero){
-    minRange = minRange - 1.0;
-    maxRange = maxRange + 1.0;
-  }
-  // Fill the bin arrays
-  currInterval = ((maxRange - minRange)/(double)numberOfBins);
-  double currPtr = minRange;
-  for(int loopA=0;loopA<numberOfBins;loopA++){
-    binMin[loopA] = currPtr;
-    binMax[loopA] = currPtr + currInterval;
-    binCenter[loopA] = 0.5*(binMin[loopA] + binMax[loopA]);
-    // Update
-    currPtr += currInterval;
-  }
-}
-
 // Constructor
 mriSequence::mriSequence(bool cyclic){
   // Set If Cyclic
@@ -91,9 +44,10 @@ mriSequence::mriSequence(mriSequence* copySequence){
       topology->cellLengths[loopA][loopB] = copySequence->topology->cellLengths[loopA][loopB];
     }
   }
+  topology->buildCoordinateTables();
 
   // Fill with Zero Scans
-  for(int loopB=0;loopB<sequence.size();loopB++){
+  for(size_t loopB=0;loopB<sequence.size();loopB++){
     mriScan* newScan = new mriScan(*copySequence->getScan(loopB));
     sequence.push_back(newScan);
   }
@@ -109,8 +63,8 @@ void mriSequence::printSequenceFiles(std::string outFIleName){
 	outFile = fopen(outFIleName.c_str(),"w");
   // Write List
   fprintf(outFile,"List of Files in Sequence\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
-    fprintf(outFile,"File %d: %s\n",loopA+1,fileNames[loopA].c_str());
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    fprintf(outFile,"File %d: %s\n",(int)loopA+1,fileNames[loopA].c_str());
   }
   // Close Output file
 	fclose(outFile);				
@@ -133,9 +87,38 @@ mriScan* mriSequence::getScan(int scanNumber){
 void mriSequence::exportToTECPLOT(std::string outfileName){
   writeSchMessage(std::string("\n"));
   writeSchMessage(std::string("EXPORTING -------------------------------------\n"));
-  for(int loopA=0;loopA<sequence.size();loopA++){
-      sequence[loopA]->exportToTECPLOT(outfileName,(loopA == 0));
+  // Scans are appended in order by the writer thread
+  mriAsyncWriter asyncWriter;
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+      sequence[loopA]->exportToTECPLOT(outfileName,(loopA == 0),&asyncWriter);
   }
+  asyncWriter.wait();
+}
+
+// EXPORT SEQUENCE TO TECPLOT BINARY FILE, ONE ZONE PER SCAN
+void mriSequence::exportToTECPLOTBinary(std::string outfileName){
+  writeSchMessage(std::string("\n"));
+  writeSchMessage(std::string("EXPORTING -------------------------------------\n"));
+  if(sequence.size() == 0){
+    return;
+  }
+  // Variables of the first scan, zones share its coordinates
+  mriStringVec varNames;
+  sequence[0]->getPLTVariableNames(varNames);
+  mriDoubleVec times;
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    times.push_back(sequence[loopA]->scanTime);
+  }
+  mriTecplotWriter writer(outfileName,"smpFilterOutput",varNames,topology->cellTotals,times,kNumberOfDimensions);
+  {
+    // Zones are written in order by the writer thread
+    mriAsyncWriter asyncWriter;
+    for(size_t loopA=0;loopA<sequence.size();loopA++){
+      sequence[loopA]->exportToTECPLOTBinary(&writer,(loopA == 0),&asyncWriter);
+    }
+    asyncWriter.wait();
+  }
+  writer.close();
 }
 
 // EXCTRACT SINGKLE POINT CURVE IN TIME
@@ -155,7 +138,7 @@ void mriSequence::extractSinglePointTimeCurve(int cellNumber, int exportQty, std
   centrePoint[2] = 0.5 * (topology->domainSizeMax[2] + topology->domainSizeMin[2]);
   // Write List
   fprintf(outFile,"List of Files in Sequence\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     // Get Time
     currTime = sequence[loopA]->scanTime;
     // Get Local Coordinates
@@ -165,16 +148,16 @@ void mriSequence::extractSinglePointTimeCurve(int cellNumber, int exportQty, std
     // Check Quantity
     switch(exportQty){
       case kQtyConcentration:
-        currValue = sequence[loopA]->cells[cellNumber].concentration;
+        currValue = sequence[loopA]->cells.conc[cellNumber];
         break;
       case kQtyVelocityX:
-        currValue = sequence[loopA]->cells[cellNumber].velocity[0];
+        currValue = sequence[loopA]->cells.vx[cellNumber];
         break;      
       case kQtyVelocityY:
-        currValue = sequence[loopA]->cells[cellNumber].velocity[1];
+        currValue = sequence[loopA]->cells.vy[cellNumber];
         break;      
       case kQtyVelocityZ:
-        currValue = sequence[loopA]->cells[cellNumber].velocity[2];
+        currValue = sequence[loopA]->cells.vz[cellNumber];
         break;      
     }
     currRad = sqrt(localCoord[1]*localCoord[1]+
@@ -188,30 +171,52 @@ void mriSequence::extractSinglePointTimeCurve(int cellNumber, int exportQty, std
 // Export to Poisson Solver
 void mriSequence::exportForPoisson(string inputFileName,double density,double viscosity,mriThresholdCriteria* threshold,
                                    bool PPE_IncludeAccelerationTerm,bool PPE_IncludeAdvectionTerm,bool PPE_IncludeDiffusionTerm,bool PPE_IncludeReynoldsTerm,
-                                   bool readMuTFromFile, string muTFile, double smagorinskyCoeff){
+                                   bool readMuTFromFile, string muTFile, double smagorinskyCoeff, int exportFormat){
   string name;
-  mriDoubleMat timeDeriv;
+  mriAsyncWriter asyncWriter;
+  mriFEMesh* mesh = NULL;
   // mriDoubleMat reynoldsDeriv;
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     name = inputFileName + "_" + mriUtils::floatToStr(loopA);
     if(PPE_IncludeAccelerationTerm){
-      printf("Computing Time Derivatives for Scan %d...",loopA);
-      evalScanTimeDerivs(loopA,timeDeriv);
+      printf("Computing Time Derivatives for Scan %d...",(int)loopA);
+      evalScanTimeDerivs(loopA);
       printf("Done.\n");
     }
-    sequence[loopA]->exportForPoisson(name,density,viscosity,threshold,timeDeriv,
+    mesh = getFEMesh(loopA,threshold,inputFileName,exportFormat,&asyncWriter);
+    sequence[loopA]->exportForPoisson(name,density,viscosity,threshold,scanTimeDerivs,
                                       PPE_IncludeAccelerationTerm,PPE_IncludeAdvectionTerm,PPE_IncludeDiffusionTerm,PPE_IncludeReynoldsTerm,
-                                      readMuTFromFile,muTFile,smagorinskyCoeff);
+                                      readMuTFromFile,muTFile,smagorinskyCoeff,mesh,exportFormat,&asyncWriter);
   }
+  asyncWriter.wait();
 }
 
 // EXPORT TO WALL DISTANCE SOLVER
-void mriSequence::exportForDistancing(string inputFileName, mriThresholdCriteria* threshold){
+void mriSequence::exportForDistancing(string inputFileName, mriThresholdCriteria* threshold, int exportFormat){
   string name;
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  mriAsyncWriter asyncWriter;
+  mriFEMesh* mesh = NULL;
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     name = inputFileName + "_" + mriUtils::floatToStr(loopA);
-    sequence[loopA]->exportForDistancing(name,threshold);
+    mesh = getFEMesh(loopA,threshold,inputFileName,exportFormat,&asyncWriter);
+    sequence[loopA]->exportForDistancing(name,threshold,mesh,exportFormat,&asyncWriter);
   }
+  asyncWriter.wait();
+}
+
+// GET THE MESH FOR THE SOLVER EXPORTS
+// The mesh is rebuilt only when the fluid cells change, binary exports
+// write it once per export next to their field files
+mriFEMesh* mriSequence::getFEMesh(int scanNumber, mriThresholdCriteria* threshold, string filePrefix, int exportFormat, mriAsyncWriter* asyncWriter){
+  const mriFluidMask& fluidMask = sequence[scanNumber]->getFluidMask(threshold);
+  if((!feMesh)||(!feMesh->isCurrent(topology,fluidMask))){
+    feMesh.reset(new mriFEMesh(topology,fluidMask));
+  }
+  if((exportFormat == kFEExportBinary)&&((feMesh->meshFileName.empty())||(feMesh->meshFilePrefix != filePrefix))){
+    feMesh->writeBinaryMesh(filePrefix + "_mesh_" + mriUtils::floatToStr(scanNumber),asyncWriter);
+    feMesh->meshFilePrefix = filePrefix;
+  }
+  return feMesh.get();
 }
 
 // GET SEQUENCE OUTPUT FILE NAME
@@ -225,12 +230,64 @@ string getSequenceOutputFileName(string outfileName, int loopA){
 }
 
 // EXPORT TO SEQUENCE OF VTK FILES
-void mriSequence::exportToVTK(string outfileName,mriThresholdCriteria* thresholdCriteria){
-  // Export All Data
-  for(int loopA=0;loopA<sequence.size();loopA++){    
+void mriSequence::exportToVTK(string outfileName,mriThresholdCriteria* thresholdCriteria,bool isBinary){
+  // Scan n is written while the fields of scan n+1 are evaluated
+  mriAsyncWriter asyncWriter;
+  for(size_t loopA=0;loopA<sequence.size();loopA++){    
     string outName = getSequenceOutputFileName(outfileName,loopA);
-    sequence[loopA]->exportToVTK(outName,thresholdCriteria);
+    sequence[loopA]->exportToVTK(outName,thresholdCriteria,isBinary,&asyncWriter);
   }
+  asyncWriter.wait();
+}
+
+// EXPORT TO VTK XML FILES AND A PVD TIME SERIES
+void mriSequence::exportToVTKXML(string outfileName,mriThresholdCriteria* thresholdCriteria,int compression){
+  string baseName = outfileName.substr(0,outfileName.find_last_of('.'));
+  mriStringVec dataFiles;
+  mriDoubleVec times;
+  mriAsyncWriter asyncWriter;
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    // Image data unless the spacing is not uniform
+    string ext = sequence[loopA]->hasUniformSpacing() ? ".vti" : ".vtr";
+    string outName = baseName + "_" + to_string(loopA) + ext;
+    sequence[loopA]->exportToVTKXML(outName,thresholdCriteria,compression,&asyncWriter);
+    dataFiles.push_back(outName);
+    times.push_back(sequence[loopA]->scanTime);
+  }
+  asyncWriter.wait();
+  writeVTKCollection(baseName + ".pvd",dataFiles,times);
+}
+
+// EXPORT ALL SCANS TO ONE BINARY SEQUENCE FILE
+void mriSequence::exportToSequenceFile(string outfileName,int compression){
+  writeSchMessage(string("Writing Sequence File: ") + outfileName + string("\n"));
+  mriSequenceFileGrid grid;
+  grid.cellTotals = topology->cellTotals;
+  grid.cellLengths = topology->cellLengths;
+  topology->getAxisCoords(grid.axisCoords);
+  grid.domainSizeMin = topology->domainSizeMin;
+  grid.domainSizeMax = topology->domainSizeMax;
+  mriSequenceFileWriter writer(outfileName,compression,grid);
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    mriScan* scan = sequence[loopA];
+    writer.beginPhase(scan->scanTime);
+    const double* conc = scan->cells.conc.data();
+    writer.writeArray("concentration",1,&conc);
+    const double* velocity[3] = {scan->cells.vx.data(),scan->cells.vy.data(),scan->cells.vz.data()};
+    writer.writeArray("velocity",3,velocity);
+    for(size_t loopB=0;loopB<scan->outputs.size();loopB++){
+      const mriField& field = scan->outputs[loopB];
+      vector<const double*> components(field.totComponents);
+      for(int loopC=0;loopC<field.totComponents;loopC++){
+        components[loopC] = field.component(loopC);
+      }
+      writer.writeArray(field.name,field.totComponents,components.data());
+    }
+    if(scan->cellTags.size() > 0){
+      writer.writeArray("Tags",scan->cellTags.data());
+    }
+  }
+  writer.close();
 }
 
 // PHYSICS FILTERING FOR ALL SCANS
@@ -241,7 +298,7 @@ void mriSequence::applySMPFilter(mriCommunicator* comm, bool isBC,
                                  bool useConstantPatterns){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     // Perform Filter
     sequence[loopA]->applySMPFilter(comm,isBC,thresholdCriteria,itTol,maxIt,useConstantPatterns);
     // Update Velocities
@@ -253,7 +310,7 @@ void mriSequence::applySMPFilter(mriCommunicator* comm, bool isBC,
 void mriSequence::saveVelocity(){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     // Perform Filter
     sequence[loopA]->saveVelocity();
   }
@@ -264,7 +321,7 @@ void mriSequence::saveVelocity(){
 void mriSequence::applyThresholding(mriThresholdCriteria* thresholdCriteria){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->applyThresholding(thresholdCriteria);
   }
 }
@@ -273,7 +330,7 @@ void mriSequence::applyThresholding(mriThresholdCriteria* thresholdCriteria){
 void mriSequence::evalVortexCriteria(mriThresholdCriteria* thresholdCriteria){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->evalVortexCriteria(thresholdCriteria);
   }
 }
@@ -282,7 +339,7 @@ void mriSequence::evalVortexCriteria(mriThresholdCriteria* thresholdCriteria){
 void mriSequence::evalVorticity(mriThresholdCriteria* thresholdCriteria){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->evalVorticity(thresholdCriteria);
   }
 }
@@ -291,7 +348,7 @@ void mriSequence::evalVorticity(mriThresholdCriteria* thresholdCriteria){
 void mriSequence::evalEnstrophy(mriThresholdCriteria* thresholdCriteria){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->evalEnstrophy(thresholdCriteria);
   }
 }
@@ -300,24 +357,26 @@ void mriSequence::evalEnstrophy(mriThresholdCriteria* thresholdCriteria){
 void mriSequence::evalSMPVortexCriteria(){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->evalSMPVortexCriteria(sequence[loopA]->expansion);
   }
 }
 
 // EVAL EXPANSION FILE
-void mriSequence::writeExpansionFile(string fileName){
+void mriSequence::writeExpansionFile(string fileName, const mriExpansionFileFormat& format){
   // Export All Data
   writeSchMessage("\n");
-  for(int loopA=0;loopA<sequence.size();loopA++){
-    sequence[loopA]->writeExpansionFile(fileName);
+  mriAsyncWriter asyncWriter;
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    sequence[loopA]->writeExpansionFile(fileName,format,&asyncWriter);
   }
+  asyncWriter.wait();
 }
 
 // Scale velocities for all Scans
 void mriSequence::scaleVelocities(double factor){
   writeSchMessage(std::string("Scaling Velocities..."));
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->scaleVelocities(factor);
   }
   writeSchMessage(std::string("Done.\n"));
@@ -333,7 +392,7 @@ void mriSequence::scalePositions(const mriDoubleVec& origin, double factor){
 // Add noise to measurements
 void mriSequence::applyNoise(double noiseIntensity, double seed){
   writeSchMessage(std::string("Applying Noise..."));
-  for(int loopA=0;loopA<sequence.size();loopA++){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
     sequence[loopA]->applyGaussianNoise(noiseIntensity, seed);
   }
   writeSchMessage(std::string("Done.\n"));
@@ -344,7 +403,7 @@ void mriSequence::applyNoise(double noiseIntensity, double seed){
 // =============================
 void mriSequence::distributeSequenceData(mriCommunicator* comm){
   // Create New Sequence
-  for(int loopA=0;loopA<this->sequence.size();loopA++){
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
     sequence[loopA]->distributeScanData(comm);
   }
 }
@@ -354,16 +413,79 @@ void mriSequence::distributeSequenceData(mriCommunicator* comm){
 // =============================
 void mriSequence::applyMedianFilter(int qtyID,int maxIt,int order,int filterType,mriThresholdCriteria* threshold){
   // Create New Sequence
-  for(int loopA=0;loopA<this->sequence.size();loopA++){
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
     sequence[loopA]->applyMedianFilter(qtyID,maxIt,order,filterType,threshold);
   }
 }
 
+// ==============================
+// FILTER ALL VELOCITY COMPONENTS
+// ==============================
+void mriSequence::applyVelocityFilter(int maxIt,int order,int filterType,mriThresholdCriteria* threshold){
+  // On a fixed mask the components are filtered independently
+  bool fixedMask = !threshold->dependsOnVelocity();
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
+    if(fixedMask&&((filterType == kMeanFilter)||(filterType == kGaussianFilter))){
+      sequence[loopA]->applySeparableFilter(maxIt,order,filterType,threshold);
+    }else if(fixedMask&&(filterType == kMedianFilter)){
+      sequence[loopA]->applyVelocityMedianFilter(maxIt,order,threshold);
+    }else{
+      // The mask changes with the filtered components, keep the original order
+      sequence[loopA]->applyMedianFilter(kQtyVelocityX,maxIt,order,filterType,threshold);
+      sequence[loopA]->applyMedianFilter(kQtyVelocityY,maxIt,order,filterType,threshold);
+      sequence[loopA]->applyMedianFilter(kQtyVelocityZ,maxIt,order,filterType,threshold);
+    }
+  }
+}
+
+// ====================================================
+// APPLY LAVISION FILTER WITH RED-BLACK PARALLEL SWEEPS
+// ====================================================
+void mriSequence::applyDivergenceSmoothing(int maxIt,double tolerance,string historyFileName){
+  vector<mriDoubleVec> residuals(sequence.size());
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
+    sequence[loopA]->applyRedBlackSmoothingFilter(maxIt,tolerance,residuals[loopA]);
+  }
+  // Write the max divergence of every iteration
+  if(!historyFileName.empty()){
+    FILE* outFile;
+    outFile = fopen(historyFileName.c_str(),"w");
+    if(outFile == NULL){
+      throw mriException("ERROR: Cannot open residual history file.\n");
+    }
+    fprintf(outFile,"%15s %15s %15s\n","Scan","Iteration","Max Div");
+    for(size_t loopA=0;loopA<residuals.size();loopA++){
+      for(size_t loopB=0;loopB<residuals[loopA].size();loopB++){
+        fprintf(outFile,"%15d %15d %15e\n",(int)loopA,(int)loopB+1,residuals[loopA][loopB]);
+      }
+    }
+    fclose(outFile);
+  }
+}
+
+// ==========================
+// TAG CONNECTED CELL REGIONS
+// ==========================
+void mriSequence::tagRegions(mriThresholdCriteria* threshold, int regionType){
+  writeSchMessage("\n");
+  writeSchMessage("Tagging Regions...\n");
+  mriIntVec regionSizes;
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
+    int totRegions = sequence[loopA]->tagRegions(threshold,regionType);
+    mriLabeling::getRegionSizes(sequence[loopA]->cellTags,totRegions,regionSizes);
+    int maxRegionSize = 0;
+    for(int loopB=0;loopB<totRegions;loopB++){
+      maxRegionSize = std::max(maxRegionSize,regionSizes[loopB]);
+    }
+    writeSchMessage("Scan " + mriUtils::intToStr(loopA) + "; Regions: " + mriUtils::intToStr(totRegions) + "; Largest: " + mriUtils::intToStr(maxRegionSize) + " cells\n");
+  }
+}
+
 // ===========================
 // CLEAN COMPONENT ON BOUNDARY
 // ===========================
 void mriSequence::cleanNormalComponentOnBoundary(mriThresholdCriteria* threshold){
-  for(int loopA=0;loopA<this->sequence.size();loopA++){
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
     sequence[loopA]->cleanNormalComponentOnBoundary(threshold);
   }
 }
@@ -373,7 +495,7 @@ void mriSequence::cleanNormalComponentOnBoundary(mriThresholdCriteria* threshold
 // ===============================
 void mriSequence::interpolateBoundaryVelocities(mriThresholdCriteria* threshold){
   printf("Interpolating Boundary Velocities...\n");
-  for(int loopA=0;loopA<this->sequence.size();loopA++){
+  for(size_t loopA=0;loopA<this->sequence.size();loopA++){
     sequence[loopA]->interpolateBoundaryVelocities(threshold);
   }
 }
@@ -382,8 +504,8 @@ void mriSequence::interpolateBoundaryVelocities(mriThresholdCriteria* threshold)
 // EVALUATE REYNOLDS STRESS TENSOR
 // ===============================
 void mriSequence::evalReynoldsStresses(mriThresholdCriteria* threshold){
-  for(int loopA=0;loopA<sequence.size();loopA++){
-    printf("Evaluating Reynolds Stress Tensor for Scan %d...",loopA);
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    printf("Evaluating Reynolds Stress Tensor for Scan %d...",(int)loopA);
     sequence[loopA]->evalReynoldsStress(threshold);
     printf("Done.");
   }
@@ -392,13 +514,14 @@ void mriSequence::evalReynoldsStresses(mriThresholdCriteria* threshold){
 // =============================
 // CREATE SEQUENCE MESH TOPOLOGY
 // =============================
-void mriSequence::createTopology(){
+void mriSequence::createTopology(int ordering){
   // Take Time
   float cellConn_BeginTime,cellConn_TotalTime;
   float faceConn_BeginTime,faceConn_TotalTime;
   float faceArea_BeginTime,faceArea_TotalTime;
   float edgeConn_BeginTime,edgeConn_TotalTime;
   float auxNodes_BeginTime,auxNodes_TotalTime;
+  float renumber_BeginTime,renumber_TotalTime;
 
   // Build Cell Connections
   writeSchMessage(std::string("Build Cell Connection...\n"));
@@ -435,6 +558,17 @@ void mriSequence::createTopology(){
   edgeConn_TotalTime = float( clock () - edgeConn_BeginTime ) /  CLOCKS_PER_SEC;
   printf("Executed in %f [s]\n",edgeConn_TotalTime);
 
+  // Renumber Faces and Edges along a Z-Order Curve
+  // Edges are built first so the canonical numbering does not depend on the ordering
+  if(ordering == kOrderingMorton){
+    writeSchMessage(std::string("Renumber Faces and Edges (Morton)...\n"));
+    renumber_BeginTime = clock();
+    topology->renumberFacesMorton();
+    topology->renumberEdgesMorton();
+    renumber_TotalTime = float( clock () - renumber_BeginTime ) /  CLOCKS_PER_SEC;
+    printf("Executed in %f [s]\n",renumber_TotalTime);
+  }
+
   // Completed
   writeSchMessage(std::string("Topology Creation Completed.\n"));
 }
@@ -449,8 +583,8 @@ void mriSequence::crop(const mriDoubleVec& limitBox){
   topology->crop(limitBox,indexesToCrop);
 
   // Crop Scans
-  for(int loopA=0;loopA<sequence.size();loopA++){
-    printf("Cropping Scan %d...",loopA);
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    printf("Cropping Scan %d...",(int)loopA);
     sequence[loopA]->crop(limitBox,indexesToCrop);
     printf("Done.\n");
   }
@@ -461,90 +595,68 @@ void mriSequence::evalScanDifferencePDF(int otherScan, int refScan, const int pd
   // Get The Scans out of the sequence
   mriScan* scanOther = getScan(otherScan);
   mriScan* scanRef = getScan(refScan);
-  // Allocate Quantities
-  mriDoubleVec binMin(numberOfBins);
-  mriDoubleVec binMax(numberOfBins);
-  // Form Bin 
-  double currInterval = 0.0;
-  formDifferenceBinLimits(otherScan,refScan,pdfQuantity,currInterval,limitBox,numberOfBins,binMin,binMax,binCenters);
-  // Intialize bins
-  for(int loopA=0;loopA<numberOfBins;loopA++){
-    binArray[loopA] = 0.0;
-  }
-  // Loop through the points
-  double sourceValue = 0.0;
-  double refValue = 0.0;
-  double* cellCoord = NULL;
-  double otherQuantity = 0.0;
-  double refQuantity = 0.0;
-  double currValue = 0.0;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    // Get quantity
-    otherQuantity = scanOther->cells[loopA].getQuantity(pdfQuantity);
-    refQuantity = scanRef->cells[loopA].getQuantity(pdfQuantity);
-    // Get Value
-    currValue = (otherQuantity - refQuantity);
-    // Assign Value to Bin
-    if (mriUtils::isPointInsideBox(topology->cellLocations[loopA][0],
-                                   topology->cellLocations[loopA][1],
-                                   topology->cellLocations[loopA][2],
-                                   limitBox)){
-      // COMPLETE
-      mriUtils::assignToBin(currValue,numberOfBins,binMin,binMax,binArray);
-    }
-  }
+  mriHistogramSet histoSet;
+  histoSet.addHistogram(&scanOther->cells,&scanRef->cells,pdfQuantity,numberOfBins,0.0);
+  histoSet.evaluate(topology,useBox ? &limitBox : NULL,NULL);
   // Normalize
-  mriUtils::normalizeBinArray(binArray,currInterval);
+  mriHistogram& histo = histoSet.histograms[0];
+  histo.normalize();
+  binCenters = histo.binCenters;
+  binArray = histo.binValues;
 }
 
 // READ SCAN FROM EXPANSION FILE
+// The coefficients are kept with the scans, velocities are rebuilt by
+// rebuildFromExpansions once the topology has faces and edges
 void mriSequence::readFromExpansionFiles(const mriStringVec& fileNames, const mriDoubleVec& Times, bool applyThreshold, int thresholdType,double thresholdRatio){
 
-  // Allocate Variables
-  mriIntVec tot(3);
-  mriDoubleVec lengthX;
-  mriDoubleVec lengthY;
-  mriDoubleVec lengthZ;
-  mriDoubleVec minlimits(3);
-  mriDoubleVec maxlimits(3);
-  mriExpansion* exp = NULL;
-
-  mriScan* scan = NULL;
-
   // Loop Through the files
-  for(int loopA=0;loopA<fileNames.size();loopA++){
+  for(size_t loopA=0;loopA<fileNames.size();loopA++){
 
     // Read current filename
-    readExpansionFile(fileNames[loopA],tot,lengthX,lengthY,lengthZ,minlimits,maxlimits,exp);
+    writeSchMessage(string("Reading Expansion File: ") + fileNames[loopA] + string("\n"));
+    mriExpansionFileData data;
+    readExpansionCoeffFile(fileNames[loopA],data);
 
     // Build a New Topology from this file
-    mriTopology* topo = new mriTopology(tot,lengthX,lengthY,lengthZ,minlimits,maxlimits);
+    std::unique_ptr<mriTopology> topo(new mriTopology(data.cellTotals,data.cellLengths[0],data.cellLengths[1],data.cellLengths[2],
+                                                      data.domainSizeMin,data.domainSizeMax));
 
     if(loopA == 0){
       // Assign as the full sequence topology
-      topology = topo;
-      // Add Scan
-      scan = new mriScan(Times[loopA]);
-      scan->rebuildFromExpansion(exp, true);
-      addScan(scan);
-    }else{
-      // Check Compatibility
-      if(topology->isCompatibleTopology(topo)){
+      topology = topo.release();
+    }else if(!topology->isCompatibleTopology(topo.get())){
+      // Skip Scan due to incompatible topology
+      printf("WARNING: Skipping Scan, topology is not compatible.\n");
+      continue;
+    }
 
-        // Add Scan From File
-        scan = new mriScan(Times[loopA]);
-        scan->rebuildFromExpansion(exp, true);
-        addScan(scan);
+    // Add Scan From File
+    mriScan* scan = new mriScan(Times[loopA]);
+    scan->cells.resize(topology->totalCells);
+    scan->expansion = new mriExpansion((int)data.vortexCoeff.size());
+    std::copy(data.constantFluxCoeff.begin(),data.constantFluxCoeff.end(),scan->expansion->constantFluxCoeff);
+    std::copy(data.vortexCoeff.begin(),data.vortexCoeff.end(),scan->expansion->vortexCoeff);
+    addScan(scan);
+  }
+}
 
-      }else{
-        // Skip Scan due to incompatible topology
-        printf("WARNING: Skipping Scan, topology is not compatible.\n");
-      }
+// REBUILD VELOCITIES FROM THE EXPANSIONS READ FROM FILE
+void mriSequence::rebuildFromExpansions(){
+  for(size_t loopA=0;loopA<sequence.size();loopA++){
+    mriScan* scan = sequence[loopA];
+    if(scan->expansion == NULL){
+      continue;
+    }
+    if(scan->expansion->totalVortices != scan->evalTotalVortex()){
+      throw mriException("ERROR: Number of expansion coefficients does not match the grid.\n");
+    }
+    scan->rebuildFromExpansion(scan->expansion,true);
+    // Coefficients in the edge numbering of the topology, as after the SMP filter
+    mriDoubleVec canonicalCoeff(scan->expansion->vortexCoeff,scan->expansion->vortexCoeff + scan->expansion->totalVortices);
+    for(int loopB=0;loopB<scan->expansion->totalVortices;loopB++){
+      scan->expansion->vortexCoeff[loopB] = canonicalCoeff[topology->getCanonicalEdge(loopB)];
     }
-
-    // Delete expansion
-    delete exp;
-    exp = NULL;
   }
 }
 
@@ -566,9 +678,10 @@ void mriSequence::makeScanDifference(int firstScanID, int secondScanID){
   writeSchMessage("Computing Scan Difference...");  
   // SubTract Velocity Data
   double diffX,diffY,diffZ;
+  mriCellWriteGuard cellWrite(firstScan->cells);
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     for(int loopB=0;loopB<3;loopB++){
-      firstScan->cells[loopA].velocity[loopB] = firstScan->cells[loopA].velocity[loopB]-secondScan->cells[loopA].velocity[loopB];
+      firstScan->cells.velocity(loopB)[loopA] = firstScan->cells.velocity(loopB)[loopA]-secondScan->cells.velocity(loopB)[loopA];
     }
   }
 }
@@ -593,9 +706,9 @@ void mriSequence::makeScanAverage(int numberOfMeasures, int firstScanID, int sec
   double diffX,diffY,diffZ;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     for(int loopB=0;loopB<3;loopB++){
-      firstScan->cells[loopA].velocity[loopB] =
-      firstScan->cells[loopA].velocity[loopB]*((double)(numberOfMeasures-1)/(double)numberOfMeasures)+
-      secondScan->cells[loopA].velocity[loopB]*(1.0/(double)numberOfMeasures);
+      firstScan->cells.velocity(loopB)[loopA] =
+      firstScan->cells.velocity(loopB)[loopA]*((double)(numberOfMeasures-1)/(double)numberOfMeasures)+
+      secondScan->cells.velocity(loopB)[loopA]*(1.0/(double)numberOfMeasures);
     }
   }
 }
@@ -685,91 +798,200 @@ void mriSequence::createSampleCase(int sampleType, const mriDoubleVec& params){
 
 }
 
-// ======================
-// INITIALIZE VTK OPTIONS
-// ======================
-void resetVTKOptions(vtkStructuredPointsOptionRecord& vtkOptions){
-  vtkOptions.dataBlockStart.clear();
-  vtkOptions.dataBlockType.clear();
-  vtkOptions.dataBlockRead.clear();
-}
-
-// ======================
-// INITIALIZE PLT OPTIONS
-// ======================
-void resetPLTOptions(pltOptionRecord& pltOptions){
-  pltOptions.i = 0;
-  pltOptions.j = 0;
-  pltOptions.k = 0;
-  pltOptions.N = 0;
-  pltOptions.E = 0;
-  pltOptions.type = pltUNIFORM;
+// Size of a file in bytes
+static size_t getFileBytes(const string& fileName){
+  struct stat fileStat;
+  if(stat(fileName.c_str(),&fileStat) != 0){
+    throw mriException(string("ERROR: Cannot open file " + fileName + ".\n").c_str());
+  }
+  return fileStat.st_size;
 }
 
-// ==========================
-// READ VTK STRUCTURED POINTS
-// ==========================
+// ============================
+// READ VTK OR TECPLOT SEQUENCE
+// ============================
+// Headers are read first to check the grids, the scans are then read in
+// parallel on a task pool. The number of files read at the same time is
+// limited by kSequenceLoadBudget.
 void mriSequence::readFromASCIISequence(int asciiInputType,const mriStringVec& asciiFileNames, const mriDoubleVec& times){
 
-  // Loop over the file names
-  mriTopology* topo;
-  mriScan* scan;
-  vtkStructuredPointsOptionRecord vtkOptions;
-  pltOptionRecord pltOptions;
-  for(int loopA=0;loopA<asciiFileNames.size();loopA++){
+  int totFiles = asciiFileNames.size();
+  if(totFiles == 0){
+    return;
+  }
 
-    // Read Topology
-    topo = new mriTopology();
+  // Read the headers and check the grids against the first file
+  std::unique_ptr<mriTopology> firstHeader;
+  mriBoolVec isCompatible(totFiles,false);
+  size_t maxFileBytes = 1;
+  for(int loopA=0;loopA<totFiles;loopA++){
+    std::unique_ptr<mriTopology> header(new mriTopology());
     if(asciiInputType == kInputVTK){
-      resetVTKOptions(vtkOptions);
-      topo->readFromVTK_ASCII(asciiFileNames[loopA],vtkOptions);  
+      mriVTKReader headerReader(asciiFileNames[loopA],true);
+      header->readSizesFromVTK(headerReader);
     }else if(asciiInputType == kInputPLT){
-      resetPLTOptions(pltOptions);
-      topo->readFromPLT_ASCII(asciiFileNames[loopA],pltOptions);  
+      mriPLTReader headerReader(asciiFileNames[loopA],true);
+      header->readSizesFromPLT(headerReader);
     }
-    
     if(loopA == 0){
-      
-      // Assign as the full sequence topology
-      topology = topo;
-      
-      // Add Scan
-      scan = new mriScan(times[loopA]);
-      if(asciiInputType == kInputVTK){
-        scan->readFromVTK_ASCII(asciiFileNames[loopA],vtkOptions);
-      }else if(asciiInputType == kInputPLT){
-        scan->readFromPLT_ASCII(asciiFileNames[loopA],pltOptions);
-      }    
-      
-      // Add scan to sequence
-      addScan(scan);
+      firstHeader = std::move(header);
+      isCompatible[loopA] = true;
+    }else if(firstHeader->isCompatibleTopology(header.get())){
+      isCompatible[loopA] = true;
     }else{
-      // Check Compatibility
-      if(topology->isCompatibleTopology(topo)){
+      // Skip Scan due to incompatible topology
+      printf("WARNING: Skipping Scan %s, topology is not compatible.\n",asciiFileNames[loopA].c_str());
+    }
+    if(isCompatible[loopA]){
+      maxFileBytes = std::max(maxFileBytes,getFileBytes(asciiFileNames[loopA]));
+    }
+  }
 
-        // Add Scan From File
-        scan = new mriScan(times[loopA]);
+  // Workers reading files at the same time, within the memory budget
+  int totCompatible = std::count(isCompatible.begin(),isCompatible.end(),true);
+  int totWorkers = std::min(mriParallel::getThreadCount(),totCompatible);
+  totWorkers = std::min((size_t)totWorkers,kSequenceLoadBudget/maxFileBytes);
+  totWorkers = std::max(1,totWorkers);
+
+  // Read the scans on the pool while the topology is built from the first
+  // file. Tecplot topologies need the point data, the first scan task
+  // builds it from the same parse.
+  vector<std::unique_ptr<mriScan> > scans(totFiles);
+  {
+    mriTaskPool pool(totWorkers);
+    for(int loopA=0;loopA<totFiles;loopA++){
+      if(!isCompatible[loopA]){
+        continue;
+      }
+      scans[loopA].reset(new mriScan(times[loopA]));
+      mriScan* scan = scans[loopA].get();
+      string fileName = asciiFileNames[loopA];
+      mriTopology* topo = (loopA == 0) ? topology : NULL;
+      pool.submit([asciiInputType,scan,topo,fileName](){
         if(asciiInputType == kInputVTK){
-          scan->readFromVTK_ASCII(asciiFileNames[loopA],vtkOptions);
+          mriVTKReader vtkReader(fileName);
+          scan->readFromVTK(vtkReader);
         }else if(asciiInputType == kInputPLT){
-          scan->readFromPLT_ASCII(asciiFileNames[loopA],pltOptions);
-        }    
-        addScan(scan);
+          mriPLTReader pltReader(fileName);
+          if(topo != NULL){
+            topo->readFromPLT(pltReader);
+          }
+          scan->readFromPLT(pltReader);
+        }
+      });
+    }
+    if(asciiInputType == kInputVTK){
+      mriVTKReader headerReader(asciiFileNames[0],true);
+      topology->readFromVTK(headerReader);
+    }
+    pool.wait();
+  }
 
-      }else{
-        
-        // Skip Scan due to incompatible topology
-        printf("WARNING: Skipping Scan, topology is not compatible.\n");
+  // Add the scans in file order
+  for(int loopA=0;loopA<totFiles;loopA++){
+    if(scans[loopA]){
+      addScan(scans[loopA].release());
+    }
+  }
+
+  // WRITE STATISTICS
+  string CurrentStats = writeStatistics();
+  writeSchMessage(CurrentStats);
+
+}
+
+// ================================
+// READ SEQUENCE FROM SEQUENCE FILE
+// ================================
+// Phases and box are inclusive index ranges, empty to read everything
+void mriSequence::readFromSequenceFile(string fileName, const mriIntVec& phases, const mriIntVec& box){
+
+  writeSchMessage(string("Reading Topology From Sequence File: ") + fileName + string("\n"));
+  mriSequenceFileReader reader(fileName);
+  const mriSequenceFileGrid& grid = reader.getGrid();
+
+  // Phases to read
+  int firstPhase = 0;
+  int lastPhase = reader.getTotalPhases() - 1;
+  if(phases.size() > 0){
+    firstPhase = phases[0];
+    lastPhase = phases[1];
+    if((firstPhase < 0)||(lastPhase >= reader.getTotalPhases())||(firstPhase > lastPhase)){
+      throw mriException("ERROR: Invalid phase range for sequence file.\n");
+    }
+  }
+
+  // Box of cells to read
+  mriIntVec boxMin(kNumberOfDimensions,0);
+  mriIntVec boxMax(grid.cellTotals);
+  if(box.size() > 0){
+    for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+      boxMin[loopA] = box[2*loopA];
+      boxMax[loopA] = box[2*loopA + 1] + 1;
+      if((boxMin[loopA] < 0)||(boxMax[loopA] > grid.cellTotals[loopA])||(boxMin[loopA] >= boxMax[loopA])){
+        throw mriException("ERROR: Invalid cell box for sequence file.\n");
+      }
+    }
+  }
 
+  // Grid of the box, extents are moved with the first and last centers
+  mriDoubleMat lengths(kNumberOfDimensions);
+  mriDoubleMat axisCoords(kNumberOfDimensions);
+  mriDoubleVec minLimits(kNumberOfDimensions);
+  mriDoubleVec maxLimits(kNumberOfDimensions);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    const mriDoubleVec& coords = grid.axisCoords[loopA];
+    lengths[loopA].assign(grid.cellLengths[loopA].begin() + boxMin[loopA],grid.cellLengths[loopA].begin() + boxMax[loopA]);
+    axisCoords[loopA].assign(coords.begin() + boxMin[loopA],coords.begin() + boxMax[loopA]);
+    minLimits[loopA] = grid.domainSizeMin[loopA] + (coords[boxMin[loopA]] - coords.front());
+    maxLimits[loopA] = grid.domainSizeMax[loopA] - (coords.back() - coords[boxMax[loopA] - 1]);
+  }
+  topology->createGridFromAxes(lengths,minLimits,maxLimits,axisCoords);
+  int totCells = topology->totalCells;
+
+  // Read the scans
+  for(int loopA=firstPhase;loopA<=lastPhase;loopA++){
+    const mriSequenceFilePhase& phase = reader.getPhase(loopA);
+    printf("Reading Scan Data From: %s, phase %d\n",fileName.c_str(),loopA);
+    std::unique_ptr<mriScan> scan(new mriScan(phase.time));
+    scan->cells.resize(totCells);
+    bool hasConcentration = false;
+    bool hasVelocity = false;
+    for(size_t loopB=0;loopB<phase.arrays.size();loopB++){
+      const mriSequenceFileArray& array = phase.arrays[loopB];
+      bool isDouble = (array.valueType == kSequenceValueDouble);
+      if(isDouble && (array.name == "concentration") && (array.totComponents == 1)){
+        void* values[1] = {scan->cells.conc.data()};
+        reader.readArray(loopA,loopB,boxMin,boxMax,values);
+        hasConcentration = true;
+      }else if(isDouble && (array.name == "velocity") && (array.totComponents == 3)){
+        void* values[3] = {scan->cells.vx.data(),scan->cells.vy.data(),scan->cells.vz.data()};
+        reader.readArray(loopA,loopB,boxMin,boxMax,values);
+        hasVelocity = true;
+      }else if((!isDouble) && (array.name == "Tags") && (array.totComponents == 1)){
+        scan->cellTags.resize(totCells);
+        void* values[1] = {scan->cellTags.data()};
+        reader.readArray(loopA,loopB,boxMin,boxMax,values);
+      }else if(isDouble && ((array.totComponents == ftScalar)||(array.totComponents == ftVector)||(array.totComponents == ftSymTensor))){
+        mriField& field = scan->outputs.addField(array.name,(mriFieldType)array.totComponents,totCells);
+        vector<void*> values(field.totComponents);
+        for(int loopC=0;loopC<field.totComponents;loopC++){
+          values[loopC] = field.component(loopC);
+        }
+        reader.readArray(loopA,loopB,boxMin,boxMax,values.data());
+      }else{
+        printf("WARNING: Skipping array %s in sequence file.\n",array.name.c_str());
       }
-      // Delete current topology
-      delete topo;
-      topo = NULL;
     }
+    if((!hasConcentration)||(!hasVelocity)){
+      throw mriException("ERROR: Missing concentration or velocity in sequence file.\n");
+    }
+    scan->cells.markModified();
+    scan->maxVelModule = scan->cells.getMaxVelocityModule();
+    addScan(scan.release());
   }
 
   // WRITE STATISTICS
   string CurrentStats = writeStatistics();
   writeSchMessage(CurrentStats);
-
 }
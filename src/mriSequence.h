@@ -6,6 +6,7 @@
 #include "mriThresholdCriteria.h"
 #include "mriTopology.h"
 #include "mriIO.h"
+#include "mriSequenceFile.h"
 
 using namespace std;
 
@@ -13,6 +14,9 @@ class mriScan;
 class mriTopology;
 class mriCommunicator;
 
+// Bytes of input files read at the same time when loading a sequence
+const size_t kSequenceLoadBudget = (size_t)4 << 30;
+
 // Generic Sequence Containing General 
 // Unstructured Data Sets
 
@@ -25,6 +29,12 @@ class mriSequence{
     // TOPOLOGY COMMON TO EVERY SCAN
     mriTopology* topology;
 
+    // TIME DERIVATIVES OF THE LAST EVALUATED SCAN
+    mriTimeDerivs scanTimeDerivs;
+
+    // MESH OF THE LAST SOLVER EXPORT
+    std::shared_ptr<mriFEMesh> feMesh;
+
     // Constructor and
     mriSequence(bool cyclic);
     // Copy Constructor
@@ -45,28 +55,35 @@ class mriSequence{
     void readFromASCIISequence(int asciiInputType, 
                                const mriStringVec& vtkFileNames, 
                                const mriDoubleVec& times);    
+    void readFromSequenceFile(string fileName, const mriIntVec& phases, const mriIntVec& box);
     void readFromExpansionFiles(const mriStringVec& fileNames, 
                                 const mriDoubleVec& Times, 
                                 bool applyThreshold, 
                                 int thresholdType,
                                 double thresholdRatio);
+    void rebuildFromExpansions();
     
     // EXPORT SEQUENCE TO FILE
     void exportToTECPLOT(string outfileName);
+    void exportToTECPLOTBinary(string outfileName);
     void exportToVOL(string outfileName);
-    void exportToVTK(string outfileName,mriThresholdCriteria* thresholdCriteria);    
-    void exportForDistancing(string inputFileName, mriThresholdCriteria* threshold);
+    void exportToVTK(string outfileName,mriThresholdCriteria* thresholdCriteria,bool isBinary);    
+    void exportToVTKXML(string outfileName,mriThresholdCriteria* thresholdCriteria,int compression);
+    void exportToSequenceFile(string outfileName,int compression);
+    void exportForDistancing(string inputFileName, mriThresholdCriteria* threshold, int exportFormat);
     void exportForPoisson(string inputFileName,double density,double viscosity,mriThresholdCriteria* threshold,
                           bool PPE_IncludeAccelerationTerm,bool PPE_IncludeAdvectionTerm,bool PPE_IncludeDiffusionTerm,bool PPE_IncludeReynoldsTerm,
-                          bool readMuTFromFile, string muTFile, double smagorinskyCoeff);
-    void writeExpansionFile(string fileName);    
+                          bool readMuTFromFile, string muTFile, double smagorinskyCoeff, int exportFormat);
+    // Masked mesh of a scan for the solver exports, reused while the fluid cells do not change
+    mriFEMesh* getFEMesh(int scanNumber, mriThresholdCriteria* threshold, string filePrefix, int exportFormat, mriAsyncWriter* asyncWriter);
+    void writeExpansionFile(string fileName, const mriExpansionFileFormat& format);    
 
     // SAVE QUANTITIES TO OUTPUTS
     void   saveVelocity();
     double getVelocityNormAtCell(int cell);
 
     // TOPOLOGY AND MAPPING
-    void createTopology();
+    void createTopology(int ordering);
     void getUnitVector(int CurrentCell, const mriDoubleVec& GlobalFaceCoords, mriDoubleVec& myVect);
     void getGlobalCoords(int DimNumber, int SliceNumber, double FaceCoord1, double FaceCoord2, mriDoubleVec& globalCoords);
     int  getCellNumber(const mriDoubleVec& coords);
@@ -106,6 +123,7 @@ class mriSequence{
     
     // PRESSURE COMPUTATION
     void computePressureGradients(mriThresholdCriteria* threshold);
+    void solvePressurePoisson(mriThresholdCriteria* threshold, double density, double viscosity, int maxIt, double tolerance);
 
     // COMPUTING REYNOLDS STRESSES
     void evalReynoldsStresses(mriThresholdCriteria* threshold);
@@ -116,6 +134,11 @@ class mriSequence{
 
     // FILTER DATA
     void applyMedianFilter(int qtyID,int maxIt,int order,int filterType,mriThresholdCriteria* threshold);
+    void applyVelocityFilter(int maxIt,int order,int filterType,mriThresholdCriteria* threshold);
+    void applyDivergenceSmoothing(int maxIt,double tolerance,string historyFileName);
+
+    // REGION TAGGING
+    void tagRegions(mriThresholdCriteria* threshold, int regionType);
     
     // File List Printing
     void printSequenceFiles(std::string outFIleName);
@@ -123,19 +146,11 @@ class mriSequence{
     void makeScanDifference(int firstScanID, int secondScanID);
     void makeScanAverage(int numberOfMeasures, int firstScanID, int secondScanID);
     // Eval Time Derivatives
-    void evalTimeDerivs(int currentScan, int currentCell, mriDoubleVec& timeDeriv);
-    void evalScanTimeDerivs(int currentScan,mriDoubleMat& timeDeriv);
+    const mriTimeDerivs& evalScanTimeDerivs(int currentScan);
   
     // STATISTICS
     void evalScanDifferencePDF(int otherScan, int refScan, const int pdfQuantity, int numberOfBins, bool useBox, mriDoubleVec& limitBox, mriDoubleVec& binCenters, mriDoubleVec& binArray);
     void extractSinglePointTimeCurve(int cellNumber, int exportQty, string fileName);
-    void formDifferenceBinLimits(int otherScan, int refScan, 
-                                 int pdfQuantity, double& currInterval,
-                                 const mriDoubleVec& limitBox, 
-                                 int numberOfBins, 
-                                 mriDoubleVec& binMin, 
-                                 mriDoubleVec& binMax, 
-                                 mriDoubleVec& binCenter);
     
     // TRANFORMATION
     void crop(const mriDoubleVec& limitBox);
@@ -0,0 +1,514 @@
+#include <string.h>
+#include <algorithm>
+#ifdef MRI_USE_ZLIB
+#include <zlib.h>
+#endif
+#include "mriSequenceFile.h"
+#include "mriParallel.h"
+#include "mriLZ4.h"
+
+// File header: magic, byte order mark, version and offset of the index
+static const char kSequenceFileMagic[8] = {'M','R','I','S','E','Q','\0','\0'};
+static const uint32_t kSequenceByteOrderMark = 0x01020304;
+static const uint32_t kSequenceFileVersion = 1;
+static const size_t kSequenceHeaderSize = 24;
+static const size_t kSequenceIndexOffsetPos = 16;
+
+// Bricks along each axis
+static void getBrickTotals(const mriIntVec& cellTotals, int brickTotals[3]){
+  for(int loopA=0;loopA<3;loopA++){
+    brickTotals[loopA] = (cellTotals[loopA] + kSequenceBrickSize - 1)/kSequenceBrickSize;
+  }
+}
+
+// First cell and number of cells of a brick along each axis, x runs fastest
+static void getBrickBox(const mriIntVec& cellTotals, int brick, int first[3], int size[3]){
+  int brickTotals[3];
+  getBrickTotals(cellTotals,brickTotals);
+  int brickCoords[3];
+  brickCoords[0] = brick % brickTotals[0];
+  brickCoords[1] = (brick/brickTotals[0]) % brickTotals[1];
+  brickCoords[2] = brick/(brickTotals[0]*brickTotals[1]);
+  for(int loopA=0;loopA<3;loopA++){
+    first[loopA] = brickCoords[loopA]*kSequenceBrickSize;
+    size[loopA] = std::min(kSequenceBrickSize,cellTotals[loopA] - first[loopA]);
+  }
+}
+
+// Group byte k of every value together, doubles compress much better
+static void shuffleBytes(const char* src, size_t totValues, int valueSize, char* dst){
+  for(size_t loopA=0;loopA<totValues;loopA++){
+    for(int loopB=0;loopB<valueSize;loopB++){
+      dst[loopB*totValues + loopA] = src[loopA*valueSize + loopB];
+    }
+  }
+}
+
+static void unshuffleBytes(const char* src, size_t totValues, int valueSize, char* dst){
+  for(int loopB=0;loopB<valueSize;loopB++){
+    const char* plane = src + loopB*totValues;
+    for(size_t loopA=0;loopA<totValues;loopA++){
+      dst[loopA*valueSize + loopB] = plane[loopA];
+    }
+  }
+}
+
+// Compress one brick with the selected codec
+static void compressBrick(int compression, const char* src, int srcSize, vector<char>& dst){
+  if(compression == kSequenceCompressLZ4){
+    mriLZ4::compressBlock(src,srcSize,dst);
+    return;
+  }
+#ifdef MRI_USE_ZLIB
+  uLongf dstSize = compressBound(srcSize);
+  dst.resize(dstSize);
+  if(compress2((Bytef*)dst.data(),&dstSize,(const Bytef*)src,srcSize,kSequenceZLibLevel) != Z_OK){
+    throw mriException("ERROR: zlib compression failed in mriSequenceFileWriter.\n");
+  }
+  dst.resize(dstSize);
+#else
+  throw mriException("ERROR: mriFilter was built without zlib.\n");
+#endif
+}
+
+// Decompress one brick of exactly dstSize bytes
+static void decompressBrick(int compression, const char* src, int srcSize, char* dst, int dstSize){
+  if(compression == kSequenceCompressLZ4){
+    mriLZ4::decompressBlock(src,srcSize,dst,dstSize);
+    return;
+  }
+#ifdef MRI_USE_ZLIB
+  uLongf outSize = dstSize;
+  if((uncompress((Bytef*)dst,&outSize,(const Bytef*)src,srcSize) != Z_OK)||(outSize != (uLongf)dstSize)){
+    throw mriException("ERROR: Corrupt zlib brick in sequence file.\n");
+  }
+#else
+  throw mriException("ERROR: Sequence file is compressed with zlib, mriFilter was built without zlib.\n");
+#endif
+}
+
+// Bytes of one value
+static int getSequenceValueSize(int valueType){
+  return (valueType == kSequenceValueInt) ? sizeof(int32_t) : sizeof(double);
+}
+
+// ========================
+// INDEX STORED AT FILE END
+// ========================
+class mriSequenceIndexBuffer{
+  public:
+    vector<char> data;
+    template<typename T> void put(T value){
+      const char* bytes = (const char*)&value;
+      data.insert(data.end(),bytes,bytes + sizeof(T));
+    }
+    void putDoubles(const mriDoubleVec& values){
+      for(size_t loopA=0;loopA<values.size();loopA++){
+        put<double>(values[loopA]);
+      }
+    }
+    void putString(const string& value){
+      put<int32_t>(value.size());
+      data.insert(data.end(),value.begin(),value.end());
+    }
+};
+
+class mriSequenceIndexCursor{
+  public:
+    mriSequenceIndexCursor(const char* begin, const char* end){
+      curr = begin;
+      this->end = end;
+    }
+    template<typename T> T get(){
+      T value;
+      check(sizeof(T));
+      memcpy(&value,curr,sizeof(T));
+      curr += sizeof(T);
+      return value;
+    }
+    void getDoubles(size_t count, mriDoubleVec& values){
+      check(count*sizeof(double));
+      values.resize(count);
+      for(size_t loopA=0;loopA<count;loopA++){
+        values[loopA] = get<double>();
+      }
+    }
+    string getString(){
+      int32_t size = get<int32_t>();
+      if(size < 0){
+        throw mriException("ERROR: Invalid index in sequence file.\n");
+      }
+      check(size);
+      string value(curr,size);
+      curr += size;
+      return value;
+    }
+    // Bytes left in the index
+    size_t remaining() const{
+      return end - curr;
+    }
+  private:
+    const char* curr;
+    const char* end;
+    void check(size_t size){
+      if((size_t)(end - curr) < size){
+        throw mriException("ERROR: Truncated index in sequence file.\n");
+      }
+    }
+};
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriSequenceFileWriter::mriSequenceFileWriter(string fileName, int compression, const mriSequenceFileGrid& grid){
+  this->fileName = fileName;
+  this->compression = compression;
+#ifndef MRI_USE_ZLIB
+  // Bundled codec when zlib is not available
+  if(compression == kSequenceCompressZLib){
+    this->compression = kSequenceCompressLZ4;
+  }
+#endif
+  this->grid = grid;
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    if((grid.axisCoords[loopA].size() != (size_t)grid.cellTotals[loopA])||
+       (grid.cellLengths[loopA].size() != (size_t)grid.cellTotals[loopA])){
+      throw mriException("ERROR: Invalid grid in mriSequenceFileWriter.\n");
+    }
+  }
+  outFile = fopen(fileName.c_str(),"wb");
+  if(outFile == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+  // Header, the index offset is set by close()
+  char header[kSequenceHeaderSize];
+  memset(header,0,kSequenceHeaderSize);
+  memcpy(header,kSequenceFileMagic,sizeof(kSequenceFileMagic));
+  memcpy(header + 8,&kSequenceByteOrderMark,sizeof(uint32_t));
+  memcpy(header + 12,&kSequenceFileVersion,sizeof(uint32_t));
+  if(fwrite(header,1,kSequenceHeaderSize,outFile) != kSequenceHeaderSize){
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+  fileOffset = kSequenceHeaderSize;
+}
+
+// ==========
+// DESTRUCTOR
+// ==========
+mriSequenceFileWriter::~mriSequenceFileWriter(){
+  // Not closed, the file has no index and cannot be read
+  if(outFile != NULL){
+    fclose(outFile);
+  }
+}
+
+// ===========
+// BEGIN PHASE
+// ===========
+void mriSequenceFileWriter::beginPhase(double time){
+  phases.push_back(mriSequenceFilePhase());
+  phases.back().time = time;
+}
+
+// ==================
+// WRITE DOUBLE ARRAY
+// ==================
+void mriSequenceFileWriter::writeArray(const string& name, int totComponents, const double* const* components){
+  mriSequenceFileArray array;
+  array.name = name;
+  array.valueType = kSequenceValueDouble;
+  array.totComponents = totComponents;
+  vector<const char*> bytes(totComponents);
+  for(int loopA=0;loopA<totComponents;loopA++){
+    bytes[loopA] = (const char*)components[loopA];
+  }
+  writeComponents(array,sizeof(double),bytes.data());
+}
+
+// ===================
+// WRITE INTEGER ARRAY
+// ===================
+void mriSequenceFileWriter::writeArray(const string& name, const int* values){
+  mriSequenceFileArray array;
+  array.name = name;
+  array.valueType = kSequenceValueInt;
+  array.totComponents = 1;
+  const char* bytes = (const char*)values;
+  writeComponents(array,sizeof(int32_t),&bytes);
+}
+
+// ====================================
+// COMPRESS AND APPEND COMPONENT BRICKS
+// ====================================
+void mriSequenceFileWriter::writeComponents(mriSequenceFileArray& array, int valueSize, const char* const* components){
+  if(phases.empty()){
+    throw mriException("ERROR: Array written before beginPhase in mriSequenceFileWriter.\n");
+  }
+  int brickTotals[3];
+  getBrickTotals(grid.cellTotals,brickTotals);
+  int totBricks = brickTotals[0]*brickTotals[1]*brickTotals[2];
+  int rowSize = grid.cellTotals[0];
+  int planeSize = grid.cellTotals[0]*grid.cellTotals[1];
+  vector<vector<char> > bricks(totBricks);
+  for(int loopA=0;loopA<array.totComponents;loopA++){
+    const char* component = components[loopA];
+    // Gather, shuffle and compress the bricks on the worker threads
+    mriParallel::parallelFor(totBricks,1,[&](int /*thread*/,int begin,int end){
+      vector<char> values;
+      vector<char> shuffled;
+      for(int loopB=begin;loopB<end;loopB++){
+        int first[3];
+        int size[3];
+        getBrickBox(grid.cellTotals,loopB,first,size);
+        size_t totValues = (size_t)size[0]*size[1]*size[2];
+        values.resize(totValues*valueSize);
+        char* out = values.data();
+        for(int loopK=0;loopK<size[2];loopK++){
+          for(int loopJ=0;loopJ<size[1];loopJ++){
+            size_t cell = (size_t)(first[2] + loopK)*planeSize + (size_t)(first[1] + loopJ)*rowSize + first[0];
+            memcpy(out,component + cell*valueSize,size[0]*valueSize);
+            out += size[0]*valueSize;
+          }
+        }
+        if(compression == kSequenceCompressNone){
+          bricks[loopB].swap(values);
+        }else{
+          shuffled.resize(values.size());
+          shuffleBytes(values.data(),totValues,valueSize,shuffled.data());
+          compressBrick(compression,shuffled.data(),shuffled.size(),bricks[loopB]);
+        }
+      }
+    });
+    // Append in brick order
+    for(int loopB=0;loopB<totBricks;loopB++){
+      if(fwrite(bricks[loopB].data(),1,bricks[loopB].size(),outFile) != bricks[loopB].size()){
+        throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+      }
+      array.brickOffsets.push_back(fileOffset);
+      array.brickSizes.push_back(bricks[loopB].size());
+      fileOffset += bricks[loopB].size();
+    }
+  }
+  phases.back().arrays.push_back(array);
+}
+
+// ==========================
+// WRITE INDEX AND CLOSE FILE
+// ==========================
+void mriSequenceFileWriter::close(){
+  if(outFile == NULL){
+    return;
+  }
+  mriSequenceIndexBuffer index;
+  index.put<int32_t>(compression);
+  index.put<int32_t>(kSequenceBrickSize);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    index.put<int32_t>(grid.cellTotals[loopA]);
+  }
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    index.putDoubles(grid.cellLengths[loopA]);
+    index.putDoubles(grid.axisCoords[loopA]);
+  }
+  index.putDoubles(grid.domainSizeMin);
+  index.putDoubles(grid.domainSizeMax);
+  index.put<int32_t>(phases.size());
+  for(size_t loopA=0;loopA<phases.size();loopA++){
+    const mriSequenceFilePhase& phase = phases[loopA];
+    index.put<double>(phase.time);
+    index.put<int32_t>(phase.arrays.size());
+    for(size_t loopB=0;loopB<phase.arrays.size();loopB++){
+      const mriSequenceFileArray& array = phase.arrays[loopB];
+      index.putString(array.name);
+      index.put<int32_t>(array.valueType);
+      index.put<int32_t>(array.totComponents);
+      for(size_t loopC=0;loopC<array.brickOffsets.size();loopC++){
+        index.put<uint64_t>(array.brickOffsets[loopC]);
+        index.put<uint64_t>(array.brickSizes[loopC]);
+      }
+    }
+  }
+  bool isWritten = (fwrite(index.data.data(),1,index.data.size(),outFile) == index.data.size());
+  isWritten = isWritten && (fseek(outFile,kSequenceIndexOffsetPos,SEEK_SET) == 0);
+  isWritten = isWritten && (fwrite(&fileOffset,sizeof(uint64_t),1,outFile) == 1);
+  isWritten = (fclose(outFile) == 0) && isWritten;
+  outFile = NULL;
+  if(!isWritten){
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriSequenceFileReader::mriSequenceFileReader(string fileName):file(fileName,false){
+  this->fileName = fileName;
+  const char* begin = file.begin();
+  // Check the header
+  uint32_t byteOrderMark = 0;
+  uint32_t version = 0;
+  uint64_t indexOffset = 0;
+  if(file.size() >= kSequenceHeaderSize){
+    memcpy(&byteOrderMark,begin + 8,sizeof(uint32_t));
+    memcpy(&version,begin + 12,sizeof(uint32_t));
+    memcpy(&indexOffset,begin + kSequenceIndexOffsetPos,sizeof(uint64_t));
+  }
+  if((file.size() < kSequenceHeaderSize)||(memcmp(begin,kSequenceFileMagic,sizeof(kSequenceFileMagic)) != 0)){
+    throw mriException(string("ERROR: " + fileName + " is not a sequence file.\n").c_str());
+  }
+  if(byteOrderMark != kSequenceByteOrderMark){
+    throw mriException(string("ERROR: Sequence file " + fileName + " was written with a different byte order.\n").c_str());
+  }
+  if(version != kSequenceFileVersion){
+    throw mriException(string("ERROR: Unsupported version of sequence file " + fileName + ".\n").c_str());
+  }
+  if((indexOffset < kSequenceHeaderSize)||(indexOffset > file.size())){
+    throw mriException(string("ERROR: Sequence file " + fileName + " is incomplete.\n").c_str());
+  }
+
+  // Read the index
+  mriSequenceIndexCursor index(begin + indexOffset,file.end());
+  compression = index.get<int32_t>();
+  int brickSize = index.get<int32_t>();
+  if(((compression != kSequenceCompressNone)&&(compression != kSequenceCompressZLib)&&(compression != kSequenceCompressLZ4))||
+     (brickSize != kSequenceBrickSize)){
+    throw mriException(string("ERROR: Unsupported layout of sequence file " + fileName + ".\n").c_str());
+  }
+  grid.cellTotals.resize(kNumberOfDimensions);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    grid.cellTotals[loopA] = index.get<int32_t>();
+    if(grid.cellTotals[loopA] < 1){
+      throw mriException("ERROR: Invalid index in sequence file.\n");
+    }
+  }
+  grid.cellLengths.resize(kNumberOfDimensions);
+  grid.axisCoords.resize(kNumberOfDimensions);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    index.getDoubles(grid.cellTotals[loopA],grid.cellLengths[loopA]);
+    index.getDoubles(grid.cellTotals[loopA],grid.axisCoords[loopA]);
+  }
+  index.getDoubles(kNumberOfDimensions,grid.domainSizeMin);
+  index.getDoubles(kNumberOfDimensions,grid.domainSizeMax);
+  int brickTotals[3];
+  getBrickTotals(grid.cellTotals,brickTotals);
+  size_t totBricks = (size_t)brickTotals[0]*brickTotals[1]*brickTotals[2];
+  int totPhases = index.get<int32_t>();
+  if((totPhases < 0)||((size_t)totPhases > index.remaining()/(sizeof(double) + sizeof(int32_t)))){
+    throw mriException("ERROR: Invalid index in sequence file.\n");
+  }
+  phases.resize(totPhases);
+  for(int loopA=0;loopA<totPhases;loopA++){
+    phases[loopA].time = index.get<double>();
+    int totArrays = index.get<int32_t>();
+    if((totArrays < 0)||((size_t)totArrays > index.remaining()/(3*sizeof(int32_t)))){
+      throw mriException("ERROR: Invalid index in sequence file.\n");
+    }
+    phases[loopA].arrays.resize(totArrays);
+    for(int loopB=0;loopB<totArrays;loopB++){
+      mriSequenceFileArray& array = phases[loopA].arrays[loopB];
+      array.name = index.getString();
+      array.valueType = index.get<int32_t>();
+      array.totComponents = index.get<int32_t>();
+      if(((array.valueType != kSequenceValueDouble)&&(array.valueType != kSequenceValueInt))||(array.totComponents < 1)){
+        throw mriException("ERROR: Invalid index in sequence file.\n");
+      }
+      // Each entry stores an offset and a size, check before allocating
+      if((size_t)array.totComponents > index.remaining()/(2*sizeof(uint64_t)*totBricks)){
+        throw mriException("ERROR: Truncated index in sequence file.\n");
+      }
+      size_t totEntries = array.totComponents*totBricks;
+      array.brickOffsets.resize(totEntries);
+      array.brickSizes.resize(totEntries);
+      for(size_t loopC=0;loopC<totEntries;loopC++){
+        array.brickOffsets[loopC] = index.get<uint64_t>();
+        array.brickSizes[loopC] = index.get<uint64_t>();
+        // Bricks lie between the header and the index
+        if((array.brickOffsets[loopC] < kSequenceHeaderSize)||(array.brickOffsets[loopC] > indexOffset)||
+           (array.brickSizes[loopC] > indexOffset - array.brickOffsets[loopC])){
+          throw mriException("ERROR: Invalid index in sequence file.\n");
+        }
+      }
+    }
+  }
+}
+
+// ===============================
+// READ ARRAY VALUES IN A CELL BOX
+// ===============================
+void mriSequenceFileReader::readArray(int phase, int array, const mriIntVec& boxMin, const mriIntVec& boxMax, void* const* values) const{
+  if((phase < 0)||(phase >= (int)phases.size())||(array < 0)||(array >= (int)phases[phase].arrays.size())){
+    throw mriException("ERROR: Invalid phase or array in mriSequenceFileReader::readArray.\n");
+  }
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    if((boxMin[loopA] < 0)||(boxMax[loopA] > grid.cellTotals[loopA])||(boxMin[loopA] >= boxMax[loopA])){
+      throw mriException("ERROR: Invalid box in mriSequenceFileReader::readArray.\n");
+    }
+  }
+  const mriSequenceFileArray& info = phases[phase].arrays[array];
+  int valueSize = getSequenceValueSize(info.valueType);
+  int brickTotals[3];
+  getBrickTotals(grid.cellTotals,brickTotals);
+  int totBricks = brickTotals[0]*brickTotals[1]*brickTotals[2];
+
+  // Bricks that overlap the box, for every component
+  vector<int> entries;
+  int firstBrick[3];
+  int lastBrick[3];
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    firstBrick[loopA] = boxMin[loopA]/kSequenceBrickSize;
+    lastBrick[loopA] = (boxMax[loopA] - 1)/kSequenceBrickSize;
+  }
+  for(int loopA=0;loopA<info.totComponents;loopA++){
+    for(int loopK=firstBrick[2];loopK<=lastBrick[2];loopK++){
+      for(int loopJ=firstBrick[1];loopJ<=lastBrick[1];loopJ++){
+        for(int loopI=firstBrick[0];loopI<=lastBrick[0];loopI++){
+          entries.push_back(loopA*totBricks + (loopK*brickTotals[1] + loopJ)*brickTotals[0] + loopI);
+        }
+      }
+    }
+  }
+
+  // Decompress the bricks and copy their part of the box
+  int boxRow = boxMax[0] - boxMin[0];
+  int boxPlane = boxRow*(boxMax[1] - boxMin[1]);
+  mriParallel::parallelFor(entries.size(),1,[&](int /*thread*/,int begin,int end){
+    vector<char> shuffled;
+    vector<char> unpacked;
+    for(int loopA=begin;loopA<end;loopA++){
+      int entry = entries[loopA];
+      int component = entry/totBricks;
+      int first[3];
+      int size[3];
+      getBrickBox(grid.cellTotals,entry % totBricks,first,size);
+      size_t totValues = (size_t)size[0]*size[1]*size[2];
+      const char* stored = file.begin() + info.brickOffsets[entry];
+      size_t storedSize = info.brickSizes[entry];
+      const char* brick = stored;
+      if(compression == kSequenceCompressNone){
+        if(storedSize != totValues*valueSize){
+          throw mriException("ERROR: Invalid brick size in sequence file.\n");
+        }
+      }else{
+        shuffled.resize(totValues*valueSize);
+        unpacked.resize(totValues*valueSize);
+        decompressBrick(compression,stored,storedSize,shuffled.data(),shuffled.size());
+        unshuffleBytes(shuffled.data(),totValues,valueSize,unpacked.data());
+        brick = unpacked.data();
+      }
+      // Rows of the brick inside the box
+      int lo[3];
+      int hi[3];
+      for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+        lo[loopB] = std::max(first[loopB],boxMin[loopB]);
+        hi[loopB] = std::min(first[loopB] + size[loopB],boxMax[loopB]);
+      }
+      char* out = (char*)values[component];
+      for(int loopK=lo[2];loopK<hi[2];loopK++){
+        for(int loopJ=lo[1];loopJ<hi[1];loopJ++){
+          size_t src = ((size_t)(loopK - first[2])*size[1] + (loopJ - first[1]))*size[0] + (lo[0] - first[0]);
+          size_t dst = (size_t)(loopK - boxMin[2])*boxPlane + (size_t)(loopJ - boxMin[1])*boxRow + (lo[0] - boxMin[0]);
+          memcpy(out + dst*valueSize,brick + src*valueSize,(hi[0] - lo[0])*valueSize);
+        }
+      }
+    }
+  });
+}
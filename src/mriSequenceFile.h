@@ -0,0 +1,122 @@
+#ifndef MRISEQUENCEFILE_H
+#define MRISEQUENCEFILE_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriConstants.h"
+# include "mriTextFile.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Compression of the stored bricks
+const int kSequenceCompressNone = 0;
+const int kSequenceCompressZLib = 1;
+const int kSequenceCompressLZ4  = 2;
+
+// Value types of the stored arrays
+const int kSequenceValueDouble = 0;
+const int kSequenceValueInt    = 1;
+
+// Cells along each side of a brick
+const int kSequenceBrickSize = 32;
+// Fast zlib level, the file is an intermediate between runs
+const int kSequenceZLibLevel = 1;
+
+// ==========================
+// ARRAY STORED FOR ONE PHASE
+// ==========================
+struct mriSequenceFileArray{
+  string name;
+  int valueType;
+  int totComponents;
+  // File offset and stored size of every brick, component by component
+  vector<uint64_t> brickOffsets;
+  vector<uint64_t> brickSizes;
+};
+
+// =====================
+// PHASE OF THE SEQUENCE
+// =====================
+struct mriSequenceFilePhase{
+  double time;
+  vector<mriSequenceFileArray> arrays;
+};
+
+// ===================================
+// GRID SHARED BY ALL PHASES OF A FILE
+// ===================================
+struct mriSequenceFileGrid{
+  mriIntVec cellTotals;
+  mriDoubleMat cellLengths;
+  // Cell center coordinates along each axis
+  mriDoubleMat axisCoords;
+  mriDoubleVec domainSizeMin;
+  mriDoubleVec domainSizeMax;
+};
+
+// ======================
+// BINARY SEQUENCE WRITER
+// ======================
+// Every component of an array is split in bricks of kSequenceBrickSize
+// cells per side, compressed on the worker threads after a byte shuffle
+// and appended to the file. The grid, the phase times and the brick index
+// are written at the end by close().
+class mriSequenceFileWriter{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    mriSequenceFileWriter(string fileName, int compression, const mriSequenceFileGrid& grid);
+    ~mriSequenceFileWriter();
+
+    // MEMBER FUNCTIONS
+    void beginPhase(double time);
+    // components[c] has the values of component c for all cells
+    void writeArray(const string& name, int totComponents, const double* const* components);
+    void writeArray(const string& name, const int* values);
+    void close();
+
+  private:
+    string fileName;
+    FILE* outFile;
+    int compression;
+    mriSequenceFileGrid grid;
+    vector<mriSequenceFilePhase> phases;
+    uint64_t fileOffset;
+    void writeComponents(mriSequenceFileArray& array, int valueSize, const char* const* components);
+    // Not copyable
+    mriSequenceFileWriter(const mriSequenceFileWriter&);
+    mriSequenceFileWriter& operator=(const mriSequenceFileWriter&);
+};
+
+// ===========================
+// MEMORY-MAPPED SEQUENCE FILE
+// ===========================
+// The index is read when the file is opened, the bricks of any phase,
+// array and box of cells are then decompressed straight from the mapping.
+class mriSequenceFileReader{
+  public:
+    // CONSTRUCTOR
+    mriSequenceFileReader(string fileName);
+
+    // MEMBER FUNCTIONS
+    string getFileName() const{return fileName;}
+    const mriSequenceFileGrid& getGrid() const{return grid;}
+    int getTotalPhases() const{return phases.size();}
+    const mriSequenceFilePhase& getPhase(int phase) const{return phases[phase];}
+    // Read the cells in [boxMin,boxMax) of all components of an array,
+    // x runs fastest in the box. values[c] receives component c.
+    void readArray(int phase, int array, const mriIntVec& boxMin, const mriIntVec& boxMax, void* const* values) const;
+
+  private:
+    string fileName;
+    mriMappedFile file;
+    int compression;
+    mriSequenceFileGrid grid;
+    vector<mriSequenceFilePhase> phases;
+};
+
+#endif // MRISEQUENCEFILE_H
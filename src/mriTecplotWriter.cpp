@@ -0,0 +1,150 @@
+#include <algorithm>
+#include "mriTecplotWriter.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriTecplotWriter::mriTecplotWriter(string fileName, const string& title, const mriStringVec& varNames,
+                                   const mriIntVec& totals, const mriDoubleVec& zoneTimes, int totSharedVars){
+  this->fileName = fileName;
+  this->totVars = varNames.size();
+  this->totSharedVars = totSharedVars;
+  totZones = zoneTimes.size();
+  totPoints = totals[0]*totals[1]*totals[2];
+  currZone = 0;
+  outFile = fopen(fileName.c_str(),"wb");
+  if(outFile == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+
+  // Version and byte order
+  write("#!TDV112",8);
+  writeInt(1);
+  // Full data file, title and variables
+  writeInt(0);
+  writeString(title);
+  writeInt(totVars);
+  for(int loopA=0;loopA<totVars;loopA++){
+    writeString(varNames[loopA]);
+  }
+
+  // Zones
+  for(int loopA=0;loopA<totZones;loopA++){
+    write(&kTecplotZoneMarker,sizeof(float));
+    writeString("Phase " + to_string(loopA));
+    // No parent zone, all zones in one time strand
+    writeInt(-1);
+    writeInt(1);
+    write(&zoneTimes[loopA],sizeof(double));
+    // Default color, ordered zone, values at the nodes
+    writeInt(-1);
+    writeInt(0);
+    writeInt(0);
+    // No face neighbors
+    writeInt(0);
+    writeInt(0);
+    writeInt(totals[0]);
+    writeInt(totals[1]);
+    writeInt(totals[2]);
+    // No auxiliary data
+    writeInt(0);
+  }
+  write(&kTecplotHeaderMarker,sizeof(float));
+}
+
+// ==========
+// DESTRUCTOR
+// ==========
+mriTecplotWriter::~mriTecplotWriter(){
+  if(outFile != NULL){
+    fclose(outFile);
+  }
+}
+
+// ==========
+// WRITE DATA
+// ==========
+void mriTecplotWriter::write(const void* data, size_t size){
+  if(fwrite(data,1,size,outFile) != size){
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+}
+
+// =============
+// WRITE INTEGER
+// =============
+void mriTecplotWriter::writeInt(int32_t value){
+  write(&value,sizeof(int32_t));
+}
+
+// ============
+// WRITE STRING
+// ============
+// One integer per character, terminated by zero
+void mriTecplotWriter::writeString(const string& text){
+  vector<int32_t> chars(text.begin(),text.end());
+  chars.push_back(0);
+  write(chars.data(),chars.size()*sizeof(int32_t));
+}
+
+// ==========
+// WRITE ZONE
+// ==========
+void mriTecplotWriter::writeZone(const vector<const float*>& values){
+  if(currZone >= totZones){
+    throw mriException(string("ERROR: Too many zones written to " + fileName + ".\n").c_str());
+  }
+  if((int)values.size() != totVars){
+    throw mriException(string("ERROR: Variables of a zone do not match the header of " + fileName + ".\n").c_str());
+  }
+  int firstVar = (currZone == 0) ? 0 : totSharedVars;
+
+  // Single precision values, not passive
+  write(&kTecplotZoneMarker,sizeof(float));
+  for(int loopA=0;loopA<totVars;loopA++){
+    writeInt(1);
+  }
+  writeInt(0);
+  // Variables shared with the first zone
+  if(currZone == 0){
+    writeInt(0);
+  }else{
+    writeInt(1);
+    for(int loopA=0;loopA<totVars;loopA++){
+      writeInt((loopA < totSharedVars) ? 0 : -1);
+    }
+  }
+  // No shared connectivity
+  writeInt(-1);
+
+  // Range of the stored variables
+  for(int loopA=firstVar;loopA<totVars;loopA++){
+    double range[2] = {0.0,0.0};
+    if(totPoints > 0){
+      std::pair<const float*,const float*> limits = std::minmax_element(values[loopA],values[loopA] + totPoints);
+      range[0] = *limits.first;
+      range[1] = *limits.second;
+    }
+    write(range,sizeof(range));
+  }
+
+  // Values, one block per variable
+  for(int loopA=firstVar;loopA<totVars;loopA++){
+    write(values[loopA],totPoints*sizeof(float));
+  }
+  currZone++;
+}
+
+// ==========
+// CLOSE FILE
+// ==========
+void mriTecplotWriter::close(){
+  if(currZone != totZones){
+    throw mriException(string("ERROR: Missing zones in " + fileName + ".\n").c_str());
+  }
+  if(fclose(outFile) != 0){
+    outFile = NULL;
+    throw mriException(string("ERROR: Cannot write to file " + fileName + ".\n").c_str());
+  }
+  outFile = NULL;
+}
@@ -0,0 +1,54 @@
+#ifndef MRITECPLOTWRITER_H
+#define MRITECPLOTWRITER_H
+
+# include <stdio.h>
+# include <stdint.h>
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Markers of the binary data file
+const float kTecplotZoneMarker   = 299.0f;
+const float kTecplotHeaderMarker = 357.0f;
+
+// ======================================
+// TECPLOT BINARY FILE WITH ORDERED ZONES
+// ======================================
+// Writes a version 112 binary data file. The header lists the variables
+// and every zone, the zones are then written in order in block format
+// with one bulk write per variable. The first totSharedVars variables are
+// only stored with the first zone, the other zones share them.
+class mriTecplotWriter{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    mriTecplotWriter(string fileName, const string& title, const mriStringVec& varNames,
+                     const mriIntVec& totals, const mriDoubleVec& zoneTimes, int totSharedVars);
+    ~mriTecplotWriter();
+
+    // MEMBER FUNCTIONS
+    // values[v] has all points of variable v, shared variables are only
+    // read for the first zone
+    void writeZone(const vector<const float*>& values);
+    void close();
+
+  private:
+    string fileName;
+    FILE* outFile;
+    int totVars;
+    int totSharedVars;
+    int totZones;
+    int totPoints;
+    int currZone;
+    void write(const void* data, size_t size);
+    void writeInt(int32_t value);
+    void writeString(const string& text);
+    // Not copyable
+    mriTecplotWriter(const mriTecplotWriter&);
+    mriTecplotWriter& operator=(const mriTecplotWriter&);
+};
+
+#endif // MRITECPLOTWRITER_H
@@ -8,31 +8,31 @@ void mriScan::assignStagnationFlowSignature(mriDirection dir){
   double xCoord,yCoord,zCoord;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Set to Zero
-    cells[loopA].concentration = 0.0;
+    cells.conc[loopA] = 0.0;
     switch(dir){
       case kdirX:
         yCoord = topology->cellLocations[loopA][1] - topology->domainSizeMin[1];
         zCoord = topology->cellLocations[loopA][2] - 0.5*(topology->domainSizeMin[2]+topology->domainSizeMax[2]);
-        cells[loopA].velocity[0] = 0.0;
-        cells[loopA].velocity[1] = -bConst * yCoord;
-        cells[loopA].velocity[2] = bConst * zCoord;
+        cells.vx[loopA] = 0.0;
+        cells.vy[loopA] = -bConst * yCoord;
+        cells.vz[loopA] = bConst * zCoord;
         break;
       case kdirY:
         xCoord = topology->cellLocations[loopA][0] - topology->domainSizeMin[0];
         zCoord = topology->cellLocations[loopA][2]- 0.5 * (topology->domainSizeMin[2] + topology->domainSizeMax[2]);
-        cells[loopA].velocity[0] = bConst * xCoord;
-        cells[loopA].velocity[1] = 0.0;
-        cells[loopA].velocity[2] = -bConst * zCoord;
+        cells.vx[loopA] = bConst * xCoord;
+        cells.vy[loopA] = 0.0;
+        cells.vz[loopA] = -bConst * zCoord;
         break;
       case kdirZ:
         xCoord = topology->cellLocations[loopA][0] - topology->domainSizeMin[0];
         yCoord = topology->cellLocations[loopA][1] - 0.5 * (topology->domainSizeMin[1] + topology->domainSizeMax[1]);
-        cells[loopA].velocity[0] = bConst * xCoord;
-        cells[loopA].velocity[1] = -bConst * yCoord;
-        cells[loopA].velocity[2] = 0.0;
+        cells.vx[loopA] = bConst * xCoord;
+        cells.vy[loopA] = -bConst * yCoord;
+        cells.vz[loopA] = 0.0;
         break;
     }
-    cells[loopA].concentration = 1.0;
+    cells.conc[loopA] = 1.0;
   }
 }
 
@@ -112,12 +112,12 @@ void mriScan::assignCylindricalFlowSignature(mriDirection dir){
     evalTangentDirection(dir,radialVector,tangVector);
     // Set Velocities    
     if ((currRadius>=minRadius)&&(currRadius<=maxRadius)){
-      cells[loopA].velocity[0] = tangVector[0]*velMod;
-      cells[loopA].velocity[1] = tangVector[1]*velMod;
-      cells[loopA].velocity[2] = tangVector[2]*velMod;
-      cells[loopA].concentration = 1.0;
+      cells.vx[loopA] = tangVector[0]*velMod;
+      cells.vy[loopA] = tangVector[1]*velMod;
+      cells.vz[loopA] = tangVector[2]*velMod;
+      cells.conc[loopA] = 1.0;
     }else{
-      cells[loopA].concentration = 0.0;
+      cells.conc[loopA] = 0.0;
     }
   }  
 }
@@ -200,7 +200,7 @@ void mriScan::assignSphericalFlowSignature(mriDirection dir){
         break;
     }
     // Assign Concentration
-    cells[loopA].concentration = 1.0;
+    cells.conc[loopA] = 1.0;
     // Normalize Radial Direction
     axialComponentIn = (3.0/2.0)*CONST_U0*(1.0-((2.0*localR*localR+localZ*localZ)/(CONST_A*CONST_A)));
     radialComponentIn = (3.0/2.0)*CONST_U0*((localR*localZ)/(CONST_A*CONST_A));
@@ -209,18 +209,18 @@ void mriScan::assignSphericalFlowSignature(mriDirection dir){
     // Set The Vector Components
     if (localR*localR+localZ*localZ<=CONST_A*CONST_A){
       // Set a Zero Concentration
-      cells[loopA].concentration = 1.0;
+      cells.conc[loopA] = 1.0;
       // Set Velocities      
-      cells[loopA].velocity[0] = axialComponentIn * axialVec[0] + radialComponentIn * radialVec[0];
-      cells[loopA].velocity[1] = axialComponentIn * axialVec[1] + radialComponentIn * radialVec[1];
-      cells[loopA].velocity[2] = axialComponentIn * axialVec[2] + radialComponentIn * radialVec[2];
+      cells.vx[loopA] = axialComponentIn * axialVec[0] + radialComponentIn * radialVec[0];
+      cells.vy[loopA] = axialComponentIn * axialVec[1] + radialComponentIn * radialVec[1];
+      cells.vz[loopA] = axialComponentIn * axialVec[2] + radialComponentIn * radialVec[2];
     }else{
       // Set a Zero Concentration
-      cells[loopA].concentration = 0.0;
+      cells.conc[loopA] = 0.0;
       // Set Velocities
-      cells[loopA].velocity[0] = 0.0;
-      cells[loopA].velocity[1] = 0.0;
-      cells[loopA].velocity[2] = 0.0;
+      cells.vx[loopA] = 0.0;
+      cells.vy[loopA] = 0.0;
+      cells.vz[loopA] = 0.0;
       //cellPoints[loopA].velocity[0] = axialComponentOut * axialVec[0] + radialComponentOut * radialVec[0];
       //cellPoints[loopA].velocity[1] = axialComponentOut * axialVec[1] + radialComponentOut * radialVec[1];
       //cellPoints[loopA].velocity[2] = axialComponentOut * axialVec[2] + radialComponentOut * radialVec[2];     
@@ -258,7 +258,7 @@ void mriScan::assignToroidalVortexFlowSignature(){
     currentZ = topology->cellLocations[loopA][2] - centrePoint[2];
     
     // Set a Zero Concentration
-    cells[loopA].concentration = 1.0;
+    cells.conc[loopA] = 1.0;
     
     // Build Axial Vector
     axialVec[0] = 1.0;
@@ -293,9 +293,9 @@ void mriScan::assignToroidalVortexFlowSignature(){
     currModulus = (8.0*radius/CONST_L)*exp(-(radius/CONST_L));
       
     // Normalize Radial Direction
-    cells[loopA].velocity[0] = currModulus * velVector[0];
-    cells[loopA].velocity[1] = currModulus * velVector[1];
-    cells[loopA].velocity[2] = currModulus * velVector[2];
+    cells.vx[loopA] = currModulus * velVector[0];
+    cells.vy[loopA] = currModulus * velVector[1];
+    cells.vz[loopA] = currModulus * velVector[2];
   }
 }
 
@@ -304,19 +304,19 @@ void mriScan::assignConstantSignature(mriDirection dir){
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     switch(dir){
       case kdirX:
-        cells[loopA].velocity[0] = 1.0;
-        cells[loopA].velocity[1] = 0.0;
-        cells[loopA].velocity[2] = 0.0;
+        cells.vx[loopA] = 1.0;
+        cells.vy[loopA] = 0.0;
+        cells.vz[loopA] = 0.0;
         break;
       case kdirY:
-        cells[loopA].velocity[0] = 0.0;
-        cells[loopA].velocity[1] = 1.0;
-        cells[loopA].velocity[2] = 0.0;
+        cells.vx[loopA] = 0.0;
+        cells.vy[loopA] = 1.0;
+        cells.vz[loopA] = 0.0;
         break;
       case kdirZ:
-        cells[loopA].velocity[0] = 0.0;
-        cells[loopA].velocity[1] = 0.0;
-        cells[loopA].velocity[2] = 1.0;
+        cells.vx[loopA] = 0.0;
+        cells.vy[loopA] = 0.0;
+        cells.vz[loopA] = 1.0;
         break;
     }
   }
@@ -337,22 +337,22 @@ void mriScan::assignTaylorVortexSignature(mriDirection dir){
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     switch(dir){
       case kdirX:
-        cells[loopA].velocity[0] = 0.0;
-        cells[loopA].velocity[1] = topology->cellLocations[loopA][2]-centrePoint[2];
-        cells[loopA].velocity[2] = -(topology->cellLocations[loopA][1]-centrePoint[1]);
+        cells.vx[loopA] = 0.0;
+        cells.vy[loopA] = topology->cellLocations[loopA][2]-centrePoint[2];
+        cells.vz[loopA] = -(topology->cellLocations[loopA][1]-centrePoint[1]);
         break;
       case kdirY:
-        cells[loopA].velocity[0] = topology->cellLocations[loopA][2]-centrePoint[2];
-        cells[loopA].velocity[1] = 0.0;
-        cells[loopA].velocity[2] = -(topology->cellLocations[loopA][0]-centrePoint[0]);
+        cells.vx[loopA] = topology->cellLocations[loopA][2]-centrePoint[2];
+        cells.vy[loopA] = 0.0;
+        cells.vz[loopA] = -(topology->cellLocations[loopA][0]-centrePoint[0]);
         break;
       case kdirZ:
-        cells[loopA].velocity[0] = topology->cellLocations[loopA][1]-centrePoint[1];
-        cells[loopA].velocity[1] = -(topology->cellLocations[loopA][0]-centrePoint[0]);
-        cells[loopA].velocity[2] = 0.0;
+        cells.vx[loopA] = topology->cellLocations[loopA][1]-centrePoint[1];
+        cells.vy[loopA] = -(topology->cellLocations[loopA][0]-centrePoint[0]);
+        cells.vz[loopA] = 0.0;
         break;
     }
-    cells[loopA].concentration = 1.0;
+    cells.conc[loopA] = 1.0;
   }
 }
 
@@ -360,9 +360,9 @@ void mriScan::assignTaylorVortexSignature(mriDirection dir){
 // SET VELOCITIES TO ZERO
 void mriScan::assignZeroVelocities(){
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    cells[loopA].velocity[0] = 0.0;
-    cells[loopA].velocity[1] = 0.0;
-    cells[loopA].velocity[2] = 0.0;
+    cells.vx[loopA] = 0.0;
+    cells.vy[loopA] = 0.0;
+    cells.vz[loopA] = 0.0;
   }
 }
 
@@ -372,16 +372,16 @@ void mriScan::assignConstantFlowWithStep(){
     if ((topology->cellLocations[loopA][0] > (0.5*(topology->domainSizeMin[0] + topology->domainSizeMax[0])))&&
        (topology->cellLocations[loopA][1] > (0.5*(topology->domainSizeMin[1] + topology->domainSizeMax[1])))){
       // Assign Constant Velocity
-      cells[loopA].concentration = 0.0;
-      cells[loopA].velocity[0] = 0.0;
-      cells[loopA].velocity[1] = 0.0;
-      cells[loopA].velocity[2] = 0.0;         
+      cells.conc[loopA] = 0.0;
+      cells.vx[loopA] = 0.0;
+      cells.vy[loopA] = 0.0;
+      cells.vz[loopA] = 0.0;         
     }else{
       // Assign Constant Velocity
-      cells[loopA].concentration = 10.0;
-      cells[loopA].velocity[0] = 1.0;
-      cells[loopA].velocity[1] = 0.0;
-      cells[loopA].velocity[2] = 0.0;
+      cells.conc[loopA] = 10.0;
+      cells.vx[loopA] = 1.0;
+      cells.vy[loopA] = 0.0;
+      cells.vz[loopA] = 0.0;
     }
   }
 }
@@ -390,10 +390,10 @@ void mriScan::assignConstantFlowWithStep(){
 void mriScan::assignRandomStandardGaussianFlow(){
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     // Assign Constant Velocity
-    cells[loopA].concentration = 10.0;
-    cells[loopA].velocity[0] = 1.0;
-    cells[loopA].velocity[1] = 0.0;
-    cells[loopA].velocity[2] = 0.0;
+    cells.conc[loopA] = 10.0;
+    cells.vx[loopA] = 1.0;
+    cells.vy[loopA] = 0.0;
+    cells.vz[loopA] = 0.0;
   }
 }
 
@@ -413,10 +413,10 @@ void mriScan::assignPoiseuilleSignature(mriDirection dir, const mriDoubleVec& au
   for(int loopA=0;loopA<topology->totalCells;loopA++){
     double currentDistance = 0.0;
     // Set to Zero
-    cells[loopA].velocity[0]   = 0.0;
-    cells[loopA].velocity[1]   = 0.0;
-    cells[loopA].velocity[2]   = 0.0;
-    cells[loopA].concentration = 0.0;
+    cells.vx[loopA]   = 0.0;
+    cells.vy[loopA]   = 0.0;
+    cells.vz[loopA]   = 0.0;
+    cells.conc[loopA] = 0.0;
     switch(dir){
       case kdirX:
         currentDistance = sqrt((topology->cellLocations[loopA][1] - centerPoint[1])*(topology->cellLocations[loopA][1] - centerPoint[1]) +
@@ -440,16 +440,16 @@ void mriScan::assignPoiseuilleSignature(mriDirection dir, const mriDoubleVec& au
       conc = 1.0e-10;
     }
     // Assign Velocity
-    cells[loopA].concentration = conc;
+    cells.conc[loopA] = conc;
     switch(dir){
       case kdirX: 
-        cells[loopA].velocity[0] = currentVelocity;
+        cells.vx[loopA] = currentVelocity;
         break;
       case kdirY: 
-        cells[loopA].velocity[1] = currentVelocity;
+        cells.vy[loopA] = currentVelocity;
         break;
       case kdirZ: 
-        cells[loopA].velocity[2] = currentVelocity;
+        cells.vz[loopA] = currentVelocity;
         break;
     }
   }
@@ -532,22 +532,19 @@ void mriScan::createFromTemplate(mriTemplateType sampleType,const mriDoubleVec&
 
   //Allocate Based on the Topology
   cells.clear();
-
-  mriCell cell;
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    cells.push_back(cell);
-  }
+  cells.resize(topology->totalCells);
 
   // Assign Concentrations and Velocities
   assignVelocitySignature(dir,sampleType,currTime,auxParams);
+  cells.markModified();
 
   // Find Velocity Modulus
   maxVelModule = 0.0;
   double currentMod = 0.0;
   for(int loopA=0;loopA<topology->totalCells;loopA++){
-    currentMod = sqrt((cells[loopA].velocity[0])*(cells[loopA].velocity[0])+
-                      (cells[loopA].velocity[1])*(cells[loopA].velocity[1])+
-                      (cells[loopA].velocity[2])*(cells[loopA].velocity[2]));
+    currentMod = sqrt((cells.vx[loopA])*(cells.vx[loopA])+
+                      (cells.vy[loopA])*(cells.vy[loopA])+
+                      (cells.vz[loopA])*(cells.vz[loopA]));
     if(currentMod>maxVelModule) maxVelModule = currentMod;
   }
 }
@@ -580,18 +577,18 @@ void mriScan::assignTimeDependentPoiseilleSignature(double omega, double radius,
     double peakVel = 4.0;
     if (normRadius<=1.0){
       if (normRadius>kMathZero){
-        cells[loopA].velocity[0] = maxVel*((peakVel/omegaMod)*(sin(omega*currtime)-((exp(-bValue))/(sqrt(normRadius)))*sin(omega*currtime-bValue)));
+        cells.vx[loopA] = maxVel*((peakVel/omegaMod)*(sin(omega*currtime)-((exp(-bValue))/(sqrt(normRadius)))*sin(omega*currtime-bValue)));
       }else{
-        cells[loopA].velocity[0] = maxVel*((peakVel/omegaMod)*(sin(omega*currtime)));
+        cells.vx[loopA] = maxVel*((peakVel/omegaMod)*(sin(omega*currtime)));
       }
-      cells[loopA].velocity[1] = 0.0;
-      cells[loopA].velocity[2] = 0.0;
-      cells[loopA].concentration = 1.0;
+      cells.vy[loopA] = 0.0;
+      cells.vz[loopA] = 0.0;
+      cells.conc[loopA] = 1.0;
     }else{
-      cells[loopA].velocity[0] = 0.0;
-      cells[loopA].velocity[1] = 0.0;
-      cells[loopA].velocity[2] = 0.0;
-      cells[loopA].concentration = 0.0;
+      cells.vx[loopA] = 0.0;
+      cells.vy[loopA] = 0.0;
+      cells.vz[loopA] = 0.0;
+      cells.conc[loopA] = 0.0;
     }
   }
 }
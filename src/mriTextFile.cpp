@@ -0,0 +1,222 @@
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "mriTextFile.h"
+#include "mriParallel.h"
+
+// Powers of ten that are exact in double precision
+static const double kExactPowersOfTen[] = {1.0e0,1.0e1,1.0e2,1.0e3,1.0e4,1.0e5,1.0e6,1.0e7,1.0e8,1.0e9,1.0e10,
+                                           1.0e11,1.0e12,1.0e13,1.0e14,1.0e15,1.0e16,1.0e17,1.0e18,1.0e19,1.0e20,
+                                           1.0e21,1.0e22};
+
+// ==============================
+// PARSE NUMBER WITH LIBC STRTOD
+// ==============================
+static double parseTextDoubleWithStrtod(const char* begin, const char* end){
+  char buffer[64];
+  size_t length = end - begin;
+  if(length >= sizeof(buffer)){
+    throw mriException("ERROR: Invalid number in text file.\n");
+  }
+  memcpy(buffer,begin,length);
+  buffer[length] = '\0';
+  char* stop = NULL;
+  double value = strtod(buffer,&stop);
+  if((length == 0)||(stop != buffer + length)){
+    throw mriException("ERROR: Invalid number in text file.\n");
+  }
+  return value;
+}
+
+// ======================
+// PARSE NUMBER FROM TEXT
+// ======================
+// Numbers with up to 19 significant digits and a mantissa below 2^53 times
+// a power of ten up to 22 are converted with one exact operation, which is
+// correctly rounded. All other numbers fall back to strtod.
+double parseTextDouble(const char* begin, const char* end){
+  const char* ptr = begin;
+  bool isNegative = false;
+  if((ptr < end)&&((*ptr == '-')||(*ptr == '+'))){
+    isNegative = (*ptr == '-');
+    ptr++;
+  }
+  unsigned long long mantissa = 0;
+  int totDigits = 0;
+  int exponent = 0;
+  bool hasDigits = false;
+  // Integer part
+  while((ptr < end)&&(*ptr >= '0')&&(*ptr <= '9')){
+    mantissa = mantissa*10 + (*ptr - '0');
+    if(mantissa > 0){
+      totDigits++;
+    }
+    hasDigits = true;
+    ptr++;
+  }
+  // Fractional part
+  if((ptr < end)&&(*ptr == '.')){
+    ptr++;
+    while((ptr < end)&&(*ptr >= '0')&&(*ptr <= '9')){
+      mantissa = mantissa*10 + (*ptr - '0');
+      if(mantissa > 0){
+        totDigits++;
+      }
+      exponent--;
+      hasDigits = true;
+      ptr++;
+    }
+  }
+  // Exponent
+  if(hasDigits&&(ptr < end)&&((*ptr == 'e')||(*ptr == 'E'))){
+    ptr++;
+    bool isNegativeExp = false;
+    if((ptr < end)&&((*ptr == '-')||(*ptr == '+'))){
+      isNegativeExp = (*ptr == '-');
+      ptr++;
+    }
+    int expValue = 0;
+    bool hasExpDigits = false;
+    while((ptr < end)&&(*ptr >= '0')&&(*ptr <= '9')&&(expValue < 10000)){
+      expValue = expValue*10 + (*ptr - '0');
+      hasExpDigits = true;
+      ptr++;
+    }
+    if(!hasExpDigits){
+      return parseTextDoubleWithStrtod(begin,end);
+    }
+    exponent += isNegativeExp ? -expValue : expValue;
+  }
+  if((!hasDigits)||(ptr != end)||(totDigits > 19)){
+    return parseTextDoubleWithStrtod(begin,end);
+  }
+  double value = 0.0;
+  if(mantissa == 0){
+    value = 0.0;
+  }else if((mantissa <= (1ULL << 53))&&(exponent >= -22)&&(exponent <= 22)){
+    value = (double)mantissa;
+    if(exponent < 0){
+      value /= kExactPowersOfTen[-exponent];
+    }else{
+      value *= kExactPowersOfTen[exponent];
+    }
+  }else{
+    return parseTextDoubleWithStrtod(begin,end);
+  }
+  return isNegative ? -value : value;
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriMappedFile::mriMappedFile(string fileName, bool isSequential){
+  data = NULL;
+  fileSize = 0;
+  int fileDesc = open(fileName.c_str(),O_RDONLY);
+  if(fileDesc < 0){
+    throw mriException(string("ERROR: Cannot open file " + fileName + ".\n").c_str());
+  }
+  struct stat fileInfo;
+  if(fstat(fileDesc,&fileInfo) != 0){
+    close(fileDesc);
+    throw mriException(string("ERROR: Cannot read size of file " + fileName + ".\n").c_str());
+  }
+  fileSize = fileInfo.st_size;
+  if(fileSize > 0){
+    void* mapped = mmap(NULL,fileSize,PROT_READ,MAP_PRIVATE,fileDesc,0);
+    if(mapped == MAP_FAILED){
+      close(fileDesc);
+      throw mriException(string("ERROR: Cannot map file " + fileName + ".\n").c_str());
+    }
+    madvise(mapped,fileSize,isSequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+    data = (const char*)mapped;
+  }
+  close(fileDesc);
+}
+
+// ==========
+// DESTRUCTOR
+// ==========
+mriMappedFile::~mriMappedFile(){
+  if(data != NULL){
+    munmap((void*)data,fileSize);
+  }
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriTextBlock::mriTextBlock(const char* begin, const char* end){
+  // Chunks end on a separator so that numbers are never split
+  chunkStart.push_back(begin);
+  const char* ptr = begin;
+  while((size_t)(end - ptr) > kTextChunkSize){
+    ptr += kTextChunkSize;
+    while((ptr < end)&&(!isTextSeparator(*ptr))){
+      ptr++;
+    }
+    if(ptr < end){
+      chunkStart.push_back(ptr);
+    }
+  }
+  chunkStart.push_back(end);
+  // Count the numbers in every chunk
+  int totChunks = chunkStart.size() - 1;
+  chunkOffset.assign(totChunks + 1,0);
+  mriParallel::parallelFor(totChunks,1,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      size_t count = 0;
+      bool inNumber = false;
+      for(const char* curr=chunkStart[loopA];curr<chunkStart[loopA+1];curr++){
+        bool isSep = isTextSeparator(*curr);
+        if((!isSep)&&(!inNumber)){
+          count++;
+        }
+        inNumber = !isSep;
+      }
+      chunkOffset[loopA+1] = count;
+    }
+  });
+  for(int loopA=0;loopA<totChunks;loopA++){
+    chunkOffset[loopA+1] += chunkOffset[loopA];
+  }
+}
+
+// ==========================
+// PARSE ALL NUMBERS IN BLOCK
+// ==========================
+void mriTextBlock::parse(int totComponents, size_t totTuples, double** components) const{
+  if(getTotalValues() > totTuples*totComponents){
+    throw mriException("ERROR: Too many values for the destination in text block.\n");
+  }
+  int totChunks = chunkStart.size() - 1;
+  mriParallel::parallelFor(totChunks,1,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      int currComp = chunkOffset[loopA] % totComponents;
+      size_t currTuple = chunkOffset[loopA] / totComponents;
+      const char* ptr = chunkStart[loopA];
+      const char* chunkEnd = chunkStart[loopA+1];
+      while(true){
+        while((ptr < chunkEnd)&&(isTextSeparator(*ptr))){
+          ptr++;
+        }
+        if(ptr == chunkEnd){
+          break;
+        }
+        const char* numberStart = ptr;
+        while((ptr < chunkEnd)&&(!isTextSeparator(*ptr))){
+          ptr++;
+        }
+        components[currComp][currTuple] = parseTextDouble(numberStart,ptr);
+        currComp++;
+        if(currComp == totComponents){
+          currComp = 0;
+          currTuple++;
+        }
+      }
+    }
+  });
+}
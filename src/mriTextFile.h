@@ -0,0 +1,70 @@
+#ifndef MRITEXTFILE_H
+#define MRITEXTFILE_H
+
+# include <stddef.h>
+# include <string>
+# include <vector>
+
+# include "mriTypes.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Bytes of text parsed by one task, split at the next separator
+const size_t kTextChunkSize = 1 << 20;
+
+// Separators between numbers in ASCII data blocks
+inline bool isTextSeparator(char c){
+  return (c == ' ')||(c == '\n')||(c == '\r')||(c == '\t')||(c == ',');
+}
+
+// Parse the number in [begin,end), same result as strtod
+double parseTextDouble(const char* begin, const char* end);
+
+// ============================
+// READ-ONLY MEMORY-MAPPED FILE
+// ============================
+class mriMappedFile{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    // Read-ahead is tuned for a front to back scan unless isSequential is false
+    mriMappedFile(string fileName, bool isSequential = true);
+    ~mriMappedFile();
+
+    // MEMBER FUNCTIONS
+    const char* begin() const{return data;}
+    const char* end() const{return data + fileSize;}
+    size_t size() const{return fileSize;}
+
+  private:
+    const char* data;
+    size_t fileSize;
+    // Not copyable
+    mriMappedFile(const mriMappedFile&);
+    mriMappedFile& operator=(const mriMappedFile&);
+};
+
+// =================================
+// BLOCK OF NUMBERS IN A TEXT BUFFER
+// =================================
+// The buffer is split in chunks that are counted and parsed on the
+// worker threads, values are written straight to their destination.
+class mriTextBlock{
+  public:
+    // CONSTRUCTOR
+    mriTextBlock(const char* begin, const char* end);
+
+    // MEMBER FUNCTIONS
+    size_t getTotalValues() const{return chunkOffset.back();}
+    // Value i goes to components[i % totComponents][i / totComponents],
+    // throws if the block holds more than totTuples tuples
+    void parse(int totComponents, size_t totTuples, double** components) const;
+
+  private:
+    // Chunk limits, chunk i is [chunkStart[i],chunkStart[i+1])
+    vector<const char*> chunkStart;
+    // Values before each chunk
+    vector<size_t> chunkOffset;
+};
+
+#endif // MRITEXTFILE_H
@@ -32,5 +32,13 @@ bool mriThresholdCriteria::meetsCriteria(double currentValue){
     return false;
   }
 }
+
+// Check If the Criteria Changes When the Velocity Changes
+bool mriThresholdCriteria::dependsOnVelocity(){
+  return (thresholdQty == kQtyVelocityX)||
+         (thresholdQty == kQtyVelocityY)||
+         (thresholdQty == kQtyVelocityZ)||
+         (thresholdQty == kQtyVelModule);
+}
   
 
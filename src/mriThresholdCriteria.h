@@ -16,6 +16,8 @@ public:
   ~mriThresholdCriteria();
   // Data Members
   bool meetsCriteria(double currentValue);
+  // True if the criterion is evaluated on the velocity field
+  bool dependsOnVelocity();
 };
 
 #endif // MRITHRESHOLDCRITERIA_H
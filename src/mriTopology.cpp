@@ -1,4 +1,5 @@
 # include <exception>
+# include <algorithm>
 # include "mriTopology.h"
 
 using namespace std;
@@ -23,150 +24,6 @@ int getLocalAdjacentFace(int localNodeNumber, int totalX, int AdjType){
   return -1;
 }
 
-// ============================
-// READ CELL DATA FROM PLT FILE
-// ============================
-void readCellsFromPLTFile(string pltFileName, 
-                          mriDoubleVec& domainSizeMin, mriDoubleVec& domainSizeMax, 
-                          double& maxVelModule, 
-                          mriDoubleVec& XCoords,
-                          mriDoubleVec& YCoords,
-                          mriDoubleVec& ZCoords,
-                          mriDoubleMat& gridData){
-
-  ifstream pltFile;
-  pltFile.open(pltFileName.c_str());
-
-  // Init Domain Limits
-  domainSizeMin[0] =  std::numeric_limits<double>::max();
-  domainSizeMin[1] =  std::numeric_limits<double>::max();
-  domainSizeMin[2] =  std::numeric_limits<double>::max();
-  domainSizeMax[0] = -std::numeric_limits<double>::max();
-  domainSizeMax[1] = -std::numeric_limits<double>::max();
-  domainSizeMax[2] = -std::numeric_limits<double>::max();  
-
-  // Read Lines
-  string Buffer;
-  int lineCount = 0;
-  mriStringVec resultArray;
-  bool Continue;
-  int valueCounter = 0;
-  int neededValues = 7;
-  mriDoubleVec LocalVal(7);
-  mriDoubleVec TempVal(7);
-  double LocalXCoord   = 0.0;
-  double LocalYCoord   = 0.0;
-  double LocalZCoord   = 0.0;
-  double LocalConc     = 0.0;
-  double LocalXVel     = 0.0;
-  double LocalYVel     = 0.0;
-  double LocalZVel     = 0.0;
-  double CurrentModule = 0.0;
-  mriDoubleVec tmp;
-  while (getline(pltFile,Buffer)){
-    // Read Line
-    lineCount++;
-
-    // Tokenize Line
-    resultArray = mriUtils::extractSubStringFromBufferMS(Buffer);
-    
-    // Store Local Structure
-    try{
-      // Set Continue
-      Continue = true;
-      // Check Ratio between ResultArray.size, valueCounter, neededValues
-      if((int)resultArray.size()+valueCounter < neededValues){
-        // Read the whole Result Array
-        for(size_t loopA=0;loopA<resultArray.size();loopA++){
-          LocalVal[loopA] = stof(resultArray[loopA].c_str());
-        }
-        Continue = false;
-      }else{
-        // Read part of the result array
-        for(int loopA=0;loopA<neededValues-valueCounter;loopA++){
-          LocalVal[loopA] = stof(resultArray[loopA].c_str());
-        }
-        // Put the rest in temporary array
-        for(size_t loopA=0;loopA<resultArray.size()-(neededValues-valueCounter);loopA++){
-          TempVal[loopA] = stof(resultArray[loopA].c_str());
-        }
-        Continue = true;
-        // Coords
-        LocalXCoord = LocalVal[0];
-        LocalYCoord = LocalVal[1];
-        LocalZCoord = LocalVal[2];
-        // Concentration
-        LocalConc = LocalVal[3];
-        // Velocity
-        LocalXVel = LocalVal[4];
-        LocalYVel = LocalVal[5];
-        LocalZVel = LocalVal[6];
-      }
-      Continue = true;
-      // Coords
-      LocalXCoord = LocalVal[0];
-      LocalYCoord = LocalVal[1];
-      LocalZCoord = LocalVal[2];
-      // Concentration
-      LocalConc = LocalVal[3];
-      // Velocity
-      LocalXVel = LocalVal[4];
-      LocalYVel = LocalVal[5];
-      LocalZVel = LocalVal[6];
-      // Update valueCounter
-      valueCounter = ((resultArray.size() + valueCounter) % neededValues);
-      // Check Module
-      CurrentModule = sqrt((LocalXVel * LocalXVel) + (LocalYVel * LocalYVel) + (LocalZVel * LocalZVel));
-      if (CurrentModule>1000.0){
-        throw 20;
-      }
-    }catch(exception& e){
-      //Set Continue
-      Continue = false;
-      //std::string outString = "WARNING[*] Error Reading Line: "+mriUtils::intToStr(lineCount)+"; Line Skipped.\n";
-      //printf("%s",outString.c_str());
-    }
-    if(Continue){
-
-      // Update Limits
-      // Min
-      if (LocalXCoord<domainSizeMin[0]) domainSizeMin[0] = LocalXCoord;
-      if (LocalYCoord<domainSizeMin[1]) domainSizeMin[1] = LocalYCoord;
-      if (LocalZCoord<domainSizeMin[2]) domainSizeMin[2] = LocalZCoord;
-      // Max
-      if (LocalXCoord>domainSizeMax[0]) domainSizeMax[0] = LocalXCoord;
-      if (LocalYCoord>domainSizeMax[1]) domainSizeMax[1] = LocalYCoord;
-      if (LocalZCoord>domainSizeMax[2]) domainSizeMax[2] = LocalZCoord;
-
-      // Update Max Speeds
-      if (CurrentModule>maxVelModule){
-        maxVelModule = CurrentModule;
-      }
-
-      // Store Node Coords To Find Grid Size
-      mriUtils::insertInList(LocalXCoord,XCoords);
-      mriUtils::insertInList(LocalYCoord,YCoords);
-      mriUtils::insertInList(LocalZCoord,ZCoords);
-
-      // Store Velocity/Concentrations
-      tmp.clear();
-      tmp.push_back(LocalXCoord);
-      tmp.push_back(LocalYCoord);
-      tmp.push_back(LocalZCoord);
-      tmp.push_back(LocalConc);
-      tmp.push_back(LocalXVel);
-      tmp.push_back(LocalYVel);
-      tmp.push_back(LocalZVel);
-    
-      // Add to Vector
-      gridData.push_back(tmp);
-
-      // Set Continue
-      Continue = true;
-    }
-  }
-}
-
 // ==========================
 // GET LOCAL FACE CONNECTIONS
 // ==========================
@@ -242,6 +99,7 @@ mriTopology::mriTopology(){
   totalCells = 0;
   cellTotals.resize(3);
   cellLengths.resize(3);
+  geometryVersion = 0;
 }
 
 // CONSTRUCTOR
@@ -252,6 +110,8 @@ mriTopology::mriTopology(const mriIntVec& totals,
                          const mriDoubleVec& minlimits,
                          const mriDoubleVec& maxlimits){
 
+  geometryVersion = 0;
+
   // SET UP SCAN QUANTITIES
   // CELL TOTALS
   cellTotals.resize(3);
@@ -275,6 +135,8 @@ mriTopology::mriTopology(const mriIntVec& totals,
   }
 
   // DIMENSIONS
+  domainSizeMin.resize(3);
+  domainSizeMax.resize(3);
   // MIN
   domainSizeMin[0] = minlimits[0];
   domainSizeMin[1] = minlimits[1];
@@ -286,11 +148,14 @@ mriTopology::mriTopology(const mriIntVec& totals,
 
   // INITIALIZE SCAN
   totalCells = cellTotals[0]*cellTotals[1]*cellTotals[2];
+  buildCoordinateTables();
 
   // INITIALIZE POSITIONS
   mriIntVec intCoords(3,0);
   mriDoubleVec Pos(3,0.0);
+  cellLocations.resize(totalCells);
   for(int loopA=0;loopA<totalCells;loopA++){
+    cellLocations[loopA].resize(3);
     mapIndexToCoords(loopA,intCoords);
     mapCoordsToPosition(intCoords,true,Pos);
     cellLocations[loopA][0] = domainSizeMin[0] + Pos[0];
@@ -519,15 +384,8 @@ void mriTopology::mapIndexToAuxNodeCoords(int index, mriIntVec& intCoords){
 // MAP AUXILIARY INTEGER COORDS TO POSITION
 // ========================================
 void mriTopology::mapAuxCoordsToPosition(const mriIntVec& auxCoords, mriDoubleVec& pos){
-  // Loop on the three dimensions
-  for(int loopA=0;loopA<3;loopA++){
-    pos[loopA] = 0.0;
-    for(int loopB=0;loopB<auxCoords[loopA];loopB++){
-      pos[loopA] += cellLengths[loopA][loopB];
-    }
-  }
   for(int loopA=0;loopA<3;loopA++){
-    pos[loopA] = pos[loopA] + domainSizeMin[loopA] - 0.5*cellLengths[loopA][0];
+    pos[loopA] = nodeOffsets[loopA][auxCoords[loopA]] + domainSizeMin[loopA] - 0.5*cellLengths[loopA][0];
   }
 }
 
@@ -605,6 +463,11 @@ void mriTopology::buildFaceConnections(){
       cellFaces[loopA].push_back(currFace);
     }
   }
+  // First-seen numbering is the canonical one
+  faceCanonical.resize(faceConnections.size());
+  for(size_t loopA=0;loopA<faceConnections.size();loopA++){
+    faceCanonical[loopA] = loopA;
+  }
 }
 
 // =====================
@@ -722,6 +585,11 @@ void mriTopology::buildEdgeConnections(){
       faceEdges[loopA].push_back(currEdge);
     }
   }
+  // First-seen numbering is the canonical one
+  edgeCanonical.resize(edgeConnections.size());
+  for(size_t loopA=0;loopA<edgeConnections.size();loopA++){
+    edgeCanonical[loopA] = loopA;
+  }
 
   // Build edgeFaces
   edgeFaces.resize(edgeConnections.size());
@@ -814,6 +682,144 @@ void mriTopology::buildFaceAreasAndNormals(){
   }
 }
 
+// ==========================================
+// SORT ENTITIES BY MORTON KEY OF THEIR CENTER
+// ==========================================
+void getMortonOrder(mriTopology* topo, const mriIntMat& connections, mriIntVec& newToOld){
+  vector<pair<unsigned long long,int> > keys(connections.size());
+  mriIntVec nodeCoords(3,0);
+  int center[3] = {0,0,0};
+  for(size_t loopA=0;loopA<connections.size();loopA++){
+    center[0] = 0;
+    center[1] = 0;
+    center[2] = 0;
+    for(size_t loopB=0;loopB<connections[loopA].size();loopB++){
+      topo->mapIndexToAuxNodeCoords(connections[loopA][loopB],nodeCoords);
+      center[0] += nodeCoords[0];
+      center[1] += nodeCoords[1];
+      center[2] += nodeCoords[2];
+    }
+    // Center on the doubled lattice: exact for faces (4 nodes) and edges (2 nodes)
+    int scale = connections[loopA].size()/2;
+    keys[loopA].first = mriUtils::getMortonKey(center[0]/scale,center[1]/scale,center[2]/scale);
+    keys[loopA].second = loopA;
+  }
+  // Ties are broken by the current number
+  std::sort(keys.begin(),keys.end());
+  newToOld.resize(keys.size());
+  for(size_t loopA=0;loopA<keys.size();loopA++){
+    newToOld[loopA] = keys[loopA].second;
+  }
+}
+
+// =======================================
+// RENUMBER FACES ALONG A Z-ORDER CURVE
+// =======================================
+void mriTopology::renumberFacesMorton(){
+  mriIntVec newToOld;
+  getMortonOrder(this,faceConnections,newToOld);
+  int totFaces = newToOld.size();
+  mriIntVec oldToNew(totFaces);
+  for(int loopA=0;loopA<totFaces;loopA++){
+    oldToNew[newToOld[loopA]] = loopA;
+  }
+  // Permute face-based arrays
+  mriIntMat tmpConnections(totFaces);
+  mriIntMat tmpCells(faceCells.size());
+  mriIntVec tmpCanonical(totFaces);
+  for(int loopA=0;loopA<totFaces;loopA++){
+    tmpConnections[loopA].swap(faceConnections[newToOld[loopA]]);
+    if(!faceCells.empty()){
+      tmpCells[loopA].swap(faceCells[newToOld[loopA]]);
+    }
+    tmpCanonical[loopA] = faceCanonical[newToOld[loopA]];
+  }
+  faceConnections.swap(tmpConnections);
+  faceCells.swap(tmpCells);
+  faceCanonical.swap(tmpCanonical);
+  if(!faceArea.empty()){
+    mriDoubleVec tmpArea(totFaces);
+    mriDoubleMat tmpNormal(totFaces);
+    for(int loopA=0;loopA<totFaces;loopA++){
+      tmpArea[loopA] = faceArea[newToOld[loopA]];
+      tmpNormal[loopA].swap(faceNormal[newToOld[loopA]]);
+    }
+    faceArea.swap(tmpArea);
+    faceNormal.swap(tmpNormal);
+  }
+  // Renumber references to faces
+  for(int loopA=0;loopA<totalCells;loopA++){
+    for(size_t loopB=0;loopB<cellFaces[loopA].size();loopB++){
+      cellFaces[loopA][loopB] = oldToNew[cellFaces[loopA][loopB]];
+    }
+  }
+  if(!faceEdges.empty()){
+    mriIntMat tmpFaceEdges(totFaces);
+    for(int loopA=0;loopA<totFaces;loopA++){
+      tmpFaceEdges[loopA].swap(faceEdges[newToOld[loopA]]);
+    }
+    faceEdges.swap(tmpFaceEdges);
+    for(size_t loopA=0;loopA<edgeFaces.size();loopA++){
+      for(size_t loopB=0;loopB<edgeFaces[loopA].size();loopB++){
+        // Signed one-based face number
+        if(edgeFaces[loopA][loopB] > 0){
+          edgeFaces[loopA][loopB] = oldToNew[edgeFaces[loopA][loopB]-1]+1;
+        }else{
+          edgeFaces[loopA][loopB] = -(oldToNew[-edgeFaces[loopA][loopB]-1]+1);
+        }
+      }
+    }
+  }
+}
+
+// =======================================
+// RENUMBER EDGES ALONG A Z-ORDER CURVE
+// =======================================
+void mriTopology::renumberEdgesMorton(){
+  mriIntVec newToOld;
+  getMortonOrder(this,edgeConnections,newToOld);
+  int totEdges = newToOld.size();
+  mriIntVec oldToNew(totEdges);
+  for(int loopA=0;loopA<totEdges;loopA++){
+    oldToNew[newToOld[loopA]] = loopA;
+  }
+  // Permute edge-based arrays
+  mriIntMat tmpConnections(totEdges);
+  mriIntMat tmpFaces(totEdges);
+  mriIntVec tmpCanonical(totEdges);
+  for(int loopA=0;loopA<totEdges;loopA++){
+    tmpConnections[loopA].swap(edgeConnections[newToOld[loopA]]);
+    tmpFaces[loopA].swap(edgeFaces[newToOld[loopA]]);
+    tmpCanonical[loopA] = edgeCanonical[newToOld[loopA]];
+  }
+  edgeConnections.swap(tmpConnections);
+  edgeFaces.swap(tmpFaces);
+  edgeCanonical.swap(tmpCanonical);
+  // Renumber references to edges
+  for(size_t loopA=0;loopA<faceEdges.size();loopA++){
+    for(size_t loopB=0;loopB<faceEdges[loopA].size();loopB++){
+      faceEdges[loopA][loopB] = oldToNew[faceEdges[loopA][loopB]];
+    }
+  }
+}
+
+// ==========================================
+// GET FIRST-SEEN NUMBER OF A FACE OR AN EDGE
+// ==========================================
+int mriTopology::getCanonicalFace(int faceID){
+  if(faceCanonical.empty()){
+    return faceID;
+  }
+  return faceCanonical[faceID];
+}
+
+int mriTopology::getCanonicalEdge(int edgeID){
+  if(edgeCanonical.empty()){
+    return edgeID;
+  }
+  return edgeCanonical[edgeID];
+}
+
 // ===============
 // SCALE POSITIONS
 // ===============
@@ -824,6 +830,7 @@ void mriTopology::scalePositions(const mriDoubleVec& origin, double factor){
       cellLengths[loopA][loopB] *= factor;
     }
   }
+  buildCoordinateTables();
   // SCALE POSITIONS
   for(int loopA=0;loopA<totalCells;loopA++){
     cellLocations[loopA][0] = origin[0] + (cellLocations[loopA][0] - origin[0]) * factor;
@@ -899,6 +906,114 @@ void mriTopology::crop(const mriDoubleVec& limitBox, mriBoolVec& indexes){
 // Create Grid from VTK Structured Scan Options
 // ============================================
 void mriTopology::createGridFromVTKStructuredPoints(const vtkStructuredPointsOptionRecord& opts){
+  setSizesFromVTKStructuredPoints(opts);
+  cellLocations.resize(totalCells);
+  for(int loopA=0;loopA<totalCells;loopA++){
+    cellLocations[loopA].resize(3);
+  }
+  buildCoordinateTables();
+  // Allocate the cells
+  //cellPoints.reserve(totalCellPoints);
+  int count = 0;
+  // Fill the position vectors
+  double locCoordX = opts.origin[0];
+  double locCoordY = opts.origin[1];
+  double locCoordZ = opts.origin[2];
+  for(int loopA=0;loopA<cellTotals[2];loopA++){
+    locCoordY = opts.origin[1];
+    for(int loopB=0;loopB<cellTotals[1];loopB++){
+      locCoordX = opts.origin[0];
+      for(int loopC=0;loopC<cellTotals[0];loopC++){
+        // Set Cell positions
+        cellLocations[count][0] = locCoordX;
+        cellLocations[count][1] = locCoordY;
+        cellLocations[count][2] = locCoordZ;
+        count++;
+        locCoordX += opts.spacing[0];
+      }
+      locCoordY += opts.spacing[1];
+    }
+    locCoordZ += opts.spacing[2];
+  }
+}
+
+// ===================================================
+// Create Grid from VTK Rectilinear Center Coordinates
+// ===================================================
+void mriTopology::createGridFromVTKRectilinearGrid(const mriDoubleMat& axisCoords){
+  setSizesFromVTKRectilinearGrid(axisCoords);
+  buildCoordinateTables();
+  // Fill the position vectors
+  cellLocations.resize(totalCells);
+  int count = 0;
+  for(int loopA=0;loopA<cellTotals[2];loopA++){
+    for(int loopB=0;loopB<cellTotals[1];loopB++){
+      for(int loopC=0;loopC<cellTotals[0];loopC++){
+        cellLocations[count].resize(3);
+        cellLocations[count][0] = axisCoords[0][loopC];
+        cellLocations[count][1] = axisCoords[1][loopB];
+        cellLocations[count][2] = axisCoords[2][loopA];
+        count++;
+      }
+    }
+  }
+}
+
+// =========================================
+// CREATE GRID FROM AXIS LENGTHS AND CENTERS
+// =========================================
+void mriTopology::createGridFromAxes(const mriDoubleMat& lengths,
+                                     const mriDoubleVec& minLimits,
+                                     const mriDoubleVec& maxLimits,
+                                     const mriDoubleMat& axisCoords){
+  cellTotals.resize(3);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    cellTotals[loopA] = axisCoords[loopA].size();
+  }
+  totalCells = cellTotals[0] * cellTotals[1] * cellTotals[2];
+  cellLengths = lengths;
+  domainSizeMin = minLimits;
+  domainSizeMax = maxLimits;
+  buildCoordinateTables();
+  cellLocations.resize(totalCells);
+  int count = 0;
+  for(int loopA=0;loopA<cellTotals[2];loopA++){
+    for(int loopB=0;loopB<cellTotals[1];loopB++){
+      for(int loopC=0;loopC<cellTotals[0];loopC++){
+        cellLocations[count].resize(3);
+        cellLocations[count][0] = axisCoords[0][loopC];
+        cellLocations[count][1] = axisCoords[1][loopB];
+        cellLocations[count][2] = axisCoords[2][loopA];
+        count++;
+      }
+    }
+  }
+}
+
+// ===========================
+// GET CELL CENTERS ALONG AXES
+// ===========================
+// Taken from the cell locations, so the grid is rebuilt exactly
+void mriTopology::getAxisCoords(mriDoubleMat& axisCoords){
+  axisCoords.resize(kNumberOfDimensions);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    axisCoords[loopA].resize(cellTotals[loopA]);
+  }
+  for(int loopA=0;loopA<cellTotals[0];loopA++){
+    axisCoords[0][loopA] = cellLocations[mapCoordsToIndex(loopA,0,0)][0];
+  }
+  for(int loopA=0;loopA<cellTotals[1];loopA++){
+    axisCoords[1][loopA] = cellLocations[mapCoordsToIndex(0,loopA,0)][1];
+  }
+  for(int loopA=0;loopA<cellTotals[2];loopA++){
+    axisCoords[2][loopA] = cellLocations[mapCoordsToIndex(0,0,loopA)][2];
+  }
+}
+
+// =====================================
+// GRID SIZES FROM VTK STRUCTURED POINTS
+// =====================================
+void mriTopology::setSizesFromVTKStructuredPoints(const vtkStructuredPointsOptionRecord& opts){
   // Assign cell totals
   cellTotals.resize(3);
   cellTotals[0] = opts.dimensions[0];
@@ -906,10 +1021,6 @@ void mriTopology::createGridFromVTKStructuredPoints(const vtkStructuredPointsOpt
   cellTotals[2] = opts.dimensions[2];
   // Assign total number of cells
   totalCells = cellTotals[0] * cellTotals[1] * cellTotals[2];
-  cellLocations.resize(totalCells);
-  for(int loopA=0;loopA<totalCells;loopA++){
-    cellLocations[loopA].resize(3);
-  }
   // Assign Cell spacing
   cellLengths.resize(3);
   cellLengths[0].resize(cellTotals[0]);
@@ -935,28 +1046,50 @@ void mriTopology::createGridFromVTKStructuredPoints(const vtkStructuredPointsOpt
   domainSizeMax[0] = opts.origin[0] + (opts.dimensions[0]-1) * opts.spacing[0];
   domainSizeMax[1] = opts.origin[1] + (opts.dimensions[1]-1) * opts.spacing[1];
   domainSizeMax[2] = opts.origin[2] + (opts.dimensions[2]-1) * opts.spacing[2];
-  // Allocate the cells
-  //cellPoints.reserve(totalCellPoints);
-  int count = 0;
-  // Fill the position vectors
-  double locCoordX = opts.origin[0];
-  double locCoordY = opts.origin[1];
-  double locCoordZ = opts.origin[2];
-  for(int loopA=0;loopA<cellTotals[2];loopA++){
-    locCoordY = opts.origin[1];
-    for(int loopB=0;loopB<cellTotals[1];loopB++){
-      locCoordX = opts.origin[0];
-      for(int loopC=0;loopC<cellTotals[0];loopC++){
-        // Set Cell positions
-        cellLocations[count][0] = locCoordX;
-        cellLocations[count][1] = locCoordY;
-        cellLocations[count][2] = locCoordZ;
-        count++;
-        locCoordX += opts.spacing[0];
+}
+
+// ====================================
+// GRID SIZES FROM VTK RECTILINEAR GRID
+// ====================================
+void mriTopology::setSizesFromVTKRectilinearGrid(const mriDoubleMat& axisCoords){
+  // Assign cell totals
+  cellTotals.resize(3);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    cellTotals[loopA] = axisCoords[loopA].size();
+  }
+  totalCells = cellTotals[0] * cellTotals[1] * cellTotals[2];
+  // Lengths whose half sums give back the center distances, as written by
+  // exportToVTK. If some length is not positive the cell faces are placed
+  // halfway between the centers instead.
+  cellLengths.resize(3);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    const mriDoubleVec& coords = axisCoords[loopA];
+    mriDoubleVec& lengths = cellLengths[loopA];
+    int totCoords = coords.size();
+    lengths.resize(totCoords);
+    if(totCoords == 1){
+      lengths[0] = 1.0;
+      continue;
+    }
+    lengths[0] = coords[1] - coords[0];
+    bool isPositive = (lengths[0] > 0.0);
+    for(int loopB=1;loopB<totCoords;loopB++){
+      lengths[loopB] = 2.0*(coords[loopB] - coords[loopB-1]) - lengths[loopB-1];
+      isPositive = isPositive && (lengths[loopB] > 0.0);
+    }
+    if(!isPositive){
+      for(int loopB=1;loopB<totCoords-1;loopB++){
+        lengths[loopB] = 0.5*(coords[loopB+1] - coords[loopB-1]);
       }
-      locCoordY += opts.spacing[1];
+      lengths[totCoords-1] = coords[totCoords-1] - coords[totCoords-2];
     }
-    locCoordZ += opts.spacing[2];
+  }
+  // Set domain size
+  domainSizeMin.resize(3);
+  domainSizeMax.resize(3);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    domainSizeMin[loopA] = axisCoords[loopA].front();
+    domainSizeMax[loopA] = axisCoords[loopA].back();
   }
 }
 
@@ -1025,6 +1158,11 @@ bool mriTopology::isCompatibleTopology(mriTopology* topo){
   result = result && (cellTotals[1] == topo->cellTotals[1]);
   result = result && (cellTotals[2] == topo->cellTotals[2]);
 
+  // Sizes only, read from a Tecplot header
+  if(cellLengths.empty() || topo->cellLengths.empty()){
+    return result;
+  }
+
   for(int loopA=0;loopA<cellTotals[0];loopA++){
     result = result && (fabs(cellLengths[0][loopA]-topo->cellLengths[0][loopA]) < kMathZero);
   }
@@ -1052,12 +1190,8 @@ bool mriTopology::isCompatibleTopology(mriTopology* topo){
 // MAP INTEGER COORDS TO POSITION
 // ==============================
 void mriTopology::mapCoordsToPosition(const mriIntVec& coords, bool addMeshMinima, mriDoubleVec& pos){
-  // Loop on the three dimensions
   for(int loopA=0;loopA<3;loopA++){
-    pos[loopA] = 0.0;
-    for(int loopB=1;loopB<(coords[loopA]+1);loopB++){
-      pos[loopA] += 0.5*(cellLengths[loopA][loopB-1] + cellLengths[loopA][loopB]);
-    }
+    pos[loopA] = cellCenterOffsets[loopA][coords[loopA]];
   }
   if(addMeshMinima){
     for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
@@ -1066,39 +1200,79 @@ void mriTopology::mapCoordsToPosition(const mriIntVec& coords, bool addMeshMinim
   }
 }
 
-// ============================
-// READ TOPOLOGY FROM ASCII VTK
-// ============================
-void mriTopology::readFromVTK_ASCII(string vtkFileName, vtkStructuredPointsOptionRecord& vtkOptions){
-  // Write Progress
-  writeSchMessage(string("Reading Topology From VTK: ") + vtkFileName + string("\n"));
-
-  // Assign File
-  ifstream vtkFile;
-  vtkFile.open(vtkFileName.c_str());
-
-  // Create and initialize vtkOption Vector
-  initVTKStructuredPointsOptions(vtkOptions);
+// =====================================
+// BUILD CUMULATIVE COORDINATES PER AXIS
+// =====================================
+void mriTopology::buildCoordinateTables(){
+  geometryVersion++;
+  cellCenterOffsets.resize(kNumberOfDimensions);
+  nodeOffsets.resize(kNumberOfDimensions);
+  uniformAxis.resize(kNumberOfDimensions);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    const mriDoubleVec& lengths = cellLengths[loopA];
+    int totLengths = lengths.size();
+    cellCenterOffsets[loopA].assign(totLengths,0.0);
+    nodeOffsets[loopA].assign(totLengths+1,0.0);
+    // Same summation order as the former per-call loops
+    for(int loopB=1;loopB<totLengths;loopB++){
+      cellCenterOffsets[loopA][loopB] = cellCenterOffsets[loopA][loopB-1] + 0.5*(lengths[loopB-1] + lengths[loopB]);
+    }
+    for(int loopB=0;loopB<totLengths;loopB++){
+      nodeOffsets[loopA][loopB+1] = nodeOffsets[loopA][loopB] + lengths[loopB];
+    }
+    uniformAxis[loopA] = true;
+    for(int loopB=1;loopB<totLengths;loopB++){
+      uniformAxis[loopA] = uniformAxis[loopA] && (fabs(lengths[loopB] - lengths[0]) < kMathZero);
+    }
+  }
+}
 
-  // Read Through and look for options
-  mriStringVec tokenizedString;
-  int totalLinesInFile = 0;
-  string Buffer;
-  while(getline(vtkFile,Buffer)){
-    boost::split(tokenizedString, Buffer, boost::is_any_of(" ,"), boost::token_compress_on);
-    // Check if you find options
-    assignVTKOptions(totalLinesInFile,tokenizedString, vtkOptions);
-    // Increase line number
-    totalLinesInFile++;
+// ========================================================
+// COUNT THE NODES ALONG AN AXIS BEFORE A DISTANCE FROM MIN
+// ========================================================
+// Returns the smallest count such that nodeOffsets[dim][count] + tol > distance
+int mriTopology::locateOnAxis(int dim, double distance){
+  const double tol = 1.0e-4;
+  const mriDoubleVec& nodes = nodeOffsets[dim];
+  int last = nodes.size() - 1;
+  int lo = 0;
+  int hi = last;
+  if(uniformAxis[dim] && (cellLengths[dim][0] > 0.0)){
+    // Direct division, then correct for round-off in the cumulative sums
+    double guess = floor((distance - tol)/cellLengths[dim][0]) + 1.0;
+    int count = (int)std::max(0.0,std::min(guess,(double)last));
+    while((count > 0)&&(nodes[count-1] + tol > distance)){
+      count--;
+    }
+    while((count < last)&&(nodes[count] + tol <= distance)){
+      count++;
+    }
+    return count;
   }
+  // Binary search on the node offsets
+  while(lo < hi){
+    int mid = lo + (hi - lo)/2;
+    if(nodes[mid] + tol > distance){
+      hi = mid;
+    }else{
+      lo = mid + 1;
+    }
+  }
+  return lo;
+}
 
-  vtkOptions.dataBlockStart.push_back(totalLinesInFile);
-  vtkOptions.dataBlockType.push_back(0);
-  vtkOptions.dataBlockRead.push_back(false);
+// Check the grid definition and read the rectilinear axis coordinates
+static void readVTKGridHeader(const mriVTKReader& reader, mriDoubleMat& axisCoords){
+  // Options collected by the reader
+  const vtkStructuredPointsOptionRecord& vtkOptions = reader.getOptions();
 
   // CHECK IF ALL PROPERTIES WERE DEFINED
   bool fileOK = true;
   for(int loopA=0;loopA<vtkOptions.numDefined;loopA++){
+    // Rectilinear grids have coordinates instead of origin and spacing
+    if(vtkOptions.isRectilinear && (loopA > 2)){
+      continue;
+    }
     fileOK = fileOK && vtkOptions.isDefined[loopA];
     if(!fileOK){
       printf("ERROR: DEFINITION %d\n",loopA);
@@ -1110,66 +1284,102 @@ void mriTopology::readFromVTK_ASCII(string vtkFileName, vtkStructuredPointsOptio
     exit(1);
   }
 
-  // Creating Grid Geometry from Options
-  createGridFromVTKStructuredPoints(vtkOptions);
+  if(vtkOptions.isRectilinear){
+    const string axisNames[3] = {"X","Y","Z"};
+    axisCoords.resize(kNumberOfDimensions);
+    for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+      const mriVTKDataBlock* block = reader.findBlock(kVTKBlockCoordinates,axisNames[loopA]);
+      if(block == NULL){
+        throw mriException(string("ERROR: Missing " + axisNames[loopA] + "_COORDINATES in VTK file.\n").c_str());
+      }
+      mriVTKBlockValues values(*block);
+      if(values.getTotalValues() != (size_t)vtkOptions.dimensions[loopA]){
+        throw mriException(string("ERROR: Invalid number of " + axisNames[loopA] + "_COORDINATES in VTK file.\n").c_str());
+      }
+      axisCoords[loopA].resize(vtkOptions.dimensions[loopA]);
+      double* coords[1] = {axisCoords[loopA].data()};
+      values.decode(1,axisCoords[loopA].size(),coords);
+    }
+  }
 }
 
-// ================================
-// READ TOPOLOGY FROM ASCII TECPLOT
-// ================================
-void mriTopology::readFromPLT_ASCII(string pltFileName, pltOptionRecord& pltOptions){
-  
+// ======================================
+// READ TOPOLOGY FROM ASCII OR BINARY VTK
+// ======================================
+void mriTopology::readFromVTK(const mriVTKReader& reader){
   // Write Progress
-  writeSchMessage(std::string("Reading Topology from PLT: ") + pltFileName + std::string("\n"));
+  writeSchMessage(string("Reading Topology From VTK: ") + reader.getFileName() + string("\n"));
 
-  // Init Line Count
-  int lineCount = 0;
-  totalCells = 0;
+  // Creating Grid Geometry from Options
+  mriDoubleMat axisCoords;
+  readVTKGridHeader(reader,axisCoords);
+  if(reader.getOptions().isRectilinear){
+    createGridFromVTKRectilinearGrid(axisCoords);
+  }else{
+    createGridFromVTKStructuredPoints(reader.getOptions());
+  }
+}
 
-  // READ PLT FILE HEADER
-  ifstream pltFile;
-  pltFile.open(pltFileName.c_str());
-  mriStringVec tokenizedString;
-  bool foundheader = false;
-  bool areAllFloats = false;
-  pltOptions.headerCount = 0;
-  int totalLinesInFile = 0;
-  std::string Buffer;
-  while (getline(pltFile,Buffer)){
-    if(!foundheader){
-      boost::trim(Buffer);
-      boost::split(tokenizedString, Buffer, boost::is_any_of("= ,"), boost::token_compress_on);
-      areAllFloats = true;
-      assignPLTOptions(tokenizedString, pltOptions);
-      for(size_t loopA=0;loopA<tokenizedString.size();loopA++){
-        areAllFloats = (areAllFloats && (mriUtils::isFloat(tokenizedString[loopA])));
-      }
-      foundheader = areAllFloats;
-      pltOptions.headerCount++;
-    }
-    // Increase cell and line number
-    totalLinesInFile++;
+// ========================
+// READ GRID SIZES FROM VTK
+// ========================
+void mriTopology::readSizesFromVTK(const mriVTKReader& reader){
+  mriDoubleMat axisCoords;
+  readVTKGridHeader(reader,axisCoords);
+  if(reader.getOptions().isRectilinear){
+    setSizesFromVTKRectilinearGrid(axisCoords);
+  }else{
+    setSizesFromVTKStructuredPoints(reader.getOptions());
   }
+}
 
+// ============================
+// READ GRID SIZES FROM TECPLOT
+// ============================
+void mriTopology::readSizesFromPLT(const mriPLTReader& reader){
+  const pltOptionRecord& pltOptions = reader.getOptions();
   cellTotals.resize(3);
   cellTotals[0] = pltOptions.i;
   cellTotals[1] = pltOptions.j;
   cellTotals[2] = pltOptions.k;
   totalCells = cellTotals[0]*cellTotals[1]*cellTotals[2];
+  cellLengths.clear();
+  domainSizeMin.clear();
+  domainSizeMax.clear();
+}
 
-  // Read Cells From PLT File
-  double maxVelModule;
-  mriDoubleVec XCoords;
-  mriDoubleVec YCoords;
-  mriDoubleVec ZCoords;
-  mriDoubleMat gridData;  
-  readCellsFromPLTFile(pltFileName, 
-                       domainSizeMin,domainSizeMax,
-                       maxVelModule, 
-                       XCoords,YCoords,ZCoords,
-                       gridData);
+// ==========================
+// READ TOPOLOGY FROM TECPLOT
+// ==========================
+void mriTopology::readFromPLT(const mriPLTReader& reader){
+
+  // Write Progress
+  writeSchMessage(std::string("Reading Topology from PLT: ") + reader.getFileName() + std::string("\n"));
+
+  // Zone sizes from the header
+  readSizesFromPLT(reader);
+
+  // Domain limits and distinct coordinates along each axis
+  const string axisNames[3] = {"X","Y","Z"};
+  domainSizeMin.resize(3);
+  domainSizeMax.resize(3);
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    const mriDoubleVec& coords = reader.getColumn(loopA);
+    domainSizeMin[loopA] =  std::numeric_limits<double>::max();
+    domainSizeMax[loopA] = -std::numeric_limits<double>::max();
+    for(int loopB=0;loopB<totalCells;loopB++){
+      domainSizeMin[loopA] = std::min(domainSizeMin[loopA],coords[loopB]);
+      domainSizeMax[loopA] = std::max(domainSizeMax[loopA],coords[loopB]);
+    }
+    // Sorted once for all points, an ordered zone has one value per I, J or K
+    mriDoubleVec axisCoords(coords);
+    std::sort(axisCoords.begin(),axisCoords.end());
+    axisCoords.erase(std::unique(axisCoords.begin(),axisCoords.end()),axisCoords.end());
+    if((int)axisCoords.size() != cellTotals[loopA]){
+      writeSchMessage(string("WARNING: " + axisNames[loopA] + " coordinates do not match the zone size in " + reader.getFileName() + ".\n"));
+    }
+  }
 
-  
   // Resize CellLenghts: UNIFORM CASE
   cellLengths.resize(3);
   for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
@@ -1182,25 +1392,16 @@ void mriTopology::readFromPLT_ASCII(string pltFileName, pltOptionRecord& pltOpti
       }
     }
   }
+  buildCoordinateTables();
 
   // Assign cell locations
   cellLocations.resize(totalCells);
   for(int loopA=0;loopA<totalCells;loopA++){
-
-    //cellLocations[loopA][0] = XCoords[loopA];
-    //cellLocations[loopA][1] = YCoords[loopA];
-    //cellLocations[loopA][2] = ZCoords[loopA];
-
     cellLocations[loopA].resize(3);
-
-    cellLocations[loopA][0] = gridData[loopA][0];
-    cellLocations[loopA][1] = gridData[loopA][1];
-    cellLocations[loopA][2] = gridData[loopA][2];
-    
+    cellLocations[loopA][0] = reader.getColumn(0)[loopA];
+    cellLocations[loopA][1] = reader.getColumn(1)[loopA];
+    cellLocations[loopA][2] = reader.getColumn(2)[loopA];
   }
-
-  // Close File
-  pltFile.close();
 }
 
 // =========================
@@ -1212,7 +1413,7 @@ int mriTopology::getAdjacentFace(int globalNodeNumber /*Already Ordered Globally
   double currentZCoord = cellLocations[globalNodeNumber][2] - domainSizeMin[2];
   
   // Find The Node Number in The Current Plane
-  int ZCompleteLevels = mriUtils::findHowMany(currentZCoord,cellLengths[2]);
+  int ZCompleteLevels = locateOnAxis(2,currentZCoord);
   int localNodeNumber = globalNodeNumber - ZCompleteLevels * cellTotals[0] * cellTotals[1];
 
   // Find The Adjacent face in the Current Plane
@@ -1327,6 +1528,7 @@ void mriTopology::createFromTemplate(mriTemplateType sampleType,const mriDoubleV
       }
     }
   }
+  buildCoordinateTables();
 
   // Set Global Dimensions
   // Min
@@ -4,6 +4,8 @@
 # include "mriTypes.h"
 # include "mriUtils.h"
 # include "mriIO.h"
+# include "mriVTKReader.h"
+# include "mriPLTReader.h"
 # include "mriException.h"
 
 // ================
@@ -31,11 +33,22 @@ class mriTopology{
     // Edge Topology
     mriIntMat edgeConnections;
     mriIntMat edgeFaces;
+    // Map from current to first-seen face and edge numbers
+    mriIntVec faceCanonical;
+    mriIntVec edgeCanonical;
 
     // STRUCTURED GRID TOPOLOGY
     // Cells Totals
     mriIntVec cellTotals;
     mriDoubleMat cellLengths;
+    // Cumulative coordinates along each axis, rebuilt when cellLengths change
+    // Offsets of cell centers from the first center (cellTotals[i] entries)
+    mriDoubleMat cellCenterOffsets;
+    // Offsets of nodes from the first node (cellTotals[i]+1 entries)
+    mriDoubleMat nodeOffsets;
+    mriBoolVec uniformAxis;
+    // Incremented every time the coordinate tables are rebuilt
+    unsigned long geometryVersion;
     // Auxiliary
     mriDoubleMat auxNodesCoords;
 
@@ -52,14 +65,27 @@ class mriTopology{
     // MEMBER FUNCTIONS
 
     // BUILDING A TOPOLOGY
-    void readFromVTK_ASCII(string vtkFileName, vtkStructuredPointsOptionRecord& vtkOptions);
-    void readFromPLT_ASCII(string pltFileName, pltOptionRecord& pltOptions);
+    void readFromVTK(const mriVTKReader& reader);
+    void readFromPLT(const mriPLTReader& reader);
+    // Sizes, lengths and extents only, enough for isCompatibleTopology
+    void readSizesFromVTK(const mriVTKReader& reader);
+    // Tecplot headers have the sizes but not the extents
+    void readSizesFromPLT(const mriPLTReader& reader);
     
     // CREATE FROM TEMPLATE
     void createFromTemplate(mriTemplateType sampleType, const mriDoubleVec& params);
 
     // CREATION FROM STRUCTURED GRIDS
     void createGridFromVTKStructuredPoints(const vtkStructuredPointsOptionRecord& opts);
+    void createGridFromVTKRectilinearGrid(const mriDoubleMat& axisCoords);
+    void setSizesFromVTKStructuredPoints(const vtkStructuredPointsOptionRecord& opts);
+    void setSizesFromVTKRectilinearGrid(const mriDoubleMat& axisCoords);
+    // Stored lengths, extents and cell center coordinates of each axis
+    void createGridFromAxes(const mriDoubleMat& lengths,
+                            const mriDoubleVec& minLimits,
+                            const mriDoubleVec& maxLimits,
+                            const mriDoubleMat& axisCoords);
+    void getAxisCoords(mriDoubleMat& axisCoords);
 
     // MAPPING
     void   mapIndexToCoords(int index, mriIntVec& intCoords);
@@ -82,8 +108,14 @@ class mriTopology{
     void   buildFaceCells();
     void   buildEdgeConnections();
     void   buildFaceAreasAndNormals();
+    void   renumberFacesMorton();
+    void   renumberEdgesMorton();
+    int    getCanonicalFace(int faceID);
+    int    getCanonicalEdge(int edgeID);
     void   getExternalFaceNormal(int cellID, int localFaceID, mriDoubleVec& extNormal);
     void   mapCoordsToPosition(const mriIntVec& coords, bool addMeshMinima, mriDoubleVec& pos);
+    void   buildCoordinateTables();
+    int    locateOnAxis(int dim, double distance);
     int    getAdjacentFace(int globalNodeNumber /*Already Ordered Globally x-y-z*/, int AdjType);
     void   getNeighborVortexes(int cellNumber,int dim,mriIntVec& idx);
 
@@ -53,6 +53,7 @@ struct pltOptionRecord{
 struct vtkStructuredPointsOptionRecord{
   bool isASCII;
   bool isValidDataset;
+  bool isRectilinear;
   int dimensions[3];
   double origin[3];
   double spacing[3];
@@ -429,23 +429,6 @@ bool isSameIntVector(const mriIntVec& one, const mriIntVec& two){
   return res;
 }
 
-// =======================
-// FIND HOW MANY INTERVALS
-// =======================
-int findHowMany(double distance, const mriDoubleVec& lengths){
-  bool found = false;
-  int count = 0;
-  double currDist = 0.0;
-  while (!found){
-    found = ((currDist + 1.0e-4) > distance);
-    if(!found){
-      currDist += lengths[count];
-      count++;
-    }
-  }
-  return count;
-}
-
 // ============================
 // CHECK ERROR GENERATED BY MPI
 // ============================
@@ -533,6 +516,28 @@ int getMinInt(vector<int> vec){
   return minVal;
 }
 
+// ===================================
+// SPREAD 21 BITS OVER EVERY THIRD SLOT
+// ===================================
+unsigned long long spreadMortonBits(unsigned long long value){
+  value &= 0x1fffffULL;
+  value = (value | (value << 32)) & 0x1f00000000ffffULL;
+  value = (value | (value << 16)) & 0x1f0000ff0000ffULL;
+  value = (value | (value << 8))  & 0x100f00f00f00f00fULL;
+  value = (value | (value << 4))  & 0x10c30c30c30c30c3ULL;
+  value = (value | (value << 2))  & 0x1249249249249249ULL;
+  return value;
+}
+
+// ===========================================
+// INTERLEAVE INTEGER COORDINATES ON A Z-CURVE
+// ===========================================
+unsigned long long getMortonKey(int i, int j, int k){
+  return spreadMortonBits((unsigned long long)i) |
+        (spreadMortonBits((unsigned long long)j) << 1) |
+        (spreadMortonBits((unsigned long long)k) << 2);
+}
+
 // ===================================
 // CHECK IF STRING IS A FLOATING POINT
 // ===================================
@@ -688,37 +693,4 @@ void normalizeBinArray(mriDoubleVec& binArray,double currInterval){
   }  
 }
 
-// =============
-// ASSIGN TO BIN
-// =============
-void assignToBin(double currValue, int numberOfBins, const mriDoubleVec& binMin, const mriDoubleVec& binMax, mriDoubleVec& binArray){
-  bool found = false;
-  int count = 0;
-  bool isMoreThanMin = false;
-  bool isLessThanMax = false;
-  while ((!found)&&(count<numberOfBins)){
-    if (fabs(currValue-binMin[0])<kMathZero){
-      isMoreThanMin = (currValue >= binMin[count] - kMathZero);
-    }else{
-      isMoreThanMin = (currValue > binMin[count]);
-    }
-    if (fabs(currValue-binMin[numberOfBins-1])<kMathZero){
-      isLessThanMax = (currValue <= binMax[count]);
-    }else{
-      isLessThanMax = (currValue <= binMax[count] + kMathZero);
-    }
-    found = (isMoreThanMin)&&(isLessThanMax);
-    // Update
-    if (!found){
-      count++;
-    }
-  }
-  if (found){
-    // Increase Bin Count
-    binArray[count] = binArray[count] + 1.0;
-  }else{
-    throw mriException("Error: Value Cannot fit in Bin.\n");
-  } 
-}
-
 }
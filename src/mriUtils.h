@@ -138,9 +138,6 @@ void applyLimitBoxFactors(double xFactor, double yFactor, double zFactor, mriDou
   // Check that two integer vectors are the same
   bool isSameIntVector(const mriIntVec& one, const mriIntVec& two);
 
-  // FIND HOW MANY INTERVALS
-  int findHowMany(double distance, const mriDoubleVec& lengths);
-
   // CHECK ERROR GENERATED BY MPI
   void checkMpiError(int mpiError);
 
@@ -153,6 +150,9 @@ void applyLimitBoxFactors(double xFactor, double yFactor, double zFactor, mriDou
   // GET MIN OF STD INT VECTOR
   int getMinInt(vector<int> vec);
 
+  // INTERLEAVE INTEGER COORDINATES ON A Z-ORDER CURVE
+  unsigned long long getMortonKey(int i, int j, int k);
+
   // CHECK IF STRING IS A FLOATING POINT
   bool isFloat(string token);
 
@@ -177,8 +177,5 @@ void applyLimitBoxFactors(double xFactor, double yFactor, double zFactor, mriDou
   // NORMALIZE BIN ARRAY
   void normalizeBinArray(mriDoubleVec& binArray,double currInterval);
 
-  // ASSIGN TO BIN ARRAY
-  void assignToBin(double currValue, int numberOfBins, const mriDoubleVec& binMin, const mriDoubleVec& binMax, mriDoubleVec& binArray);
-
 }
 #endif //MRIUTILS_H
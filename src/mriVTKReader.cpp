@@ -0,0 +1,259 @@
+#include <string.h>
+#include <ctype.h>
+#include "mriVTKReader.h"
+#include "mriByteOrder.h"
+#include "mriParallel.h"
+#include "mriIO.h"
+
+// Lines starting with a letter are headers, except nan and inf values
+static bool isVTKHeaderLine(const char* ptr, const char* lineEnd){
+  if((ptr == lineEnd)||(!isalpha((unsigned char)*ptr))){
+    return false;
+  }
+  if(lineEnd - ptr >= 3){
+    string start(ptr,3);
+    boost::to_upper(start);
+    if((start == "NAN")||(start == "INF")){
+      return false;
+    }
+  }
+  return true;
+}
+
+// ===========================
+// GET DATA TYPE FROM ITS NAME
+// ===========================
+int getVTKDataType(const string& typeName){
+  string name = boost::to_lower_copy(typeName);
+  if(name == "char"){
+    return kVTKTypeChar;
+  }else if(name == "unsigned_char"){
+    return kVTKTypeUnsignedChar;
+  }else if(name == "short"){
+    return kVTKTypeShort;
+  }else if(name == "unsigned_short"){
+    return kVTKTypeUnsignedShort;
+  }else if(name == "int"){
+    return kVTKTypeInt;
+  }else if(name == "unsigned_int"){
+    return kVTKTypeUnsignedInt;
+  }else if(name == "float"){
+    return kVTKTypeFloat;
+  }else if(name == "double"){
+    return kVTKTypeDouble;
+  }
+  return kVTKTypeUnknown;
+}
+
+// ==================
+// GET DATA TYPE SIZE
+// ==================
+int getVTKDataTypeSize(int dataType){
+  switch(dataType){
+    case kVTKTypeChar:
+    case kVTKTypeUnsignedChar:
+      return 1;
+    case kVTKTypeShort:
+    case kVTKTypeUnsignedShort:
+      return 2;
+    case kVTKTypeInt:
+    case kVTKTypeUnsignedInt:
+    case kVTKTypeFloat:
+      return 4;
+    case kVTKTypeDouble:
+      return 8;
+  }
+  return 0;
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriVTKReader::mriVTKReader(string fileName, bool headerOnly):file(fileName){
+  this->fileName = fileName;
+  initVTKStructuredPointsOptions(options);
+
+  // Walk the lines once, ASCII numbers are only skipped, binary blocks are jumped over
+  mriStringVec tokenizedString;
+  int lineNum = 0;
+  int openBlock = -1;
+  size_t totDataPoints = 0;
+  int fieldArraysLeft = 0;
+  const char* lineStart = file.begin();
+  const char* fileEnd = file.end();
+  while(lineStart < fileEnd){
+    const char* lineEnd = (const char*)memchr(lineStart,'\n',fileEnd - lineStart);
+    if(lineEnd == NULL){
+      lineEnd = fileEnd;
+    }
+    const char* nextLine = (lineEnd < fileEnd) ? lineEnd + 1 : fileEnd;
+    const char* ptr = lineStart;
+    while((ptr < lineEnd)&&((*ptr == ' ')||(*ptr == '\t'))){
+      ptr++;
+    }
+    if(isVTKHeaderLine(ptr,lineEnd)){
+      string buffer(ptr,lineEnd);
+      boost::trim(buffer);
+      boost::split(tokenizedString, buffer, boost::is_any_of(" ,"), boost::token_compress_on);
+      string keyword = boost::to_upper_copy(tokenizedString[0]);
+      if(headerOnly && ((keyword == "POINT_DATA")||(keyword == "CELL_DATA"))){
+        // Grid coordinates end here
+        if(openBlock >= 0){
+          blocks[openBlock].end = lineStart;
+        }
+        break;
+      }
+      assignVTKOptions(lineNum,tokenizedString,options);
+      if((keyword == "LOOKUP_TABLE")&&(openBlock >= 0)&&(blocks[openBlock].begin == lineStart)){
+        // Lookup table of a scalar block, data starts on the next line
+        blocks[openBlock].begin = nextLine;
+      }else{
+        if(openBlock >= 0){
+          blocks[openBlock].end = lineStart;
+          openBlock = -1;
+        }
+        // Block header: name, type, value type and number of values
+        mriVTKDataBlock block;
+        block.type = -1;
+        size_t totValues = 0;
+        string typeName;
+        if(fieldArraysLeft > 0){
+          // Array of a FIELD: name components tuples type
+          if(tokenizedString.size() < 4){
+            throw mriException("ERROR: Invalid FIELD array in VTK file.\n");
+          }
+          block.name = boost::to_upper_copy(tokenizedString[0]);
+          block.type = kVTKBlockFieldArray;
+          totValues = (size_t)atoi(tokenizedString[1].c_str())*(size_t)atoi(tokenizedString[2].c_str());
+          typeName = tokenizedString[3];
+          fieldArraysLeft--;
+        }else if((keyword == "POINT_DATA")||(keyword == "CELL_DATA")){
+          totDataPoints = (tokenizedString.size() > 1) ? atoi(tokenizedString[1].c_str()) : 0;
+        }else if(keyword == "FIELD"){
+          fieldArraysLeft = (tokenizedString.size() > 2) ? atoi(tokenizedString[2].c_str()) : 0;
+        }else if(tokenizedString.size() > 2){
+          if(keyword == "SCALARS"){
+            block.type = kVTKBlockScalars;
+            int totComponents = (tokenizedString.size() > 3) ? atoi(tokenizedString[3].c_str()) : 1;
+            totValues = totComponents*totDataPoints;
+          }else if((keyword == "VECTORS")||(keyword == "NORMALS")){
+            block.type = kVTKBlockVectors;
+            totValues = 3*totDataPoints;
+          }else if(keyword == "TENSORS"){
+            block.type = kVTKBlockTensors;
+            totValues = 9*totDataPoints;
+          }else if((keyword == "X_COORDINATES")||(keyword == "Y_COORDINATES")||(keyword == "Z_COORDINATES")){
+            block.type = kVTKBlockCoordinates;
+            totValues = atoi(tokenizedString[1].c_str());
+          }
+          if(block.type == kVTKBlockCoordinates){
+            block.name = keyword.substr(0,1);
+          }else{
+            block.name = boost::to_upper_copy(tokenizedString[1]);
+          }
+          typeName = tokenizedString[2];
+        }
+        if(block.type >= 0){
+          block.dataType = getVTKDataType(typeName);
+          block.isBinary = options.isDefined[0] && (!options.isASCII);
+          block.begin = nextLine;
+          block.end = fileEnd;
+          if(block.isBinary){
+            // Skip the lookup table line of scalars
+            if((block.type == kVTKBlockScalars)&&(fileEnd - nextLine >= 12)&&(strncmp(nextLine,"LOOKUP_TABLE",12) == 0)){
+              const char* tableEnd = (const char*)memchr(nextLine,'\n',fileEnd - nextLine);
+              block.begin = (tableEnd == NULL) ? fileEnd : tableEnd + 1;
+            }
+            int typeSize = getVTKDataTypeSize(block.dataType);
+            if(typeSize == 0){
+              throw mriException(string("ERROR: Unsupported binary data type " + typeName + " in VTK file.\n").c_str());
+            }
+            if((size_t)(fileEnd - block.begin) < totValues*typeSize){
+              throw mriException("ERROR: Truncated binary data block in VTK file.\n");
+            }
+            block.end = block.begin + totValues*typeSize;
+            // Continue after the binary values
+            nextLine = block.end;
+            blocks.push_back(block);
+          }else{
+            blocks.push_back(block);
+            openBlock = blocks.size() - 1;
+          }
+        }
+      }
+    }
+    lineStart = nextLine;
+    lineNum++;
+  }
+}
+
+// ===============
+// FIND DATA BLOCK
+// ===============
+const mriVTKDataBlock* mriVTKReader::findBlock(int type, const string& name) const{
+  for(size_t loopA=0;loopA<blocks.size();loopA++){
+    if((blocks[loopA].type == type)&&(blocks[loopA].name == name)){
+      return &blocks[loopA];
+    }
+  }
+  return NULL;
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriVTKBlockValues::mriVTKBlockValues(const mriVTKDataBlock& block):block(block){
+  if(!block.isBinary){
+    text.reset(new mriTextBlock(block.begin,block.end));
+  }
+}
+
+// ====================
+// GET NUMBER OF VALUES
+// ====================
+size_t mriVTKBlockValues::getTotalValues() const{
+  if(!block.isBinary){
+    return text->getTotalValues();
+  }
+  return (block.end - block.begin)/getVTKDataTypeSize(block.dataType);
+}
+
+// Decode big-endian values of type T, tuples are split among the threads
+template<typename T>
+static void decodeBigEndianBlock(const char* data, size_t totValues, int totComponents, double** components){
+  int totTuples = totValues/totComponents;
+  mriParallel::parallelFor(totTuples,[&](int /*thread*/,int begin,int end){
+    for(int loopA=begin;loopA<end;loopA++){
+      const char* tuple = data + (size_t)loopA*totComponents*sizeof(T);
+      for(int loopB=0;loopB<totComponents;loopB++){
+        components[loopB][loopA] = (double)loadBigEndian<T>(tuple + loopB*sizeof(T));
+      }
+    }
+  });
+}
+
+// ===================
+// DECODE BLOCK VALUES
+// ===================
+void mriVTKBlockValues::decode(int totComponents, size_t totTuples, double** components) const{
+  if(!block.isBinary){
+    text->parse(totComponents,totTuples,components);
+    return;
+  }
+  size_t totValues = getTotalValues();
+  if(totValues/totComponents > totTuples){
+    throw mriException("ERROR: Too many values for the destination in VTK block.\n");
+  }
+  switch(block.dataType){
+    case kVTKTypeChar:          decodeBigEndianBlock<int8_t>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeUnsignedChar:  decodeBigEndianBlock<uint8_t>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeShort:         decodeBigEndianBlock<int16_t>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeUnsignedShort: decodeBigEndianBlock<uint16_t>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeInt:           decodeBigEndianBlock<int32_t>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeUnsignedInt:   decodeBigEndianBlock<uint32_t>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeFloat:         decodeBigEndianBlock<float>(block.begin,totValues,totComponents,components); break;
+    case kVTKTypeDouble:        decodeBigEndianBlock<double>(block.begin,totValues,totComponents,components); break;
+    default:
+      throw mriException("ERROR: Unsupported binary data type in VTK file.\n");
+  }
+}
@@ -0,0 +1,96 @@
+#ifndef MRIVTKREADER_H
+#define MRIVTKREADER_H
+
+# include <string>
+# include <vector>
+# include <memory>
+
+# include "mriTypes.h"
+# include "mriTextFile.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Data block types, scalars and vectors as in vtkStructuredPointsOptionRecord::dataBlockType
+const int kVTKBlockScalars     = 0;
+const int kVTKBlockVectors     = 1;
+const int kVTKBlockTensors     = 2;
+const int kVTKBlockCoordinates = 3;
+const int kVTKBlockFieldArray  = 4;
+
+// Value types of binary data blocks
+const int kVTKTypeUnknown       = -1;
+const int kVTKTypeChar          = 0;
+const int kVTKTypeUnsignedChar  = 1;
+const int kVTKTypeShort         = 2;
+const int kVTKTypeUnsignedShort = 3;
+const int kVTKTypeInt           = 4;
+const int kVTKTypeUnsignedInt   = 5;
+const int kVTKTypeFloat         = 6;
+const int kVTKTypeDouble        = 7;
+
+// Type code and size in bytes from the name in a VTK header
+int getVTKDataType(const string& typeName);
+int getVTKDataTypeSize(int dataType);
+
+// ========================
+// DATA BLOCK IN A VTK FILE
+// ========================
+struct mriVTKDataBlock{
+  // Upper case name from the block header, X, Y or Z for coordinates
+  string name;
+  int type;
+  int dataType;
+  bool isBinary;
+  // Values of the block, after the header and lookup table lines
+  const char* begin;
+  const char* end;
+};
+
+// =========================================
+// VALUES OF ONE DATA BLOCK, READY TO DECODE
+// =========================================
+// ASCII blocks are split in chunks and parsed in parallel, binary blocks
+// are byte-swapped straight from the mapped file into the destination.
+class mriVTKBlockValues{
+  public:
+    // CONSTRUCTOR
+    mriVTKBlockValues(const mriVTKDataBlock& block);
+
+    // MEMBER FUNCTIONS
+    size_t getTotalValues() const;
+    // Value i goes to components[i % totComponents][i / totComponents],
+    // throws if the block holds more than totTuples tuples
+    void decode(int totComponents, size_t totTuples, double** components) const;
+
+  private:
+    const mriVTKDataBlock& block;
+    unique_ptr<mriTextBlock> text;
+};
+
+// ================================================
+// LEGACY VTK STRUCTURED POINTS OR RECTILINEAR FILE
+// ================================================
+// The file is memory-mapped and scanned once for the header lines and the
+// data blocks, binary blocks are skipped using their size. Topology and
+// scan are both built from the same reader. A header only reader stops at
+// the point data, it knows the grid but has no field blocks.
+class mriVTKReader{
+  public:
+    // CONSTRUCTOR
+    mriVTKReader(string fileName, bool headerOnly = false);
+
+    // MEMBER FUNCTIONS
+    string getFileName() const{return fileName;}
+    const vtkStructuredPointsOptionRecord& getOptions() const{return options;}
+    // First block with the given type and upper case name, NULL if missing
+    const mriVTKDataBlock* findBlock(int type, const string& name) const;
+
+  private:
+    string fileName;
+    mriMappedFile file;
+    vtkStructuredPointsOptionRecord options;
+    vector<mriVTKDataBlock> blocks;
+};
+
+#endif // MRIVTKREADER_H
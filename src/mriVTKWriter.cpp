@@ -0,0 +1,133 @@
+#include "mriVTKWriter.h"
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriVTKWriter::mriVTKWriter(string fileName, bool isBinary){
+  this->isBinary = isBinary;
+  totPoints = 0;
+  outFile = fopen(fileName.c_str(),isBinary ? "wb" : "w");
+  if(outFile == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+}
+
+// ==========
+// DESTRUCTOR
+// ==========
+mriVTKWriter::~mriVTKWriter(){
+  close();
+}
+
+// ==========
+// CLOSE FILE
+// ==========
+void mriVTKWriter::close(){
+  if(outFile != NULL){
+    fclose(outFile);
+    outFile = NULL;
+  }
+}
+
+// ============
+// WRITE HEADER
+// ============
+void mriVTKWriter::writeHeader(const string& title){
+  fprintf(outFile,"# vtk DataFile Version 3.0\n");
+  fprintf(outFile,"%s\n",title.c_str());
+  fprintf(outFile,isBinary ? "BINARY\n" : "ASCII\n");
+}
+
+// =======================
+// WRITE STRUCTURED POINTS
+// =======================
+void mriVTKWriter::writeStructuredPoints(const mriIntVec& totals, const double spacing[3], const double origin[3]){
+  fprintf(outFile,"DATASET STRUCTURED_POINTS\n");
+  fprintf(outFile,"DIMENSIONS %d %d %d\n",totals[0],totals[1],totals[2]);
+  fprintf(outFile,"SPACING %e %e %e\n",spacing[0],spacing[1],spacing[2]);
+  fprintf(outFile,"ORIGIN %e %e %e\n",origin[0],origin[1],origin[2]);
+}
+
+// ======================
+// WRITE RECTILINEAR GRID
+// ======================
+void mriVTKWriter::writeRectilinearGrid(const mriIntVec& totals, const mriDoubleMat& axisCoords){
+  const char* axisNames[3] = {"X","Y","Z"};
+  fprintf(outFile,"DATASET RECTILINEAR_GRID\n");
+  fprintf(outFile,"DIMENSIONS %d %d %d\n",totals[0],totals[1],totals[2]);
+  for(int loopA=0;loopA<3;loopA++){
+    const mriDoubleVec& coords = axisCoords[loopA];
+    int totCoords = coords.size();
+    fprintf(outFile,"%s_COORDINATES %d double\n",axisNames[loopA],totCoords);
+    if(isBinary){
+      writeBinaryTuples(totCoords,1,[&](int tuple,double* values){
+        values[0] = coords[tuple];
+      });
+    }else{
+      for(int loopB=0;loopB<totCoords-1;loopB++){
+        fprintf(outFile,"%e ",coords[loopB]);
+      }
+      fprintf(outFile,"%e\n",coords.back());
+    }
+  }
+}
+
+// ================
+// WRITE POINT DATA
+// ================
+void mriVTKWriter::writePointData(int totPoints){
+  this->totPoints = totPoints;
+  fprintf(outFile,"POINT_DATA %d\n",totPoints);
+}
+
+// =============
+// WRITE SCALARS
+// =============
+void mriVTKWriter::writeScalars(const string& name, const double* values){
+  fprintf(outFile,"%s\n",string("SCALARS " + name + " double").c_str());
+  fprintf(outFile,"LOOKUP_TABLE default\n");
+  if(isBinary){
+    writeBinaryTuples(totPoints,1,[&](int point,double* tuple){
+      tuple[0] = values[point];
+    });
+  }else{
+    for(int loopA=0;loopA<totPoints;loopA++){
+      fprintf(outFile,"%e\n",values[loopA]);
+    }
+  }
+}
+
+// =====================
+// WRITE INTEGER SCALARS
+// =====================
+void mriVTKWriter::writeScalars(const string& name, const int* values){
+  fprintf(outFile,"%s\n",string("SCALARS " + name + " double").c_str());
+  fprintf(outFile,"LOOKUP_TABLE default\n");
+  if(isBinary){
+    writeBinaryTuples(totPoints,1,[&](int point,double* tuple){
+      tuple[0] = (double)values[point];
+    });
+  }else{
+    for(int loopA=0;loopA<totPoints;loopA++){
+      fprintf(outFile,"%d\n",values[loopA]);
+    }
+  }
+}
+
+// =============
+// WRITE VECTORS
+// =============
+void mriVTKWriter::writeVectors(const string& name, const double* x, const double* y, const double* z){
+  fprintf(outFile,"%s\n",string("VECTORS " + name + " double").c_str());
+  if(isBinary){
+    writeBinaryTuples(totPoints,3,[&](int point,double* tuple){
+      tuple[0] = x[point];
+      tuple[1] = y[point];
+      tuple[2] = z[point];
+    });
+  }else{
+    for(int loopA=0;loopA<totPoints;loopA++){
+      fprintf(outFile,"%e %e %e\n",x[loopA],y[loopA],z[loopA]);
+    }
+  }
+}
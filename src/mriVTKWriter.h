@@ -0,0 +1,96 @@
+#ifndef MRIVTKWRITER_H
+#define MRIVTKWRITER_H
+
+# include <stdio.h>
+# include <string>
+# include <vector>
+# include <algorithm>
+
+# include "mriTypes.h"
+# include "mriByteOrder.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Tuples converted and written together in binary files
+const int kVTKWriterChunkTuples = 8192;
+
+// ================================
+// LEGACY VTK FILE, ASCII OR BINARY
+// ================================
+// ASCII files print every value with %e, binary files store big-endian
+// doubles that are filled in chunks and byte-swapped in bulk.
+class mriVTKWriter{
+  public:
+    // CONSTRUCTOR AND DESTRUCTOR
+    mriVTKWriter(string fileName, bool isBinary);
+    ~mriVTKWriter();
+
+    // MEMBER FUNCTIONS
+    void writeHeader(const string& title);
+    void writeStructuredPoints(const mriIntVec& totals, const double spacing[3], const double origin[3]);
+    void writeRectilinearGrid(const mriIntVec& totals, const mriDoubleMat& axisCoords);
+    void writePointData(int totPoints);
+    void writeScalars(const string& name, const double* values);
+    void writeScalars(const string& name, const int* values);
+    void writeVectors(const string& name, const double* x, const double* y, const double* z);
+    // getTensor(point,tensor) fills the 3x3 tensor of a point
+    template<typename F> void writeTensors(const string& name, F getTensor);
+    void close();
+
+  private:
+    FILE* outFile;
+    bool isBinary;
+    int totPoints;
+    vector<double> buffer;
+    // Write totTuples tuples, fillTuple(tuple,values) sets the components
+    template<typename F> void writeBinaryTuples(int totTuples, int totComponents, F fillTuple);
+    // Not copyable
+    mriVTKWriter(const mriVTKWriter&);
+    mriVTKWriter& operator=(const mriVTKWriter&);
+};
+
+// ======================
+// WRITE TUPLES IN BINARY
+// ======================
+template<typename F> void mriVTKWriter::writeBinaryTuples(int totTuples, int totComponents, F fillTuple){
+  buffer.resize((size_t)kVTKWriterChunkTuples*totComponents);
+  for(int loopA=0;loopA<totTuples;loopA+=kVTKWriterChunkTuples){
+    int chunkTuples = std::min(kVTKWriterChunkTuples,totTuples - loopA);
+    for(int loopB=0;loopB<chunkTuples;loopB++){
+      fillTuple(loopA + loopB,&buffer[(size_t)loopB*totComponents]);
+    }
+    size_t totValues = (size_t)chunkTuples*totComponents;
+    swapToBigEndian(buffer.data(),totValues);
+    fwrite(buffer.data(),sizeof(double),totValues,outFile);
+  }
+  fprintf(outFile,"\n");
+}
+
+// =============
+// WRITE TENSORS
+// =============
+template<typename F> void mriVTKWriter::writeTensors(const string& name, F getTensor){
+  fprintf(outFile,"%s\n",string("TENSORS " + name + " double").c_str());
+  double tensor[3][3];
+  if(isBinary){
+    writeBinaryTuples(totPoints,9,[&](int point,double* values){
+      getTensor(point,tensor);
+      for(int loopA=0;loopA<3;loopA++){
+        for(int loopB=0;loopB<3;loopB++){
+          values[loopA*3 + loopB] = tensor[loopA][loopB];
+        }
+      }
+    });
+  }else{
+    for(int loopA=0;loopA<totPoints;loopA++){
+      getTensor(loopA,tensor);
+      fprintf(outFile,"%e %e %e\n",tensor[0][0],tensor[0][1],tensor[0][2]);
+      fprintf(outFile,"%e %e %e\n",tensor[1][0],tensor[1][1],tensor[1][2]);
+      fprintf(outFile,"%e %e %e\n",tensor[2][0],tensor[2][1],tensor[2][2]);
+      fprintf(outFile,"\n");
+    }
+  }
+}
+
+#endif // MRIVTKWRITER_H
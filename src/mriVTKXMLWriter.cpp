@@ -0,0 +1,340 @@
+#include <string.h>
+#include <stdint.h>
+#include <memory>
+#include <algorithm>
+#ifdef MRI_USE_ZLIB
+#include <zlib.h>
+#endif
+#include "mriVTKXMLWriter.h"
+#include "mriByteOrder.h"
+#include "mriLZ4.h"
+
+// Tuples formatted at once in uncompressed files
+static const int kVTKXMLChunkTuples = 8192;
+
+// Compress one block with the selected codec
+static void compressVTKBlock(int compression, const char* src, int srcSize, vector<char>& dst){
+  if(compression == kVTKCompressLZ4){
+    mriLZ4::compressBlock(src,srcSize,dst);
+    return;
+  }
+#ifdef MRI_USE_ZLIB
+  uLongf dstSize = compressBound(srcSize);
+  dst.resize(dstSize);
+  if(compress2((Bytef*)dst.data(),&dstSize,(const Bytef*)src,srcSize,kVTKXMLZLibLevel) != Z_OK){
+    throw mriException("ERROR: zlib compression failed in mriVTKXMLWriter.\n");
+  }
+  dst.resize(dstSize);
+#else
+  throw mriException("ERROR: mriFilter was built without zlib.\n");
+#endif
+}
+
+// Greatest common divisor
+static size_t getGCD(size_t a, size_t b){
+  while(b != 0){
+    size_t rem = a % b;
+    a = b;
+    b = rem;
+  }
+  return a;
+}
+
+// ===========
+// CONSTRUCTOR
+// ===========
+mriVTKXMLWriter::mriVTKXMLWriter(string fileName, int compression){
+  this->fileName = fileName;
+  this->compression = compression;
+#ifndef MRI_USE_ZLIB
+  // Bundled codec when zlib is not available
+  if(compression == kVTKCompressZLib){
+    this->compression = kVTKCompressLZ4;
+  }
+#endif
+  isRectilinear = false;
+  totPoints = 0;
+  for(int loopA=0;loopA<3;loopA++){
+    spacing[loopA] = 0.0;
+    origin[loopA] = 0.0;
+  }
+}
+
+// ==============
+// SET IMAGE DATA
+// ==============
+void mriVTKXMLWriter::setImageData(const mriIntVec& totals, const double spacing[3], const double origin[3]){
+  isRectilinear = false;
+  this->totals = totals;
+  for(int loopA=0;loopA<3;loopA++){
+    this->spacing[loopA] = spacing[loopA];
+    this->origin[loopA] = origin[loopA];
+  }
+}
+
+// ====================
+// SET RECTILINEAR GRID
+// ====================
+void mriVTKXMLWriter::setRectilinearGrid(const mriIntVec& totals, const mriDoubleMat& axisCoords){
+  isRectilinear = true;
+  this->totals = totals;
+  this->axisCoords = axisCoords;
+  const char* axisNames[3] = {"x_coordinates","y_coordinates","z_coordinates"};
+  coordArrays.clear();
+  for(int loopA=0;loopA<3;loopA++){
+    const double* coords = this->axisCoords[loopA].data();
+    addArray(coordArrays,axisNames[loopA],"Float64",sizeof(double),1,this->axisCoords[loopA].size(),[coords](int begin,int end,char* out){
+      memcpy(out,coords + begin,(end - begin)*sizeof(double));
+    });
+  }
+}
+
+// ================
+// WRITE POINT DATA
+// ================
+void mriVTKXMLWriter::writePointData(int totPoints){
+  this->totPoints = totPoints;
+}
+
+// =============
+// WRITE SCALARS
+// =============
+void mriVTKXMLWriter::writeScalars(const string& name, const double* values){
+  addArray(pointArrays,name,"Float64",sizeof(double),1,totPoints,[values](int begin,int end,char* out){
+    memcpy(out,values + begin,(end - begin)*sizeof(double));
+  });
+}
+
+// =====================
+// WRITE INTEGER SCALARS
+// =====================
+void mriVTKXMLWriter::writeScalars(const string& name, const int* values){
+  addArray(pointArrays,name,"Int32",sizeof(int32_t),1,totPoints,[values](int begin,int end,char* out){
+    int32_t* tuples = (int32_t*)out;
+    for(int loopA=begin;loopA<end;loopA++){
+      *tuples++ = values[loopA];
+    }
+  });
+}
+
+// =============
+// WRITE VECTORS
+// =============
+void mriVTKXMLWriter::writeVectors(const string& name, const double* x, const double* y, const double* z){
+  addArray(pointArrays,name,"Float64",sizeof(double),3,totPoints,[x,y,z](int begin,int end,char* out){
+    double* tuples = (double*)out;
+    for(int loopA=begin;loopA<end;loopA++){
+      *tuples++ = x[loopA];
+      *tuples++ = y[loopA];
+      *tuples++ = z[loopA];
+    }
+  });
+}
+
+// =========
+// ADD ARRAY
+// =========
+void mriVTKXMLWriter::addArray(vector<mriVTKXMLArray>& arrays, const string& name, const string& typeName, int valueSize,
+                               int totComponents, int totTuples, const std::function<void(int,int,char*)>& fill){
+  mriVTKXMLArray array;
+  array.name = name;
+  array.typeName = typeName;
+  array.valueSize = valueSize;
+  array.totComponents = totComponents;
+  array.totTuples = totTuples;
+  array.fill = fill;
+  arrays.push_back(array);
+}
+
+// ============================
+// FORMAT AND COMPRESS AN ARRAY
+// ============================
+// Groups of whole tuples that are also whole blocks are formatted on the
+// calling thread and handed to the pool, except for the last group.
+void mriVTKXMLWriter::compressArray(mriVTKXMLArray& array, mriTaskPool& pool){
+  size_t tupleBytes = (size_t)array.valueSize*array.totComponents;
+  size_t totBytes = tupleBytes*array.totTuples;
+  size_t totBlocks = (totBytes + kVTKXMLBlockSize - 1)/kVTKXMLBlockSize;
+  array.blocks.assign(totBlocks,vector<char>());
+  // Smallest group that ends on both a tuple and a block boundary
+  size_t unitBytes = tupleBytes/getGCD(tupleBytes,kVTKXMLBlockSize)*kVTKXMLBlockSize;
+  size_t unitBlocks = unitBytes/kVTKXMLBlockSize;
+  size_t groupBytes = unitBytes*std::max((size_t)1,kVTKXMLBlocksPerTask/unitBlocks);
+  int groupTuples = groupBytes/tupleBytes;
+  int maxPending = 4*mriParallel::getThreadCount();
+  int comp = compression;
+  for(int loopA=0;loopA<array.totTuples;loopA+=groupTuples){
+    int endTuple = std::min(array.totTuples,loopA + groupTuples);
+    std::shared_ptr<vector<char> > group(new vector<char>((size_t)(endTuple - loopA)*tupleBytes));
+    array.fill(loopA,endTuple,group->data());
+    size_t firstBlock = (size_t)loopA*tupleBytes/kVTKXMLBlockSize;
+    vector<vector<char> >* blocks = &array.blocks;
+    // Limit the formatted data waiting for compression
+    pool.waitForSlots(maxPending);
+    pool.submit([group,firstBlock,blocks,comp](){
+      size_t groupSize = group->size();
+      for(size_t loopB=0;loopB<groupSize;loopB+=kVTKXMLBlockSize){
+        int blockSize = (int)std::min((size_t)kVTKXMLBlockSize,groupSize - loopB);
+        compressVTKBlock(comp,group->data() + loopB,blockSize,(*blocks)[firstBlock + loopB/kVTKXMLBlockSize]);
+      }
+    });
+  }
+}
+
+// ============================
+// GET SIZE IN APPENDED SECTION
+// ============================
+size_t mriVTKXMLWriter::getAppendedSize(const mriVTKXMLArray& array) const{
+  size_t totBytes = (size_t)array.valueSize*array.totComponents*array.totTuples;
+  if(compression == kVTKCompressNone){
+    return sizeof(uint64_t) + totBytes;
+  }
+  size_t size = (3 + array.blocks.size())*sizeof(uint64_t);
+  for(size_t loopA=0;loopA<array.blocks.size();loopA++){
+    size += array.blocks[loopA].size();
+  }
+  return size;
+}
+
+// ==================
+// WRITE ARRAY HEADER
+// ==================
+void mriVTKXMLWriter::writeArrayHeader(FILE* outFile, const mriVTKXMLArray& array, size_t offset) const{
+  fprintf(outFile,"        <DataArray type=\"%s\" Name=\"%s\" NumberOfComponents=\"%d\" format=\"appended\" offset=\"%zu\"/>\n",
+          array.typeName.c_str(),array.name.c_str(),array.totComponents,offset);
+}
+
+// ====================
+// WRITE APPENDED ARRAY
+// ====================
+void mriVTKXMLWriter::writeAppendedArray(FILE* outFile, const mriVTKXMLArray& array) const{
+  size_t tupleBytes = (size_t)array.valueSize*array.totComponents;
+  size_t totBytes = tupleBytes*array.totTuples;
+  if(compression == kVTKCompressNone){
+    uint64_t size = totBytes;
+    fwrite(&size,sizeof(size),1,outFile);
+    vector<char> buffer(kVTKXMLChunkTuples*tupleBytes);
+    for(int loopA=0;loopA<array.totTuples;loopA+=kVTKXMLChunkTuples){
+      int endTuple = std::min(array.totTuples,loopA + kVTKXMLChunkTuples);
+      array.fill(loopA,endTuple,buffer.data());
+      fwrite(buffer.data(),tupleBytes,endTuple - loopA,outFile);
+    }
+    return;
+  }
+  // Block count, block size, last block size, compressed sizes
+  size_t totBlocks = array.blocks.size();
+  vector<uint64_t> header(3 + totBlocks);
+  header[0] = totBlocks;
+  header[1] = kVTKXMLBlockSize;
+  header[2] = (totBlocks == 0) ? 0 : totBytes - (totBlocks - 1)*kVTKXMLBlockSize;
+  for(size_t loopA=0;loopA<totBlocks;loopA++){
+    header[3 + loopA] = array.blocks[loopA].size();
+  }
+  fwrite(header.data(),sizeof(uint64_t),header.size(),outFile);
+  for(size_t loopA=0;loopA<totBlocks;loopA++){
+    fwrite(array.blocks[loopA].data(),1,array.blocks[loopA].size(),outFile);
+  }
+}
+
+// ==========
+// WRITE FILE
+// ==========
+void mriVTKXMLWriter::close(){
+  // Compress all arrays before the offsets are known
+  if(compression != kVTKCompressNone){
+    mriTaskPool pool(std::max(1,mriParallel::getThreadCount() - 1));
+    for(size_t loopA=0;loopA<coordArrays.size();loopA++){
+      compressArray(coordArrays[loopA],pool);
+    }
+    for(size_t loopA=0;loopA<pointArrays.size();loopA++){
+      compressArray(pointArrays[loopA],pool);
+    }
+    pool.wait();
+  }
+
+  FILE* outFile = fopen(fileName.c_str(),"wb");
+  if(outFile == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+  const char* dataType = isRectilinear ? "RectilinearGrid" : "ImageData";
+  const char* compressor = "";
+  if(compression == kVTKCompressZLib){
+    compressor = " compressor=\"vtkZLibDataCompressor\"";
+  }else if(compression == kVTKCompressLZ4){
+    compressor = " compressor=\"vtkLZ4DataCompressor\"";
+  }
+  char extent[256];
+  snprintf(extent,sizeof(extent),"0 %d 0 %d 0 %d",totals[0] - 1,totals[1] - 1,totals[2] - 1);
+  fprintf(outFile,"<?xml version=\"1.0\"?>\n");
+  fprintf(outFile,"<VTKFile type=\"%s\" version=\"1.0\" byte_order=\"%s\" header_type=\"UInt64\"%s>\n",
+          dataType,kHostIsBigEndian ? "BigEndian" : "LittleEndian",compressor);
+  if(isRectilinear){
+    fprintf(outFile,"  <RectilinearGrid WholeExtent=\"%s\">\n",extent);
+  }else{
+    fprintf(outFile,"  <ImageData WholeExtent=\"%s\" Origin=\"%.17g %.17g %.17g\" Spacing=\"%.17g %.17g %.17g\">\n",
+            extent,origin[0],origin[1],origin[2],spacing[0],spacing[1],spacing[2]);
+  }
+  fprintf(outFile,"    <Piece Extent=\"%s\">\n",extent);
+
+  // Active scalars and vectors are the first ones
+  string activeAttribs;
+  for(size_t loopA=0;loopA<pointArrays.size();loopA++){
+    if((pointArrays[loopA].totComponents == 1)&&(activeAttribs.find("Scalars") == string::npos)){
+      activeAttribs += " Scalars=\"" + pointArrays[loopA].name + "\"";
+    }else if((pointArrays[loopA].totComponents == 3)&&(activeAttribs.find("Vectors") == string::npos)){
+      activeAttribs += " Vectors=\"" + pointArrays[loopA].name + "\"";
+    }
+  }
+  size_t offset = 0;
+  fprintf(outFile,"      <PointData%s>\n",activeAttribs.c_str());
+  for(size_t loopA=0;loopA<pointArrays.size();loopA++){
+    writeArrayHeader(outFile,pointArrays[loopA],offset);
+    offset += getAppendedSize(pointArrays[loopA]);
+  }
+  fprintf(outFile,"      </PointData>\n");
+  if(isRectilinear){
+    fprintf(outFile,"      <Coordinates>\n");
+    for(size_t loopA=0;loopA<coordArrays.size();loopA++){
+      writeArrayHeader(outFile,coordArrays[loopA],offset);
+      offset += getAppendedSize(coordArrays[loopA]);
+    }
+    fprintf(outFile,"      </Coordinates>\n");
+  }
+  fprintf(outFile,"    </Piece>\n");
+  fprintf(outFile,"  </%s>\n",dataType);
+
+  // Appended data in the same order as the offsets
+  fprintf(outFile,"  <AppendedData encoding=\"raw\">\n   _");
+  for(size_t loopA=0;loopA<pointArrays.size();loopA++){
+    writeAppendedArray(outFile,pointArrays[loopA]);
+  }
+  if(isRectilinear){
+    for(size_t loopA=0;loopA<coordArrays.size();loopA++){
+      writeAppendedArray(outFile,coordArrays[loopA]);
+    }
+  }
+  fprintf(outFile,"\n  </AppendedData>\n");
+  fprintf(outFile,"</VTKFile>\n");
+  fclose(outFile);
+}
+
+// =========================
+// WRITE PVD TIME COLLECTION
+// =========================
+void writeVTKCollection(string fileName, const mriStringVec& dataFiles, const mriDoubleVec& times){
+  FILE* outFile = fopen(fileName.c_str(),"w");
+  if(outFile == NULL){
+    throw mriException(string("ERROR: Cannot open file " + fileName + " for writing.\n").c_str());
+  }
+  fprintf(outFile,"<?xml version=\"1.0\"?>\n");
+  fprintf(outFile,"<VTKFile type=\"Collection\" version=\"0.1\" byte_order=\"%s\">\n",kHostIsBigEndian ? "BigEndian" : "LittleEndian");
+  fprintf(outFile,"  <Collection>\n");
+  for(size_t loopA=0;loopA<dataFiles.size();loopA++){
+    // Data files are next to the collection
+    string dataFile = dataFiles[loopA].substr(dataFiles[loopA].find_last_of('/') + 1);
+    fprintf(outFile,"    <DataSet timestep=\"%.17g\" group=\"\" part=\"0\" file=\"%s\"/>\n",times[loopA],dataFile.c_str());
+  }
+  fprintf(outFile,"  </Collection>\n");
+  fprintf(outFile,"</VTKFile>\n");
+  fclose(outFile);
+}
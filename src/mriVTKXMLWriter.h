@@ -0,0 +1,107 @@
+#ifndef MRIVTKXMLWRITER_H
+#define MRIVTKXMLWRITER_H
+
+# include <stdio.h>
+# include <string>
+# include <vector>
+# include <functional>
+
+# include "mriTypes.h"
+# include "mriParallel.h"
+# include "mriException.h"
+
+using namespace std;
+
+// Compression of the appended data blocks
+const int kVTKCompressNone = 0;
+const int kVTKCompressZLib = 1;
+const int kVTKCompressLZ4  = 2;
+
+// Uncompressed bytes in one appended data block
+const int kVTKXMLBlockSize = 1 << 16;
+// Blocks compressed by one background task
+const int kVTKXMLBlocksPerTask = 16;
+// Fast zlib level, compression runs while the next fields are formatted
+const int kVTKXMLZLibLevel = 1;
+
+// =======================================
+// DATA ARRAY IN THE APPENDED DATA SECTION
+// =======================================
+struct mriVTKXMLArray{
+  string name;
+  // VTK XML type name (Float64, Int32)
+  string typeName;
+  int valueSize;
+  int totComponents;
+  int totTuples;
+  // Copy the values of tuples [begin,end) to out
+  std::function<void(int begin,int end,char* out)> fill;
+  // Compressed blocks, filled by the task pool
+  vector<vector<char> > blocks;
+};
+
+// ===========================================================
+// VTK XML IMAGE DATA (.vti) OR RECTILINEAR GRID (.vtr) WRITER
+// ===========================================================
+// Arrays are registered first and written by close() as raw appended
+// data. When compressed, the calling thread formats the arrays while the
+// blocks are compressed on a task pool. Registered pointers must stay
+// valid until close().
+class mriVTKXMLWriter{
+  public:
+    // CONSTRUCTOR
+    mriVTKXMLWriter(string fileName, int compression);
+
+    // MEMBER FUNCTIONS
+    void setImageData(const mriIntVec& totals, const double spacing[3], const double origin[3]);
+    void setRectilinearGrid(const mriIntVec& totals, const mriDoubleMat& axisCoords);
+    void writePointData(int totPoints);
+    void writeScalars(const string& name, const double* values);
+    void writeScalars(const string& name, const int* values);
+    void writeVectors(const string& name, const double* x, const double* y, const double* z);
+    // getTensor(point,tensor) fills the 3x3 tensor of a point
+    template<typename F> void writeTensors(const string& name, F getTensor);
+    // Write the file
+    void close();
+
+  private:
+    string fileName;
+    int compression;
+    bool isRectilinear;
+    mriIntVec totals;
+    double spacing[3];
+    double origin[3];
+    mriDoubleMat axisCoords;
+    int totPoints;
+    vector<mriVTKXMLArray> coordArrays;
+    vector<mriVTKXMLArray> pointArrays;
+    void addArray(vector<mriVTKXMLArray>& arrays, const string& name, const string& typeName, int valueSize,
+                  int totComponents, int totTuples, const std::function<void(int,int,char*)>& fill);
+    void compressArray(mriVTKXMLArray& array, mriTaskPool& pool);
+    size_t getAppendedSize(const mriVTKXMLArray& array) const;
+    void writeArrayHeader(FILE* outFile, const mriVTKXMLArray& array, size_t offset) const;
+    void writeAppendedArray(FILE* outFile, const mriVTKXMLArray& array) const;
+};
+
+// =============
+// WRITE TENSORS
+// =============
+template<typename F> void mriVTKXMLWriter::writeTensors(const string& name, F getTensor){
+  addArray(pointArrays,name,"Float64",sizeof(double),9,totPoints,[getTensor](int begin,int end,char* out){
+    double tensor[3][3];
+    double* values = (double*)out;
+    for(int loopA=begin;loopA<end;loopA++){
+      getTensor(loopA,tensor);
+      for(int loopB=0;loopB<3;loopB++){
+        for(int loopC=0;loopC<3;loopC++){
+          *values++ = tensor[loopB][loopC];
+        }
+      }
+    }
+  });
+}
+
+// Write the .pvd collection of a time series
+void writeVTKCollection(string fileName, const mriStringVec& dataFiles, const mriDoubleVec& times);
+
+#endif // MRIVTKXMLWRITER_H
@@ -109,43 +109,54 @@ double mriScan::evalCellVortexCriteria(int currentCell,int criteriaType, const m
 // EVALUATION OF VORTEX CRITERIA
 // =============================
 void mriScan::evalVortexCriteria(mriThresholdCriteria* threshold){
-  // Velocity Gradient and Hessian
-  // First and Second Derivatives
-
-  mriDoubleMat deformation;
-  mriDoubleMat rotation;
-  mriDoubleMat firstDerivs;
-  mriDoubleMat secondDerivs;
-
-  deformation.resize(kNumberOfDimensions);
-  rotation.resize(kNumberOfDimensions);
-  firstDerivs.resize(kNumberOfDimensions);
-  secondDerivs.resize(kNumberOfDimensions);
-
-  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
-    deformation[loopA].resize(kNumberOfDimensions);
-    rotation[loopA].resize(kNumberOfDimensions);
-    firstDerivs[loopA].resize(kNumberOfDimensions);
-    secondDerivs[loopA].resize(kNumberOfDimensions);
-  }
-
   // Create three new outputs
-  mriOutput out1("QCriterion",1);
-  mriOutput out2("L2Criterion",1);
-  mriOutput out3("DeltaCriterion",1);
+  mriScalarView out1 = outputs.addScalar("QCriterion",topology->totalCells);
+  mriScalarView out2 = outputs.addScalar("L2Criterion",topology->totalCells);
+  mriScalarView out3 = outputs.addScalar("DeltaCriterion",topology->totalCells);
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
   // Loop on cells
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
-    evalCellVelocityGradientDecomposition(loopA,deformation,rotation,firstDerivs);
-    // Store Criteria
-    out1.values.push_back(evalCellVortexCriteria(loopA,kVortexQ,deformation,rotation,firstDerivs));
-    out2.values.push_back(evalCellVortexCriteria(loopA,kVortexL2,deformation,rotation,firstDerivs));
-    out3.values.push_back(evalCellVortexCriteria(loopA,kVortexDelta,deformation,rotation,firstDerivs));
-  }
-  // Add output quantities
-  outputs.push_back(out1);
-  outputs.push_back(out2);
-  outputs.push_back(out3);
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    // Velocity Gradient and Hessian
+    // First and Second Derivatives
+    mriDoubleMat deformation(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat rotation(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat firstDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat secondDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    for(int loopA=begin;loopA<end;loopA++){
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
+      evalCellVelocityGradientDecomposition(loopA,deformation,rotation,firstDerivs);
+      // Store Criteria
+      out1.at<0>(loopA) = evalCellVortexCriteria(loopA,kVortexQ,deformation,rotation,firstDerivs);
+      out2.at<0>(loopA) = evalCellVortexCriteria(loopA,kVortexL2,deformation,rotation,firstDerivs);
+      out3.at<0>(loopA) = evalCellVortexCriteria(loopA,kVortexDelta,deformation,rotation,firstDerivs);
+    }
+  });
+}
+
+// ==============================
+// FIND CELLS IN THE VORTEX CORES
+// ==============================
+// Fluid cells where rotation dominates strain (Q > 0)
+void mriScan::evalVortexCoreCells(mriThresholdCriteria* threshold, vector<unsigned char>& isCore){
+  isCore.assign(topology->totalCells,0);
+  // Cached fluid mask and velocity derivatives
+  const mriFluidMask& fluidMask = getFluidMask(threshold);
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    mriDoubleMat deformation(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat rotation(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat firstDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat secondDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    for(int loopA=begin;loopA<end;loopA++){
+      if(!fluidMask.isFluid(loopA)){
+        continue;
+      }
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
+      evalCellVelocityGradientDecomposition(loopA,firstDerivs,deformation,rotation);
+      isCore[loopA] = (evalCellQCriterion(loopA,deformation,rotation) > 0.0);
+    }
+  });
 }
 
 // COMPUTATION OF VORTICITY
@@ -159,63 +170,55 @@ void computeVorticity(const mriDoubleMat& firstDerivs, mriDoubleVec& auxVector){
 // EVAL VORTICITY
 // ==============
 void mriScan::evalVorticity(mriThresholdCriteria* threshold){
-  // Allocate derivatives
-  mriDoubleMat firstDerivs;
-  mriDoubleMat secondDerivs;
-  firstDerivs.resize(kNumberOfDimensions);
-  secondDerivs.resize(kNumberOfDimensions);
-  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
-    firstDerivs[loopA].resize(kNumberOfDimensions);
-    secondDerivs[loopA].resize(kNumberOfDimensions);
-  }
-  mriDoubleVec vort(3);
-  mriOutput out1("Vorticity",3);
+  mriVectorView out1 = outputs.addVector("Vorticity",topology->totalCells);
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
   // Loop on cells
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
-    // Store Criteria
-    computeVorticity(firstDerivs,vort);
-    out1.values.push_back(vort[0]);
-    out1.values.push_back(vort[1]);
-    out1.values.push_back(vort[2]);
-  }
-  // Add output quantities
-  outputs.push_back(out1);
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    // Allocate derivatives
+    mriDoubleMat firstDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat secondDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleVec vort(3);
+    for(int loopA=begin;loopA<end;loopA++){
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
+      // Store Criteria
+      computeVorticity(firstDerivs,vort);
+      out1.at<0>(loopA) = vort[0];
+      out1.at<1>(loopA) = vort[1];
+      out1.at<2>(loopA) = vort[2];
+    }
+  });
 }
 
 // ==============
 // EVAL ENSTROPHY
 // ==============
 void mriScan::evalEnstrophy(mriThresholdCriteria* threshold){
-
-  mriDoubleMat firstDerivs;
-  mriDoubleMat secondDerivs;
-
-  // Allocate derivatives  
-  firstDerivs.resize(kNumberOfDimensions);
-  secondDerivs.resize(kNumberOfDimensions);
-
-  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
-    firstDerivs[loopA].resize(kNumberOfDimensions);
-    secondDerivs[loopA].resize(kNumberOfDimensions);
-  }
-  mriDoubleVec vec(3);
-  double value = 0.0;
-  mriOutput out1("Enstrophy",1);
+  mriScalarView out1 = outputs.addScalar("Enstrophy",topology->totalCells);
+  // Velocity derivatives for all cells
+  const mriVelocityDerivs& derivs = getVelocityDerivs(threshold);
+  // Partial sums for each block
+  mriDoubleVec blockValue(mriParallel::getBlockCount(topology->totalCells),0.0);
   // Loop on cells
-  for(int loopA=0;loopA<topology->totalCells;loopA++){
-    evalSpaceDerivs(loopA,threshold,firstDerivs,secondDerivs);
-    // Store Criteria
-    computeVorticity(firstDerivs,vec);
-    // Square Modulus
-    out1.values.push_back(vec[0]*vec[0] + vec[1]*vec[1] + vec[2]*vec[2]);
-    // Compute Sum
-    value += vec[0]*vec[0] + vec[1]*vec[1] + vec[2]*vec[2];
-  }
-  // Add output quantities
-  outputs.push_back(out1);
+  mriParallel::parallelFor(topology->totalCells,[&](int /*thread*/,int begin,int end){
+    // Allocate derivatives
+    mriDoubleMat firstDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleMat secondDerivs(kNumberOfDimensions,mriDoubleVec(kNumberOfDimensions));
+    mriDoubleVec vec(3);
+    double value = 0.0;
+    for(int loopA=begin;loopA<end;loopA++){
+      derivs.getDerivs(loopA,firstDerivs,secondDerivs);
+      // Store Criteria
+      computeVorticity(firstDerivs,vec);
+      // Square Modulus
+      out1.at<0>(loopA) = vec[0]*vec[0] + vec[1]*vec[1] + vec[2]*vec[2];
+      // Compute Sum
+      value += vec[0]*vec[0] + vec[1]*vec[1] + vec[2]*vec[2];
+    }
+    blockValue[mriParallel::getBlockIndex(begin)] = value;
+  });
   // Print
-  printf("Total Enstrophy: %e\n",value);
+  printf("Total Enstrophy: %e\n",mriParallel::sumBlocks(blockValue));
 }
 
 
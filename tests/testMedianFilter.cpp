@@ -0,0 +1,126 @@
+# include <stdio.h>
+# include <math.h>
+# include <algorithm>
+
+# include "mriMedianFilter.h"
+# include "mriFluidMask.h"
+# include "mriTopology.h"
+# include "mriThresholdCriteria.h"
+# include "mriParallel.h"
+
+using namespace std;
+
+// Same value, NaN matches NaN
+bool isSameValue(double first, double second){
+  return (!medianLess(first,second))&&(!medianLess(second,first));
+}
+
+// ==================================
+// MERGE A WINDOW HOLDING NaN VALUES
+// ==================================
+bool testMergeWithNaN(){
+  double nanValue = nan("");
+  mriDoubleVec window = {1.0,2.0,nanValue,nanValue};
+  mriDoubleVec leaving = {1.0,nanValue};
+  mriDoubleVec entering = {1.5,3.0,nanValue};
+  mriDoubleVec expected = {1.5,2.0,3.0,nanValue,nanValue};
+  mriDoubleVec result;
+  mergeSortedWindow(window,leaving,entering,result);
+  if(result.size() != expected.size()){
+    printf("Merge with NaN: %d values instead of %d.\n",(int)result.size(),(int)expected.size());
+    return false;
+  }
+  for(size_t loopA=0;loopA<result.size();loopA++){
+    if(!isSameValue(result[loopA],expected[loopA])){
+      printf("Merge with NaN: wrong value at %d.\n",(int)loopA);
+      return false;
+    }
+  }
+  // Leaving values missing from the window are reported, not written
+  mriDoubleVec missing = {5.0};
+  try{
+    mergeSortedWindow(expected,missing,entering,result);
+  }catch(mriException& ex){
+    return true;
+  }
+  printf("Merge with missing leaving value not detected.\n");
+  return false;
+}
+
+// ===========================================
+// COMPARE FILTERED FIELD WITH A DIRECT MEDIAN
+// ===========================================
+bool testFilterWithNaN(int order){
+  int totals[3] = {9,7,6};
+  mriIntVec cellTotals(totals,totals+3);
+  mriDoubleVec lengths[3];
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    lengths[loopA].assign(totals[loopA],0.1);
+  }
+  mriDoubleVec minLimits(3,0.0);
+  mriDoubleVec maxLimits(3,1.0);
+  mriTopology topology(cellTotals,lengths[0],lengths[1],lengths[2],minLimits,maxLimits);
+  int totCells = topology.totalCells;
+
+  // Repeated values and a few NaN in every component
+  mriCellData cells(totCells);
+  for(int loopA=0;loopA<totCells;loopA++){
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      cells.velocity(loopB)[loopA] = ((loopA*(7+loopB)) % 13) - 6.0;
+      if(((loopA + 5*loopB) % 11) == 0){
+        cells.velocity(loopB)[loopA] = nan("");
+      }
+    }
+  }
+  cells.markModified();
+  mriThresholdCriteria threshold(kNoQuantity,kCriterionLessThen,0.0);
+  mriFluidMask fluidMask;
+  fluidMask.build(cells,&topology,&threshold);
+
+  mriCellData filtered(totCells);
+  double* inVel[3] = {cells.vx.data(),cells.vy.data(),cells.vz.data()};
+  double* outVel[3] = {filtered.vx.data(),filtered.vy.data(),filtered.vz.data()};
+  mriMedianFilter filter(order);
+  filter.apply(&topology,fluidMask,inVel,outVel);
+
+  // Median of the box with NaN after all numbers
+  mriDoubleVec box;
+  for(int loopA=0;loopA<totCells;loopA++){
+    int coords[3] = {loopA % totals[0],(loopA / totals[0]) % totals[1],loopA / (totals[0]*totals[1])};
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      box.clear();
+      for(int loopZ=std::max(0,coords[2]-order);loopZ<=std::min(totals[2]-1,coords[2]+order);loopZ++){
+        for(int loopY=std::max(0,coords[1]-order);loopY<=std::min(totals[1]-1,coords[1]+order);loopY++){
+          for(int loopX=std::max(0,coords[0]-order);loopX<=std::min(totals[0]-1,coords[0]+order);loopX++){
+            box.push_back(inVel[loopB][(loopZ*totals[1] + loopY)*totals[0] + loopX]);
+          }
+        }
+      }
+      std::sort(box.begin(),box.end(),medianLess);
+      if(!isSameValue(outVel[loopB][loopA],box[box.size()/2])){
+        printf("Order %d: wrong median in cell %d component %d.\n",order,loopA,loopB);
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+// ====
+// MAIN
+// ====
+int main(){
+  bool passed = true;
+  mriParallel::setThreadCount(2);
+  try{
+    passed = testMergeWithNaN() && passed;
+    // Gathered box and sliding window
+    passed = testFilterWithNaN(1) && passed;
+    passed = testFilterWithNaN(kMedianGatherMaxOrder+1) && passed;
+  }catch(mriException& ex){
+    printf("%s",ex.what());
+    passed = false;
+  }
+  printf("%s\n",passed ? "Median filter test passed." : "Median filter test FAILED.");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,122 @@
+# include <stdio.h>
+# include <math.h>
+
+# include "mriPoisson.h"
+# include "mriFluidMask.h"
+# include "mriTopology.h"
+# include "mriThresholdCriteria.h"
+# include "mriParallel.h"
+
+using namespace std;
+
+// Tolerance on the recovered pressure relative to its range
+const double kPoissonTestTolerance = 1.0e-6;
+
+// =====================================================
+// RECOVER A LINEAR PRESSURE FROM ITS CONSTANT GRADIENT
+// =====================================================
+// Box with non-uniform cells along x and a solid block inside, the walls
+// of the block and the domain boundaries are Neumann faces. The solver
+// must return the linear field up to a constant.
+bool testLinearPressure(){
+  int totals[3] = {12,10,8};
+  mriIntVec cellTotals(totals,totals+3);
+  mriDoubleVec lengths[3];
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    lengths[loopA].assign(totals[loopA],0.1);
+  }
+  for(int loopA=0;loopA<totals[0];loopA++){
+    lengths[0][loopA] = 0.05 + 0.01*loopA;
+  }
+  mriDoubleVec minLimits(3,0.0);
+  mriDoubleVec maxLimits(3,1.0);
+  mriTopology topology(cellTotals,lengths[0],lengths[1],lengths[2],minLimits,maxLimits);
+  int totCells = topology.totalCells;
+
+  // Solid block where the concentration is below the threshold
+  mriCellData cells(totCells);
+  for(int loopA=0;loopA<totCells;loopA++){
+    int coords[3] = {loopA % totals[0],(loopA / totals[0]) % totals[1],loopA / (totals[0]*totals[1])};
+    bool isSolid = (coords[0] >= 4)&&(coords[0] < 7)&&(coords[1] >= 3)&&(coords[1] < 6)&&(coords[2] >= 2);
+    cells.conc[loopA] = isSolid ? 0.0 : 1.0;
+  }
+  cells.markModified();
+  mriThresholdCriteria threshold(kQtyConcentration,kCriterionLessThen,0.5);
+  mriFluidMask fluidMask;
+  fluidMask.build(cells,&topology,&threshold);
+
+  // Constant gradient of p = 3x - 2y + 0.5z
+  double gradient[3] = {3.0,-2.0,0.5};
+  mriDoubleVec exact(totCells,0.0);
+  mriDoubleVec gradComps[3];
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    gradComps[loopA].assign(totCells,gradient[loopA]);
+  }
+  for(int loopA=0;loopA<totCells;loopA++){
+    for(int loopB=0;loopB<kNumberOfDimensions;loopB++){
+      exact[loopA] += gradient[loopB]*topology.cellLocations[loopA][loopB];
+    }
+  }
+  const double* pressGrad[3] = {gradComps[0].data(),gradComps[1].data(),gradComps[2].data()};
+
+  mriPoissonSolver solver;
+  solver.build(&topology,fluidMask);
+  mriDoubleVec rhs(totCells,0.0);
+  solver.evalSource(pressGrad,rhs.data());
+  // A compatible Neumann problem has a source summing to zero
+  double rhsSum = 0.0;
+  double rhsNorm = 0.0;
+  for(int loopA=0;loopA<totCells;loopA++){
+    rhsSum += rhs[loopA];
+    rhsNorm += fabs(rhs[loopA]);
+  }
+  if(fabs(rhsSum) > kPoissonTestTolerance*rhsNorm){
+    printf("Linear pressure: source sums to %e.\n",rhsSum);
+    return false;
+  }
+  mriDoubleVec pressure(totCells,0.0);
+  mriDoubleVec residuals;
+  solver.solve(rhs.data(),pressure.data(),500,1.0e-12,residuals);
+
+  // Compare with zero mean on the fluid cells
+  double exactMean = 0.0;
+  double minExact = 0.0;
+  double maxExact = 0.0;
+  bool isFirst = true;
+  for(int loopA=0;loopA<totCells;loopA++){
+    if(fluidMask.isFluid(loopA)){
+      exactMean += exact[loopA];
+      minExact = isFirst ? exact[loopA] : std::min(minExact,exact[loopA]);
+      maxExact = isFirst ? exact[loopA] : std::max(maxExact,exact[loopA]);
+      isFirst = false;
+    }
+  }
+  exactMean /= fluidMask.totalFluidCells;
+  double maxError = 0.0;
+  for(int loopA=0;loopA<totCells;loopA++){
+    if(fluidMask.isFluid(loopA)){
+      maxError = std::max(maxError,fabs(pressure[loopA] - (exact[loopA] - exactMean)));
+    }
+  }
+  if(maxError > kPoissonTestTolerance*(maxExact - minExact)){
+    printf("Linear pressure: max error %e after %d iterations.\n",maxError,(int)residuals.size());
+    return false;
+  }
+  return true;
+}
+
+// ====
+// MAIN
+// ====
+int main(){
+  bool passed = true;
+  mriParallel::setThreadCount(2);
+  try{
+    passed = testLinearPressure() && passed;
+  }catch(mriException& ex){
+    printf("%s",ex.what());
+    passed = false;
+  }
+  printf("%s\n",passed ? "Poisson solver test passed." : "Poisson solver test FAILED.");
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+# include <stdio.h>
+# include <string.h>
+# include <stdint.h>
+
+# include "mriSequenceFile.h"
+# include "mriParallel.h"
+
+using namespace std;
+
+// Grid of a single brick
+const int kTestCellTotals[3] = {4,3,2};
+
+// ===============================
+// WRITE A FILE WITH ONE INT ARRAY
+// ===============================
+void writeTestFile(const string& fileName){
+  mriSequenceFileGrid grid;
+  for(int loopA=0;loopA<kNumberOfDimensions;loopA++){
+    grid.cellTotals.push_back(kTestCellTotals[loopA]);
+    grid.cellLengths.push_back(mriDoubleVec(kTestCellTotals[loopA],0.1));
+    mriDoubleVec coords(kTestCellTotals[loopA],0.0);
+    for(int loopB=0;loopB<kTestCellTotals[loopA];loopB++){
+      coords[loopB] = 0.05 + 0.1*loopB;
+    }
+    grid.axisCoords.push_back(coords);
+  }
+  grid.domainSizeMin.assign(kNumberOfDimensions,0.0);
+  grid.domainSizeMax.assign(kNumberOfDimensions,1.0);
+  int totCells = kTestCellTotals[0]*kTestCellTotals[1]*kTestCellTotals[2];
+  mriIntVec values(totCells,0);
+  for(int loopA=0;loopA<totCells;loopA++){
+    values[loopA] = loopA;
+  }
+  mriSequenceFileWriter writer(fileName,kSequenceCompressNone,grid);
+  writer.beginPhase(0.0);
+  writer.writeArray("tag",values.data());
+  writer.close();
+}
+
+// =================================
+// COPY A FILE CHANGING BYTES AT END
+// =================================
+// The last index entry is the offset and size of the only brick, the
+// number of components of the array comes right before it
+void corruptTestFile(const string& source, const string& target, size_t posFromEnd, const void* bytes, size_t size){
+  FILE* inFile = fopen(source.c_str(),"rb");
+  vector<char> data;
+  char buffer[4096];
+  size_t count = 0;
+  while((count = fread(buffer,1,sizeof(buffer),inFile)) > 0){
+    data.insert(data.end(),buffer,buffer+count);
+  }
+  fclose(inFile);
+  memcpy(data.data() + data.size() - posFromEnd,bytes,size);
+  FILE* outFile = fopen(target.c_str(),"wb");
+  fwrite(data.data(),1,data.size(),outFile);
+  fclose(outFile);
+}
+
+bool isRejected(const string& fileName){
+  try{
+    mriSequenceFileReader reader(fileName);
+  }catch(mriException& ex){
+    return true;
+  }
+  return false;
+}
+
+// ===========================
+// REJECT INCONSISTENT INDEXES
+// ===========================
+bool testIndexChecks(){
+  writeTestFile("testSequence.seq");
+  mriSequenceFileReader reader("testSequence.seq");
+  int totCells = kTestCellTotals[0]*kTestCellTotals[1]*kTestCellTotals[2];
+  mriIntVec values(totCells,-1);
+  mriIntVec boxMin(3,0);
+  mriIntVec boxMax(kTestCellTotals,kTestCellTotals+3);
+  void* components[1] = {values.data()};
+  reader.readArray(0,0,boxMin,boxMax,components);
+  if(values[totCells-1] != totCells-1){
+    printf("Sequence file: wrong value read back.\n");
+    return false;
+  }
+  bool passed = true;
+  // Brick past the index with zero size
+  uint64_t brick[2] = {UINT64_MAX/2,0};
+  corruptTestFile("testSequence.seq","testSequenceOffset.seq",sizeof(brick),brick,sizeof(brick));
+  if(!isRejected("testSequenceOffset.seq")){
+    printf("Sequence file: brick offset past the index not detected.\n");
+    passed = false;
+  }
+  // More components than the index can describe
+  int32_t totComponents = INT32_MAX;
+  corruptTestFile("testSequence.seq","testSequenceEntries.seq",sizeof(brick) + sizeof(int32_t),&totComponents,sizeof(int32_t));
+  if(!isRejected("testSequenceEntries.seq")){
+    printf("Sequence file: truncated brick entries not detected.\n");
+    passed = false;
+  }
+  remove("testSequence.seq");
+  remove("testSequenceOffset.seq");
+  remove("testSequenceEntries.seq");
+  return passed;
+}
+
+// ====
+// MAIN
+// ====
+int main(){
+  bool passed = true;
+  mriParallel::setThreadCount(2);
+  try{
+    passed = testIndexChecks() && passed;
+  }catch(mriException& ex){
+    printf("%s",ex.what());
+    passed = false;
+  }
+  printf("%s\n",passed ? "Sequence file test passed." : "Sequence file test FAILED.");
+  return passed ? 0 : 1;
+}
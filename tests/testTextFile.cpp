@@ -0,0 +1,47 @@
+# include <stdio.h>
+# include <string.h>
+
+# include "mriTextFile.h"
+# include "mriParallel.h"
+
+using namespace std;
+
+// =======================================
+// PARSE INTO DESTINATIONS OF LIMITED SIZE
+// =======================================
+bool testParseCapacity(){
+  const char* text = "1.0 2.0\n3.0 4.0\n5.0 6.0\n";
+  mriTextBlock block(text,text+strlen(text));
+  mriDoubleVec first(3,0.0);
+  mriDoubleVec second(3,0.0);
+  double* components[2] = {first.data(),second.data()};
+  block.parse(2,3,components);
+  if((first[2] != 5.0)||(second[2] != 6.0)){
+    printf("Parse: wrong values in the last tuple.\n");
+    return false;
+  }
+  // One tuple less than in the block
+  try{
+    block.parse(2,2,components);
+  }catch(mriException& ex){
+    return true;
+  }
+  printf("Parse past the destination not detected.\n");
+  return false;
+}
+
+// ====
+// MAIN
+// ====
+int main(){
+  bool passed = true;
+  mriParallel::setThreadCount(2);
+  try{
+    passed = testParseCapacity() && passed;
+  }catch(mriException& ex){
+    printf("%s",ex.what());
+    passed = false;
+  }
+  printf("%s\n",passed ? "Text file test passed." : "Text file test FAILED.");
+  return passed ? 0 : 1;
+}